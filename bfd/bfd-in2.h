@@ -1970,6 +1970,14 @@ struct bfd
      least-recently-used list of BFDs.  */
   struct bfd *lru_prev, *lru_next;
 
+  /* The number of positional reads in progress on the file, which
+     the caching routines must not close while this is non-zero.  */
+  unsigned int cache_pins;
+
+  /* Set when the file was to be closed while it was pinned.  The
+     last positional read to finish closes it.  */
+  unsigned int cache_close_pending : 1;
+
   /* Track current file position (or current buffer offset for
      in-memory BFDs).  When a file is closed by the caching routines,
      BFD retains state information on the file here.  */
@@ -2079,12 +2087,20 @@ struct bfd
   /* Don't generate ELF section header.  */
 #define BFD_NO_SECTION_HEADER  0x800000
 
+  /* Compress zstd sections as a sequence of independent frames, so
+     that they can be decompressed in parallel.  */
+#define BFD_COMPRESS_CHUNKED  0x1000000
+
+  /* Build a flat index of all DWARF line tables on the first address
+     lookup, for callers which look up many addresses.  */
+#define BFD_DWARF2_LINE_INDEX 0x2000000
+
   /* Flags bits which are for BFD use only.  */
 #define BFD_FLAGS_FOR_BFD_USE_MASK \
   (BFD_IN_MEMORY | BFD_COMPRESS | BFD_DECOMPRESS | BFD_LINKER_CREATED \
    | BFD_PLUGIN | BFD_TRADITIONAL_FORMAT | BFD_DETERMINISTIC_OUTPUT \
    | BFD_COMPRESS_GABI | BFD_CONVERT_ELF_COMMON | BFD_USE_ELF_STT_COMMON \
-   | BFD_NO_SECTION_HEADER)
+   | BFD_NO_SECTION_HEADER | BFD_DWARF2_LINE_INDEX)
 
   /* The format which belongs to the BFD. (object, core, etc.)  */
   ENUM_BITFIELD (bfd_format) format : 3;
@@ -2749,6 +2765,9 @@ char *bfd_demangle (bfd *, const char *, int);
 bfd_size_type bfd_read (void *, bfd_size_type, bfd *)
 ATTRIBUTE_WARN_UNUSED_RESULT;
 
+bfd_size_type bfd_pread (void *, bfd_size_type, file_ptr, bfd *)
+ATTRIBUTE_WARN_UNUSED_RESULT;
+
 bfd_size_type bfd_write (const void *, bfd_size_type, bfd *)
 ATTRIBUTE_WARN_UNUSED_RESULT;
 
@@ -2799,12 +2818,35 @@ bool bfd_get_file_window
    (bfd *, file_ptr, bfd_size_type, bfd_window *, bool /*writable*/);
 
 /* Extracted from cache.c.  */
+/* Counters describing the activity of the file cache, returned by
+   bfd_cache_get_stats.  */
+struct bfd_cache_stats
+{
+  /* The number of files opened or reopened by the cache.  */
+  unsigned long opens;
+  /* The number of files closed to keep the number of open files
+     below the limit.  */
+  unsigned long evictions;
+  /* The number of times the cache took the BFD lock.  */
+  unsigned long lock_acquisitions;
+  /* The number of reads done through the shared stream of a file,
+     with the BFD lock held for the whole read.  */
+  unsigned long locked_reads;
+  bfd_size_type locked_bytes;
+  /* The number of positional reads done without holding the BFD
+     lock.  */
+  unsigned long positional_reads;
+  bfd_size_type positional_bytes;
+};
+
 bool bfd_cache_close (bfd *abfd);
 
 bool bfd_cache_close_all (void);
 
 unsigned bfd_cache_size (void);
 
+void bfd_cache_get_stats (struct bfd_cache_stats *stats);
+
 /* Extracted from compress.c.  */
 /* Types of compressed DWARF debug sections.  */
 enum compressed_debug_section_type
@@ -2813,7 +2855,8 @@ enum compressed_debug_section_type
   COMPRESS_DEBUG_GNU_ZLIB = 1 << 1,
   COMPRESS_DEBUG_GABI_ZLIB = 1 << 2,
   COMPRESS_DEBUG_ZSTD = 1 << 3,
-  COMPRESS_UNKNOWN = 1 << 4
+  COMPRESS_DEBUG_ZSTD_CHUNKED = 1 << 4,
+  COMPRESS_UNKNOWN = 1 << 5
 };
 
 /* Tuple for compressed_debug_section_type and their name.  */
@@ -2831,6 +2874,27 @@ enum compression_type
   ch_compress_zstd = 2         /* Compressed with zstd (www.zstandard.org).  */
 };
 
+/* The amount of uncompressed data in each zstd frame of a section
+   compressed with BFD_COMPRESS_CHUNKED.  Each frame can be
+   decompressed on its own, so smaller frames allow more parallelism
+   and finer-grained access, at the cost of a worse compression
+   ratio.  */
+#define BFD_COMPRESS_CHUNK_SIZE (1024 * 1024)
+
+/* A piece of a compressed section that can be decompressed on its
+   own, see bfd_get_compressed_section_chunks.  */
+struct bfd_compressed_chunk
+{
+  /* Offset and size of the compressed data in the buffer returned
+     by bfd_get_compressed_section_chunks.  */
+  bfd_size_type compressed_offset;
+  bfd_size_type compressed_size;
+
+  /* Offset and size of the decompressed data in the section.  */
+  bfd_size_type uncompressed_offset;
+  bfd_size_type uncompressed_size;
+};
+
 static inline char *
 bfd_debug_name_to_zdebug (bfd *abfd, const char *name)
 {
@@ -2878,6 +2942,14 @@ bool bfd_convert_section_contents
 bool bfd_get_full_section_contents
    (bfd *abfd, asection *section, bfd_byte **ptr);
 
+bool bfd_get_compressed_section_chunks
+   (bfd *abfd, asection *section, bfd_byte **compressed,
+    struct bfd_compressed_chunk **chunks, unsigned int *count);
+
+bool bfd_decompress_section_chunk
+   (asection *section, const bfd_byte *compressed,
+    const struct bfd_compressed_chunk *chunk, bfd_byte *buffer);
+
 bool bfd_is_section_compressed_info
    (bfd *abfd, asection *section,
     int *compression_header_size_p,
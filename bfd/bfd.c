@@ -93,6 +93,14 @@ CODE_FRAGMENT
 .     least-recently-used list of BFDs.  *}
 .  struct bfd *lru_prev, *lru_next;
 .
+.  {* The number of positional reads in progress on the file, which
+.     the caching routines must not close while this is non-zero.  *}
+.  unsigned int cache_pins;
+.
+.  {* Set when the file was to be closed while it was pinned.  The
+.     last positional read to finish closes it.  *}
+.  unsigned int cache_close_pending : 1;
+.
 .  {* Track current file position (or current buffer offset for
 .     in-memory BFDs).  When a file is closed by the caching routines,
 .     BFD retains state information on the file here.  *}
@@ -203,12 +211,20 @@ CODE_FRAGMENT
 .  {* Don't generate ELF section header.  *}
 .#define BFD_NO_SECTION_HEADER	0x800000
 .
+.  {* Compress zstd sections as a sequence of independent frames, so
+.     that they can be decompressed in parallel.  *}
+.#define BFD_COMPRESS_CHUNKED  0x1000000
+.
+.  {* Build a flat index of all DWARF line tables on the first address
+.     lookup, for callers which look up many addresses.  *}
+.#define BFD_DWARF2_LINE_INDEX 0x2000000
+.
 .  {* Flags bits which are for BFD use only.  *}
 .#define BFD_FLAGS_FOR_BFD_USE_MASK \
 .  (BFD_IN_MEMORY | BFD_COMPRESS | BFD_DECOMPRESS | BFD_LINKER_CREATED \
 .   | BFD_PLUGIN | BFD_TRADITIONAL_FORMAT | BFD_DETERMINISTIC_OUTPUT \
 .   | BFD_COMPRESS_GABI | BFD_CONVERT_ELF_COMMON | BFD_USE_ELF_STT_COMMON \
-.   | BFD_NO_SECTION_HEADER)
+.   | BFD_NO_SECTION_HEADER | BFD_DWARF2_LINE_INDEX)
 .
 .  {* The format which belongs to the BFD. (object, core, etc.)  *}
 .  ENUM_BITFIELD (bfd_format) format : 3;
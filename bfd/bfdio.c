@@ -222,6 +222,12 @@ DESCRIPTION
 .  void *(*bmmap) (struct bfd *abfd, void *addr, bfd_size_type len,
 .		   int prot, int flags, file_ptr offset,
 .		   void **map_addr, bfd_size_type *map_len);
+.  {* Like bread, but read at OFFSET, without using or changing the
+.     IOSTREAM's file offset.  This may be called by several threads at
+.     once.  May be NULL, in which case bfd_pread falls back to bseek
+.     and bread.  *}
+.  file_ptr (*bpread) (struct bfd *abfd, void *ptr, file_ptr nbytes,
+.		      file_ptr offset);
 .};
 
 .extern const struct bfd_iovec _bfd_memory_iovec;
@@ -295,6 +301,68 @@ bfd_read (void *ptr, bfd_size_type size, bfd *abfd)
   return nread;
 }
 
+/*
+FUNCTION
+	bfd_pread
+
+SYNOPSIS
+	bfd_size_type bfd_pread (void *, bfd_size_type, file_ptr, bfd *)
+				 ATTRIBUTE_WARN_UNUSED_RESULT;
+
+DESCRIPTION
+	Attempt to read SIZE bytes at offset OFFSET of ABFD to PTR.
+	Return the amount read.  Unlike bfd_seek followed by bfd_read,
+	this neither uses nor changes ABFD's file position, so several
+	threads may read different parts of the same file at once.
+*/
+
+bfd_size_type
+bfd_pread (void *ptr, bfd_size_type size, file_ptr offset, bfd *abfd)
+{
+  bfd *element_bfd = abfd;
+  ufile_ptr origin = 0;
+
+  while (abfd->my_archive != NULL
+	 && !bfd_is_thin_archive (abfd->my_archive))
+    {
+      origin += abfd->origin;
+      abfd = abfd->my_archive;
+    }
+  origin += abfd->origin;
+
+  /* If this is a non-thin archive element, don't read past the end of
+     this element.  */
+  if (element_bfd->arelt_data != NULL
+      && element_bfd->my_archive != NULL
+      && !bfd_is_thin_archive (element_bfd->my_archive))
+    {
+      bfd_size_type maxbytes = arelt_size (element_bfd);
+
+      if (offset < 0 || (ufile_ptr) offset >= maxbytes)
+	{
+	  bfd_set_error (bfd_error_invalid_operation);
+	  return -1;
+	}
+      if ((ufile_ptr) offset + size > maxbytes)
+	size = maxbytes - offset;
+    }
+
+  if (abfd->iovec == NULL)
+    {
+      bfd_set_error (bfd_error_invalid_operation);
+      return -1;
+    }
+
+  if (abfd->iovec->bpread == NULL)
+    {
+      if (bfd_seek (element_bfd, offset, SEEK_SET) != 0)
+	return -1;
+      return bfd_read (ptr, size, element_bfd);
+    }
+
+  return abfd->iovec->bpread (abfd, ptr, size, origin + offset);
+}
+
 /*
 FUNCTION
 	bfd_write
@@ -695,6 +763,26 @@ memory_bread (bfd *abfd, void *ptr, file_ptr size)
   return get;
 }
 
+static file_ptr
+memory_bpread (bfd *abfd, void *ptr, file_ptr size, file_ptr offset)
+{
+  struct bfd_in_memory *bim;
+  bfd_size_type get;
+
+  bim = (struct bfd_in_memory *) abfd->iostream;
+  get = size;
+  if (offset + get > bim->size)
+    {
+      if (bim->size < (bfd_size_type) offset)
+	get = 0;
+      else
+	get = bim->size - offset;
+      bfd_set_error (bfd_error_file_truncated);
+    }
+  memcpy (ptr, bim->buffer + offset, (size_t) get);
+  return get;
+}
+
 static file_ptr
 memory_bwrite (bfd *abfd, const void *ptr, file_ptr size)
 {
@@ -826,7 +914,8 @@ memory_bmmap (bfd *abfd ATTRIBUTE_UNUSED, void *addr ATTRIBUTE_UNUSED,
 const struct bfd_iovec _bfd_memory_iovec =
 {
   &memory_bread, &memory_bwrite, &memory_btell, &memory_bseek,
-  &memory_bclose, &memory_bflush, &memory_bstat, &memory_bmmap
+  &memory_bclose, &memory_bflush, &memory_bstat, &memory_bmmap,
+  &memory_bpread
 };
 
 /*
@@ -125,6 +125,47 @@ static unsigned open_files;
 
 static bfd *bfd_last_cache = NULL;
 
+/*
+EXTERNAL
+.{* Counters describing the activity of the file cache, returned by
+.   bfd_cache_get_stats.  *}
+.struct bfd_cache_stats
+.{
+.  {* The number of files opened or reopened by the cache.  *}
+.  unsigned long opens;
+.  {* The number of files closed to keep the number of open files
+.     below the limit.  *}
+.  unsigned long evictions;
+.  {* The number of times the cache took the BFD lock.  *}
+.  unsigned long lock_acquisitions;
+.  {* The number of reads done through the shared stream of a file,
+.     with the BFD lock held for the whole read.  *}
+.  unsigned long locked_reads;
+.  bfd_size_type locked_bytes;
+.  {* The number of positional reads done without holding the BFD
+.     lock.  *}
+.  unsigned long positional_reads;
+.  bfd_size_type positional_bytes;
+.};
+.
+*/
+
+/* The statistics of the cache.  These are only updated with the BFD
+   lock held.  */
+
+static struct bfd_cache_stats cache_stats;
+
+/* Take the BFD lock on behalf of the cache.  */
+
+static bool
+cache_lock (void)
+{
+  if (!bfd_lock ())
+    return false;
+  ++cache_stats.lock_acquisitions;
+  return true;
+}
+
 /* Insert a BFD into the cache.  */
 
 static void
@@ -178,6 +219,7 @@ bfd_cache_delete (bfd *abfd)
   snip (abfd);
 
   abfd->iostream = NULL;
+  abfd->cache_close_pending = 0;
   BFD_ASSERT (open_files > 0);
   --open_files;
   abfd->flags |= BFD_CLOSED_BY_CACHE;
@@ -186,7 +228,8 @@ bfd_cache_delete (bfd *abfd)
 }
 
 /* We need to open a new file, and the cache is full.  Find the least
-   recently used cacheable BFD and close it.  */
+   recently used cacheable BFD that isn't being read by cache_bpread,
+   and close it.  */
 
 static bool
 close_one (void)
@@ -198,7 +241,7 @@ close_one (void)
   else
     {
       for (to_kill = bfd_last_cache->lru_prev;
-	   ! to_kill->cacheable;
+	   ! to_kill->cacheable || to_kill->cache_pins != 0;
 	   to_kill = to_kill->lru_prev)
 	{
 	  if (to_kill == bfd_last_cache)
@@ -217,6 +260,7 @@ close_one (void)
 
   to_kill->where = _bfd_real_ftell ((FILE *) to_kill->iostream);
 
+  ++cache_stats.evictions;
   return bfd_cache_delete (to_kill);
 }
 
@@ -280,7 +324,7 @@ bfd_cache_lookup_worker (bfd *abfd, enum cache_flag flag)
 static file_ptr
 cache_btell (struct bfd *abfd)
 {
-  if (!bfd_lock ())
+  if (!cache_lock ())
     return -1;
   FILE *f = bfd_cache_lookup (abfd, CACHE_NO_OPEN);
   if (f == NULL)
@@ -298,7 +342,7 @@ cache_btell (struct bfd *abfd)
 static int
 cache_bseek (struct bfd *abfd, file_ptr offset, int whence)
 {
-  if (!bfd_lock ())
+  if (!cache_lock ())
     return -1;
   FILE *f = bfd_cache_lookup (abfd, whence != SEEK_CUR ? CACHE_NO_SEEK : CACHE_NORMAL);
   if (f == NULL)
@@ -354,20 +398,12 @@ cache_bread_1 (FILE *f, void *buf, file_ptr nbytes)
   return nread;
 }
 
+/* Read NBYTES from F, which is at the right position, to BUF.  */
+
 static file_ptr
-cache_bread (struct bfd *abfd, void *buf, file_ptr nbytes)
+cache_bread_unlocked (FILE *f, void *buf, file_ptr nbytes)
 {
-  if (!bfd_lock ())
-    return -1;
   file_ptr nread = 0;
-  FILE *f;
-
-  f = bfd_cache_lookup (abfd, CACHE_NORMAL);
-  if (f == NULL)
-    {
-      bfd_unlock ();
-      return -1;
-    }
 
   /* Some filesystems are unable to handle reads that are too large
      (for instance, NetApp shares with oplocks turned off).  To avoid
@@ -398,6 +434,144 @@ cache_bread (struct bfd *abfd, void *buf, file_ptr nbytes)
 	break;
     }
 
+  return nread;
+}
+
+static file_ptr
+cache_bread (struct bfd *abfd, void *buf, file_ptr nbytes)
+{
+  if (!cache_lock ())
+    return -1;
+  file_ptr nread;
+  FILE *f;
+
+  f = bfd_cache_lookup (abfd, CACHE_NORMAL);
+  if (f == NULL)
+    {
+      bfd_unlock ();
+      return -1;
+    }
+
+  nread = cache_bread_unlocked (f, buf, nbytes);
+  ++cache_stats.locked_reads;
+  if (nread > 0)
+    cache_stats.locked_bytes += nread;
+
+  if (!bfd_unlock ())
+    return -1;
+  return nread;
+}
+
+#if defined (HAVE_PREAD) && defined (HAVE_FILENO)
+
+/* Read NBYTES at OFFSET of the file open on FD to BUF, without
+   changing the file offset.  This is called without the BFD lock.  */
+
+static file_ptr
+cache_pread_fd (int fd, void *buf, file_ptr nbytes, file_ptr offset)
+{
+  file_ptr nread = 0;
+
+  /* Read in chunks of 8MB max, for the same reason as
+     cache_bread_unlocked.  */
+  while (nread < nbytes)
+    {
+      const file_ptr max_chunk_size = 0x800000;
+      file_ptr chunk_size = nbytes - nread;
+      ssize_t chunk_nread;
+
+      if (chunk_size > max_chunk_size)
+	chunk_size = max_chunk_size;
+
+      chunk_nread = pread (fd, (char *) buf + nread, chunk_size,
+			   offset + nread);
+      if (chunk_nread < 0 && errno == EINTR)
+	continue;
+      if (chunk_nread < 0)
+	{
+	  bfd_set_error (bfd_error_system_call);
+	  return nread == 0 ? -1 : nread;
+	}
+      if (chunk_nread == 0)
+	break;
+      nread += chunk_nread;
+    }
+
+  if (nread < nbytes)
+    /* This may or may not be an error, but in case the calling code
+       bails out because of it, set the right error code.  */
+    bfd_set_error (bfd_error_file_truncated);
+  return nread;
+}
+
+#endif
+
+/* Read NBYTES at OFFSET of ABFD to BUF, without changing the position
+   of its stream.
+
+   A file that is only read can be read through its descriptor with
+   pread, so the lock is only held while looking the file up and
+   pinning it in the cache, and several threads can read at once.  A
+   file that may be written can have data buffered in its stream, so
+   it is read through the stream, with the lock held.  */
+
+static file_ptr
+cache_bpread (struct bfd *abfd, void *buf, file_ptr nbytes, file_ptr offset)
+{
+  if (!cache_lock ())
+    return -1;
+  file_ptr nread;
+  FILE *f;
+
+  f = bfd_cache_lookup (abfd, CACHE_NORMAL);
+  if (f == NULL)
+    {
+      bfd_unlock ();
+      return -1;
+    }
+
+#if defined (HAVE_PREAD) && defined (HAVE_FILENO)
+  if (abfd->direction == read_direction)
+    {
+      int fd = fileno (f);
+
+      ++abfd->cache_pins;
+      if (!bfd_unlock ())
+	return -1;
+
+      nread = cache_pread_fd (fd, buf, nbytes, offset);
+
+      if (!cache_lock ())
+	return -1;
+      --abfd->cache_pins;
+      ++cache_stats.positional_reads;
+      if (nread > 0)
+	cache_stats.positional_bytes += nread;
+      if (abfd->cache_pins == 0 && abfd->cache_close_pending)
+	bfd_cache_delete (abfd);
+      if (!bfd_unlock ())
+	return -1;
+      return nread;
+    }
+#endif
+
+  file_ptr pos = _bfd_real_ftell (f);
+  if (pos < 0 || _bfd_real_fseek (f, offset, SEEK_SET) != 0)
+    {
+      bfd_set_error (bfd_error_system_call);
+      bfd_unlock ();
+      return -1;
+    }
+  nread = cache_bread_unlocked (f, buf, nbytes);
+  if (_bfd_real_fseek (f, pos, SEEK_SET) != 0)
+    {
+      bfd_set_error (bfd_error_system_call);
+      nread = -1;
+    }
+  ++cache_stats.locked_reads;
+  if (nread > 0)
+    cache_stats.locked_bytes += nread;
+
   if (!bfd_unlock ())
     return -1;
   return nread;
@@ -406,7 +580,7 @@ cache_bread (struct bfd *abfd, void *buf, file_ptr nbytes)
 static file_ptr
 cache_bwrite (struct bfd *abfd, const void *from, file_ptr nbytes)
 {
-  if (!bfd_lock ())
+  if (!cache_lock ())
     return -1;
   file_ptr nwrite;
   FILE *f = bfd_cache_lookup (abfd, CACHE_NORMAL);
@@ -439,7 +613,7 @@ cache_bclose (struct bfd *abfd)
 static int
 cache_bflush (struct bfd *abfd)
 {
-  if (!bfd_lock ())
+  if (!cache_lock ())
     return -1;
   int sts;
   FILE *f = bfd_cache_lookup (abfd, CACHE_NO_OPEN);
@@ -461,7 +635,7 @@ cache_bflush (struct bfd *abfd)
 static int
 cache_bstat (struct bfd *abfd, struct stat *sb)
 {
-  if (!bfd_lock ())
+  if (!cache_lock ())
     return -1;
   int sts;
   FILE *f = bfd_cache_lookup (abfd, CACHE_NO_SEEK_ERROR);
@@ -491,7 +665,7 @@ cache_bmmap (struct bfd *abfd ATTRIBUTE_UNUSED,
 {
   void *ret = (void *) -1;
 
-  if (!bfd_lock ())
+  if (!cache_lock ())
     return ret;
   if ((abfd->flags & BFD_IN_MEMORY) != 0)
     abort ();
@@ -537,7 +711,8 @@ cache_bmmap (struct bfd *abfd ATTRIBUTE_UNUSED,
 static const struct bfd_iovec cache_iovec =
 {
   &cache_bread, &cache_bwrite, &cache_btell, &cache_bseek,
-  &cache_bclose, &cache_bflush, &cache_bstat, &cache_bmmap
+  &cache_bclose, &cache_bflush, &cache_bstat, &cache_bmmap,
+  &cache_bpread
 };
 
 static bool
@@ -553,6 +728,7 @@ _bfd_cache_init_unlocked (bfd *abfd)
   insert (abfd);
   abfd->flags &= ~BFD_CLOSED_BY_CACHE;
   ++open_files;
+  ++cache_stats.opens;
   return true;
 }
 
@@ -570,7 +746,7 @@ DESCRIPTION
 bool
 bfd_cache_init (bfd *abfd)
 {
-  if (!bfd_lock ())
+  if (!cache_lock ())
     return false;
   bool result = _bfd_cache_init_unlocked (abfd);
   if (!bfd_unlock ())
@@ -589,6 +765,15 @@ _bfd_cache_close_unlocked (bfd *abfd)
     /* Previously closed.  */
     return true;
 
+  /* Another thread is reading the file through its descriptor, with
+     the lock released.  Leave the file to be closed when the last
+     such read finishes.  */
+  if (abfd->cache_pins != 0)
+    {
+      abfd->cache_close_pending = 1;
+      return true;
+    }
+
   /* Note: no locking needed in this function, as it is handled by
      bfd_cache_delete.  */
   return bfd_cache_delete (abfd);
@@ -603,7 +788,8 @@ SYNOPSIS
 
 DESCRIPTION
 	Remove the BFD @var{abfd} from the cache. If the attached file is open,
-	then close it too.
+	then close it too.  If another thread is reading the file with
+	<<bfd_pread>>, the file is closed when that read finishes.
 
 	<<FALSE>> is returned if closing the file fails, <<TRUE>> is
 	returned if all is well.
@@ -612,7 +798,7 @@ DESCRIPTION
 bool
 bfd_cache_close (bfd *abfd)
 {
-  if (!bfd_lock ())
+  if (!cache_lock ())
     return false;
   bool result = _bfd_cache_close_unlocked (abfd);
   if (!bfd_unlock ())
@@ -631,7 +817,9 @@ DESCRIPTION
 	Remove all BFDs from the cache. If the attached file is open,
 	then close it too.  Note - despite its name this function will
 	close a BFD even if it is not marked as being cacheable, ie
-	even if bfd_get_cacheable() returns false.
+	even if bfd_get_cacheable() returns false.  Files that other
+	threads are reading with <<bfd_pread>> are closed when those
+	reads finish.
 
 	<<FALSE>> is returned if closing one of the file fails, <<TRUE>> is
 	returned if all is well.
@@ -641,19 +829,25 @@ bool
 bfd_cache_close_all (void)
 {
   bool ret = true;
+  bfd *abfd;
+  unsigned int n;
 
-  if (!bfd_lock ())
+  if (!cache_lock ())
     return false;
-  while (bfd_last_cache != NULL)
-    {
-      bfd *prev_bfd_last_cache = bfd_last_cache;
 
-      ret &= _bfd_cache_close_unlocked (bfd_last_cache);
+  /* A file being read by another thread stays in the cache until that
+     read finishes, so walk the list rather than always closing its
+     head.  Visiting each of the OPEN_FILES entries once also stops a
+     potential infinite loop should bfd_cache_close() not update the
+     list.  */
+  for (abfd = bfd_last_cache, n = open_files;
+       abfd != NULL && n > 0;
+       n--)
+    {
+      bfd *next = abfd->lru_next;
 
-      /* Stop a potential infinite loop should bfd_cache_close()
-	 not update bfd_last_cache.  */
-      if (bfd_last_cache == prev_bfd_last_cache)
-	break;
+      ret &= _bfd_cache_close_unlocked (abfd);
+      abfd = bfd_last_cache != NULL ? next : NULL;
     }
 
   if (!bfd_unlock ())
@@ -678,6 +872,30 @@ bfd_cache_size (void)
   return open_files;
 }
 
+/*
+FUNCTION
+	bfd_cache_get_stats
+
+SYNOPSIS
+	void bfd_cache_get_stats (struct bfd_cache_stats *stats);
+
+DESCRIPTION
+	Store the counters describing the activity of the file cache
+	since the program started in @var{stats}.
+*/
+
+void
+bfd_cache_get_stats (struct bfd_cache_stats *stats)
+{
+  if (!bfd_lock ())
+    {
+      memset (stats, 0, sizeof (*stats));
+      return;
+    }
+  *stats = cache_stats;
+  bfd_unlock ();
+}
+
 static FILE *
 _bfd_open_file_unlocked (bfd *abfd)
 {
@@ -769,7 +987,7 @@ DESCRIPTION
 FILE *
 bfd_open_file (bfd *abfd)
 {
-  if (!bfd_lock ())
+  if (!cache_lock ())
     return NULL;
   FILE *result = _bfd_open_file_unlocked (abfd);
   if (!bfd_unlock ())
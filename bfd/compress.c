@@ -40,7 +40,8 @@ EXTERNAL
 .  COMPRESS_DEBUG_GNU_ZLIB = 1 << 1,
 .  COMPRESS_DEBUG_GABI_ZLIB = 1 << 2,
 .  COMPRESS_DEBUG_ZSTD = 1 << 3,
-.  COMPRESS_UNKNOWN = 1 << 4
+.  COMPRESS_DEBUG_ZSTD_CHUNKED = 1 << 4,
+.  COMPRESS_UNKNOWN = 1 << 5
 .};
 .
 .{* Tuple for compressed_debug_section_type and their name.  *}
@@ -58,6 +59,27 @@ EXTERNAL
 .  ch_compress_zstd = 2		{* Compressed with zstd (www.zstandard.org).  *}
 .};
 .
+.{* The amount of uncompressed data in each zstd frame of a section
+.   compressed with BFD_COMPRESS_CHUNKED.  Each frame can be
+.   decompressed on its own, so smaller frames allow more parallelism
+.   and finer-grained access, at the cost of a worse compression
+.   ratio.  *}
+.#define BFD_COMPRESS_CHUNK_SIZE (1024 * 1024)
+.
+.{* A piece of a compressed section that can be decompressed on its
+.   own, see bfd_get_compressed_section_chunks.  *}
+.struct bfd_compressed_chunk
+.{
+.  {* Offset and size of the compressed data in the buffer returned
+.     by bfd_get_compressed_section_chunks.  *}
+.  bfd_size_type compressed_offset;
+.  bfd_size_type compressed_size;
+.
+.  {* Offset and size of the decompressed data in the section.  *}
+.  bfd_size_type uncompressed_offset;
+.  bfd_size_type uncompressed_size;
+.};
+.
 .static inline char *
 .bfd_debug_name_to_zdebug (bfd *abfd, const char *name)
 .{
@@ -93,6 +115,7 @@ static const struct compressed_type_tuple compressed_debug_section_names[] =
   { COMPRESS_DEBUG_GNU_ZLIB, "zlib-gnu" },
   { COMPRESS_DEBUG_GABI_ZLIB, "zlib-gabi" },
   { COMPRESS_DEBUG_ZSTD, "zstd" },
+  { COMPRESS_DEBUG_ZSTD_CHUNKED, "zstd-chunked" },
 };
 
 /*
@@ -553,6 +576,63 @@ decompress_contents (bool is_zstd, bfd_byte *compressed_buffer,
   return inflateEnd (&strm) == Z_OK && rc == Z_OK && strm.avail_out == 0;
 }
 
+#ifdef HAVE_ZSTD
+/* Return the size of the buffer needed to compress INPUT_SIZE bytes
+   with compress_zstd_chunked.  */
+
+static size_t
+compress_zstd_chunked_bound (size_t input_size)
+{
+  size_t bound = 0;
+
+  for (size_t pos = 0; pos < input_size; pos += BFD_COMPRESS_CHUNK_SIZE)
+    {
+      size_t chunk_size = input_size - pos;
+      if (chunk_size > BFD_COMPRESS_CHUNK_SIZE)
+	chunk_size = BFD_COMPRESS_CHUNK_SIZE;
+      bound += ZSTD_compressBound (chunk_size);
+    }
+  return bound;
+}
+
+/* Compress INPUT_SIZE bytes at INPUT into OUTPUT, which has room for
+   OUTPUT_SIZE bytes, as a sequence of independent zstd frames of
+   BFD_COMPRESS_CHUNK_SIZE uncompressed bytes each.  This is still a
+   valid zstd stream, so any consumer can read it.  Return the
+   compressed size, or a zstd error code.  */
+
+static size_t
+compress_zstd_chunked (bfd_byte *output, size_t output_size,
+		       const bfd_byte *input, size_t input_size)
+{
+  ZSTD_CCtx *cctx = ZSTD_createCCtx ();
+  if (cctx == NULL)
+    return (size_t) -1;
+
+  size_t out_pos = 0;
+  for (size_t in_pos = 0; in_pos < input_size;
+       in_pos += BFD_COMPRESS_CHUNK_SIZE)
+    {
+      size_t chunk_size = input_size - in_pos;
+      if (chunk_size > BFD_COMPRESS_CHUNK_SIZE)
+	chunk_size = BFD_COMPRESS_CHUNK_SIZE;
+      size_t ret = ZSTD_compressCCtx (cctx, output + out_pos,
+				      output_size - out_pos,
+				      input + in_pos, chunk_size,
+				      ZSTD_CLEVEL_DEFAULT);
+      if (ZSTD_isError (ret))
+	{
+	  ZSTD_freeCCtx (cctx);
+	  return ret;
+	}
+      out_pos += ret;
+    }
+
+  ZSTD_freeCCtx (cctx);
+  return out_pos;
+}
+#endif
+
 /* Compress section contents using zlib/zstd and store
    as the contents field.  This function assumes the contents
    field was allocated using bfd_malloc() or equivalent.
@@ -631,7 +711,15 @@ bfd_compress_section_contents (bfd *abfd, sec_ptr sec)
     }
 
   if (!update)
-    compressed_size = compressBound (uncompressed_size) + new_header_size;
+    {
+      compressed_size = compressBound (uncompressed_size) + new_header_size;
+#ifdef HAVE_ZSTD
+      if ((abfd->flags & (BFD_COMPRESS_ZSTD | BFD_COMPRESS_CHUNKED))
+	  == (BFD_COMPRESS_ZSTD | BFD_COMPRESS_CHUNKED))
+	compressed_size = (compress_zstd_chunked_bound (uncompressed_size)
+			   + new_header_size);
+#endif
+    }
 
   buffer_size = compressed_size;
   buffer = bfd_alloc (abfd, buffer_size);
@@ -650,11 +738,17 @@ bfd_compress_section_contents (bfd *abfd, sec_ptr sec)
       if (abfd->flags & BFD_COMPRESS_ZSTD)
 	{
 #if HAVE_ZSTD
-	  compressed_size = ZSTD_compress (buffer + new_header_size,
-					   compressed_size,
-					   input_buffer,
-					   uncompressed_size,
-					   ZSTD_CLEVEL_DEFAULT);
+	  if (abfd->flags & BFD_COMPRESS_CHUNKED)
+	    compressed_size = compress_zstd_chunked (buffer + new_header_size,
+						     compressed_size,
+						     input_buffer,
+						     uncompressed_size);
+	  else
+	    compressed_size = ZSTD_compress (buffer + new_header_size,
+					     compressed_size,
+					     input_buffer,
+					     uncompressed_size,
+					     ZSTD_CLEVEL_DEFAULT);
 	  if (ZSTD_isError (compressed_size))
 	    {
 	      bfd_release (abfd, buffer);
@@ -714,15 +808,49 @@ DESCRIPTION
 	returns @code{TRUE} but @var{*ptr} is set to NULL.
 */
 
+/* Read the raw contents of SEC, which is being decompressed, into a
+   buffer allocated with bfd_malloc.  Return NULL on error.  */
+
+static bfd_byte *
+read_compressed_contents (bfd *abfd, sec_ptr sec)
+{
+  const unsigned int compress_status = sec->compress_status;
+  bfd_size_type save_size;
+  bfd_size_type save_rawsize;
+  bfd_byte *compressed_buffer;
+  bool ret;
+
+  compressed_buffer = (bfd_byte *) bfd_malloc (sec->compressed_size);
+  if (compressed_buffer == NULL)
+    return NULL;
+  save_rawsize = sec->rawsize;
+  save_size = sec->size;
+  /* Clear rawsize, set size to compressed size and set compress_status
+     to COMPRESS_SECTION_NONE.  If the compressed size is bigger than
+     the uncompressed size, bfd_get_section_contents will fail.  */
+  sec->rawsize = 0;
+  sec->size = sec->compressed_size;
+  sec->compress_status = COMPRESS_SECTION_NONE;
+  ret = bfd_get_section_contents (abfd, sec, compressed_buffer,
+				  0, sec->compressed_size);
+  /* Restore rawsize and size.  */
+  sec->rawsize = save_rawsize;
+  sec->size = save_size;
+  sec->compress_status = compress_status;
+  if (!ret)
+    {
+      free (compressed_buffer);
+      return NULL;
+    }
+  return compressed_buffer;
+}
+
 bool
 bfd_get_full_section_contents (bfd *abfd, sec_ptr sec, bfd_byte **ptr)
 {
   bfd_size_type readsz = bfd_get_section_limit_octets (abfd, sec);
   bfd_size_type allocsz = bfd_get_section_alloc_size (abfd, sec);
   bfd_byte *p = *ptr;
-  bool ret;
-  bfd_size_type save_size;
-  bfd_size_type save_rawsize;
   bfd_byte *compressed_buffer;
   unsigned int compression_header_size;
   const unsigned int compress_status = sec->compress_status;
@@ -776,25 +904,9 @@ bfd_get_full_section_contents (bfd *abfd, sec_ptr sec, bfd_byte **ptr)
     case DECOMPRESS_SECTION_ZLIB:
     case DECOMPRESS_SECTION_ZSTD:
       /* Read in the full compressed section contents.  */
-      compressed_buffer = (bfd_byte *) bfd_malloc (sec->compressed_size);
+      compressed_buffer = read_compressed_contents (abfd, sec);
       if (compressed_buffer == NULL)
 	return false;
-      save_rawsize = sec->rawsize;
-      save_size = sec->size;
-      /* Clear rawsize, set size to compressed size and set compress_status
-	 to COMPRESS_SECTION_NONE.  If the compressed size is bigger than
-	 the uncompressed size, bfd_get_section_contents will fail.  */
-      sec->rawsize = 0;
-      sec->size = sec->compressed_size;
-      sec->compress_status = COMPRESS_SECTION_NONE;
-      ret = bfd_get_section_contents (abfd, sec, compressed_buffer,
-				      0, sec->compressed_size);
-      /* Restore rawsize and size.  */
-      sec->rawsize = save_rawsize;
-      sec->size = save_size;
-      sec->compress_status = compress_status;
-      if (!ret)
-	goto fail_compressed;
 
       if (p == NULL)
 	p = (bfd_byte *) bfd_malloc (allocsz);
@@ -843,6 +955,210 @@ bfd_get_full_section_contents (bfd *abfd, sec_ptr sec, bfd_byte **ptr)
     }
 }
 
+#ifdef HAVE_ZSTD
+/* Return the number of frames in the zstd data at DATA, of size SIZE,
+   which decompresses to UNCOMPRESSED_SIZE bytes.  Return 1 if the
+   frames can't be decompressed separately, because one of them
+   doesn't record its decompressed size, or if the data is corrupt; in
+   this case, decompress_contents will deal with it as a whole.  */
+
+static unsigned int
+count_zstd_chunks (const bfd_byte *data, bfd_size_type size,
+		   bfd_size_type uncompressed_size)
+{
+  bfd_size_type in_pos = 0;
+  bfd_size_type out_pos = 0;
+  unsigned int count = 0;
+
+  while (in_pos < size)
+    {
+      size_t frame_size = ZSTD_findFrameCompressedSize (data + in_pos,
+							size - in_pos);
+      if (ZSTD_isError (frame_size))
+	return 1;
+
+      unsigned long long content_size
+	= ZSTD_getFrameContentSize (data + in_pos, frame_size);
+      if (content_size == ZSTD_CONTENTSIZE_UNKNOWN
+	  || content_size == ZSTD_CONTENTSIZE_ERROR
+	  || content_size > uncompressed_size - out_pos)
+	return 1;
+
+      in_pos += frame_size;
+      out_pos += content_size;
+      ++count;
+    }
+
+  if (count == 0 || out_pos != uncompressed_size)
+    return 1;
+  return count;
+}
+#endif
+
+/*
+FUNCTION
+	bfd_get_compressed_section_chunks
+
+SYNOPSIS
+	bool bfd_get_compressed_section_chunks
+	  (bfd *abfd, asection *section, bfd_byte **compressed,
+	   struct bfd_compressed_chunk **chunks, unsigned int *count);
+
+DESCRIPTION
+	Read the raw contents of @var{section}, which must be a
+	compressed section that BFD decompresses on reading, into a
+	buffer malloc'd by this function and returned in
+	@var{*compressed}.  Then split them into pieces that can be
+	decompressed independently with bfd_decompress_section_chunk,
+	for instance by several threads, or to materialize only part of
+	the section.  The pieces are returned in a malloc'd array in
+	@var{*chunks}, and their number in @var{*count}.  They cover the
+	whole section, in order.
+
+	A section compressed with zstd is split at the boundaries of
+	its frames, so a section written with BFD_COMPRESS_CHUNKED
+	gives one piece per frame.  Any other compressed section is a
+	single piece.
+
+	Return @code{FALSE}, without reading the section, if its
+	uncompressed size is not plausible for the size of the file.
+	Return @code{TRUE} on success.
+*/
+
+bool
+bfd_get_compressed_section_chunks (bfd *abfd, sec_ptr sec,
+				   bfd_byte **compressed,
+				   struct bfd_compressed_chunk **chunks,
+				   unsigned int *count)
+{
+  const unsigned int compress_status = sec->compress_status;
+  unsigned int compression_header_size;
+  struct bfd_compressed_chunk *result;
+  bfd_byte *buffer;
+
+  if (compress_status != DECOMPRESS_SECTION_ZLIB
+      && compress_status != DECOMPRESS_SECTION_ZSTD)
+    {
+      bfd_set_error (bfd_error_invalid_operation);
+      return false;
+    }
+
+  compression_header_size = bfd_get_compression_header_size (abfd, sec);
+  if (compression_header_size == 0)
+    compression_header_size = 12;
+  if (sec->compressed_size < compression_header_size)
+    {
+      bfd_set_error (bfd_error_bad_value);
+      return false;
+    }
+
+  /* PR 24708: The caller allocates the uncompressed size given by the
+     compression header, so check it as bfd_get_full_section_contents
+     does.  */
+  if (_bfd_section_size_insane (abfd, sec))
+    {
+      bfd_set_error (bfd_error_bad_value);
+      return false;
+    }
+
+  buffer = read_compressed_contents (abfd, sec);
+  if (buffer == NULL)
+    return false;
+
+  /* Count the pieces.  A zstd section is a sequence of frames; a zlib
+     section may also be a sequence of streams, but their boundaries
+     can't be found without decompressing them.  */
+  unsigned int n_chunks = 1;
+#ifdef HAVE_ZSTD
+  if (compress_status == DECOMPRESS_SECTION_ZSTD)
+    n_chunks = count_zstd_chunks (buffer + compression_header_size,
+				  sec->compressed_size - compression_header_size,
+				  sec->size);
+#endif
+
+  result = (struct bfd_compressed_chunk *)
+    bfd_malloc (n_chunks * sizeof (*result));
+  if (result == NULL)
+    {
+      free (buffer);
+      return false;
+    }
+
+  if (n_chunks == 1)
+    {
+      result[0].compressed_offset = compression_header_size;
+      result[0].compressed_size
+	= sec->compressed_size - compression_header_size;
+      result[0].uncompressed_offset = 0;
+      result[0].uncompressed_size = sec->size;
+    }
+#ifdef HAVE_ZSTD
+  else
+    {
+      bfd_size_type in_pos = compression_header_size;
+      bfd_size_type out_pos = 0;
+
+      for (unsigned int i = 0; i < n_chunks; ++i)
+	{
+	  size_t frame_size
+	    = ZSTD_findFrameCompressedSize (buffer + in_pos,
+					    sec->compressed_size - in_pos);
+
+	  result[i].compressed_offset = in_pos;
+	  result[i].compressed_size = frame_size;
+	  result[i].uncompressed_offset = out_pos;
+	  result[i].uncompressed_size
+	    = ZSTD_getFrameContentSize (buffer + in_pos, frame_size);
+	  in_pos += frame_size;
+	  out_pos += result[i].uncompressed_size;
+	}
+    }
+#endif
+
+  *compressed = buffer;
+  *chunks = result;
+  *count = n_chunks;
+  return true;
+}
+
+/*
+FUNCTION
+	bfd_decompress_section_chunk
+
+SYNOPSIS
+	bool bfd_decompress_section_chunk
+	  (asection *section, const bfd_byte *compressed,
+	   const struct bfd_compressed_chunk *chunk, bfd_byte *buffer);
+
+DESCRIPTION
+	Decompress @var{chunk}, one of the pieces of @var{section}
+	returned by bfd_get_compressed_section_chunks along with
+	@var{compressed}, into @var{buffer}, which must have room for
+	its uncompressed size.  This does not access the BFD, so
+	several pieces of a section may be decompressed at the same
+	time by different threads.
+
+	Return @code{FALSE} if the data is corrupt.
+*/
+
+bool
+bfd_decompress_section_chunk (sec_ptr sec, const bfd_byte *compressed,
+			      const struct bfd_compressed_chunk *chunk,
+			      bfd_byte *buffer)
+{
+  bool is_zstd = sec->compress_status == DECOMPRESS_SECTION_ZSTD;
+
+  if (!decompress_contents (is_zstd,
+			    (bfd_byte *) compressed + chunk->compressed_offset,
+			    chunk->compressed_size, buffer,
+			    chunk->uncompressed_size))
+    {
+      bfd_set_error (bfd_error_bad_value);
+      return false;
+    }
+  return true;
+}
+
 /*
 FUNCTION
 	bfd_is_section_compressed_info
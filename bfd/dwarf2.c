@@ -336,6 +336,19 @@ struct dwarf2_debug
 #define STASH_INFO_HASH_ON	   1
 #define STASH_INFO_HASH_DISABLED   2
 
+  /* Flat index of the line tables of all compilation units, sorted
+     by address.  Only built if the BFD has BFD_DWARF2_LINE_INDEX set.  */
+  struct line_index_entry *line_index;
+
+  /* Number of entries in LINE_INDEX.  */
+  size_t line_index_count;
+
+  /* Status of the line index.  */
+  int line_index_status;
+#define STASH_LINE_INDEX_OFF	   0
+#define STASH_LINE_INDEX_ON	   1
+#define STASH_LINE_INDEX_DISABLED  2
+
   /* True if we opened bfd_ptr.  */
   bool close_on_cleanup;
 };
@@ -1856,6 +1869,23 @@ struct lookup_funcinfo
   unsigned int idx;
 };
 
+/* An entry in the flat line index of a stash.  Each entry describes
+   one row of a line table, covering the addresses from LOW_PC up to
+   but not including HIGH_PC.  */
+
+struct line_index_entry
+{
+  bfd_vma low_pc;
+  bfd_vma high_pc;
+  /* The compilation unit whose line table holds this row.  */
+  struct comp_unit *unit;
+  char *filename;
+  unsigned int line;
+  unsigned int discriminator;
+  /* Index of this entry, used to ensure qsort is stable.  */
+  unsigned int idx;
+};
+
 struct varinfo
 {
   /* Pointer to previous variable in list of all variables.  */
@@ -5632,6 +5662,183 @@ stash_comp_unit (struct dwarf2_debug *stash, struct dwarf2_debug_file *file)
   return NULL;
 }
 
+static int
+compare_line_index_entries (const void *a, const void *b)
+{
+  const struct line_index_entry *entry1 = a;
+  const struct line_index_entry *entry2 = b;
+
+  if (entry1->low_pc < entry2->low_pc)
+    return -1;
+  if (entry1->low_pc > entry2->low_pc)
+    return 1;
+
+  if (entry1->idx < entry2->idx)
+    return -1;
+  if (entry1->idx > entry2->idx)
+    return 1;
+  return 0;
+}
+
+/* Build the flat line index of STASH.  This reads every remaining
+   compilation unit and decodes all of their line tables up front,
+   which costs more than the lazy per-unit decoding but makes each
+   subsequent lookup a single binary search over one array.  */
+
+static void
+stash_build_line_index (struct dwarf2_debug *stash)
+{
+  struct line_index_entry *line_index;
+  struct comp_unit *each;
+  size_t count, i, j;
+
+  BFD_ASSERT (stash->line_index_status == STASH_LINE_INDEX_OFF);
+
+  /* Don't try again if anything below fails.  */
+  stash->line_index_status = STASH_LINE_INDEX_DISABLED;
+
+  while (stash_comp_unit (stash, &stash->f) != NULL)
+    ;
+
+  count = 0;
+  for (each = stash->f.all_comp_units; each; each = each->next_unit)
+    {
+      struct line_info_table *table;
+      unsigned int k;
+
+      if (!comp_unit_maybe_decode_line_info (each))
+	continue;
+
+      table = each->line_table;
+      for (k = 0; k < table->num_sequences; k++)
+	{
+	  if (!build_line_info_table (table, &table->sequences[k]))
+	    return;
+	  count += table->sequences[k].num_lines;
+	}
+    }
+
+  if (count == 0 || count > (unsigned int) -1)
+    return;
+
+  line_index = (struct line_index_entry *)
+    bfd_malloc (count * sizeof (struct line_index_entry));
+  if (line_index == NULL)
+    return;
+
+  /* Make one entry for each row covering a non-empty range.  Rows at
+     the same address as their successor are superseded by it, just as
+     in lookup_address_in_line_info_table.  */
+  count = 0;
+  for (each = stash->f.all_comp_units; each; each = each->next_unit)
+    {
+      struct line_info_table *table = each->line_table;
+      unsigned int k;
+
+      if (each->error || table == NULL)
+	continue;
+
+      for (k = 0; k < table->num_sequences; k++)
+	{
+	  struct line_sequence *seq = &table->sequences[k];
+	  bfd_size_type n;
+
+	  for (n = 0; n + 1 < seq->num_lines; n++)
+	    {
+	      struct line_info *info = seq->line_info_lookup[n];
+	      bfd_vma next = seq->line_info_lookup[n + 1]->address;
+	      struct line_index_entry *entry;
+
+	      if (info->end_sequence || next <= info->address)
+		continue;
+
+	      entry = &line_index[count];
+	      entry->low_pc = info->address;
+	      entry->high_pc = next;
+	      entry->unit = each;
+	      entry->filename = info->filename;
+	      entry->line = info->line;
+	      entry->discriminator = info->discriminator;
+	      entry->idx = count++;
+	    }
+	}
+    }
+
+  if (count == 0)
+    {
+      free (line_index);
+      return;
+    }
+
+  qsort (line_index, count, sizeof (struct line_index_entry),
+	 compare_line_index_entries);
+
+  /* Make the entries disjoint.  Of several rows starting at the same
+     address keep the first, and clip every row at the start of the
+     next one.  An address which falls in the clipped part of a row is
+     then not found here, and is left to the per-unit search.  */
+  j = 0;
+  for (i = 1; i < count; i++)
+    {
+      if (line_index[i].low_pc == line_index[j].low_pc)
+	continue;
+      if (line_index[j].high_pc > line_index[i].low_pc)
+	line_index[j].high_pc = line_index[i].low_pc;
+      line_index[++j] = line_index[i];
+    }
+
+  stash->line_index = line_index;
+  stash->line_index_count = j + 1;
+  stash->line_index_status = STASH_LINE_INDEX_ON;
+}
+
+/* Find ADDR in the flat line index of STASH.  If it is there, set the
+   output parameters as comp_unit_find_nearest_line would and return
+   TRUE, otherwise return FALSE.  */
+
+static bool
+stash_find_nearest_line_fast (struct dwarf2_debug *stash,
+			      bfd_vma addr,
+			      const char **filename_ptr,
+			      struct funcinfo **function_ptr,
+			      unsigned int *linenumber_ptr,
+			      unsigned int *discriminator_ptr)
+{
+  const struct line_index_entry *entry;
+  size_t low, high, mid;
+
+  BFD_ASSERT (stash->line_index_status == STASH_LINE_INDEX_ON);
+
+  /* Find the last entry starting at or below ADDR.  */
+  low = 0;
+  high = stash->line_index_count;
+  while (low < high)
+    {
+      mid = low + (high - low) / 2;
+      if (addr < stash->line_index[mid].low_pc)
+	high = mid;
+      else
+	low = mid + 1;
+    }
+
+  if (low == 0)
+    return false;
+  entry = &stash->line_index[low - 1];
+  if (addr >= entry->high_pc)
+    return false;
+
+  *function_ptr = NULL;
+  if (lookup_address_in_function_table (entry->unit, addr, function_ptr)
+      && (*function_ptr)->tag == DW_TAG_inlined_subroutine)
+    stash->inliner_chain = *function_ptr;
+
+  *filename_ptr = entry->filename;
+  *linenumber_ptr = entry->line;
+  if (discriminator_ptr)
+    *discriminator_ptr = entry->discriminator;
+  return true;
+}
+
 /* Hash function for an asymbol.  */
 
 static hashval_t
@@ -5907,6 +6114,19 @@ _bfd_dwarf2_find_nearest_line_with_alt
       unsigned int bits = VMA_BITS - 8;
       struct comp_unit **prev_each;
 
+      if (stash->line_index_status == STASH_LINE_INDEX_OFF
+	  && (abfd->flags & BFD_DWARF2_LINE_INDEX) != 0)
+	stash_build_line_index (stash);
+
+      if (stash->line_index_status == STASH_LINE_INDEX_ON)
+	{
+	  found = stash_find_nearest_line_fast (stash, addr, filename_ptr,
+						&function, linenumber_ptr,
+						discriminator_ptr);
+	  if (found)
+	    goto done;
+	}
+
       /* Traverse interior nodes until we get to a leaf.  */
       while (trie && trie->num_room_in_leaf == 0)
 	{
@@ -6076,6 +6296,7 @@ _bfd_dwarf2_cleanup_debug_info (bfd *abfd, void **pinfo)
     bfd_hash_table_free (&stash->varinfo_hash_table->base);
   if (stash->funcinfo_hash_table)
     bfd_hash_table_free (&stash->funcinfo_hash_table->base);
+  free (stash->line_index);
 
   file = &stash->f;
   while (1)
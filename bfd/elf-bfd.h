@@ -2758,6 +2758,8 @@ extern bfd_reloc_status_type _bfd_elf_rel_vtable_reloc_fn
   (bfd *, arelent *, struct bfd_symbol *, void *,
    asection *, bfd *, char **);
 
+extern bool bfd_elf_link_preload_input
+  (bfd *, struct bfd_link_info *);
 extern bool bfd_elf_final_link
   (bfd *, struct bfd_link_info *);
 
@@ -1212,7 +1212,9 @@ _bfd_elf_make_section_from_shdr (bfd *abfd,
 	      if ((abfd->flags & BFD_COMPRESS_GABI) != 0)
 		new_ch_type = ((abfd->flags & BFD_COMPRESS_ZSTD) != 0
 			       ? ch_compress_zstd : ch_compress_zlib);
-	      if (new_ch_type != ch_type)
+	      /* Recompress zstd sections to split them into chunks.  */
+	      if (new_ch_type != ch_type
+		  || (abfd->flags & BFD_COMPRESS_CHUNKED) != 0)
 		action = compress;
 	    }
 	}
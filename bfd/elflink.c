@@ -5972,6 +5972,300 @@ _bfd_elf_archive_symbol_lookup (bfd *abfd,
   return h;
 }
 
+/* Flags kept for each armap entry by elf_link_add_archive_symbols.  */
+
+/* The entry needs no further look: its member has been included, or its
+   symbol is defined.  */
+#define ELF_ARMAP_INCLUDED 1
+/* The entry is queued to be looked at in the current pass.  */
+#define ELF_ARMAP_QUEUED 2
+/* The entry is queued to be looked at in the next pass.  */
+#define ELF_ARMAP_NEXT 4
+
+/* An entry of the index of an armap.  NAME is the name of armap entry
+   INDX, or for a default version name, one of the other names
+   _bfd_elf_archive_symbol_lookup may look up for it.  HASH is the hash
+   of NAME.  */
+
+struct elf_armap_index_entry
+{
+  unsigned long hash;
+  symindex indx;
+  const char *name;
+};
+
+/* The index of the armap of an archive, sorted by hash and then by
+   armap index.  It is built the first time the archive is searched, and
+   lets elf_link_add_archive_symbols find the armap entries that may
+   define a newly undefined symbol without going through the whole
+   armap.  */
+
+struct elf_armap_index
+{
+  size_t count;
+  struct elf_armap_index_entry *entries;
+};
+
+/* The armap entries elf_link_add_archive_symbols has yet to look at.  */
+
+struct elf_armap_queue
+{
+  /* Entries to look at in the current pass, as a min-heap.  */
+  symindex *heap;
+  size_t nheap;
+
+  /* Entries to look at in the next pass.  */
+  symindex *next;
+  size_t nnext;
+};
+
+/* qsort comparison function for elf_armap_index_entry.  */
+
+static int
+elf_armap_index_compare (const void *a, const void *b)
+{
+  const struct elf_armap_index_entry *ea = a;
+  const struct elf_armap_index_entry *eb = b;
+
+  if (ea->hash != eb->hash)
+    return ea->hash < eb->hash ? -1 : 1;
+  if (ea->indx != eb->indx)
+    return ea->indx < eb->indx ? -1 : 1;
+  return 0;
+}
+
+/* Return the index of the armap of archive ABFD, building it if need be.
+   Return NULL if the archive must be searched by going through the
+   whole armap instead, because its members' armap entries are not
+   grouped together in file order, or on error.  */
+
+static struct elf_armap_index *
+elf_link_armap_index (bfd *abfd)
+{
+  struct elf_armap_index *index;
+  carsym *symdefs = bfd_ardata (abfd)->symdefs;
+  symindex c = bfd_ardata (abfd)->symdef_count;
+  symindex i;
+  size_t count;
+  struct elf_armap_index_entry *ent;
+
+  index = (struct elf_armap_index *) bfd_ardata (abfd)->symdef_index;
+  if (index != NULL)
+    return index;
+
+  /* Including a member marks all of its armap entries, which is only
+     the same as going through the armap in order if they are next to
+     each other.  */
+  count = c;
+  for (i = 0; i < c; i++)
+    {
+      const char *p;
+
+      if (i > 0 && symdefs[i].file_offset < symdefs[i - 1].file_offset)
+	return NULL;
+      p = strchr (symdefs[i].name, ELF_VER_CHR);
+      if (p != NULL && p[1] == ELF_VER_CHR)
+	count += 2;
+    }
+
+  index = (struct elf_armap_index *) bfd_alloc (abfd, sizeof (*index));
+  if (index == NULL)
+    return NULL;
+  index->entries = ((struct elf_armap_index_entry *)
+		    bfd_alloc (abfd, count * sizeof (*index->entries)));
+  if (index->entries == NULL)
+    return NULL;
+
+  ent = index->entries;
+  for (i = 0; i < c; i++)
+    {
+      const char *name = symdefs[i].name;
+      const char *p;
+
+      ent->name = name;
+      ent->indx = i;
+      ent->hash = bfd_elf_gnu_hash (name);
+      ent++;
+
+      /* A default version armap entry also matches references to the
+	 symbol with one `@' and without a version.  */
+      p = strchr (name, ELF_VER_CHR);
+      if (p != NULL && p[1] == ELF_VER_CHR)
+	{
+	  size_t len = strlen (name);
+	  size_t first = p - name + 1;
+	  char *copy = (char *) bfd_alloc (abfd, len + first);
+
+	  if (copy == NULL)
+	    return NULL;
+	  memcpy (copy, name, first);
+	  memcpy (copy + first, name + first + 1, len - first);
+	  ent->name = copy;
+	  ent->indx = i;
+	  ent->hash = bfd_elf_gnu_hash (copy);
+	  ent++;
+
+	  copy += len;
+	  memcpy (copy, name, first - 1);
+	  copy[first - 1] = '\0';
+	  ent->name = copy;
+	  ent->indx = i;
+	  ent->hash = bfd_elf_gnu_hash (copy);
+	  ent++;
+	}
+    }
+
+  qsort (index->entries, count, sizeof (*index->entries),
+	 elf_armap_index_compare);
+  index->count = count;
+  bfd_ardata (abfd)->symdef_index = index;
+  return index;
+}
+
+/* Add armap entry INDX to the heap of QUEUE.  */
+
+static void
+elf_armap_heap_push (struct elf_armap_queue *queue, symindex indx)
+{
+  size_t n = queue->nheap++;
+
+  while (n > 0 && queue->heap[(n - 1) / 2] > indx)
+    {
+      queue->heap[n] = queue->heap[(n - 1) / 2];
+      n = (n - 1) / 2;
+    }
+  queue->heap[n] = indx;
+}
+
+/* Remove the lowest armap entry from the heap of QUEUE and return it.  */
+
+static symindex
+elf_armap_heap_pop (struct elf_armap_queue *queue)
+{
+  symindex top = queue->heap[0];
+  symindex last = queue->heap[--queue->nheap];
+  size_t n = 0;
+
+  for (;;)
+    {
+      size_t child = 2 * n + 1;
+
+      if (child >= queue->nheap)
+	break;
+      if (child + 1 < queue->nheap
+	  && queue->heap[child + 1] < queue->heap[child])
+	child++;
+      if (queue->heap[child] >= last)
+	break;
+      queue->heap[n] = queue->heap[child];
+      n = child;
+    }
+  if (queue->nheap > 0)
+    queue->heap[n] = last;
+  return top;
+}
+
+/* Queue the armap entries of INDEX whose lookup may now find symbol
+   NAME, which has just been referenced or defined by the member of
+   armap entry CUR.  Those after CUR are still looked at in the current
+   pass, the others in the next one.  If FULL, the current pass goes
+   through the whole armap and will get to those after CUR anyway.
+   INCLUDED holds the flags of the armap entries.  */
+
+static void
+elf_armap_queue_name (struct elf_armap_index *index, const char *name,
+		      symindex cur, bool full, unsigned char *included,
+		      struct elf_armap_queue *queue)
+{
+  unsigned long hash = bfd_elf_gnu_hash (name);
+  size_t lo = 0, hi = index->count;
+
+  while (lo < hi)
+    {
+      size_t mid = lo + (hi - lo) / 2;
+
+      if (index->entries[mid].hash < hash)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  for (; lo < index->count && index->entries[lo].hash == hash; lo++)
+    {
+      symindex j = index->entries[lo].indx;
+
+      if ((included[j] & ELF_ARMAP_INCLUDED) != 0
+	  || strcmp (index->entries[lo].name, name) != 0)
+	continue;
+      if (j > cur)
+	{
+	  if (!full && (included[j] & ELF_ARMAP_QUEUED) == 0)
+	    {
+	      included[j] |= ELF_ARMAP_QUEUED;
+	      elf_armap_heap_push (queue, j);
+	    }
+	}
+      else if ((included[j] & ELF_ARMAP_NEXT) == 0)
+	{
+	  included[j] |= ELF_ARMAP_NEXT;
+	  queue->next[queue->nnext++] = j;
+	}
+    }
+}
+
+/* Queue the armap entries of INDEX whose lookup may find one of the
+   symbols of ELEMENT, which has just been included for armap entry
+   CUR.  FULL, INCLUDED and QUEUE are as for elf_armap_queue_name.
+   Return false if the symbols of ELEMENT can't be found that way.  */
+
+static bool
+elf_armap_queue_element (struct elf_armap_index *index, bfd *element,
+			 symindex cur, bool full, unsigned char *included,
+			 struct elf_armap_queue *queue)
+{
+  const struct elf_backend_data *bed;
+  Elf_Internal_Shdr *hdr;
+  struct elf_link_hash_entry **sym_hashes;
+  size_t extsymcount, k;
+
+  if (bfd_get_flavour (element) != bfd_target_elf_flavour
+      || (element->flags & (DYNAMIC | BFD_PLUGIN)) != 0)
+    return false;
+
+  bed = get_elf_backend_data (element);
+  hdr = &elf_tdata (element)->symtab_hdr;
+  extsymcount = hdr->sh_size / bed->s->sizeof_sym;
+  if (!elf_bad_symtab (element))
+    extsymcount -= hdr->sh_info;
+  if (extsymcount == 0)
+    return true;
+
+  sym_hashes = elf_sym_hashes (element);
+  if (sym_hashes == NULL)
+    return false;
+
+  for (k = 0; k < extsymcount; k++)
+    {
+      struct elf_link_hash_entry *h = sym_hashes[k];
+
+      if (h == NULL)
+	continue;
+      elf_armap_queue_name (index, h->root.root.string, cur, full,
+			    included, queue);
+      if (h->root.type == bfd_link_hash_indirect
+	  || h->root.type == bfd_link_hash_warning)
+	{
+	  while (h->root.type == bfd_link_hash_indirect
+		 || h->root.type == bfd_link_hash_warning)
+	    h = (struct elf_link_hash_entry *) h->root.u.i.link;
+	  elf_armap_queue_name (index, h->root.root.string, cur, full,
+				included, queue);
+	}
+    }
+
+  return true;
+}
+
 /* Add symbols from an ELF archive file to the linker hash table.  We
    don't use _bfd_generic_link_add_archive_symbols because we need to
    handle versioned symbols.
@@ -5983,7 +6277,13 @@ _bfd_elf_archive_symbol_lookup (bfd *abfd,
    object file.
 
    Unfortunately, we do have to make multiple passes over the symbol
-   table until nothing further is resolved.  */
+   table until nothing further is resolved.  Only the first pass goes
+   through the whole armap, though.  After it, looking up the symbol of
+   an armap entry can only give a different answer if the symbol has
+   since been referenced or defined by an included member.  An index of
+   the armap gives those entries, which the later passes look at in
+   armap order, so that the same members are included as by going
+   through the whole armap each time.  */
 
 static bool
 elf_link_add_archive_symbols (bfd *abfd, struct bfd_link_info *info)
@@ -5992,10 +6292,13 @@ elf_link_add_archive_symbols (bfd *abfd, struct bfd_link_info *info)
   unsigned char *included = NULL;
   carsym *symdefs;
   bool loop;
+  bool first_pass;
   size_t amt;
   const struct elf_backend_data *bed;
   struct bfd_link_hash_entry * (*archive_symbol_lookup)
     (bfd *, struct bfd_link_info *, const char *);
+  struct elf_armap_index *index;
+  struct elf_armap_queue queue;
 
   if (! bfd_has_map (abfd))
     {
@@ -6021,34 +6324,86 @@ elf_link_add_archive_symbols (bfd *abfd, struct bfd_link_info *info)
   bed = get_elf_backend_data (abfd);
   archive_symbol_lookup = bed->elf_backend_archive_symbol_lookup;
 
+  /* The index only knows which names _bfd_elf_archive_symbol_lookup
+     matches armap entries with.  */
+  index = NULL;
+  memset (&queue, 0, sizeof (queue));
+  if (archive_symbol_lookup == _bfd_elf_archive_symbol_lookup)
+    index = elf_link_armap_index (abfd);
+  if (index != NULL)
+    {
+      amt = c * sizeof (*queue.heap);
+      queue.heap = (symindex *) bfd_malloc (amt);
+      queue.next = (symindex *) bfd_malloc (amt);
+      if (queue.heap == NULL || queue.next == NULL)
+	goto error_return;
+    }
+
+  first_pass = true;
   do
     {
       file_ptr last;
       symindex i;
+      symindex next_i;
       carsym *symdef;
-      carsym *symdefend;
+      bool scan;
 
       loop = false;
       last = -1;
+      info->hash->archive_passes++;
 
-      symdef = symdefs;
-      symdefend = symdef + c;
-      for (i = 0; symdef < symdefend; symdef++, i++)
+      /* Whether this pass goes through the whole armap.  */
+      scan = first_pass || index == NULL;
+      if (!scan)
+	{
+	  /* Only look at the armap entries queued for this pass.  */
+	  for (i = 0; i < queue.nnext; i++)
+	    {
+	      symindex j = queue.next[i];
+
+	      included[j] &= ~ELF_ARMAP_NEXT;
+	      if ((included[j] & (ELF_ARMAP_INCLUDED | ELF_ARMAP_QUEUED)) == 0)
+		{
+		  included[j] |= ELF_ARMAP_QUEUED;
+		  elf_armap_heap_push (&queue, j);
+		}
+	    }
+	  queue.nnext = 0;
+	}
+
+      next_i = 0;
+      for (;;)
 	{
 	  struct bfd_link_hash_entry *h;
 	  bfd *element;
 	  struct bfd_link_hash_entry *undefs_tail;
 	  symindex mark;
 
-	  if (included[i])
+	  if (scan)
+	    {
+	      if (next_i == c)
+		break;
+	      i = next_i++;
+	    }
+	  else
+	    {
+	      if (queue.nheap == 0)
+		break;
+	      i = elf_armap_heap_pop (&queue);
+	      included[i] &= ~ELF_ARMAP_QUEUED;
+	    }
+	  symdef = symdefs + i;
+
+	  if (included[i] & ELF_ARMAP_INCLUDED)
 	    continue;
 	  if (symdef->file_offset == last)
 	    {
-	      included[i] = true;
+	      included[i] |= ELF_ARMAP_INCLUDED;
 	      continue;
 	    }
 
 	  h = archive_symbol_lookup (abfd, info, symdef->name);
+	  info->hash->archive_lookups++;
 	  if (h == (struct bfd_link_hash_entry *) -1)
 	    goto error_return;
 
@@ -6085,7 +6440,7 @@ elf_link_add_archive_symbols (bfd *abfd, struct bfd_link_info *info)
 	    {
 	      if (h->type != bfd_link_hash_undefweak)
 		/* Symbol must be defined.  Don't check it again.  */
-		included[i] = true;
+		included[i] |= ELF_ARMAP_INCLUDED;
 	      continue;
 	    }
 
@@ -6121,7 +6476,7 @@ elf_link_add_archive_symbols (bfd *abfd, struct bfd_link_info *info)
 	  mark = i;
 	  do
 	    {
-	      included[mark] = true;
+	      included[mark] |= ELF_ARMAP_INCLUDED;
 	      if (mark == 0)
 		break;
 	      --mark;
@@ -6131,14 +6486,45 @@ elf_link_add_archive_symbols (bfd *abfd, struct bfd_link_info *info)
 	  /* We mark subsequent symbols from this object file as we go
 	     on through the loop.  */
 	  last = symdef->file_offset;
+
+	  if (index != NULL)
+	    {
+	      /* Without going through the whole armap, the subsequent
+		 symbols must be marked now.  */
+	      for (mark = i + 1;
+		   mark < c && symdefs[mark].file_offset == last;
+		   mark++)
+		included[mark] |= ELF_ARMAP_INCLUDED;
+
+	      if (!elf_armap_queue_element (index, element, i, scan,
+					    included, &queue))
+		{
+		  /* Go through the rest of this pass and the following
+		     ones in full.  */
+		  while (queue.nheap != 0)
+		    included[elf_armap_heap_pop (&queue)] &= ~ELF_ARMAP_QUEUED;
+		  for (mark = 0; mark < queue.nnext; mark++)
+		    included[queue.next[mark]] &= ~ELF_ARMAP_NEXT;
+		  queue.nnext = 0;
+		  index = NULL;
+		  scan = true;
+		  next_i = i + 1;
+		}
+	    }
 	}
+
+      first_pass = false;
     }
   while (loop);
 
+  free (queue.heap);
+  free (queue.next);
   free (included);
   return true;
 
  error_return:
+  free (queue.heap);
+  free (queue.next);
   free (included);
   return false;
 }
@@ -12303,6 +12689,87 @@ elf_final_link_free (bfd *obfd, struct elf_final_link_info *flinfo)
     }
 }
 
+/* Read the local symbols, relocs and section contents of input file
+   IBFD which elf_link_input_bfd will use, and cache them where it
+   looks for them.  This reads IBFD only and changes nothing shared
+   with other input files, so the linker may call it for different
+   input files from different threads before bfd_elf_final_link, as
+   long as all the members of an archive are read by the same thread.
+   Returns false if something could not be read, which leaves it to
+   be read and reported by the final link.  */
+
+bool
+bfd_elf_link_preload_input (bfd *ibfd, struct bfd_link_info *info)
+{
+  const struct elf_backend_data *bed;
+  Elf_Internal_Shdr *symtab_hdr;
+  size_t locsymcount;
+  asection *o;
+
+  if (bfd_get_flavour (ibfd) != bfd_target_elf_flavour
+      || (ibfd->flags & DYNAMIC) != 0)
+    return true;
+
+  bed = get_elf_backend_data (info->output_bfd);
+  if (elf_elfheader (ibfd)->e_ident[EI_CLASS] != bed->s->elfclass)
+    return true;
+
+  symtab_hdr = &elf_tdata (ibfd)->symtab_hdr;
+  if (elf_bad_symtab (ibfd))
+    locsymcount = symtab_hdr->sh_size / bed->s->sizeof_sym;
+  else
+    locsymcount = symtab_hdr->sh_info;
+
+  if (symtab_hdr->contents == NULL && locsymcount != 0)
+    {
+      Elf_Internal_Sym *isymbuf;
+
+      isymbuf = bfd_elf_get_elf_syms (ibfd, symtab_hdr, locsymcount, 0,
+				      NULL, NULL, NULL);
+      if (isymbuf == NULL)
+	return false;
+      symtab_hdr->contents = (unsigned char *) isymbuf;
+    }
+
+  for (o = ibfd->sections; o != NULL; o = o->next)
+    {
+      struct bfd_elf_section_data *esdo = elf_section_data (o);
+
+      /* Only sections which are going into the output, and which
+	 elf_link_input_bfd reads in the ordinary way.  Leave sections
+	 that relaxation or other editing has resized to it.  */
+      if (o->output_section == NULL
+	  || o->output_section->owner != info->output_bfd
+	  || (o->flags & (SEC_EXCLUDE | SEC_LINKER_CREATED
+			  | SEC_IN_MEMORY)) != 0
+	  || (o->flags & SEC_HAS_CONTENTS) == 0
+	  || o->sec_info_type != SEC_INFO_TYPE_NONE
+	  || (o->rawsize != 0 && o->rawsize != o->size))
+	continue;
+
+      if (o->size != 0 && esdo->this_hdr.contents == NULL)
+	{
+	  bfd_byte *contents;
+
+	  contents = bfd_alloc (ibfd, bfd_get_section_alloc_size (ibfd, o));
+	  if (contents == NULL
+	      || !bfd_get_full_section_contents (ibfd, o, &contents))
+	    return false;
+	  esdo->this_hdr.contents = contents;
+	}
+
+      /* Pass a NULL INFO so as not to update its cache_size, which is
+	 shared by all input files.  */
+      if ((o->flags & SEC_RELOC) != 0
+	  && o->reloc_count != 0
+	  && _bfd_elf_link_info_read_relocs (ibfd, NULL, o, NULL, NULL,
+					     true) == NULL)
+	return false;
+    }
+
+  return true;
+}
+
 /* Do the final step of an ELF link.  */
 
 bool
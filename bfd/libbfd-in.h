@@ -85,6 +85,7 @@ struct artdata
   file_ptr armap_datepos;	/* Position within archive to seek to
 				   rewrite the date field.  */
   void *tdata;			/* Backend specific information.  */
+  void *symdef_index;		/* Linker index of the symdefs.  */
 };
 
 #define bfd_ardata(bfd) ((bfd)->tdata.aout_ar_data)
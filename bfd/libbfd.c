@@ -1073,8 +1073,7 @@ _bfd_generic_get_section_contents (bfd *abfd,
       return false;
     }
 
-  if (bfd_seek (abfd, section->filepos + offset, SEEK_SET) != 0
-      || bfd_read (location, count, abfd) != count)
+  if (bfd_pread (location, count, section->filepos + offset, abfd) != count)
     return false;
 
   return true;
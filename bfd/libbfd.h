@@ -91,6 +91,7 @@ struct artdata
   file_ptr armap_datepos;	/* Position within archive to seek to
 				   rewrite the date field.  */
   void *tdata;			/* Backend specific information.  */
+  void *symdef_index;		/* Linker index of the symdefs.  */
 };
 
 #define bfd_ardata(bfd) ((bfd)->tdata.aout_ar_data)
@@ -971,6 +972,12 @@ struct bfd_iovec
   void *(*bmmap) (struct bfd *abfd, void *addr, bfd_size_type len,
 		  int prot, int flags, file_ptr offset,
 		  void **map_addr, bfd_size_type *map_len);
+  /* Like bread, but read at OFFSET, without using or changing the
+     IOSTREAM's file offset.  This may be called by several threads at
+     once.  May be NULL, in which case bfd_pread falls back to bseek
+     and bread.  */
+  file_ptr (*bpread) (struct bfd *abfd, void *ptr, file_ptr nbytes,
+		     file_ptr offset);
 };
 extern const struct bfd_iovec _bfd_memory_iovec;
 
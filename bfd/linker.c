@@ -470,6 +470,8 @@ _bfd_link_hash_table_init
   table->undefs = NULL;
   table->undefs_tail = NULL;
   table->type = bfd_link_generic_hash_table;
+  table->archive_passes = 0;
+  table->archive_lookups = 0;
 
   ret = bfd_hash_table_init (&table->table, newfunc, entsize);
   if (ret)
@@ -45,7 +45,19 @@
    we could binary search it, but that's not cache-friendly and it's faster
    to add another lookup structure that gets us very near the correct
    entry in just one step (that's what ofstolowbound is for) and do a linear
-   search from there.  */
+   search from there.
+
+   When the linker provides a parallel_for callback, large sets are
+   recorded in batches of input sections instead: the contents of a batch
+   are read in, the blobs of each section are found and hashed on a thread
+   of their own, and then the blobs are inserted into one of several
+   shard tables, chosen by the top bits of their hash, again a thread per
+   shard.  Equal blobs always land in the same shard, and each shard sees
+   its blobs in input order, so the shards together end up holding just
+   the entries the single table would, with the same alignments.  The
+   entries are then chained in the order in which the single table would
+   have created them, so the output doesn't depend on the number of
+   threads or on whether we used them at all.  */
 
 /* An entry in the section merge hash table.  */
 
@@ -98,6 +110,23 @@ struct sec_merge_hash
    resizing.  */
 #define NEEDS_RESIZE(newcount, nbuckets) ((newcount) > (nbuckets) / 3 * 2)
 
+/* Number of bits of the hash that select the shard table, when
+   recording in parallel.  */
+#define MERGE_SHARD_BITS 6
+#define MERGE_SHARDS (1u << MERGE_SHARD_BITS)
+#define MERGE_SHARD(hash) ((uint32_t) (hash) >> (32 - MERGE_SHARD_BITS))
+
+/* Record sets in parallel only when they have at least this many octets
+   of input, and read at most about this many octets per batch.  */
+#define MERGE_PARALLEL_MIN (256 * 1024)
+#define MERGE_BATCH_SIZE (64 * 1024 * 1024)
+
+/* Sort the strings for suffix merging in parallel when there are at
+   least this many, by sorting MERGE_SORT_RUNS runs of them and then
+   merging those.  */
+#define MERGE_PARALLEL_SORT_MIN 65536
+#define MERGE_SORT_RUNS 16
+
 struct sec_merge_sec_info;
 
 /* Information per merged blob.  This is the unit of merging and is
@@ -113,6 +142,9 @@ struct sec_merge_info
   struct sec_merge_sec_info **last;
   /* A hash table used to hold section content.  */
   struct sec_merge_hash *htab;
+  /* When recording in parallel, the MERGE_SHARDS tables the entries are
+     really looked up in.  HTAB then only chains them.  */
+  struct sec_merge_hash **shards;
 };
 
 /* Offset into input mergable sections are represented by this type.
@@ -327,15 +359,14 @@ end:
   return ret;
 }
 
-/* Given a hash TABLE, return the hash of STRING (a blob described
+/* Given a hash TABLE, return the length of STRING (a blob described
    according to info in TABLE, either a character string, or some fixed
-   size entity) and set *PLEN to the length of this blob.  */
+   size entity).  */
 
-static uint32_t
-hashit (struct sec_merge_hash *table, const char *string, unsigned int *plen)
+static inline unsigned int
+blob_length (const struct sec_merge_hash *table, const char *string)
 {
   const unsigned char *s;
-  uint32_t hash;
   unsigned int len, i;
 
   s = (const unsigned char *) string;
@@ -362,18 +393,46 @@ hashit (struct sec_merge_hash *table, const char *string, unsigned int *plen)
     }
   else
     len = table->entsize;
-  hash = hash_blob (string, len);
+  return len;
+}
+
+/* Given a hash TABLE, return the hash of STRING (a blob described
+   according to info in TABLE, either a character string, or some fixed
+   size entity) and set *PLEN to the length of this blob.  */
+
+static uint32_t
+hashit (const struct sec_merge_hash *table, const char *string,
+	unsigned int *plen)
+{
+  unsigned int len = blob_length (table, string);
+
   *plen = len;
-  return hash;
+  return hash_blob (string, len);
 }
 
-/* Lookup or insert a blob STRING (of length LEN, precomputed HASH and
-   input ALIGNMENT) into TABLE.  Return the found or new hash table entry.  */
+/* Return the alignment in octets a blob at input offset OFS in a section
+   with alignment mask MASK is known to have.  */
 
-static struct sec_merge_hash_entry *
-sec_merge_hash_lookup (struct sec_merge_hash *table, const char *string,
-		       unsigned int len, uint64_t hash,
-		       unsigned int alignment)
+static inline unsigned int
+blob_alignment (unsigned int ofs, bfd_vma mask)
+{
+  bfd_vma eltalign = ofs;
+
+  eltalign = ((eltalign ^ (eltalign - 1)) + 1) >> 1;
+  if (!eltalign || eltalign > mask)
+    eltalign = mask + 1;
+  return eltalign;
+}
+
+/* Lookup or insert a blob STRING (of length LEN, precomputed HASH and
+   input ALIGNMENT) into TABLE, setting *CREATED if the entry is new.
+   Return the found or new hash table entry.  New entries are not yet
+   chained.  */
+
+static inline struct sec_merge_hash_entry *
+sec_merge_hash_find (struct sec_merge_hash *table, const char *string,
+		     unsigned int len, uint64_t hash,
+		     unsigned int alignment, bool *created)
 {
   struct sec_merge_hash_entry *hashp;
   unsigned int _index;
@@ -394,6 +453,7 @@ sec_merge_hash_lookup (struct sec_merge_hash *table, const char *string,
 	  hashp = values[_index];
 	  if (hashp->alignment < alignment)
 	    hashp->alignment = alignment;
+	  *created = false;
 	  return hashp;
 	}
       if (!(candlen & (uint32_t)-1))
@@ -405,6 +465,24 @@ sec_merge_hash_lookup (struct sec_merge_hash *table, const char *string,
   if (hashp == NULL)
     return NULL;
   hashp->alignment = alignment;
+  *created = true;
+  return hashp;
+}
+
+/* Lookup or insert a blob STRING (of length LEN, precomputed HASH and
+   input ALIGNMENT) into TABLE.  Return the found or new hash table entry.  */
+
+static struct sec_merge_hash_entry *
+sec_merge_hash_lookup (struct sec_merge_hash *table, const char *string,
+		       unsigned int len, uint64_t hash,
+		       unsigned int alignment)
+{
+  struct sec_merge_hash_entry *hashp;
+  bool created;
+
+  hashp = sec_merge_hash_find (table, string, len, hash, alignment, &created);
+  if (hashp == NULL || !created)
+    return hashp;
 
   table->size++;
   BFD_ASSERT (table->size == table->table.count);
@@ -417,10 +495,10 @@ sec_merge_hash_lookup (struct sec_merge_hash *table, const char *string,
   return hashp;
 }
 
-/* Create a new hash table.  */
+/* Create a new hash table with NBUCKETS (a power of two) buckets.  */
 
 static struct sec_merge_hash *
-sec_merge_init (unsigned int entsize, bool strings)
+sec_merge_init (unsigned int entsize, bool strings, unsigned int nbuckets)
 {
   struct sec_merge_hash *table;
 
@@ -429,7 +507,7 @@ sec_merge_init (unsigned int entsize, bool strings)
     return NULL;
 
   if (! bfd_hash_table_init_n (&table->table, NULL,
-			       sizeof (struct sec_merge_hash_entry), 0x2000))
+			       sizeof (struct sec_merge_hash_entry), nbuckets))
     {
       free (table);
       return NULL;
@@ -441,7 +519,7 @@ sec_merge_init (unsigned int entsize, bool strings)
   table->entsize = entsize;
   table->strings = strings;
 
-  table->nbuckets = 0x2000;
+  table->nbuckets = nbuckets;
   table->key_lens = objalloc_alloc ((struct objalloc *) table->table.memory,
 				table->nbuckets * sizeof (table->key_lens[0]));
   memset (table->key_lens, 0, table->nbuckets * sizeof (table->key_lens[0]));
@@ -679,7 +757,9 @@ _bfd_add_merge_section (bfd *abfd, void **psinfo, asection *sec,
       sinfo->chain = NULL;
       sinfo->last = &sinfo->chain;
       *psinfo = sinfo;
-      sinfo->htab = sec_merge_init (sec->entsize, (sec->flags & SEC_STRINGS));
+      sinfo->shards = NULL;
+      sinfo->htab = sec_merge_init (sec->entsize, (sec->flags & SEC_STRINGS),
+				    0x2000);
       if (sinfo->htab == NULL)
 	goto error_return;
     }
@@ -697,21 +777,14 @@ _bfd_add_merge_section (bfd *abfd, void **psinfo, asection *sec,
   return false;
 }
 
-/* Record one whole input section (described by SECINFO) into the hash table
-   SINFO.  */
+/* Read in the contents of the merge section SEC, returning a malloc'd
+   buffer or NULL on error.  */
 
-static bool
-record_section (struct sec_merge_info *sinfo,
-		struct sec_merge_sec_info *secinfo)
+static bfd_byte *
+read_merge_section (asection *sec)
 {
-  asection *sec = secinfo->sec;
-  struct sec_merge_hash_entry *entry;
-  unsigned char *p, *end;
-  bfd_vma mask, eltalign;
-  unsigned int align;
   bfd_size_type amt;
   bfd_byte *contents;
-  void *tmpptr;
 
   amt = sec->size;
   if (sec->flags & SEC_STRINGS)
@@ -721,13 +794,37 @@ record_section (struct sec_merge_info *sinfo,
     amt += sec->entsize;
   contents = bfd_malloc (amt);
   if (!contents)
-    goto error_return;
+    return NULL;
 
   /* Slurp in all section contents (possibly decompressing it).  */
   sec->rawsize = sec->size;
   if (sec->flags & SEC_STRINGS)
     memset (contents + sec->size, 0, sec->entsize);
   if (! bfd_get_full_section_contents (sec->owner, sec, &contents))
+    {
+      free (contents);
+      return NULL;
+    }
+  return contents;
+}
+
+/* Record one whole input section (described by SECINFO) into the hash table
+   SINFO.  */
+
+static bool
+record_section (struct sec_merge_info *sinfo,
+		struct sec_merge_sec_info *secinfo)
+{
+  asection *sec = secinfo->sec;
+  struct sec_merge_hash_entry *entry;
+  unsigned char *p, *end;
+  bfd_vma mask;
+  bfd_size_type amt;
+  bfd_byte *contents;
+  void *tmpptr;
+
+  contents = read_merge_section (sec);
+  if (!contents)
     goto error_return;
 
   /* Now populate the hash table and offset mapping.  */
@@ -744,20 +841,15 @@ record_section (struct sec_merge_info *sinfo,
   /* Walk through the contents, calculate hashes and length of all
      blobs (strings or fixed-size entries) we find and fill the
      hash and offset tables.  */
-  align = sec->alignment_power;
-  mask = ((bfd_vma) 1 << align) - 1;
+  mask = ((bfd_vma) 1 << sec->alignment_power) - 1;
   end = contents + sec->size;
   for (p = contents; p < end;)
     {
       unsigned len;
       uint32_t hash = hashit (sinfo->htab, (char*) p, &len);
       unsigned int ofs = p - contents;
-      eltalign = ofs;
-      eltalign = ((eltalign ^ (eltalign - 1)) + 1) >> 1;
-      if (!eltalign || eltalign > mask)
-	eltalign = mask + 1;
       entry = sec_merge_hash_lookup (sinfo->htab, (char *) p, len, hash,
-				     (unsigned) eltalign);
+				     blob_alignment (ofs, mask));
       if (! entry)
 	goto error_return;
       if (! append_offsetmap (secinfo, ofs, entry))
@@ -798,6 +890,277 @@ record_section (struct sec_merge_info *sinfo,
   return false;
 }
 
+/* A blob of an input section that is being recorded in parallel.  */
+
+struct sec_merge_blob
+{
+  uint32_t hash;
+  unsigned int len;
+  unsigned int alignment;
+};
+
+/* An input section that is being recorded in parallel.  */
+
+struct sec_merge_scan
+{
+  struct sec_merge_sec_info *secinfo;
+  bfd_byte *contents;
+  /* Number of the first blob of this section, counting all blobs of the
+     set in the order record_section would see them.  */
+  bfd_size_type first;
+  /* The blobs, in the order of SECINFO's map.  */
+  struct sec_merge_blob *blobs;
+  /* Indices into BLOBS, grouped by shard.  The blobs of shard S start
+     at shard_start[S] and are in input order.  */
+  unsigned int *order;
+  unsigned int shard_start[MERGE_SHARDS + 1];
+  bool ok;
+};
+
+/* A batch of input sections being recorded in parallel.  */
+
+struct sec_merge_batch
+{
+  struct sec_merge_info *sinfo;
+  struct sec_merge_scan *scans;
+  size_t nscans;
+  bool shard_ok[MERGE_SHARDS];
+};
+
+/* parallel_for worker: find and hash the blobs of the I'th section of
+   the batch DATA, and fill in its offset map, except for the entries.  */
+
+static void
+scan_section (size_t i, void *data)
+{
+  struct sec_merge_batch *batch = (struct sec_merge_batch *) data;
+  struct sec_merge_scan *scan = &batch->scans[i];
+  struct sec_merge_sec_info *secinfo = scan->secinfo;
+  const struct sec_merge_hash *htab = batch->sinfo->htab;
+  asection *sec = secinfo->sec;
+  unsigned int cursor[MERGE_SHARDS];
+  unsigned char *p, *end;
+  unsigned int n, j, s;
+  bfd_vma mask;
+
+  end = scan->contents + sec->size;
+  if (htab->strings)
+    for (n = 0, p = scan->contents; p < end; n++)
+      p += blob_length (htab, (char *) p);
+  else
+    n = sec->size / htab->entsize;
+
+  secinfo->map_ofs = bfd_malloc ((n + 1) * sizeof (secinfo->map_ofs[0]));
+  secinfo->map = bfd_malloc ((n + 1) * sizeof (secinfo->map[0]));
+  scan->blobs = bfd_malloc (n * sizeof (scan->blobs[0]));
+  scan->order = bfd_malloc (n * sizeof (scan->order[0]));
+  if (!secinfo->map_ofs || !secinfo->map || !scan->blobs || !scan->order)
+    return;
+
+  memset (scan->shard_start, 0, sizeof (scan->shard_start));
+  mask = ((bfd_vma) 1 << sec->alignment_power) - 1;
+  for (j = 0, p = scan->contents; j < n; j++)
+    {
+      struct sec_merge_blob *blob = &scan->blobs[j];
+      unsigned int ofs = p - scan->contents;
+
+      blob->hash = hashit (htab, (char *) p, &blob->len);
+      blob->alignment = blob_alignment (ofs, mask);
+      MAP_OFS (secinfo, j) = ofs;
+      scan->shard_start[MERGE_SHARD (blob->hash) + 1]++;
+      p += blob->len;
+    }
+
+  /* Add a sentinel element that's conceptually behind all others.  */
+  MAP_OFS (secinfo, n) = sec->size;
+  secinfo->map[n].entry = NULL;
+  secinfo->noffsetmap = n;
+
+  for (s = 0; s < MERGE_SHARDS; s++)
+    {
+      scan->shard_start[s + 1] += scan->shard_start[s];
+      cursor[s] = scan->shard_start[s];
+    }
+  for (j = 0; j < n; j++)
+    scan->order[cursor[MERGE_SHARD (scan->blobs[j].hash)]++] = j;
+
+  scan->ok = true;
+}
+
+/* parallel_for worker: look up the blobs of shard S of the batch DATA
+   in the shard's table, in input order, and record their entries.  */
+
+static void
+insert_shard (size_t s, void *data)
+{
+  struct sec_merge_batch *batch = (struct sec_merge_batch *) data;
+  struct sec_merge_hash *table = batch->sinfo->shards[s];
+  unsigned int added = 0;
+  size_t i;
+
+  for (i = 0; i < batch->nscans; i++)
+    added += (batch->scans[i].shard_start[s + 1]
+	      - batch->scans[i].shard_start[s]);
+  if (!sec_merge_maybe_resize (table, added))
+    return;
+
+  for (i = 0; i < batch->nscans; i++)
+    {
+      struct sec_merge_scan *scan = &batch->scans[i];
+      struct sec_merge_sec_info *secinfo = scan->secinfo;
+      unsigned int k;
+
+      for (k = scan->shard_start[s]; k < scan->shard_start[s + 1]; k++)
+	{
+	  unsigned int j = scan->order[k];
+	  struct sec_merge_blob *blob = &scan->blobs[j];
+	  struct sec_merge_hash_entry *entry;
+	  bool created;
+
+	  entry = sec_merge_hash_find (table, ((char *) scan->contents
+						+ MAP_OFS (secinfo, j)),
+				       blob->len, blob->hash, blob->alignment,
+				       &created);
+	  if (entry == NULL)
+	    return;
+	  /* Remember where the entry was first seen until it is chained.  */
+	  if (created)
+	    entry->u.index = scan->first + j;
+	  secinfo->map[j].entry = entry;
+	}
+    }
+  batch->shard_ok[s] = true;
+}
+
+/* Record the input sections of SINFO into its hash table, using the
+   parallel_for callback of INFO.  This has the same effect as calling
+   record_section for each of them in turn.  */
+
+static bool
+record_sections_parallel (struct bfd_link_info *info,
+			  struct sec_merge_info *sinfo)
+{
+  struct sec_merge_hash *htab = sinfo->htab;
+  struct sec_merge_sec_info *secinfo, *next;
+  struct sec_merge_batch batch;
+  bfd_size_type nblobs = 0;
+  size_t i, nsecs = 0;
+  unsigned int s;
+
+  if (sinfo->shards == NULL)
+    {
+      sinfo->shards = bfd_zmalloc (MERGE_SHARDS * sizeof (sinfo->shards[0]));
+      if (sinfo->shards == NULL)
+	goto error_return;
+      for (s = 0; s < MERGE_SHARDS; s++)
+	{
+	  sinfo->shards[s] = sec_merge_init (htab->entsize, htab->strings,
+					     0x100);
+	  if (sinfo->shards[s] == NULL)
+	    goto error_return;
+	}
+    }
+
+  for (secinfo = sinfo->chain; secinfo; secinfo = secinfo->next)
+    if ((secinfo->sec->flags & SEC_EXCLUDE) == 0)
+      nsecs++;
+  batch.sinfo = sinfo;
+  batch.scans = bfd_malloc (nsecs * sizeof (batch.scans[0]));
+  if (batch.scans == NULL)
+    goto error_return;
+
+  for (secinfo = sinfo->chain; secinfo; secinfo = next)
+    {
+      bfd_size_type batch_size = 0;
+      bool ok = true;
+
+      /* Read in the next batch.  */
+      batch.nscans = 0;
+      for (next = secinfo;
+	   next != NULL && batch_size < MERGE_BATCH_SIZE;
+	   next = next->next)
+	if ((next->sec->flags & SEC_EXCLUDE) == 0)
+	  {
+	    struct sec_merge_scan *scan = &batch.scans[batch.nscans++];
+
+	    memset (scan, 0, sizeof (*scan));
+	    scan->secinfo = next;
+	    scan->contents = read_merge_section (next->sec);
+	    if (scan->contents == NULL)
+	      {
+		ok = false;
+		break;
+	      }
+	    batch_size += next->sec->size;
+	  }
+
+      if (ok)
+	{
+	  info->callbacks->parallel_for (batch.nscans, scan_section, &batch);
+	  for (i = 0; i < batch.nscans; i++)
+	    {
+	      batch.scans[i].first = nblobs;
+	      nblobs += batch.scans[i].secinfo->noffsetmap;
+	      ok &= batch.scans[i].ok;
+	    }
+	}
+      if (ok)
+	{
+	  memset (batch.shard_ok, 0, sizeof (batch.shard_ok));
+	  info->callbacks->parallel_for (MERGE_SHARDS, insert_shard, &batch);
+	  for (s = 0; s < MERGE_SHARDS; s++)
+	    ok &= batch.shard_ok[s];
+	}
+
+      /* Chain the new entries in the order of their first use, as
+	 sec_merge_hash_lookup would have.  */
+      for (i = 0; ok && i < batch.nscans; i++)
+	{
+	  struct sec_merge_scan *scan = &batch.scans[i];
+	  unsigned int j;
+
+	  for (j = 0; j < scan->secinfo->noffsetmap; j++)
+	    {
+	      struct sec_merge_hash_entry *entry = scan->secinfo->map[j].entry;
+
+	      if (entry->u.index == scan->first + j)
+		{
+		  /* No blob number matches this.  */
+		  entry->u.index = (bfd_size_type) -1;
+		  entry->next = NULL;
+		  if (htab->first == NULL)
+		    htab->first = entry;
+		  else
+		    htab->last->next = entry;
+		  htab->last = entry;
+		  htab->size++;
+		}
+	    }
+	}
+
+      for (i = 0; i < batch.nscans; i++)
+	{
+	  free (batch.scans[i].contents);
+	  free (batch.scans[i].blobs);
+	  free (batch.scans[i].order);
+	}
+      if (!ok)
+	{
+	  free (batch.scans);
+	  goto error_return;
+	}
+    }
+
+  free (batch.scans);
+  return true;
+
+ error_return:
+  bfd_set_error (bfd_error_no_memory);
+  for (secinfo = sinfo->chain; secinfo; secinfo = secinfo->next)
+    *secinfo->psecinfo = NULL;
+  return false;
+}
+
 /* qsort comparison function.  Won't ever return zero as all entries
    differ, so there is no issue with qsort stability here.  */
 
@@ -865,10 +1228,99 @@ is_suffix (const struct sec_merge_hash_entry *A,
 		 B->str, B->len) == 0;
 }
 
+/* State for sorting the strings for suffix merging in parallel.  */
+
+struct sec_merge_sort
+{
+  struct sec_merge_hash_entry **array;
+  struct sec_merge_hash_entry **tmp;
+  size_t count;
+  /* Length of the sorted runs.  */
+  size_t run;
+  int (*cmp) (const void *, const void *);
+};
+
+/* parallel_for worker: qsort the I'th run of the sort DATA.  */
+
+static void
+sort_run (size_t i, void *data)
+{
+  struct sec_merge_sort *sort = (struct sec_merge_sort *) data;
+  size_t lo = i * sort->run;
+  size_t n = sort->count - lo < sort->run ? sort->count - lo : sort->run;
+
+  qsort (sort->array + lo, n, sizeof (sort->array[0]), sort->cmp);
+}
+
+/* parallel_for worker: merge the I'th pair of runs of the sort DATA
+   into TMP.  */
+
+static void
+merge_runs (size_t i, void *data)
+{
+  struct sec_merge_sort *sort = (struct sec_merge_sort *) data;
+  struct sec_merge_hash_entry **array = sort->array;
+  size_t lo = 2 * i * sort->run;
+  size_t mid = sort->count - lo < sort->run ? sort->count : lo + sort->run;
+  size_t hi = sort->count - mid < sort->run ? sort->count : mid + sort->run;
+  size_t a = lo, b = mid, o = lo;
+
+  while (a < mid && b < hi)
+    if (sort->cmp (&array[a], &array[b]) < 0)
+      sort->tmp[o++] = array[a++];
+    else
+      sort->tmp[o++] = array[b++];
+  while (a < mid)
+    sort->tmp[o++] = array[a++];
+  while (b < hi)
+    sort->tmp[o++] = array[b++];
+}
+
+/* Sort the COUNT entries of ARRAY with CMP like qsort, using the
+   parallel_for callback of INFO.  CMP never returns zero, so the result
+   is the same as qsort's.  */
+
+static bool
+sort_strings_parallel (struct bfd_link_info *info,
+		       struct sec_merge_hash_entry **array, size_t count,
+		       int (*cmp) (const void *, const void *))
+{
+  struct sec_merge_sort sort;
+
+  sort.tmp = bfd_malloc (count * sizeof (array[0]));
+  if (sort.tmp == NULL)
+    return false;
+  sort.array = array;
+  sort.count = count;
+  sort.cmp = cmp;
+  sort.run = (count + MERGE_SORT_RUNS - 1) / MERGE_SORT_RUNS;
+  info->callbacks->parallel_for ((count + sort.run - 1) / sort.run,
+				 sort_run, &sort);
+
+  for (; sort.run < count; sort.run *= 2)
+    {
+      struct sec_merge_hash_entry **t;
+
+      info->callbacks->parallel_for ((count + 2 * sort.run - 1)
+				     / (2 * sort.run), merge_runs, &sort);
+      t = sort.array;
+      sort.array = sort.tmp;
+      sort.tmp = t;
+    }
+
+  if (sort.array != array)
+    {
+      memcpy (array, sort.array, count * sizeof (array[0]));
+      sort.tmp = sort.array;
+    }
+  free (sort.tmp);
+  return true;
+}
+
 /* This is a helper function for _bfd_merge_sections.  It attempts to
    merge strings matching suffixes of longer strings.  */
 static struct sec_merge_sec_info *
-merge_strings (struct sec_merge_info *sinfo)
+merge_strings (struct bfd_link_info *info, struct sec_merge_info *sinfo)
 {
   struct sec_merge_hash_entry **array, **a, *e;
   struct sec_merge_sec_info *secinfo;
@@ -899,10 +1351,24 @@ merge_strings (struct sec_merge_info *sinfo)
   sinfo->htab->size = a - array;
   if (sinfo->htab->size != 0)
     {
-      qsort (array, (size_t) sinfo->htab->size,
-	     sizeof (struct sec_merge_hash_entry *),
-	     (alignment != (unsigned) -1 && alignment > sinfo->htab->entsize
-	      ? strrevcmp_align : strrevcmp));
+      int (*compare) (const void *, const void *)
+	= (alignment != (unsigned) -1 && alignment > sinfo->htab->entsize
+	   ? strrevcmp_align : strrevcmp);
+
+      if (info != NULL
+	  && info->callbacks->parallel_for != NULL
+	  && sinfo->htab->size >= MERGE_PARALLEL_SORT_MIN)
+	{
+	  if (!sort_strings_parallel (info, array, sinfo->htab->size,
+				      compare))
+	    {
+	      free (array);
+	      return NULL;
+	    }
+	}
+      else
+	qsort (array, (size_t) sinfo->htab->size,
+	       sizeof (struct sec_merge_hash_entry *), compare);
 
       /* Loop over the sorted array and merge suffixes */
       e = *--a;
@@ -966,7 +1432,7 @@ merge_strings (struct sec_merge_info *sinfo)
 
 bool
 _bfd_merge_sections (bfd *abfd,
-		     struct bfd_link_info *info ATTRIBUTE_UNUSED,
+		     struct bfd_link_info *info,
 		     void *xsinfo,
 		     void (*remove_hook) (bfd *, asection *))
 {
@@ -976,10 +1442,22 @@ _bfd_merge_sections (bfd *abfd,
     {
       struct sec_merge_sec_info *secinfo;
       bfd_size_type align;  /* Bytes.  */
+      bool parallel = false;
 
       if (! sinfo->chain)
 	continue;
 
+      /* Big sets are worth recording on several threads.  */
+      if (info != NULL && info->callbacks->parallel_for != NULL)
+	{
+	  bfd_size_type total = 0;
+
+	  for (secinfo = sinfo->chain; secinfo; secinfo = secinfo->next)
+	    if ((secinfo->sec->flags & SEC_EXCLUDE) == 0)
+	      total += secinfo->sec->size;
+	  parallel = total >= MERGE_PARALLEL_MIN;
+	}
+
       /* Record the sections into the hash table.  */
       align = 1;
       for (secinfo = sinfo->chain; secinfo; secinfo = secinfo->next)
@@ -991,7 +1469,7 @@ _bfd_merge_sections (bfd *abfd,
 	  }
 	else
 	  {
-	    if (!record_section (sinfo, secinfo))
+	    if (!parallel && !record_section (sinfo, secinfo))
 	      return false;
 	    if (align)
 	      {
@@ -1003,12 +1481,15 @@ _bfd_merge_sections (bfd *abfd,
 	      }
 	  }
 
+      if (parallel && !record_sections_parallel (info, sinfo))
+	return false;
+
       if (sinfo->htab->first == NULL)
 	continue;
 
       if (sinfo->htab->strings)
 	{
-	  secinfo = merge_strings (sinfo);
+	  secinfo = merge_strings (info, sinfo);
 	  if (!secinfo)
 	    return false;
 	}
@@ -1159,6 +1640,18 @@ _bfd_merge_sections_free (void *xsinfo)
 	  free (secinfo->map);
 	  free (secinfo->map_ofs);
 	}
+      if (sinfo->shards != NULL)
+	{
+	  unsigned int s;
+
+	  for (s = 0; s < MERGE_SHARDS; s++)
+	    if (sinfo->shards[s] != NULL)
+	      {
+		bfd_hash_table_free (&sinfo->shards[s]->table);
+		free (sinfo->shards[s]);
+	      }
+	  free (sinfo->shards);
+	}
       bfd_hash_table_free (&sinfo->htab->table);
       free (sinfo->htab);
     }
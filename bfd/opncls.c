@@ -625,6 +625,14 @@ opncls_bread (struct bfd *abfd, void *buf, file_ptr nbytes)
   return nread;
 }
 
+static file_ptr
+opncls_bpread (struct bfd *abfd, void *buf, file_ptr nbytes, file_ptr offset)
+{
+  struct opncls *vec = (struct opncls *) abfd->iostream;
+
+  return (vec->pread) (abfd, vec->stream, buf, nbytes, offset);
+}
+
 static file_ptr
 opncls_bwrite (struct bfd *abfd ATTRIBUTE_UNUSED,
 	      const void *where ATTRIBUTE_UNUSED,
@@ -681,7 +689,8 @@ opncls_bmmap (struct bfd *abfd ATTRIBUTE_UNUSED,
 static const struct bfd_iovec opncls_iovec =
 {
   &opncls_bread, &opncls_bwrite, &opncls_btell, &opncls_bseek,
-  &opncls_bclose, &opncls_bflush, &opncls_bstat, &opncls_bmmap
+  &opncls_bclose, &opncls_bflush, &opncls_bstat, &opncls_bmmap,
+  &opncls_bpread
 };
 
 bfd *
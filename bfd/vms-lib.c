@@ -1282,7 +1282,8 @@ vms_lib_bmmap (struct bfd *abfd ATTRIBUTE_UNUSED,
 
 static const struct bfd_iovec vms_lib_iovec = {
   &vms_lib_bread, &vms_lib_bwrite, &vms_lib_btell, &vms_lib_bseek,
-  &vms_lib_bclose, &vms_lib_bflush, &vms_lib_bstat, &vms_lib_bmmap
+  &vms_lib_bclose, &vms_lib_bflush, &vms_lib_bstat, &vms_lib_bmmap,
+  NULL
 };
 
 /* Open a library module.  FILEPOS is the position of the module header.  */
@@ -26,9 +26,14 @@
    addr2line [options] addr addr ...
    or
    addr2line [options]
+   or
+   addr2line [options] --server
 
-   both forms write results to stdout, the second form reads addresses
-   to be converted from stdin.  */
+   the first two forms write results to stdout, the second form reads
+   addresses to be converted from stdin.  The third form reads requests
+   naming a file and any number of addresses from stdin, and answers
+   each one with a line of JSON, keeping the files open between
+   requests.  */
 
 #include "sysdep.h"
 #include "bfd.h"
@@ -45,6 +50,7 @@ static bool with_functions;	/* -f, show function names.  */
 static bool do_demangle;	/* -C, demangle names.  */
 static bool pretty_print;	/* -p, print on one line.  */
 static bool base_names;		/* -s, strip directory names.  */
+static bool line_index;		/* --line-index, index all line tables.  */
 
 /* Flags passed to the name demangler.  */
 static int demangle_flags = DMGL_PARAMS | DMGL_ANSI;
@@ -55,6 +61,16 @@ static char **addr;		/* Hex addresses to process.  */
 static long symcount;
 static asymbol **syms;		/* Symbol table.  */
 
+/* In server mode, the total size of the files to keep open.  */
+static unsigned long long cache_limit = 512ULL << 20;
+
+enum long_option_values
+{
+  OPTION_SERVER = 200,
+  OPTION_CACHE_LIMIT,
+  OPTION_LINE_INDEX
+};
+
 static struct option long_options[] =
 {
   {"addresses", no_argument, NULL, 'a'},
@@ -70,6 +86,9 @@ static struct option long_options[] =
   {"no-recursion-limit", no_argument, NULL, 'r'},  
   {"section", required_argument, NULL, 'j'},
   {"target", required_argument, NULL, 'b'},
+  {"server", no_argument, NULL, OPTION_SERVER},
+  {"cache-limit", required_argument, NULL, OPTION_CACHE_LIMIT},
+  {"line-index", no_argument, NULL, OPTION_LINE_INDEX},
   {"help", no_argument, NULL, 'H'},
   {"version", no_argument, NULL, 'V'},
   {0, no_argument, 0, 0}
@@ -102,6 +121,12 @@ usage (FILE *stream, int status)
   -C --demangle[=style]  Demangle function names\n\
   -R --recurse-limit     Enable a limit on recursion whilst demangling.  [Default]\n\
   -r --no-recurse-limit  Disable a limit on recursion whilst demangling\n\
+     --server            Answer requests read from stdin with JSON, keeping\n\
+                          files open between requests\n\
+     --cache-limit=<MiB> Close files once their total size exceeds this\n\
+                          amount in --server mode (default 512)\n\
+     --line-index        Index all line tables up front, which is faster\n\
+                          when looking up many addresses\n\
   -h --help              Display this information\n\
   -v --version           Display the program's version\n\
 \n"));
@@ -280,6 +305,43 @@ is_symbol (char *adr, char **symp, size_t *offset)
   return true;
 }
 
+/* Set PC to the address given by ADR, which is either hexadecimal or
+   symbol+offset.  */
+
+static void
+set_pc (bfd *abfd, char *adr)
+{
+  char *symp;
+  size_t offset;
+
+  if (is_symbol (adr, &symp, &offset))
+    pc = lookup_symbol (abfd, symp, offset);
+  else
+    pc = bfd_scan_vma (adr, NULL, 16);
+  if (bfd_get_flavour (abfd) == bfd_target_elf_flavour)
+    {
+      const struct elf_backend_data *bed = get_elf_backend_data (abfd);
+      bfd_vma sign = (bfd_vma) 1 << (bed->s->arch_size - 1);
+
+      pc &= (sign << 1) - 1;
+      if (bed->sign_extend_vma)
+	pc = (pc ^ sign) - sign;
+    }
+}
+
+/* Look up PC in SECTION, or in all of ABFD's sections if SECTION is
+   NULL, setting FOUND and the location variables.  */
+
+static void
+find_pc (bfd *abfd, asection *section)
+{
+  found = false;
+  if (section)
+    find_offset_in_section (abfd, section);
+  else
+    bfd_map_over_sections (abfd, find_address_in_section, NULL);
+}
+
 /* Read hexadecimal or symbolic with offset addresses from stdin, translate into
    file_name:line_number and optionally function name.  */
 
@@ -289,8 +351,6 @@ translate_addresses (bfd *abfd, asection *section)
   int read_stdin = (naddr == 0);
   char *adr;
   char addr_hex[100];
-  char *symp;
-  size_t offset;
 
   for (;;)
     {
@@ -308,19 +368,7 @@ translate_addresses (bfd *abfd, asection *section)
 	  adr = *addr++;
 	}
 
-      if (is_symbol (adr, &symp, &offset))
-        pc = lookup_symbol (abfd, symp, offset);
-      else
-        pc = bfd_scan_vma (adr, NULL, 16);
-      if (bfd_get_flavour (abfd) == bfd_target_elf_flavour)
-	{
-	  const struct elf_backend_data *bed = get_elf_backend_data (abfd);
-	  bfd_vma sign = (bfd_vma) 1 << (bed->s->arch_size - 1);
-
-	  pc &= (sign << 1) - 1;
-	  if (bed->sign_extend_vma)
-	    pc = (pc ^ sign) - sign;
-	}
+      set_pc (abfd, adr);
 
       if (with_addresses)
         {
@@ -333,11 +381,7 @@ translate_addresses (bfd *abfd, asection *section)
             printf ("\n");
         }
 
-      found = false;
-      if (section)
-	find_offset_in_section (abfd, section);
-      else
-	bfd_map_over_sections (abfd, find_address_in_section, NULL);
+      find_pc (abfd, section);
 
       if (! found)
 	{
@@ -428,54 +472,87 @@ translate_addresses (bfd *abfd, asection *section)
     }
 }
 
-/* Process a file.  Returns an exit value for main().  */
+/* Why the last call to open_file failed, for server mode.  */
 
-static int
-process_file (const char *file_name, const char *section_name,
-	      const char *target)
+static const char *open_error;
+
+/* Open FILE_NAME for address translation, and store the section
+   named SECTION_NAME, or NULL if SECTION_NAME is NULL, in *SECTIONP.
+   Return the BFD, or NULL after reporting an error.  */
+
+static bfd *
+open_file (const char *file_name, const char *section_name,
+	   const char *target, asection **sectionp)
 {
   bfd *abfd;
-  asection *section;
   char **matching;
 
   if (get_file_size (file_name) < 1)
-    return 1;
+    {
+      open_error = _("cannot read file");
+      return NULL;
+    }
 
   abfd = bfd_openr (file_name, target);
   if (abfd == NULL)
-    bfd_fatal (file_name);
+    {
+      bfd_nonfatal (file_name);
+      open_error = bfd_errmsg (bfd_get_error ());
+      return NULL;
+    }
 
   /* Decompress sections.  */
   abfd->flags |= BFD_DECOMPRESS;
+  if (line_index)
+    abfd->flags |= BFD_DWARF2_LINE_INDEX;
 
   if (bfd_check_format (abfd, bfd_archive))
     {
       non_fatal (_("%s: cannot get addresses from archive"), file_name);
+      open_error = _("cannot get addresses from archive");
       bfd_close (abfd);
-      return 1;
+      return NULL;
     }
 
   if (! bfd_check_format_matches (abfd, bfd_object, &matching))
     {
       bfd_nonfatal (bfd_get_filename (abfd));
+      open_error = bfd_errmsg (bfd_get_error ());
       if (bfd_get_error () == bfd_error_file_ambiguously_recognized)
 	list_matching_formats (matching);
       bfd_close (abfd);
-      return 1;
+      return NULL;
     }
 
   if (section_name != NULL)
     {
-      section = bfd_get_section_by_name (abfd, section_name);
-      if (section == NULL)
+      *sectionp = bfd_get_section_by_name (abfd, section_name);
+      if (*sectionp == NULL)
 	{
 	  non_fatal (_("%s: cannot find section %s"), file_name, section_name);
+	  open_error = _("cannot find section");
 	  bfd_close (abfd);
-	  return 1;
+	  return NULL;
 	}
     }
   else
-    section = NULL;
+    *sectionp = NULL;
+
+  return abfd;
+}
+
+/* Process a file.  Returns an exit value for main().  */
+
+static int
+process_file (const char *file_name, const char *section_name,
+	      const char *target)
+{
+  bfd *abfd;
+  asection *section;
+
+  abfd = open_file (file_name, section_name, target, &section);
+  if (abfd == NULL)
+    return 1;
 
   slurp_symtab (abfd);
 
@@ -488,13 +565,386 @@ process_file (const char *file_name, const char *section_name,
 
   return 0;
 }
-
+
+/* In server mode, a file that has been opened.  The BFD keeps the
+   line and function tables that it has read from the debug info, so
+   later requests for the same file don't read them again.  */
+
+struct server_file
+{
+  /* The next file in the cache, which is kept in most recently used
+     order.  */
+  struct server_file *next;
+
+  /* The names under which the file has been requested.  A file can
+     have several names, when copies of the same binary are requested
+     under different paths.  Each name comes with the size and
+     modification time it had when it was added, so that a file that
+     has since been replaced isn't used.  */
+  struct server_name *names;
+
+  bfd *abfd;
+  asection *section;
+  asymbol **syms;
+  long symcount;
+
+  /* The size of the file, used to enforce the cache limit.  */
+  off_t size;
+};
+
+struct server_name
+{
+  struct server_name *next;
+  char *name;
+  off_t size;
+  time_t mtime;
+};
+
+/* The open files, most recently used first, and their total size.  */
+
+static struct server_file *server_files;
+static unsigned long long server_files_size;
+
+/* Close FILE and free it.  */
+
+static void
+server_close_file (struct server_file *file)
+{
+  struct server_name *name, *next;
+
+  for (name = file->names; name != NULL; name = next)
+    {
+      next = name->next;
+      free (name->name);
+      free (name);
+    }
+  free (file->syms);
+  bfd_close (file->abfd);
+  server_files_size -= file->size;
+  free (file);
+}
+
+/* Close the least recently used files, other than the first one,
+   until the open files fit in the cache limit.  */
+
+static void
+server_trim_cache (void)
+{
+  struct server_file **filep;
+  unsigned long long size;
+
+  if (server_files == NULL)
+    return;
+
+  /* Keep the files that fit, in order, and close the rest.  */
+  size = server_files->size;
+  filep = &server_files->next;
+  while (*filep != NULL)
+    {
+      struct server_file *file = *filep;
+
+      if (size + file->size > cache_limit)
+	{
+	  *filep = file->next;
+	  server_close_file (file);
+	}
+      else
+	{
+	  size += file->size;
+	  filep = &file->next;
+	}
+    }
+}
+
+/* Return true if FILE1 and FILE2 have the same build-id and size, and
+   so can be assumed to be the same binary.  The size is compared as
+   well because a stripped copy of a binary keeps its build-id.  */
+
+static bool
+same_binary (struct server_file *file1, struct server_file *file2)
+{
+  const struct bfd_build_id *id1 = file1->abfd->build_id;
+  const struct bfd_build_id *id2 = file2->abfd->build_id;
+
+  return (id1 != NULL && id2 != NULL
+	  && file1->size == file2->size
+	  && id1->size == id2->size
+	  && memcmp (id1->data, id2->data, id1->size) == 0);
+}
+
+/* Return the open file for FILE_NAME, opening it if needed, and move
+   it to the front of the cache.  Return NULL, setting OPEN_ERROR, if
+   the file can't be used.  */
+
+static struct server_file *
+server_get_file (const char *file_name, const char *section_name,
+		 const char *target)
+{
+  struct server_file **filep, *file;
+  struct server_name *name;
+  struct stat statbuf;
+
+  if (stat (file_name, &statbuf) != 0)
+    {
+      open_error = strerror (errno);
+      return NULL;
+    }
+
+  for (filep = &server_files; *filep != NULL; filep = &(*filep)->next)
+    {
+      struct server_name **namep;
+
+      for (namep = &(*filep)->names; *namep != NULL; namep = &(*namep)->next)
+	if (strcmp ((*namep)->name, file_name) == 0)
+	  break;
+      if (*namep == NULL)
+	continue;
+
+      name = *namep;
+      if (name->size == statbuf.st_size && name->mtime == statbuf.st_mtime)
+	{
+	  file = *filep;
+	  *filep = file->next;
+	  file->next = server_files;
+	  server_files = file;
+	  return file;
+	}
+
+      /* The file has changed, so forget this name, and the binary
+	 if it has no other name.  */
+      *namep = name->next;
+      free (name->name);
+      free (name);
+      if ((*filep)->names == NULL)
+	{
+	  file = *filep;
+	  *filep = file->next;
+	  server_close_file (file);
+	}
+      break;
+    }
+
+  file = (struct server_file *) xcalloc (1, sizeof (*file));
+  file->abfd = open_file (file_name, section_name, target, &file->section);
+  if (file->abfd == NULL)
+    {
+      free (file);
+      return NULL;
+    }
+  file->size = statbuf.st_size;
+
+  name = (struct server_name *) xmalloc (sizeof (*name));
+  name->name = xstrdup (file_name);
+  name->size = statbuf.st_size;
+  name->mtime = statbuf.st_mtime;
+
+  /* Reading the symbols and the debug info is what takes time, so if
+     the same binary is already open under another name, use that.  */
+  for (filep = &server_files; *filep != NULL; filep = &(*filep)->next)
+    if (same_binary (*filep, file))
+      {
+	bfd_close (file->abfd);
+	free (file);
+	file = *filep;
+	*filep = file->next;
+	break;
+      }
+
+  if (file->names == NULL)
+    {
+      slurp_symtab (file->abfd);
+      file->syms = syms;
+      file->symcount = symcount;
+      syms = NULL;
+      symcount = 0;
+      server_files_size += file->size;
+    }
+
+  name->next = file->names;
+  file->names = name;
+  file->next = server_files;
+  server_files = file;
+  server_trim_cache ();
+  return file;
+}
+
+/* Print STR as a JSON string.  */
+
+static void
+print_json_string (const char *str)
+{
+  putchar ('"');
+  for (; *str != '\0'; ++str)
+    {
+      unsigned char c = *str;
+
+      if (c == '"' || c == '\\')
+	printf ("\\%c", c);
+      else if (c == '\n')
+	printf ("\\n");
+      else if (c < 0x20)
+	printf ("\\u%04x", c);
+      else
+	putchar (c);
+    }
+  putchar ('"');
+}
+
+/* Print the location found by the last lookup of PC as a JSON
+   object.  */
+
+static void
+print_json_frame (bfd *abfd)
+{
+  const char *name = functionname;
+  const char *file = filename;
+  char *alloc = NULL;
+
+  printf ("{\"function\": ");
+  if (name == NULL || *name == '\0')
+    printf ("null");
+  else
+    {
+      if (do_demangle)
+	{
+	  alloc = bfd_demangle (abfd, name, demangle_flags);
+	  if (alloc != NULL)
+	    name = alloc;
+	}
+      print_json_string (name);
+      free (alloc);
+    }
+
+  printf (", \"file\": ");
+  if (file == NULL)
+    printf ("null");
+  else
+    {
+      if (base_names)
+	{
+	  const char *h = strrchr (file, '/');
+	  if (h != NULL)
+	    file = h + 1;
+	}
+      print_json_string (file);
+    }
+
+  printf (", \"line\": %u", line);
+  if (discriminator != 0)
+    printf (", \"discriminator\": %u", discriminator);
+  putchar ('}');
+}
+
+/* Answer a request in server mode.  REQUEST holds a file name
+   followed by any number of addresses, separated by white space.  */
+
+static void
+server_request (char *request, const char *section_name, const char *target)
+{
+  struct server_file *file;
+  char *file_name, *adr;
+  const char *sep = "";
+
+  file_name = strtok (request, " \t\r\n");
+  if (file_name == NULL)
+    return;
+
+  printf ("{\"file\": ");
+  print_json_string (file_name);
+
+  file = server_get_file (file_name, section_name, target);
+  if (file == NULL)
+    {
+      printf (", \"error\": ");
+      print_json_string (open_error);
+      printf ("}\n");
+      return;
+    }
+
+  syms = file->syms;
+  symcount = file->symcount;
+
+  printf (", \"addresses\": [");
+  while ((adr = strtok (NULL, " \t\r\n")) != NULL)
+    {
+      const char *frame_sep = "";
+
+      set_pc (file->abfd, adr);
+      find_pc (file->abfd, file->section);
+
+      printf ("%s{\"address\": \"0x%" PRIx64 "\", \"frames\": [",
+	      sep, (uint64_t) pc);
+      while (found)
+	{
+	  printf ("%s", frame_sep);
+	  print_json_frame (file->abfd);
+	  frame_sep = ", ";
+	  found = (unwind_inlines
+		   && bfd_find_inliner_info (file->abfd, &filename,
+					     &functionname, &line));
+	  discriminator = 0;
+	}
+      printf ("]}");
+      sep = ", ";
+    }
+  printf ("]}\n");
+
+  syms = NULL;
+  symcount = 0;
+}
+
+/* Run in server mode: answer each line read from stdin with a line of
+   JSON on stdout, until the end of the input.  */
+
+static int
+run_server (const char *section_name, const char *target)
+{
+  size_t size = 256;
+  char *request = (char *) xmalloc (size);
+
+  for (;;)
+    {
+      size_t len = 0;
+      int c;
+
+      while ((c = getchar ()) != EOF && c != '\n')
+	{
+	  if (len + 1 >= size)
+	    {
+	      size *= 2;
+	      request = (char *) xrealloc (request, size);
+	    }
+	  request[len++] = c;
+	}
+      if (c == EOF && len == 0)
+	break;
+      request[len] = '\0';
+
+      server_request (request, section_name, target);
+
+      /* As in translate_addresses, the answer must be flushed for a
+	 client waiting on a pipe.  */
+      fflush (stdout);
+    }
+
+  free (request);
+  while (server_files != NULL)
+    {
+      struct server_file *file = server_files;
+
+      server_files = file->next;
+      server_close_file (file);
+    }
+  return 0;
+}
+
 int
 main (int argc, char **argv)
 {
   const char *file_name;
   const char *section_name;
   char *target;
+  bool server = false;
   int c;
 
 #ifdef HAVE_LC_MESSAGES
@@ -576,12 +1026,36 @@ main (int argc, char **argv)
 	case 'j':
 	  section_name = optarg;
 	  break;
+	case OPTION_SERVER:
+	  server = true;
+	  line_index = true;
+	  break;
+	case OPTION_LINE_INDEX:
+	  line_index = true;
+	  break;
+	case OPTION_CACHE_LIMIT:
+	  {
+	    char *end;
+
+	    cache_limit = strtoull (optarg, &end, 0);
+	    if (*end != '\0' || end == optarg)
+	      fatal (_("bad cache limit `%s'"), optarg);
+	    cache_limit <<= 20;
+	  }
+	  break;
 	default:
 	  usage (stderr, 1);
 	  break;
 	}
     }
 
+  if (server)
+    {
+      if (file_name != NULL || optind != argc)
+	usage (stderr, 1);
+      return run_server (section_name, target);
+    }
+
   if (file_name == NULL)
     file_name = "a.out";
 
@@ -31,6 +31,9 @@
 #include "filenames.h"
 #include "safe-ctype.h"
 #include <assert.h>
+#ifdef HAVE_SYS_WAIT_H
+#include <sys/wait.h>
+#endif
 
 #ifdef HAVE_LIBDEBUGINFOD
 #include <elfutils/debuginfod.h>
@@ -117,6 +120,8 @@ bool do_checks;
 
 int dwarf_cutoff_level = -1;
 unsigned long dwarf_start_die;
+const char *dwarf_die_name;
+unsigned int dwarf_jobs = 1;
 
 int dwarf_check = 0;
 
@@ -3645,7 +3650,9 @@ skip_attribute (unsigned long    form,
       return skip_attribute (form, data, end, pointer_size, offset_size, dwarf_version);
 
     case DW_FORM_string:
-      data += strnlen ((char *) data, end - data);    
+      data += strnlen ((char *) data, end - data);
+      if (data < end)
+	data++;
       break;
     case DW_FORM_block:
     case DW_FORM_exprloc:
@@ -3717,211 +3724,137 @@ read_bases (abbrev_entry *   entry,
     }
 }
 
-/* Process the contents of a .debug_info section.
-   If do_loc is TRUE then we are scanning for location lists and dwo tags
-   and we do not want to display anything to the user.
-   If do_types is TRUE, we are processing a .debug_types section instead of
-   a .debug_info section.
-   The information displayed is restricted by the values in DWARF_START_DIE
-   and DWARF_CUTOFF_LEVEL.
-   Returns TRUE upon success.  Otherwise an error or warning message is
-   printed and FALSE is returned.  */
+/* A walk over the units of a .debug_info or .debug_types section.  */
 
-static bool
-process_debug_info (struct dwarf_section * section,
-		    void *file,
-		    enum dwarf_section_display_enum abbrev_sec,
-		    bool do_loc,
-		    bool do_types)
+struct debug_info_walk
 {
-  unsigned char *start = section->start;
-  unsigned char *end = start + section->size;
+  struct dwarf_section *section;
+  enum dwarf_section_display_enum abbrev_sec;
   unsigned char *section_begin;
-  unsigned int unit;
-  unsigned int num_units = 0;
-
-  /* First scan the section to get the number of comp units.
-     Length sanity checks are done here.  */
-  for (section_begin = start, num_units = 0; section_begin < end;
-       num_units ++)
-    {
-      uint64_t length;
-
-      /* Read the first 4 bytes.  For a 32-bit DWARF section, this
-	 will be the length.  For a 64-bit DWARF section, it'll be
-	 the escape code 0xffffffff followed by an 8 byte length.  */
-      SAFE_BYTE_GET_AND_INC (length, section_begin, 4, end);
+  unsigned char *end;
+  bool do_loc;
+  /* Updated from the header of each DWARF 5 unit.  */
+  bool do_types;
+  /* Set once the DIEs selected by DWARF_START_DIE have been displayed.  */
+  bool stopped;
+};
 
-      if (length == 0xffffffff)
-	SAFE_BYTE_GET_AND_INC (length, section_begin, 8, end);
-      else if (length >= 0xfffffff0 && length < 0xffffffff)
-	{
-	  warn (_("Reserved length value (%#" PRIx64 ") found in section %s\n"),
-		length, section->name);
-	  return false;
-	}
+/* Return TRUE if the DIE described by ENTRY, whose attribute values
+   start at DATA, has a DW_AT_name attribute equal to NAME.  */
 
-      /* Negative values are illegal, they may even cause infinite
-	 looping.  This can happen if we can't accurately apply
-	 relocations to an object file, or if the file is corrupt.  */
-      if (length > (size_t) (end - section_begin))
-	{
-	  warn (_("Corrupt unit length (got %#" PRIx64
-		  " expected at most %#tx) in section %s\n"),
-		length, end - section_begin, section->name);
-	  return false;
-	}
-      section_begin += length;
-    }
-
-  if (num_units == 0)
-    {
-      error (_("No comp units in %s section ?\n"), section->name);
-      return false;
-    }
+static bool
+die_has_name (abbrev_entry *        entry,
+	      unsigned char *       data,
+	      unsigned char *       end,
+	      const char *          name,
+	      uint64_t              pointer_size,
+	      uint64_t              offset_size,
+	      int                   dwarf_version,
+	      debug_info *          debug_info_p,
+	      struct dwarf_section *section,
+	      struct cu_tu_set *    this_set)
+{
+  abbrev_attr *attr;
 
-  if ((do_loc || do_debug_loc || do_debug_ranges || do_debug_info)
-      && num_debug_info_entries == 0
-      && ! do_types)
+  for (attr = entry->first_attr;
+       attr && attr->attribute;
+       attr = attr->next)
     {
+      unsigned long form = attr->form;
+      const char *strng = NULL;
+      uint64_t uvalue;
 
-      /* Then allocate an array to hold the information.  */
-      debug_information = (debug_info *) cmalloc (num_units,
-						  sizeof (* debug_information));
-      if (debug_information == NULL)
+      if (attr->attribute != DW_AT_name)
 	{
-	  error (_("Not enough memory for a debug info array of %u entries\n"),
-		 num_units);
-	  alloc_num_debug_info_entries = num_debug_info_entries = 0;
-	  return false;
+	  data = skip_attribute (form, data, end, pointer_size,
+				 offset_size, dwarf_version);
+	  continue;
 	}
 
-      /* PR 17531: file: 92ca3797.
-	 We cannot rely upon the debug_information array being initialised
-	 before it is used.  A corrupt file could easily contain references
-	 to a unit for which information has not been made available.  So
-	 we ensure that the array is zeroed here.  */
-      memset (debug_information, 0, num_units * sizeof (*debug_information));
-
-      alloc_num_debug_info_entries = num_units;
-    }
-
-  if (!do_loc)
-    {
-      load_debug_section_with_follow (str, file);
-      load_debug_section_with_follow (line_str, file);
-      load_debug_section_with_follow (str_dwo, file);
-      load_debug_section_with_follow (str_index, file);
-      load_debug_section_with_follow (str_index_dwo, file);
-      load_debug_section_with_follow (debug_addr, file);
-    }
-
-  load_debug_section_with_follow (abbrev_sec, file);
-  load_debug_section_with_follow (loclists, file);
-  load_debug_section_with_follow (rnglists, file);
-  load_debug_section_with_follow (loclists_dwo, file);
-  load_debug_section_with_follow (rnglists_dwo, file);
-
-  if (debug_displays [abbrev_sec].section.start == NULL)
-    {
-      warn (_("Unable to locate %s section!\n"),
-	    debug_displays [abbrev_sec].section.uncompressed_name);
-      return false;
-    }
-
-  if (!do_loc && dwarf_start_die == 0)
-    introduce (section, false);
-
-  free_all_abbrevs ();
-
-  /* In order to be able to resolve DW_FORM_ref_addr forms we need
-     to load *all* of the abbrevs for all CUs in this .debug_info
-     section.  This does effectively mean that we (partially) read
-     every CU header twice.  */
-  for (section_begin = start; start < end;)
-    {
-      DWARF2_Internal_CompUnit compunit;
-      unsigned char *hdrptr;
-      uint64_t abbrev_base;
-      size_t abbrev_size;
-      uint64_t cu_offset;
-      unsigned int offset_size;
-      struct cu_tu_set *this_set;
-      unsigned char *end_cu;
-
-      hdrptr = start;
-      cu_offset = start - section_begin;
-
-      SAFE_BYTE_GET_AND_INC (compunit.cu_length, hdrptr, 4, end);
+      while (form == DW_FORM_indirect)
+	READ_ULEB (form, data, end);
 
-      if (compunit.cu_length == 0xffffffff)
+      switch (form)
 	{
-	  SAFE_BYTE_GET_AND_INC (compunit.cu_length, hdrptr, 8, end);
-	  offset_size = 8;
-	}
-      else
-	offset_size = 4;
-      end_cu = hdrptr + compunit.cu_length;
-
-      SAFE_BYTE_GET_AND_INC (compunit.cu_version, hdrptr, 2, end_cu);
+	case DW_FORM_string:
+	  if (strnlen ((char *) data, end - data) < (size_t) (end - data))
+	    strng = (const char *) data;
+	  break;
 
-      this_set = find_cu_tu_set_v2 (cu_offset, do_types);
+	case DW_FORM_strp:
+	  SAFE_BYTE_GET (uvalue, data, offset_size, end);
+	  strng = (const char *) fetch_indirect_string (uvalue);
+	  break;
 
-      if (compunit.cu_version < 5)
-	{
-	  compunit.cu_unit_type = DW_UT_compile;
-	  /* Initialize it due to a false compiler warning.  */
-	  compunit.cu_pointer_size = -1;
-	}
-      else
-	{
-	  SAFE_BYTE_GET_AND_INC (compunit.cu_unit_type, hdrptr, 1, end_cu);
-	  do_types = (compunit.cu_unit_type == DW_UT_type);
+	case DW_FORM_line_strp:
+	  SAFE_BYTE_GET (uvalue, data, offset_size, end);
+	  strng = (const char *) fetch_indirect_line_string (uvalue);
+	  break;
 
-	  SAFE_BYTE_GET_AND_INC (compunit.cu_pointer_size, hdrptr, 1, end_cu);
-	}
+	case DW_FORM_GNU_strp_alt:
+	  SAFE_BYTE_GET (uvalue, data, offset_size, end);
+	  strng = fetch_alt_indirect_string (uvalue);
+	  break;
 
-      SAFE_BYTE_GET_AND_INC (compunit.cu_abbrev_offset, hdrptr, offset_size,
-			     end_cu);
+	case DW_FORM_strx1:
+	case DW_FORM_strx2:
+	case DW_FORM_strx3:
+	case DW_FORM_strx4:
+	case DW_FORM_strx:
+	case DW_FORM_GNU_str_index:
+	  {
+	    const char *suffix = strrchr (section->name, '.');
+	    bool dwo = suffix && strcmp (suffix, ".dwo") == 0;
 
-      if (compunit.cu_unit_type == DW_UT_split_compile
-	  || compunit.cu_unit_type == DW_UT_skeleton)
-	{
-	  uint64_t dwo_id;
-	  SAFE_BYTE_GET_AND_INC (dwo_id, hdrptr, 8, end_cu);
-	}
+	    if (form == DW_FORM_strx || form == DW_FORM_GNU_str_index)
+	      READ_ULEB (uvalue, data, end);
+	    else
+	      SAFE_BYTE_GET (uvalue, data, form - DW_FORM_strx1 + 1, end);
+	    strng = fetch_indexed_string (uvalue, this_set, offset_size, dwo,
+					  debug_info_p
+					  ? debug_info_p->str_offsets_base : 0);
+	  }
+	  break;
 
-      if (this_set == NULL)
-	{
-	  abbrev_base = 0;
-	  abbrev_size = debug_displays [abbrev_sec].section.size;
-	}
-      else
-	{
-	  abbrev_base = this_set->section_offsets [DW_SECT_ABBREV];
-	  abbrev_size = this_set->section_sizes [DW_SECT_ABBREV];
+	default:
+	  break;
 	}
 
-      abbrev_list *list;
-      abbrev_list *free_list;
-      list = find_and_process_abbrev_set (&debug_displays[abbrev_sec].section,
-					  abbrev_base, abbrev_size,
-					  compunit.cu_abbrev_offset,
-					  &free_list);
-      start = end_cu;
-      if (list != NULL && list->first_abbrev != NULL)
-	record_abbrev_list_for_cu (cu_offset, start - section_begin,
-				   list, free_list);
-      else if (free_list != NULL)
-	free_abbrev_list (free_list);
+      return strng != NULL && strcmp (strng, name) == 0;
     }
 
-  for (start = section_begin, unit = 0; start < end; unit++)
-    {
+  return false;
+}
+
+/* Process the units of the section walked by W, starting with unit
+   number UNIT at START and stopping before unit number LIMIT.  Only
+   the units numbered from SHOW_FIRST up to, but not including,
+   SHOW_LIMIT are displayed.  Returns FALSE if a unit could not be
+   decoded.  */
+
+static bool
+process_debug_info_units (struct debug_info_walk *w,
+			  unsigned char *start,
+			  unsigned int unit,
+			  unsigned int limit,
+			  unsigned int show_first,
+			  unsigned int show_limit)
+{
+  struct dwarf_section *section = w->section;
+  enum dwarf_section_display_enum abbrev_sec = w->abbrev_sec;
+  unsigned char *section_begin = w->section_begin;
+  unsigned char *end = w->end;
+  bool do_types = w->do_types;
+
+  for (; start < end && unit < limit; unit++)
+    {
+      /* Units outside the range being shown are still decoded, so that
+	 the information the other displays need is recorded.  */
+      bool do_loc = w->do_loc || unit < show_first || unit >= show_limit;
       DWARF2_Internal_CompUnit compunit;
       unsigned char *hdrptr;
       unsigned char *tags;
-      int level, last_level, saved_level;
+      int level, last_level, saved_level, match_level;
       uint64_t cu_offset;
       unsigned int offset_size;
       uint64_t signature = 0;
@@ -4008,7 +3941,7 @@ process_debug_info (struct dwarf_section * section,
 	  continue;
 	}
 
-      if ((do_loc || do_debug_loc || do_debug_ranges || do_debug_info)
+      if ((w->do_loc || do_debug_loc || do_debug_ranges || do_debug_info)
 	  && num_debug_info_entries == 0
 	  && alloc_num_debug_info_entries > unit
 	  && ! do_types)
@@ -4097,6 +4030,7 @@ process_debug_info (struct dwarf_section * section,
       level = 0;
       last_level = level;
       saved_level = -1;
+      match_level = -1;
       while (tags < start)
 	{
 	  unsigned long abbrev_number;
@@ -4127,7 +4061,9 @@ process_debug_info (struct dwarf_section * section,
 
 	      if (!do_loc && die_offset >= dwarf_start_die
 		  && (dwarf_cutoff_level == -1
-		      || level < dwarf_cutoff_level))
+		      || level < dwarf_cutoff_level)
+		  && (dwarf_die_name == NULL
+		      || (match_level != -1 && level > match_level)))
 		printf (_(" <%d><%lx>: Abbrev Number: 0\n"),
 			level, die_offset);
 
@@ -4149,14 +4085,43 @@ process_debug_info (struct dwarf_section * section,
 		{
 		  if (list != NULL)
 		    free_abbrev_list (list);
+		  w->stopped = true;
 		  return true;
 		}
 	      continue;
 	    }
 
+	  /* Scan through the abbreviation list until we reach the
+	     correct entry.  */
+	  entry = NULL;
+	  if (list != NULL)
+	    for (entry = list->first_abbrev; entry != NULL; entry = entry->next)
+	      if (entry->number == abbrev_number)
+		break;
+
+	  /* With DWARF_DIE_NAME only the DIEs of that name are displayed,
+	     together with their children.  MATCH_LEVEL is the level of the
+	     named DIE being displayed, or -1.  */
+	  if (!do_loc && dwarf_die_name != NULL)
+	    {
+	      if (match_level >= level)
+		match_level = -1;
+	      if (match_level == -1
+		  && entry != NULL
+		  && die_has_name (entry, tags, start, dwarf_die_name,
+				   compunit.cu_pointer_size, offset_size,
+				   compunit.cu_version,
+				   (debug_information
+				    && unit < alloc_num_debug_info_entries)
+				   ? debug_information + unit : NULL,
+				   section, this_set))
+		match_level = level;
+	    }
+
 	  if (!do_loc)
 	    {
-	      if (dwarf_start_die != 0 && die_offset < dwarf_start_die)
+	      if ((dwarf_start_die != 0 && die_offset < dwarf_start_die)
+		  || (dwarf_die_name != NULL && match_level == -1))
 		do_printing = 0;
 	      else
 		{
@@ -4174,14 +4139,6 @@ process_debug_info (struct dwarf_section * section,
 		}
 	    }
 
-	  /* Scan through the abbreviation list until we reach the
-	     correct entry.  */
-	  entry = NULL;
-	  if (list != NULL)
-	    for (entry = list->first_abbrev; entry != NULL; entry = entry->next)
-	      if (entry->number == abbrev_number)
-		break;
-
 	  if (entry == NULL)
 	    {
 	      if (!do_loc && do_printing)
@@ -4207,7 +4164,7 @@ process_debug_info (struct dwarf_section * section,
 	    case DW_TAG_compile_unit:
 	    case DW_TAG_skeleton_unit:
 	      need_base_address = 1;
-	      need_dwo_info = do_loc;
+	      need_dwo_info = w->do_loc;
 	      break;
 	    case DW_TAG_entry_point:
 	      need_base_address = 0;
@@ -4315,6 +4272,434 @@ process_debug_info (struct dwarf_section * section,
 	free_abbrev_list (list);
     }
 
+  w->do_types = do_types;
+  return true;
+}
+
+#ifdef HAVE_SYS_WAIT_H
+
+/* Display the NUM_UNITS units of the section walked by W using up to
+   DWARF_JOBS processes.  The section is split at unit boundaries into
+   runs of roughly equal size.  Each run but the first is displayed by
+   a child process into temporary files, which are copied to stdout
+   and stderr in order once the runs before them have been output.
+   Meanwhile this process displays the first run and then decodes the
+   others without displaying them, so that the information recorded
+   about every unit is available to the displays of other sections.
+   A run whose child fails is displayed here instead.  */
+
+static bool
+process_debug_info_in_parallel (struct debug_info_walk *w,
+				unsigned int num_units)
+{
+  struct debug_info_run
+  {
+    unsigned char *start;
+    unsigned int unit;
+    bool do_types;
+    pid_t pid;
+    FILE *out;
+    FILE *err;
+    int result_fd;
+  } *runs;
+  unsigned int jobs = MIN (dwarf_jobs, num_units);
+  size_t run_size = (w->end - w->section_begin + jobs - 1) / jobs;
+  unsigned char *start;
+  bool do_types = w->do_types;
+  bool shown, loaded;
+  unsigned int unit;
+  unsigned int i;
+
+  runs = (struct debug_info_run *) xmalloc ((jobs + 1) * sizeof (*runs));
+  runs[0].start = w->section_begin;
+  runs[0].unit = 0;
+  runs[0].do_types = do_types;
+
+  /* The unit lengths have already been checked by our caller.  */
+  for (start = w->section_begin, unit = 0, i = 1;
+       start < w->end && unit < num_units && i < jobs;
+       unit++)
+    {
+      unsigned char *hdrptr = start;
+      uint64_t length;
+      unsigned int version;
+
+      SAFE_BYTE_GET_AND_INC (length, hdrptr, 4, w->end);
+      if (length == 0xffffffff)
+	SAFE_BYTE_GET_AND_INC (length, hdrptr, 8, w->end);
+      start = hdrptr + length;
+
+      SAFE_BYTE_GET_AND_INC (version, hdrptr, 2, start);
+      if (version >= 5)
+	{
+	  unsigned int unit_type;
+
+	  SAFE_BYTE_GET (unit_type, hdrptr, 1, start);
+	  do_types = unit_type == DW_UT_type;
+	}
+
+      if (start < w->end
+	  && (size_t) (start - w->section_begin) >= i * run_size)
+	{
+	  runs[i].start = start;
+	  runs[i].unit = unit + 1;
+	  runs[i].do_types = do_types;
+	  i++;
+	}
+    }
+  jobs = i;
+  runs[jobs].start = w->end;
+  runs[jobs].unit = num_units;
+
+  fflush (stdout);
+  for (i = 1; i < jobs; i++)
+    {
+      int fds[2];
+
+      runs[i].pid = -1;
+      runs[i].out = tmpfile ();
+      runs[i].err = runs[i].out != NULL ? tmpfile () : NULL;
+      if (runs[i].err == NULL || pipe (fds) != 0)
+	{
+	  if (runs[i].out != NULL)
+	    fclose (runs[i].out);
+	  if (runs[i].err != NULL)
+	    fclose (runs[i].err);
+	  runs[i].out = runs[i].err = NULL;
+	  continue;
+	}
+
+      runs[i].pid = fork ();
+      if (runs[i].pid == 0)
+	{
+	  char result;
+
+	  close (fds[0]);
+	  if (dup2 (fileno (runs[i].out), fileno (stdout)) < 0
+	      || dup2 (fileno (runs[i].err), fileno (stderr)) < 0)
+	    _exit (1);
+	  w->do_types = runs[i].do_types;
+	  result = process_debug_info_units (w, runs[i].start, runs[i].unit,
+					     runs[i + 1].unit, runs[i].unit,
+					     runs[i + 1].unit);
+	  if (fflush (stdout) != 0
+	      || write (fds[1], &result, sizeof (result)) != sizeof (result))
+	    _exit (1);
+	  _exit (0);
+	}
+
+      close (fds[1]);
+      runs[i].result_fd = fds[0];
+      if (runs[i].pid < 0)
+	{
+	  close (runs[i].result_fd);
+	  fclose (runs[i].out);
+	  fclose (runs[i].err);
+	  runs[i].out = runs[i].err = NULL;
+	}
+    }
+
+  shown = process_debug_info_units (w, runs[0].start, 0, runs[1].unit,
+				    0, runs[1].unit);
+  loaded = shown;
+  if (shown && jobs > 1)
+    {
+      /* Problems with the other runs are reported by their children.  */
+      int null_fd = open ("/dev/null", O_WRONLY);
+      int stderr_fd = dup (fileno (stderr));
+      bool quiet = (null_fd >= 0 && stderr_fd >= 0
+		    && dup2 (null_fd, fileno (stderr)) >= 0);
+
+      loaded = process_debug_info_units (w, runs[1].start, runs[1].unit,
+					 num_units, 0, 0);
+      if (quiet)
+	dup2 (stderr_fd, fileno (stderr));
+      if (null_fd >= 0)
+	close (null_fd);
+      if (stderr_fd >= 0)
+	close (stderr_fd);
+    }
+  do_types = w->do_types;
+
+  for (i = 1; i < jobs; i++)
+    {
+      char result = 0;
+      bool done = false;
+
+      if (runs[i].pid > 0)
+	{
+	  int status;
+
+	  if (read (runs[i].result_fd, &result, sizeof (result))
+	      == sizeof (result))
+	    done = true;
+	  close (runs[i].result_fd);
+	  if (waitpid (runs[i].pid, &status, 0) != runs[i].pid
+	      || !WIFEXITED (status)
+	      || WEXITSTATUS (status) != 0)
+	    done = false;
+	}
+
+      if (!shown)
+	;
+      else if (done)
+	{
+	  char buf[8192];
+	  size_t n;
+
+	  rewind (runs[i].out);
+	  while ((n = fread (buf, 1, sizeof (buf), runs[i].out)) > 0)
+	    fwrite (buf, 1, n, stdout);
+	  fflush (stdout);
+	  rewind (runs[i].err);
+	  while ((n = fread (buf, 1, sizeof (buf), runs[i].err)) > 0)
+	    fwrite (buf, 1, n, stderr);
+	  shown = result;
+	}
+      else
+	{
+	  w->do_types = runs[i].do_types;
+	  shown = process_debug_info_units (w, runs[i].start, runs[i].unit,
+					    runs[i + 1].unit, runs[i].unit,
+					    runs[i + 1].unit);
+	}
+
+      if (runs[i].out != NULL)
+	{
+	  fclose (runs[i].out);
+	  fclose (runs[i].err);
+	}
+    }
+
+  free (runs);
+  w->do_types = do_types;
+  return shown && loaded;
+}
+
+#endif /* HAVE_SYS_WAIT_H */
+
+/* Process the contents of a .debug_info section.
+   If do_loc is TRUE then we are scanning for location lists and dwo tags
+   and we do not want to display anything to the user.
+   If do_types is TRUE, we are processing a .debug_types section instead of
+   a .debug_info section.
+   The information displayed is restricted by the values in DWARF_START_DIE,
+   DWARF_CUTOFF_LEVEL and DWARF_DIE_NAME.  If DWARF_JOBS is more than one,
+   the units are displayed by that many processes.
+   Returns TRUE upon success.  Otherwise an error or warning message is
+   printed and FALSE is returned.  */
+
+static bool
+process_debug_info (struct dwarf_section * section,
+		    void *file,
+		    enum dwarf_section_display_enum abbrev_sec,
+		    bool do_loc,
+		    bool do_types)
+{
+  unsigned char *start = section->start;
+  unsigned char *end = start + section->size;
+  unsigned char *section_begin;
+  unsigned int num_units = 0;
+  struct debug_info_walk walk;
+  bool ok;
+
+  /* First scan the section to get the number of comp units.
+     Length sanity checks are done here.  */
+  for (section_begin = start, num_units = 0; section_begin < end;
+       num_units ++)
+    {
+      uint64_t length;
+
+      /* Read the first 4 bytes.  For a 32-bit DWARF section, this
+	 will be the length.  For a 64-bit DWARF section, it'll be
+	 the escape code 0xffffffff followed by an 8 byte length.  */
+      SAFE_BYTE_GET_AND_INC (length, section_begin, 4, end);
+
+      if (length == 0xffffffff)
+	SAFE_BYTE_GET_AND_INC (length, section_begin, 8, end);
+      else if (length >= 0xfffffff0 && length < 0xffffffff)
+	{
+	  warn (_("Reserved length value (%#" PRIx64 ") found in section %s\n"),
+		length, section->name);
+	  return false;
+	}
+
+      /* Negative values are illegal, they may even cause infinite
+	 looping.  This can happen if we can't accurately apply
+	 relocations to an object file, or if the file is corrupt.  */
+      if (length > (size_t) (end - section_begin))
+	{
+	  warn (_("Corrupt unit length (got %#" PRIx64
+		  " expected at most %#tx) in section %s\n"),
+		length, end - section_begin, section->name);
+	  return false;
+	}
+      section_begin += length;
+    }
+
+  if (num_units == 0)
+    {
+      error (_("No comp units in %s section ?\n"), section->name);
+      return false;
+    }
+
+  if ((do_loc || do_debug_loc || do_debug_ranges || do_debug_info)
+      && num_debug_info_entries == 0
+      && ! do_types)
+    {
+
+      /* Then allocate an array to hold the information.  */
+      debug_information = (debug_info *) cmalloc (num_units,
+						  sizeof (* debug_information));
+      if (debug_information == NULL)
+	{
+	  error (_("Not enough memory for a debug info array of %u entries\n"),
+		 num_units);
+	  alloc_num_debug_info_entries = num_debug_info_entries = 0;
+	  return false;
+	}
+
+      /* PR 17531: file: 92ca3797.
+	 We cannot rely upon the debug_information array being initialised
+	 before it is used.  A corrupt file could easily contain references
+	 to a unit for which information has not been made available.  So
+	 we ensure that the array is zeroed here.  */
+      memset (debug_information, 0, num_units * sizeof (*debug_information));
+
+      alloc_num_debug_info_entries = num_units;
+    }
+
+  if (!do_loc)
+    {
+      load_debug_section_with_follow (str, file);
+      load_debug_section_with_follow (line_str, file);
+      load_debug_section_with_follow (str_dwo, file);
+      load_debug_section_with_follow (str_index, file);
+      load_debug_section_with_follow (str_index_dwo, file);
+      load_debug_section_with_follow (debug_addr, file);
+    }
+
+  load_debug_section_with_follow (abbrev_sec, file);
+  load_debug_section_with_follow (loclists, file);
+  load_debug_section_with_follow (rnglists, file);
+  load_debug_section_with_follow (loclists_dwo, file);
+  load_debug_section_with_follow (rnglists_dwo, file);
+
+  if (debug_displays [abbrev_sec].section.start == NULL)
+    {
+      warn (_("Unable to locate %s section!\n"),
+	    debug_displays [abbrev_sec].section.uncompressed_name);
+      return false;
+    }
+
+  if (!do_loc && dwarf_start_die == 0)
+    introduce (section, false);
+
+  free_all_abbrevs ();
+
+  /* In order to be able to resolve DW_FORM_ref_addr forms we need
+     to load *all* of the abbrevs for all CUs in this .debug_info
+     section.  This does effectively mean that we (partially) read
+     every CU header twice.  */
+  for (section_begin = start; start < end;)
+    {
+      DWARF2_Internal_CompUnit compunit;
+      unsigned char *hdrptr;
+      uint64_t abbrev_base;
+      size_t abbrev_size;
+      uint64_t cu_offset;
+      unsigned int offset_size;
+      struct cu_tu_set *this_set;
+      unsigned char *end_cu;
+
+      hdrptr = start;
+      cu_offset = start - section_begin;
+
+      SAFE_BYTE_GET_AND_INC (compunit.cu_length, hdrptr, 4, end);
+
+      if (compunit.cu_length == 0xffffffff)
+	{
+	  SAFE_BYTE_GET_AND_INC (compunit.cu_length, hdrptr, 8, end);
+	  offset_size = 8;
+	}
+      else
+	offset_size = 4;
+      end_cu = hdrptr + compunit.cu_length;
+
+      SAFE_BYTE_GET_AND_INC (compunit.cu_version, hdrptr, 2, end_cu);
+
+      this_set = find_cu_tu_set_v2 (cu_offset, do_types);
+
+      if (compunit.cu_version < 5)
+	{
+	  compunit.cu_unit_type = DW_UT_compile;
+	  /* Initialize it due to a false compiler warning.  */
+	  compunit.cu_pointer_size = -1;
+	}
+      else
+	{
+	  SAFE_BYTE_GET_AND_INC (compunit.cu_unit_type, hdrptr, 1, end_cu);
+	  do_types = (compunit.cu_unit_type == DW_UT_type);
+
+	  SAFE_BYTE_GET_AND_INC (compunit.cu_pointer_size, hdrptr, 1, end_cu);
+	}
+
+      SAFE_BYTE_GET_AND_INC (compunit.cu_abbrev_offset, hdrptr, offset_size,
+			     end_cu);
+
+      if (compunit.cu_unit_type == DW_UT_split_compile
+	  || compunit.cu_unit_type == DW_UT_skeleton)
+	{
+	  uint64_t dwo_id;
+	  SAFE_BYTE_GET_AND_INC (dwo_id, hdrptr, 8, end_cu);
+	}
+
+      if (this_set == NULL)
+	{
+	  abbrev_base = 0;
+	  abbrev_size = debug_displays [abbrev_sec].section.size;
+	}
+      else
+	{
+	  abbrev_base = this_set->section_offsets [DW_SECT_ABBREV];
+	  abbrev_size = this_set->section_sizes [DW_SECT_ABBREV];
+	}
+
+      abbrev_list *list;
+      abbrev_list *free_list;
+      list = find_and_process_abbrev_set (&debug_displays[abbrev_sec].section,
+					  abbrev_base, abbrev_size,
+					  compunit.cu_abbrev_offset,
+					  &free_list);
+      start = end_cu;
+      if (list != NULL && list->first_abbrev != NULL)
+	record_abbrev_list_for_cu (cu_offset, start - section_begin,
+				   list, free_list);
+      else if (free_list != NULL)
+	free_abbrev_list (free_list);
+    }
+
+  walk.section = section;
+  walk.abbrev_sec = abbrev_sec;
+  walk.section_begin = section_begin;
+  walk.end = end;
+  walk.do_loc = do_loc;
+  walk.do_types = do_types;
+  walk.stopped = false;
+
+#ifdef HAVE_SYS_WAIT_H
+  if (!do_loc && dwarf_jobs > 1 && dwarf_start_die == 0 && num_units > 1)
+    ok = process_debug_info_in_parallel (&walk, num_units);
+  else
+#endif
+    ok = process_debug_info_units (&walk, section_begin, 0, num_units,
+				   0, num_units);
+  if (!ok)
+    return false;
+  if (walk.stopped)
+    return true;
+  do_types = walk.do_types;
+
   /* Set num_debug_info_entries here so that it can be used to check if
      we need to process .debug_loc and .debug_ranges sections.  */
   if ((do_loc || do_debug_loc || do_debug_ranges || do_debug_info)
@@ -236,6 +236,8 @@ extern bool do_checks;
 
 extern int dwarf_cutoff_level;
 extern unsigned long dwarf_start_die;
+extern const char *dwarf_die_name;
+extern unsigned int dwarf_jobs;
 
 extern int dwarf_check;
 
@@ -233,7 +233,8 @@ static enum
   compress_gnu_zlib = compress | 1 << 2,
   compress_gabi_zlib = compress | 1 << 3,
   compress_zstd = compress | 1 << 4,
-  decompress = 1 << 5
+  decompress = 1 << 5,
+  compress_zstd_chunked = compress | 1 << 6
 } do_debug_sections = nothing;
 
 /* Whether to generate ELF common symbols with the STT_COMMON type.  */
@@ -688,7 +689,7 @@ copy_usage (FILE *stream, int exit_status)
                                    <commit>\n\
      --subsystem <name>[:<version>]\n\
                                    Set PE subsystem to <name> [& <version>]\n\
-     --compress-debug-sections[={none|zlib|zlib-gnu|zlib-gabi|zstd}]\n\
+     --compress-debug-sections[={none|zlib|zlib-gnu|zlib-gabi|zstd|zstd-chunked}]\n\
 				   Compress DWARF debug sections\n\
      --decompress-debug-sections   Decompress DWARF debug sections using zlib\n\
      --elf-stt-common=[yes|no]     Generate ELF common symbols with STT_COMMON\n\
@@ -2737,7 +2738,7 @@ copy_object (bfd *ibfd, bfd *obfd, const bfd_arch_info_type *input_arch)
 	  && do_debug_sections != compress)
 	{
 	  non_fatal (_ ("--compress-debug-sections=[zlib|zlib-gnu|zlib-gabi|"
-			"zstd] is unsupported on `%s'"),
+			"zstd|zstd-chunked] is unsupported on `%s'"),
 		     bfd_get_archive_filename (ibfd));
 	  return false;
 	}
@@ -3892,6 +3893,14 @@ copy_file (const char *input_filename, const char *output_filename, int ofd,
 #ifndef HAVE_ZSTD
       fatal (_ ("--compress-debug-sections=zstd: binutils is not built with "
 		"zstd support"));
+#endif
+      break;
+    case compress_zstd_chunked:
+      ibfd->flags |= (BFD_COMPRESS | BFD_COMPRESS_GABI | BFD_COMPRESS_ZSTD
+		      | BFD_COMPRESS_CHUNKED);
+#ifndef HAVE_ZSTD
+      fatal (_ ("--compress-debug-sections=zstd-chunked: binutils is not "
+		"built with zstd support"));
 #endif
       break;
     case decompress:
@@ -5585,6 +5594,8 @@ copy_main (int argc, char *argv[])
 		do_debug_sections = compress_gabi_zlib;
 	      else if (strcasecmp (optarg, "zstd") == 0)
 		do_debug_sections = compress_zstd;
+	      else if (strcasecmp (optarg, "zstd-chunked") == 0)
+		do_debug_sections = compress_zstd_chunked;
 	      else
 		fatal (_("unrecognized --compress-debug-sections type `%s'"),
 		       optarg);
@@ -72,6 +72,12 @@
 #include <sys/mman.h>
 #endif
 
+/* Sections are disassembled by several processes, with
+   --disassembler-jobs, where fork and waitpid are available.  */
+#ifdef HAVE_SYS_WAIT_H
+#include <sys/wait.h>
+#endif
+
 #ifdef HAVE_LIBDEBUGINFOD
 #include <elfutils/debuginfod.h>
 #endif
@@ -117,6 +123,7 @@ static int disassemble_zeroes;		/* --disassemble-zeroes */
 static bool formats_info;		/* -i */
 int wide_output;			/* -w */
 static int insn_width;			/* --insn-width */
+static unsigned int disassembler_jobs = 1; /* --disassembler-jobs */
 static bfd_vma start_address = (bfd_vma) -1; /* --start-address */
 static bfd_vma stop_address = (bfd_vma) -1;  /* --stop-address */
 static int dump_debugging;		/* --debugging */
@@ -400,6 +407,8 @@ usage (FILE *stream, int status)
       fprintf (stream, _("\
       --insn-width=WIDTH         Display WIDTH bytes on a single line for -d\n"));
       fprintf (stream, _("\
+      --disassembler-jobs=JOBS   Disassemble large sections using JOBS processes\n"));
+      fprintf (stream, _("\
       --adjust-vma=OFFSET        Add OFFSET to all displayed section addresses\n"));
       fprintf (stream, _("\
       --show-all-symbols         When disassembling, display all symbols at a given address\n"));
@@ -488,7 +497,8 @@ enum option_values
 #endif
     OPTION_SFRAME,
     OPTION_VISUALIZE_JUMPS,
-    OPTION_DISASSEMBLER_COLOR
+    OPTION_DISASSEMBLER_COLOR,
+    OPTION_DISASSEMBLER_JOBS
   };
 
 static struct option long_options[]=
@@ -558,6 +568,7 @@ static struct option long_options[]=
   {"visualize-jumps", optional_argument, 0, OPTION_VISUALIZE_JUMPS},
   {"wide", no_argument, NULL, 'w'},
   {"disassembler-color", required_argument, NULL, OPTION_DISASSEMBLER_COLOR},
+  {"disassembler-jobs", required_argument, NULL, OPTION_DISASSEMBLER_JOBS},
   {NULL, no_argument, NULL, 0}
 };
 
@@ -3679,188 +3690,104 @@ disassemble_bytes (struct disassemble_info *inf,
   free (color_buffer);
 }
 
-static void
-disassemble_section (bfd *abfd, asection *section, void *inf)
-{
-  const struct elf_backend_data *bed;
-  bfd_vma sign_adjust = 0;
-  struct disassemble_info *pinfo = (struct disassemble_info *) inf;
-  struct objdump_disasm_info *paux;
-  unsigned int opb = pinfo->octets_per_byte;
-  bfd_byte *data = NULL;
-  bfd_size_type datasize = 0;
-  arelent **rel_pp = NULL;
-  arelent **rel_ppstart = NULL;
-  arelent **rel_ppend;
-  bfd_vma stop_offset;
-  asymbol *sym = NULL;
-  long place = 0;
-  long rel_count;
-  bfd_vma rel_offset;
-  unsigned long addr_offset;
-  bool do_print;
-  enum loop_control
-  {
-   stop_offset_reached,
-   function_sym,
-   next_sym
-  } loop_until;
-
-  if (only_list == NULL)
-    {
-      /* Sections that do not contain machine
-	 code are not normally disassembled.  */
-      if ((section->flags & SEC_HAS_CONTENTS) == 0)
-	return;
-
-      if (! disassemble_all
-	  && (section->flags & SEC_CODE) == 0)
-	return;
-    }
-  else if (!process_section_p (section))
-    return;
-
-  datasize = bfd_section_size (section);
-  if (datasize == 0)
-    return;
-
-  if (start_address == (bfd_vma) -1
-      || start_address < section->vma)
-    addr_offset = 0;
-  else
-    addr_offset = start_address - section->vma;
+/* How the walk over the symbols of a section knows when to stop
+   displaying, when disassembling from a specific symbol.  */
 
-  if (stop_address == (bfd_vma) -1)
-    stop_offset = datasize / opb;
-  else
-    {
-      if (stop_address < section->vma)
-	stop_offset = 0;
-      else
-	stop_offset = stop_address - section->vma;
-      if (stop_offset > datasize / opb)
-	stop_offset = datasize / opb;
-    }
-
-  if (addr_offset >= stop_offset)
-    return;
-
-  /* Decide which set of relocs to use.  Load them if necessary.  */
-  paux = (struct objdump_disasm_info *) pinfo->application_data;
-  if (pinfo->dynrelbuf && dump_dynamic_reloc_info)
-    {
-      rel_pp = pinfo->dynrelbuf;
-      rel_count = pinfo->dynrelcount;
-      /* Dynamic reloc addresses are absolute, non-dynamic are section
-	 relative.  REL_OFFSET specifies the reloc address corresponding
-	 to the start of this section.  */
-      rel_offset = section->vma;
-    }
-  else
-    {
-      rel_count = 0;
-      rel_pp = NULL;
-      rel_offset = 0;
-
-      if ((section->flags & SEC_RELOC) != 0
-	  && (dump_reloc_info || pinfo->disassembler_needs_relocs))
-	{
-	  long relsize;
+enum loop_control
+{
+  stop_offset_reached,
+  function_sym,
+  next_sym
+};
 
-	  relsize = bfd_get_reloc_upper_bound (abfd, section);
-	  if (relsize < 0)
-	    my_bfd_nonfatal (bfd_get_filename (abfd));
+/* Where disassemble_section is in its walk over a section, from one
+   region between symbols to the next.  */
 
-	  if (relsize > 0)
-	    {
-	      rel_pp = (arelent **) xmalloc (relsize);
-	      rel_count = bfd_canonicalize_reloc (abfd, section, rel_pp, syms);
-	      if (rel_count < 0)
-		{
-		  my_bfd_nonfatal (bfd_get_filename (abfd));
-		  free (rel_pp);
-		  rel_pp = NULL;
-		  rel_count = 0;
-		}
-	      else if (rel_count > 1)
-		/* Sort the relocs by address.  */
-		qsort (rel_pp, rel_count, sizeof (arelent *), compare_relocs);
-	      rel_ppstart = rel_pp;
-	    }
-	}
-    }
-  rel_ppend = PTR_ADD (rel_pp, rel_count);
-
-  if (!bfd_malloc_and_get_section (abfd, section, &data))
-    {
-      non_fatal (_("Reading section %s failed because: %s"),
-		 section->name, bfd_errmsg (bfd_get_error ()));
-      return;
-    }
+struct disasm_walk
+{
+  /* The section, its contents and its relocs.  */
+  bfd *abfd;
+  asection *section;
+  bfd_byte *data;
+  bfd_vma sign_adjust;
+  bfd_vma rel_offset;
+  arelent **rel_ppend;
 
-  pinfo->buffer = data;
-  pinfo->buffer_vma = section->vma;
-  pinfo->buffer_length = datasize;
-  pinfo->section = section;
+  /* The start of the next region, and the end of the last one.  */
+  bfd_vma addr_offset;
+  bfd_vma stop_offset;
 
-  /* Sort the symbols into value and section order.  */
-  compare_section = section;
-  if (sorted_symcount > 1)
-    qsort (sorted_syms, sorted_symcount, sizeof (asymbol *), compare_symbols);
+  /* The symbol of the next region, and its place in sorted_syms.  */
+  asymbol *sym;
+  long place;
 
-  /* Skip over the relocs belonging to addresses below the
-     start address.  */
-  while (rel_pp < rel_ppend
-	 && (*rel_pp)->address < rel_offset + addr_offset)
-    ++rel_pp;
+  /* The next reloc to display.  */
+  arelent **rel_pp;
 
-  printf (_("\nDisassembly of section %s:\n"), sanitize_string (section->name));
+  /* The reloc to start with in the first region displayed, or NULL to
+     start with the first one at its address.  Set to the one used.  */
+  arelent **first_rel_pp;
 
-  /* Find the nearest symbol forwards from our current position.  */
-  paux->require_sec = true;
-  sym = (asymbol *) find_symbol_for_address (section->vma + addr_offset,
-					     (struct disassemble_info *) inf,
-					     &place);
-  paux->require_sec = false;
+  bool do_print;
+  enum loop_control loop_until;
+};
 
-  /* PR 9774: If the target used signed addresses then we must make
-     sure that we sign extend the value that we calculate for 'addr'
-     in the loop below.  */
-  if (bfd_get_flavour (abfd) == bfd_target_elf_flavour
-      && (bed = get_elf_backend_data (abfd)) != NULL
-      && bed->sign_extend_vma)
-    sign_adjust = (bfd_vma) 1 << (bed->s->arch_size - 1);
+/* Disassemble the regions between the symbols of W's section, starting
+   with the one at W->addr_offset.  Only the regions starting in
+   [EMIT_START, EMIT_STOP) are displayed; the walk over those before
+   them only keeps track of the symbols.  Returns whether any region
+   was displayed.  */
 
-  /* Disassemble a block of instructions up to the address associated with
-     the symbol we have just found.  Then print the symbol and find the
-     next symbol on.  Repeat until we have disassembled the entire section
-     or we have reached the end of the address range we are interested in.  */
-  do_print = paux->symbol == NULL;
-  loop_until = stop_offset_reached;
+static bool
+disassemble_regions (struct disassemble_info *pinfo, struct disasm_walk *w,
+		     bfd_vma emit_start, bfd_vma emit_stop)
+{
+  struct objdump_disasm_info *paux
+    = (struct objdump_disasm_info *) pinfo->application_data;
+  bfd *abfd = w->abfd;
+  asection *section = w->section;
+  bool emitted = false;
 
-  while (addr_offset < stop_offset)
+  while (w->addr_offset < w->stop_offset && w->addr_offset < emit_stop)
     {
       bfd_vma addr;
       asymbol *nextsym;
       bfd_vma nextstop_offset;
       bool insns;
+      bool emit;
+
+      addr = section->vma + w->addr_offset;
+      addr = (((addr & ((w->sign_adjust << 1) - 1)) ^ w->sign_adjust)
+	      - w->sign_adjust);
 
-      addr = section->vma + addr_offset;
-      addr = ((addr & ((sign_adjust << 1) - 1)) ^ sign_adjust) - sign_adjust;
+      emit = w->addr_offset >= emit_start;
+      if (emit && !emitted)
+	{
+	  /* Start with the relocs the regions before would have
+	     left.  */
+	  if (w->first_rel_pp != NULL)
+	    w->rel_pp = w->first_rel_pp;
+	  else
+	    while (w->rel_pp < w->rel_ppend
+		   && (*w->rel_pp)->address < w->rel_offset + w->addr_offset)
+	      ++w->rel_pp;
+	  w->first_rel_pp = w->rel_pp;
+	  emitted = true;
+	}
 
-      if (sym != NULL && bfd_asymbol_value (sym) <= addr)
+      if (w->sym != NULL && bfd_asymbol_value (w->sym) <= addr)
 	{
 	  int x;
 
-	  for (x = place;
+	  for (x = w->place;
 	       (x < sorted_symcount
 		&& (bfd_asymbol_value (sorted_syms[x]) <= addr));
 	       ++x)
 	    continue;
 
-	  pinfo->symbols = sorted_syms + place;
-	  pinfo->num_symbols = x - place;
-	  pinfo->symtab_pos = place;
+	  pinfo->symbols = sorted_syms + w->place;
+	  pinfo->num_symbols = x - w->place;
+	  pinfo->symtab_pos = w->place;
 	}
       else
 	{
@@ -3871,16 +3798,16 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
 
       /* If we are only disassembling from a specific symbol,
 	 check to see if we should start or stop displaying.  */
-      if (sym && paux->symbol)
+      if (w->sym && paux->symbol)
 	{
-	  if (do_print)
+	  if (w->do_print)
 	    {
 	      /* See if we should stop printing.  */
-	      switch (loop_until)
+	      switch (w->loop_until)
 		{
 		case function_sym:
-		  if (sym->flags & BSF_FUNCTION)
-		    do_print = false;
+		  if (w->sym->flags & BSF_FUNCTION)
+		    w->do_print = false;
 		  break;
 
 		case stop_offset_reached:
@@ -3891,14 +3818,14 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
 		  /* FIXME: There is an implicit assumption here
 		     that the name of sym is different from
 		     paux->symbol.  */
-		  if (! bfd_is_local_label (abfd, sym))
-		    do_print = false;
+		  if (! bfd_is_local_label (abfd, w->sym))
+		    w->do_print = false;
 		  break;
 		}
 	    }
 	  else
 	    {
-	      const char * name = bfd_asymbol_name (sym);
+	      const char * name = bfd_asymbol_name (w->sym);
 	      char * alloc = NULL;
 
 	      if (do_demangle && name[0] != '\0')
@@ -3913,38 +3840,39 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
 		 if the current symbol matches the requested symbol.  */
 	      if (streq (name, paux->symbol))
 		{
-		  do_print = true;
+		  w->do_print = true;
 
 		  /* Skip over the relocs belonging to addresses below the
 		     symbol address.  */
-		  const bfd_vma sym_offset = bfd_asymbol_value (sym) - section->vma;
-		  while (rel_pp < rel_ppend &&
-		   (*rel_pp)->address - rel_offset < sym_offset)
-			  ++rel_pp;
+		  const bfd_vma sym_offset
+		    = bfd_asymbol_value (w->sym) - section->vma;
+		  while (w->rel_pp < w->rel_ppend &&
+		   (*w->rel_pp)->address - w->rel_offset < sym_offset)
+			  ++w->rel_pp;
 
-		  if (sym->flags & BSF_FUNCTION)
+		  if (w->sym->flags & BSF_FUNCTION)
 		    {
 		      if (bfd_get_flavour (abfd) == bfd_target_elf_flavour
-			  && ((elf_symbol_type *) sym)->internal_elf_sym.st_size > 0)
+			  && ((elf_symbol_type *) w->sym)->internal_elf_sym.st_size > 0)
 			{
 			  /* Sym is a function symbol with a size associated
 			     with it.  Turn on automatic disassembly for the
 			     next VALUE bytes.  */
-			  stop_offset = addr_offset
-			    + ((elf_symbol_type *) sym)->internal_elf_sym.st_size;
-			  loop_until = stop_offset_reached;
+			  w->stop_offset = w->addr_offset
+			    + ((elf_symbol_type *) w->sym)->internal_elf_sym.st_size;
+			  w->loop_until = stop_offset_reached;
 			}
 		      else
 			{
 			  /* Otherwise we need to tell the loop heuristic to
 			     loop until the next function symbol is encountered.  */
-			  loop_until = function_sym;
+			  w->loop_until = function_sym;
 			}
 		    }
 		  else
 		    {
 		      /* Otherwise loop until the next symbol is encountered.  */
-		      loop_until = next_sym;
+		      w->loop_until = next_sym;
 		    }
 		}
 
@@ -3952,116 +3880,123 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
 	    }
 	}
 
-      if (! prefix_addresses && do_print)
+      if (! prefix_addresses && w->do_print)
 	{
-	  pinfo->fprintf_func (pinfo->stream, "\n");
-	  objdump_print_addr_with_sym (abfd, section, sym, addr,
-				       pinfo, false);
-	  pinfo->fprintf_func (pinfo->stream, ":\n");
+	  if (emit)
+	    {
+	      pinfo->fprintf_func (pinfo->stream, "\n");
+	      objdump_print_addr_with_sym (abfd, section, w->sym, addr,
+					   pinfo, false);
+	      pinfo->fprintf_func (pinfo->stream, ":\n");
+	    }
 
-	  if (sym != NULL && show_all_symbols)
+	  if (w->sym != NULL && show_all_symbols)
 	    {
-	      for (++place; place < sorted_symcount; place++)
+	      for (++w->place; w->place < sorted_symcount; w->place++)
 		{
-		  sym = sorted_syms[place];
-		  
-		  if (bfd_asymbol_value (sym) != addr)
+		  w->sym = sorted_syms[w->place];
+
+		  if (bfd_asymbol_value (w->sym) != addr)
 		    break;
-		  if (! pinfo->symbol_is_valid (sym, pinfo))
+		  if (! pinfo->symbol_is_valid (w->sym, pinfo))
 		    continue;
-		  if (strcmp (bfd_section_name (sym->section), bfd_section_name (section)) != 0)
+		  if (strcmp (bfd_section_name (w->sym->section), bfd_section_name (section)) != 0)
 		    break;
 
-		  objdump_print_addr_with_sym (abfd, section, sym, addr, pinfo, false);
-		  pinfo->fprintf_func (pinfo->stream, ":\n");
+		  if (emit)
+		    {
+		      objdump_print_addr_with_sym (abfd, section, w->sym, addr,
+						   pinfo, false);
+		      pinfo->fprintf_func (pinfo->stream, ":\n");
+		    }
 		}
-	    }	   
+	    }
 	}
 
-      if (sym != NULL && bfd_asymbol_value (sym) > addr)
-	nextsym = sym;
-      else if (sym == NULL)
+      if (w->sym != NULL && bfd_asymbol_value (w->sym) > addr)
+	nextsym = w->sym;
+      else if (w->sym == NULL)
 	nextsym = NULL;
       else
 	{
 #define is_valid_next_sym(SYM) \
   (strcmp (bfd_section_name ((SYM)->section), bfd_section_name (section)) == 0 \
-   && (bfd_asymbol_value (SYM) > bfd_asymbol_value (sym)) \
+   && (bfd_asymbol_value (SYM) > bfd_asymbol_value (w->sym)) \
    && pinfo->symbol_is_valid (SYM, pinfo))
 
 	  /* Search forward for the next appropriate symbol in
 	     SECTION.  Note that all the symbols are sorted
 	     together into one big array, and that some sections
 	     may have overlapping addresses.  */
-	  while (place < sorted_symcount
-		 && ! is_valid_next_sym (sorted_syms [place]))
-	    ++place;
+	  while (w->place < sorted_symcount
+		 && ! is_valid_next_sym (sorted_syms [w->place]))
+	    ++w->place;
 
-	  if (place >= sorted_symcount)
+	  if (w->place >= sorted_symcount)
 	    nextsym = NULL;
 	  else
-	    nextsym = sorted_syms[place];
+	    nextsym = sorted_syms[w->place];
 	}
 
-      if (sym != NULL && bfd_asymbol_value (sym) > addr)
-	nextstop_offset = bfd_asymbol_value (sym) - section->vma;
+      if (w->sym != NULL && bfd_asymbol_value (w->sym) > addr)
+	nextstop_offset = bfd_asymbol_value (w->sym) - section->vma;
       else if (nextsym == NULL)
-	nextstop_offset = stop_offset;
+	nextstop_offset = w->stop_offset;
       else
 	nextstop_offset = bfd_asymbol_value (nextsym) - section->vma;
 
-      if (nextstop_offset > stop_offset
-	  || nextstop_offset <= addr_offset)
-	nextstop_offset = stop_offset;
+      if (nextstop_offset > w->stop_offset
+	  || nextstop_offset <= w->addr_offset)
+	nextstop_offset = w->stop_offset;
 
       /* If a symbol is explicitly marked as being an object
 	 rather than a function, just dump the bytes without
 	 disassembling them.  */
       if (disassemble_all
-	  || sym == NULL
-	  || sym->section != section
-	  || bfd_asymbol_value (sym) > addr
-	  || ((sym->flags & BSF_OBJECT) == 0
-	      && (strstr (bfd_asymbol_name (sym), "gnu_compiled")
+	  || w->sym == NULL
+	  || w->sym->section != section
+	  || bfd_asymbol_value (w->sym) > addr
+	  || ((w->sym->flags & BSF_OBJECT) == 0
+	      && (strstr (bfd_asymbol_name (w->sym), "gnu_compiled")
 		  == NULL)
-	      && (strstr (bfd_asymbol_name (sym), "gcc2_compiled")
+	      && (strstr (bfd_asymbol_name (w->sym), "gcc2_compiled")
 		  == NULL))
-	  || (sym->flags & BSF_FUNCTION) != 0)
+	  || (w->sym->flags & BSF_FUNCTION) != 0)
 	insns = true;
       else
 	insns = false;
 
-      if (do_print)
+      if (w->do_print && emit)
 	{
 	  /* Resolve symbol name.  */
-	  if (visualize_jumps && abfd && sym && sym->name)
+	  if (visualize_jumps && abfd && w->sym && w->sym->name)
 	    {
 	      struct disassemble_info di;
 	      SFILE sf;
 
-	      sf.alloc = strlen (sym->name) + 40;
+	      sf.alloc = strlen (w->sym->name) + 40;
 	      sf.buffer = (char*) xmalloc (sf.alloc);
 	      sf.pos = 0;
 	      disassemble_set_printf
 		(&di, &sf, (fprintf_ftype) objdump_sprintf,
 		 (fprintf_styled_ftype) objdump_styled_sprintf);
 
-	      objdump_print_symname (abfd, &di, sym);
+	      objdump_print_symname (abfd, &di, w->sym);
 
 	      /* Fetch jump information.  */
 	      detected_jumps = disassemble_jumps
 		(pinfo, paux->disassemble_fn,
-		 addr_offset, nextstop_offset,
-		 rel_offset, &rel_pp, rel_ppend);
+		 w->addr_offset, nextstop_offset,
+		 w->rel_offset, &w->rel_pp, w->rel_ppend);
 
 	      /* Free symbol name.  */
 	      free (sf.buffer);
 	    }
 
 	  /* Add jumps to output.  */
-	  disassemble_bytes (pinfo, paux->disassemble_fn, insns, data,
-			     addr_offset, nextstop_offset,
-			     rel_offset, &rel_pp, rel_ppend);
+	  disassemble_bytes (pinfo, paux->disassemble_fn, insns, w->data,
+			     w->addr_offset, nextstop_offset,
+			     w->rel_offset, &w->rel_pp, w->rel_ppend);
 
 	  /* Free jumps.  */
 	  while (detected_jumps)
@@ -4070,10 +4005,366 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
 	    }
 	}
 
-      addr_offset = nextstop_offset;
-      sym = nextsym;
+      w->addr_offset = nextstop_offset;
+      w->sym = nextsym;
+    }
+
+  return emitted;
+}
+
+#ifdef HAVE_SYS_WAIT_H
+
+/* The smallest amount of a section given to each process with
+   --disassembler-jobs.  */
+#define DISASSEMBLE_CHUNK_MIN 0x10000
+
+/* Whether the regions of a section can be disassembled in chunks,
+   independently of those before them.  */
+
+static bool
+can_disassemble_in_chunks (struct disassemble_info *pinfo)
+{
+  struct objdump_disasm_info *paux
+    = (struct objdump_disasm_info *) pinfo->application_data;
+
+  /* What is displayed for line numbers and source code, and when
+     disassembling from a symbol, depends on the regions before.  */
+  if (with_line_numbers || with_source_code || paux->symbol != NULL)
+    return false;
+
+  /* So does the output of disassemblers which keep state from one
+     instruction to the next.  */
+  switch (pinfo->arch)
+    {
+    case bfd_arch_i386:
+    case bfd_arch_iamcu:
+      return true;
+    default:
+      return false;
+    }
+}
+
+/* What a child process disassembling a chunk reports back.  */
+
+struct disasm_chunk_result
+{
+  bool emitted;
+  arelent **first_rel_pp;
+  arelent **rel_pp;
+};
+
+/* Disassemble the regions of W's section in JOBS chunks of about the
+   same size.  The first chunk is done by this process, the others by
+   child processes writing to temporary files, which are then copied
+   to stdout in order.
+
+   A child process can not know which relocs the chunks before its own
+   displayed, as the last instruction of a chunk may extend into the
+   next one.  It assumes that they displayed those before the start of
+   its chunk; if that turns out to be wrong, the chunk is disassembled
+   again by this process.  */
+
+static void
+disassemble_chunks (struct disassemble_info *pinfo, struct disasm_walk *w,
+		    unsigned int jobs)
+{
+  struct disasm_chunk
+  {
+    pid_t pid;
+    FILE *out;
+    int result_fd;
+  } *chunks;
+  bfd_vma start = w->addr_offset;
+  bfd_vma chunk_size = (w->stop_offset - start + jobs - 1) / jobs;
+  struct disasm_walk cw;
+  arelent **rel_pp;
+  unsigned int i;
+
+#define CHUNK_START(I) ((I) == jobs ? (bfd_vma) -1 : start + (I) * chunk_size)
+
+  chunks = (struct disasm_chunk *) xmalloc (jobs * sizeof (*chunks));
+  fflush (stdout);
+  for (i = 1; i < jobs; i++)
+    {
+      int fds[2];
+
+      chunks[i].pid = -1;
+      chunks[i].out = tmpfile ();
+      if (chunks[i].out == NULL)
+	continue;
+      if (pipe (fds) != 0)
+	{
+	  fclose (chunks[i].out);
+	  chunks[i].out = NULL;
+	  continue;
+	}
+
+      chunks[i].pid = fork ();
+      if (chunks[i].pid == 0)
+	{
+	  struct disasm_chunk_result result;
+
+	  close (fds[0]);
+	  if (dup2 (fileno (chunks[i].out), fileno (stdout)) < 0)
+	    _exit (1);
+	  cw = *w;
+	  result.emitted = disassemble_regions (pinfo, &cw, CHUNK_START (i),
+						CHUNK_START (i + 1));
+	  result.first_rel_pp = cw.first_rel_pp;
+	  result.rel_pp = cw.rel_pp;
+	  if (fflush (stdout) != 0
+	      || write (fds[1], &result, sizeof (result)) != sizeof (result))
+	    _exit (1);
+	  _exit (exit_status);
+	}
+
+      close (fds[1]);
+      chunks[i].result_fd = fds[0];
+      if (chunks[i].pid < 0)
+	{
+	  close (chunks[i].result_fd);
+	  fclose (chunks[i].out);
+	  chunks[i].out = NULL;
+	}
+    }
+
+  /* REL_PP is where the serial disassembly would be in the relocs
+     at the end of each chunk.  */
+  cw = *w;
+  cw.first_rel_pp = w->rel_pp;
+  disassemble_regions (pinfo, &cw, start, CHUNK_START (1));
+  rel_pp = cw.rel_pp;
+
+  for (i = 1; i < jobs; i++)
+    {
+      struct disasm_chunk_result result;
+      bool done = false;
+
+      if (chunks[i].pid > 0)
+	{
+	  int status;
+
+	  if (read (chunks[i].result_fd, &result, sizeof (result))
+	      == sizeof (result)
+	      && (!result.emitted || result.first_rel_pp == rel_pp))
+	    done = true;
+	  close (chunks[i].result_fd);
+	  if (waitpid (chunks[i].pid, &status, 0) != chunks[i].pid
+	      || !WIFEXITED (status))
+	    done = false;
+	  else if (done && WEXITSTATUS (status) != 0)
+	    exit_status = 1;
+	}
+
+      if (done)
+	{
+	  char buf[8192];
+	  size_t n;
+
+	  rewind (chunks[i].out);
+	  while ((n = fread (buf, 1, sizeof (buf), chunks[i].out)) > 0)
+	    fwrite (buf, 1, n, stdout);
+	  if (result.emitted)
+	    rel_pp = result.rel_pp;
+	}
+      else
+	{
+	  cw = *w;
+	  cw.first_rel_pp = rel_pp;
+	  if (disassemble_regions (pinfo, &cw, CHUNK_START (i),
+				   CHUNK_START (i + 1)))
+	    rel_pp = cw.rel_pp;
+	}
+
+      if (chunks[i].out != NULL)
+	fclose (chunks[i].out);
+    }
+
+#undef CHUNK_START
+
+  free (chunks);
+}
+
+#endif /* HAVE_SYS_WAIT_H */
+
+static void
+disassemble_section (bfd *abfd, asection *section, void *inf)
+{
+  const struct elf_backend_data *bed;
+  bfd_vma sign_adjust = 0;
+  struct disassemble_info *pinfo = (struct disassemble_info *) inf;
+  struct objdump_disasm_info *paux;
+  unsigned int opb = pinfo->octets_per_byte;
+  bfd_byte *data = NULL;
+  bfd_size_type datasize = 0;
+  arelent **rel_pp = NULL;
+  arelent **rel_ppstart = NULL;
+  arelent **rel_ppend;
+  bfd_vma stop_offset;
+  asymbol *sym = NULL;
+  long place = 0;
+  long rel_count;
+  bfd_vma rel_offset;
+  unsigned long addr_offset;
+  struct disasm_walk walk;
+#ifdef HAVE_SYS_WAIT_H
+  unsigned int jobs;
+#endif
+
+  if (only_list == NULL)
+    {
+      /* Sections that do not contain machine
+	 code are not normally disassembled.  */
+      if ((section->flags & SEC_HAS_CONTENTS) == 0)
+	return;
+
+      if (! disassemble_all
+	  && (section->flags & SEC_CODE) == 0)
+	return;
+    }
+  else if (!process_section_p (section))
+    return;
+
+  datasize = bfd_section_size (section);
+  if (datasize == 0)
+    return;
+
+  if (start_address == (bfd_vma) -1
+      || start_address < section->vma)
+    addr_offset = 0;
+  else
+    addr_offset = start_address - section->vma;
+
+  if (stop_address == (bfd_vma) -1)
+    stop_offset = datasize / opb;
+  else
+    {
+      if (stop_address < section->vma)
+	stop_offset = 0;
+      else
+	stop_offset = stop_address - section->vma;
+      if (stop_offset > datasize / opb)
+	stop_offset = datasize / opb;
+    }
+
+  if (addr_offset >= stop_offset)
+    return;
+
+  /* Decide which set of relocs to use.  Load them if necessary.  */
+  paux = (struct objdump_disasm_info *) pinfo->application_data;
+  if (pinfo->dynrelbuf && dump_dynamic_reloc_info)
+    {
+      rel_pp = pinfo->dynrelbuf;
+      rel_count = pinfo->dynrelcount;
+      /* Dynamic reloc addresses are absolute, non-dynamic are section
+	 relative.  REL_OFFSET specifies the reloc address corresponding
+	 to the start of this section.  */
+      rel_offset = section->vma;
+    }
+  else
+    {
+      rel_count = 0;
+      rel_pp = NULL;
+      rel_offset = 0;
+
+      if ((section->flags & SEC_RELOC) != 0
+	  && (dump_reloc_info || pinfo->disassembler_needs_relocs))
+	{
+	  long relsize;
+
+	  relsize = bfd_get_reloc_upper_bound (abfd, section);
+	  if (relsize < 0)
+	    my_bfd_nonfatal (bfd_get_filename (abfd));
+
+	  if (relsize > 0)
+	    {
+	      rel_pp = (arelent **) xmalloc (relsize);
+	      rel_count = bfd_canonicalize_reloc (abfd, section, rel_pp, syms);
+	      if (rel_count < 0)
+		{
+		  my_bfd_nonfatal (bfd_get_filename (abfd));
+		  free (rel_pp);
+		  rel_pp = NULL;
+		  rel_count = 0;
+		}
+	      else if (rel_count > 1)
+		/* Sort the relocs by address.  */
+		qsort (rel_pp, rel_count, sizeof (arelent *), compare_relocs);
+	      rel_ppstart = rel_pp;
+	    }
+	}
+    }
+  rel_ppend = PTR_ADD (rel_pp, rel_count);
+
+  if (!bfd_malloc_and_get_section (abfd, section, &data))
+    {
+      non_fatal (_("Reading section %s failed because: %s"),
+		 section->name, bfd_errmsg (bfd_get_error ()));
+      return;
     }
 
+  pinfo->buffer = data;
+  pinfo->buffer_vma = section->vma;
+  pinfo->buffer_length = datasize;
+  pinfo->section = section;
+
+  /* Sort the symbols into value and section order.  */
+  compare_section = section;
+  if (sorted_symcount > 1)
+    qsort (sorted_syms, sorted_symcount, sizeof (asymbol *), compare_symbols);
+
+  /* Skip over the relocs belonging to addresses below the
+     start address.  */
+  while (rel_pp < rel_ppend
+	 && (*rel_pp)->address < rel_offset + addr_offset)
+    ++rel_pp;
+
+  printf (_("\nDisassembly of section %s:\n"), sanitize_string (section->name));
+
+  /* Find the nearest symbol forwards from our current position.  */
+  paux->require_sec = true;
+  sym = (asymbol *) find_symbol_for_address (section->vma + addr_offset,
+					     (struct disassemble_info *) inf,
+					     &place);
+  paux->require_sec = false;
+
+  /* PR 9774: If the target used signed addresses then we must make
+     sure that we sign extend the value that we calculate for 'addr'
+     in the loop below.  */
+  if (bfd_get_flavour (abfd) == bfd_target_elf_flavour
+      && (bed = get_elf_backend_data (abfd)) != NULL
+      && bed->sign_extend_vma)
+    sign_adjust = (bfd_vma) 1 << (bed->s->arch_size - 1);
+
+  /* Disassemble a block of instructions up to the address associated with
+     the symbol we have just found.  Then print the symbol and find the
+     next symbol on.  Repeat until we have disassembled the entire section
+     or we have reached the end of the address range we are interested in.  */
+  walk.abfd = abfd;
+  walk.section = section;
+  walk.data = data;
+  walk.sign_adjust = sign_adjust;
+  walk.rel_offset = rel_offset;
+  walk.rel_ppend = rel_ppend;
+  walk.addr_offset = addr_offset;
+  walk.stop_offset = stop_offset;
+  walk.sym = sym;
+  walk.place = place;
+  walk.rel_pp = rel_pp;
+  walk.first_rel_pp = NULL;
+  walk.do_print = paux->symbol == NULL;
+  walk.loop_until = stop_offset_reached;
+
+#ifdef HAVE_SYS_WAIT_H
+  jobs = disassembler_jobs;
+  if (jobs > (stop_offset - addr_offset) / DISASSEMBLE_CHUNK_MIN)
+    jobs = (stop_offset - addr_offset) / DISASSEMBLE_CHUNK_MIN;
+  if (jobs > 1 && can_disassemble_in_chunks (pinfo))
+    disassemble_chunks (pinfo, &walk, jobs);
+  else
+#endif
+    disassemble_regions (pinfo, &walk, 0, (bfd_vma) -1);
+
   free (data);
 
   if (rel_ppstart != NULL)
@@ -5998,6 +6289,11 @@ main (int argc, char **argv)
 	  if (insn_width <= 0)
 	    fatal (_("error: instruction width must be positive"));
 	  break;
+	case OPTION_DISASSEMBLER_JOBS:
+	  disassembler_jobs = strtoul (optarg, NULL, 0);
+	  if (disassembler_jobs == 0)
+	    fatal (_("error: the number of disassembler jobs must be positive"));
+	  break;
 	case OPTION_INLINES:
 	  unwind_inlines = true;
 	  break;
@@ -5565,6 +5565,8 @@ enum long_option_values
   OPTION_LTO_SYMS,
   OPTION_DWARF_DEPTH,
   OPTION_DWARF_START,
+  OPTION_DWARF_NAME,
+  OPTION_DWARF_JOBS,
   OPTION_DWARF_CHECK,
   OPTION_CTF_DUMP,
   OPTION_CTF_PARENT,
@@ -5629,6 +5631,8 @@ static struct option options[] =
   {"debug-dump",       optional_argument, 0, OPTION_DEBUG_DUMP},
   {"dwarf-depth",      required_argument, 0, OPTION_DWARF_DEPTH},
   {"dwarf-start",      required_argument, 0, OPTION_DWARF_START},
+  {"dwarf-name",       required_argument, 0, OPTION_DWARF_NAME},
+  {"dwarf-jobs",       required_argument, 0, OPTION_DWARF_JOBS},
   {"dwarf-check",      no_argument, 0, OPTION_DWARF_CHECK},
 #ifdef ENABLE_LIBCTF
   {"ctf",	       required_argument, 0, OPTION_CTF_DUMP},
@@ -5769,6 +5773,10 @@ usage (FILE * stream)
   --dwarf-depth=N        Do not display DIEs at depth N or greater\n"));
   fprintf (stream, _("\
   --dwarf-start=N        Display DIEs starting at offset N\n"));
+  fprintf (stream, _("\
+  --dwarf-name=NAME      Display only DIEs named NAME, and their children\n"));
+  fprintf (stream, _("\
+  --dwarf-jobs=N         Use N processes to display .debug_info\n"));
 #ifdef ENABLE_LIBCTF
   fprintf (stream, _("\
   --ctf=<number|name>    Display CTF info from section <number|name>\n"));
@@ -6037,6 +6045,18 @@ parse_args (struct dump_data *dumpdata, int argc, char ** argv)
 	    dwarf_start_die = strtoul (optarg, & cp, 0);
 	  }
 	  break;
+	case OPTION_DWARF_NAME:
+	  dwarf_die_name = optarg;
+	  break;
+	case OPTION_DWARF_JOBS:
+	  {
+	    char *cp;
+
+	    dwarf_jobs = strtoul (optarg, & cp, 0);
+	    if (dwarf_jobs == 0)
+	      dwarf_jobs = 1;
+	  }
+	  break;
 	case OPTION_DWARF_CHECK:
 	  dwarf_check = true;
 	  break;
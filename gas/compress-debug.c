@@ -28,14 +28,44 @@
 #include "ansidecl.h"
 #include "compress-debug.h"
 
-/* Initialize the compression engine.  */
+#if HAVE_ZSTD
+/* The state of a zstd compression.  */
+
+struct zstd_state
+{
+  ZSTD_CCtx *cctx;
+  /* If non-zero, end the current frame and start a new one after this
+     many bytes of input, so that the frames can be decompressed
+     independently.  */
+  size_t chunk_size;
+  /* The number of input bytes consumed by the current frame.  */
+  size_t in_frame;
+  /* Whether the current frame has been started.  */
+  bool frame_started;
+  /* The number of input bytes not yet consumed.  */
+  size_t remaining;
+};
+#endif
+
+/* Initialize the compression engine for SIZE bytes of input.  If
+   CHUNK_SIZE is non-zero, zstd output is split into independent
+   frames of CHUNK_SIZE uncompressed bytes.  */
 
 void *
-compress_init (bool use_zstd)
+compress_init (bool use_zstd, size_t chunk_size ATTRIBUTE_UNUSED,
+	       size_t size ATTRIBUTE_UNUSED)
 {
   if (use_zstd) {
 #if HAVE_ZSTD
-    return ZSTD_createCCtx ();
+    static struct zstd_state state;
+    state.cctx = ZSTD_createCCtx ();
+    if (state.cctx == NULL)
+      return NULL;
+    state.chunk_size = chunk_size;
+    state.in_frame = 0;
+    state.frame_started = false;
+    state.remaining = size;
+    return &state;
 #endif
   }
 
@@ -55,15 +85,50 @@ compress_data (bool use_zstd, void *ctx, const char **next_in, int *avail_in,
   if (use_zstd)
     {
 #if HAVE_ZSTD
+      struct zstd_state *state = ctx;
+      size_t in_size = *avail_in;
+      ZSTD_EndDirective mode = ZSTD_e_continue;
+
+      /* Only pass the input that belongs to the current frame, and
+	 end the frame once it is all there.  Ending a frame may take
+	 several calls if the output buffer fills up.  */
+      if (state->chunk_size != 0
+	  && in_size >= state->chunk_size - state->in_frame)
+	{
+	  in_size = state->chunk_size - state->in_frame;
+	  mode = ZSTD_e_end;
+	}
+
+      /* Record the size of each frame in its header, which the
+	 reader needs to decompress the frames separately.  */
+      if (state->chunk_size != 0 && !state->frame_started && in_size != 0)
+	{
+	  size_t frame_size = state->remaining;
+	  if (frame_size > state->chunk_size)
+	    frame_size = state->chunk_size;
+	  if (ZSTD_isError (ZSTD_CCtx_setPledgedSrcSize (state->cctx,
+							 frame_size)))
+	    return -1;
+	}
+
       ZSTD_outBuffer ob = { *next_out, *avail_out, 0 };
-      ZSTD_inBuffer ib = { *next_in, *avail_in, 0 };
-      size_t ret = ZSTD_compressStream2 (ctx, &ob, &ib, ZSTD_e_continue);
+      ZSTD_inBuffer ib = { *next_in, in_size, 0 };
+      size_t ret = ZSTD_compressStream2 (state->cctx, &ob, &ib, mode);
       *next_in += ib.pos;
       *avail_in -= ib.pos;
       *next_out += ob.pos;
       *avail_out -= ob.pos;
       if (ZSTD_isError (ret))
 	return -1;
+      state->in_frame += ib.pos;
+      state->remaining -= ib.pos;
+      if (ib.pos != 0)
+	state->frame_started = true;
+      if (mode == ZSTD_e_end && ret == 0)
+	{
+	  state->in_frame = 0;
+	  state->frame_started = false;
+	}
       return (int)ob.pos;
 #endif
     }
@@ -99,16 +164,27 @@ compress_finish (bool use_zstd, void *ctx, char **next_out,
   if (use_zstd)
     {
 #if HAVE_ZSTD
+      struct zstd_state *state = ctx;
+
+      /* If the input ended exactly at the end of a frame, there is
+	 nothing left to flush; don't emit an empty frame.  */
+      if (state->chunk_size != 0 && !state->frame_started)
+	{
+	  *out_size = 0;
+	  ZSTD_freeCCtx (state->cctx);
+	  return 0;
+	}
+
       ZSTD_outBuffer ob = { *next_out, *avail_out, 0 };
       ZSTD_inBuffer ib = { 0, 0, 0 };
-      size_t ret = ZSTD_compressStream2 (ctx, &ob, &ib, ZSTD_e_end);
+      size_t ret = ZSTD_compressStream2 (state->cctx, &ob, &ib, ZSTD_e_end);
       *out_size = ob.pos;
       *next_out += ob.pos;
       *avail_out -= ob.pos;
       if (ZSTD_isError (ret))
 	return -1;
       if (ret == 0)
-	ZSTD_freeCCtx (ctx);
+	ZSTD_freeCCtx (state->cctx);
       return ret ? 1 : 0;
 #endif
     }
@@ -22,11 +22,12 @@
 #define COMPRESS_DEBUG_H
 
 #include <stdbool.h>
+#include <stddef.h>
 
 struct z_stream_s;
 
 /* Initialize the compression engine.  */
-extern void *compress_init (bool);
+extern void *compress_init (bool, size_t, size_t);
 
 /* Stream the contents of a frag to the compression engine.  Output
    from the engine goes into the current frag on the obstack.  */
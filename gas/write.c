@@ -1478,7 +1478,9 @@ compress_debug (bfd *abfd, asection *sec, void *xxx ATTRIBUTE_UNUSED)
     return;
 
   bool use_zstd = abfd->flags & BFD_COMPRESS_ZSTD;
-  void *ctx = compress_init (use_zstd);
+  size_t chunk_size = ((abfd->flags & BFD_COMPRESS_CHUNKED) != 0
+		       ? BFD_COMPRESS_CHUNK_SIZE : 0);
+  void *ctx = compress_init (use_zstd, chunk_size, uncompressed_size);
   if (ctx == NULL)
     return;
 
@@ -2533,6 +2535,9 @@ write_object_file (void)
 	flags = BFD_COMPRESS | BFD_COMPRESS_GABI;
       else if (flag_compress_debug == COMPRESS_DEBUG_ZSTD)
 	flags = BFD_COMPRESS | BFD_COMPRESS_GABI | BFD_COMPRESS_ZSTD;
+      else if (flag_compress_debug == COMPRESS_DEBUG_ZSTD_CHUNKED)
+	flags = (BFD_COMPRESS | BFD_COMPRESS_GABI | BFD_COMPRESS_ZSTD
+		 | BFD_COMPRESS_CHUNKED);
       stdoutput->flags |= flags & bfd_applicable_file_flags (stdoutput);
       if ((stdoutput->flags & BFD_COMPRESS) != 0)
 	bfd_map_over_sections (stdoutput, compress_debug, (char *) 0);
@@ -38,6 +38,7 @@
 #include "dwarf2/frame.h"
 #include "gdbtypes.h"
 #include "prologue-value.h"
+#include "sframe-unwind.h"
 #include "target-descriptions.h"
 #include "user-regs.h"
 #include "ax-gdb.h"
@@ -4549,6 +4550,7 @@ aarch64_gdbarch_init (struct gdbarch_info info, struct gdbarch_list *arches)
 
   /* Add some default predicates.  */
   frame_unwind_append_unwinder (gdbarch, &aarch64_stub_unwind);
+  sframe_append_unwinders (gdbarch);
   dwarf2_append_unwinders (gdbarch);
   frame_unwind_append_unwinder (gdbarch, &aarch64_prologue_unwind);
 
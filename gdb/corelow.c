@@ -47,10 +47,12 @@
 #include "build-id.h"
 #include "gdbsupport/pathstuff.h"
 #include "gdbsupport/scoped_fd.h"
+#include "gdbsupport/scoped_mmap.h"
 #include "gdbsupport/x86-xstate.h"
 #include "debuginfod-support.h"
 #include <unordered_map>
 #include <unordered_set>
+#include <algorithm>
 #include "gdbcmd.h"
 #include "xml-tdesc.h"
 #include "memtag.h"
@@ -59,6 +61,25 @@
 #define O_LARGEFILE 0
 #endif
 
+/* Whether the contents of the core file are mapped into GDB's address
+   space when it is opened, so that memory reads are served by copying
+   from the mapping rather than reading the file through BFD.  */
+
+static bool core_file_mmap = true;
+
+/* A section of the core file whose contents are mapped into memory,
+   see core_target::m_core_mapped_sections.  */
+
+struct core_mapped_section
+{
+  /* The range of target addresses covered by the section.  */
+  CORE_ADDR addr;
+  CORE_ADDR endaddr;
+
+  /* The contents of the section, in the mapping of the core file.  */
+  const gdb_byte *contents;
+};
+
 /* The core file target.  */
 
 static const target_info core_target_info = {
@@ -153,9 +174,30 @@ class core_target final : public process_stratum_target
      still be useful.  */
   std::vector<mem_range> m_core_unavailable_mappings;
 
+#ifdef HAVE_SYS_MMAN_H
+  /* The whole core file, mapped read-only, if "maint set core-file-mmap"
+     was on when it was opened and mapping it succeeded.  */
+  scoped_mmap m_core_mapping;
+#endif
+
+  /* The sections of m_core_section_table with contents that lie within
+     m_core_mapping, sorted by address.  Empty if the core file is not
+     mapped.  */
+  std::vector<core_mapped_section> m_core_mapped_sections;
+
   /* Build m_core_file_mappings.  Called from the constructor.  */
   void build_file_mappings ();
 
+  /* Map the core file and build m_core_mapped_sections.  Called from
+     the constructor.  */
+  void map_core_file ();
+
+  /* Helper method for xfer_partial.  */
+  enum target_xfer_status xfer_memory_via_mapped_core (gdb_byte *readbuf,
+						       ULONGEST offset,
+						       ULONGEST len,
+						       ULONGEST *xfered_len);
+
   /* Helper method for xfer_partial.  */
   enum target_xfer_status xfer_memory_via_mappings (gdb_byte *readbuf,
 						    const gdb_byte *writebuf,
@@ -195,6 +237,63 @@ core_target::core_target ()
   m_core_section_table = build_section_table (core_bfd);
 
   build_file_mappings ();
+
+  if (core_file_mmap)
+    map_core_file ();
+}
+
+void
+core_target::map_core_file ()
+{
+#ifdef HAVE_SYS_MMAN_H
+  /* Only a plain local file can be mapped.  */
+  const char *filename = bfd_get_filename (core_bfd);
+  if (is_target_filename (filename)
+      || (bfd_get_file_flags (core_bfd) & BFD_IN_MEMORY) != 0
+      || core_bfd->my_archive != nullptr)
+    return;
+
+  try
+    {
+      m_core_mapping = mmap_file (filename);
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      /* Reading through BFD still works.  */
+      return;
+    }
+
+  const gdb_byte *base = (const gdb_byte *) m_core_mapping.get ();
+  ULONGEST file_size = m_core_mapping.size ();
+
+  for (const target_section &tsp : m_core_section_table)
+    {
+      asection *sec = tsp.the_bfd_section;
+      if ((bfd_section_flags (sec) & SEC_HAS_CONTENTS) == 0
+	  || sec->compress_status != COMPRESS_SECTION_NONE
+	  || tsp.endaddr <= tsp.addr)
+	continue;
+
+      /* Touching the mapping past the end of the file raises SIGBUS,
+	 so sections of truncated core files are left to BFD, which
+	 reports the error.  */
+      ULONGEST size = tsp.endaddr - tsp.addr;
+      if (sec->filepos < 0
+	  || size > bfd_section_size (sec)
+	  || (ULONGEST) sec->filepos > file_size
+	  || size > file_size - sec->filepos)
+	continue;
+
+      m_core_mapped_sections.push_back ({ tsp.addr, tsp.endaddr,
+					  base + sec->filepos });
+    }
+
+  std::sort (m_core_mapped_sections.begin (), m_core_mapped_sections.end (),
+	     [] (const core_mapped_section &a, const core_mapped_section &b)
+	     {
+	       return a.addr < b.addr;
+	     });
+#endif
 }
 
 /* Construct the table for file-backed mappings if they exist.
@@ -1006,6 +1105,33 @@ core_target::xfer_memory_via_mappings (gdb_byte *readbuf,
   return xfer_status;
 }
 
+/* Helper method for core_target::xfer_partial.  Read memory from the
+   mapped sections of the core file, if one covers OFFSET.  */
+
+enum target_xfer_status
+core_target::xfer_memory_via_mapped_core (gdb_byte *readbuf,
+					  ULONGEST offset, ULONGEST len,
+					  ULONGEST *xfered_len)
+{
+  /* Find the last section starting at or before OFFSET.  */
+  auto it = std::upper_bound (m_core_mapped_sections.begin (),
+			      m_core_mapped_sections.end (), offset,
+			      [] (ULONGEST addr, const core_mapped_section &s)
+			      {
+				return addr < s.addr;
+			      });
+  if (it == m_core_mapped_sections.begin ())
+    return TARGET_XFER_EOF;
+  --it;
+  if (offset >= it->endaddr)
+    return TARGET_XFER_EOF;
+
+  ULONGEST size = std::min (len, (ULONGEST) (it->endaddr - offset));
+  memcpy (readbuf, it->contents + (offset - it->addr), size);
+  *xfered_len = size;
+  return TARGET_XFER_OK;
+}
+
 enum target_xfer_status
 core_target::xfer_partial (enum target_object object, const char *annex,
 			   gdb_byte *readbuf, const gdb_byte *writebuf,
@@ -1017,6 +1143,16 @@ core_target::xfer_partial (enum target_object object, const char *annex,
       {
 	enum target_xfer_status xfer_status;
 
+	/* Reads of the core file's contents are cheapest from its
+	   mapping, when there is one.  */
+	if (readbuf != nullptr && !m_core_mapped_sections.empty ())
+	  {
+	    xfer_status = xfer_memory_via_mapped_core (readbuf, offset, len,
+						       xfered_len);
+	    if (xfer_status == TARGET_XFER_OK)
+	      return TARGET_XFER_OK;
+	  }
+
 	/* Try accessing memory contents from core file data,
 	   restricting consideration to those sections for which
 	   the BFD section flag SEC_HAS_CONTENTS is set.  */
@@ -1505,4 +1641,16 @@ _initialize_corelow ()
 	   maintenance_print_core_file_backed_mappings,
 	   _("Print core file's file-backed mappings."),
 	   &maintenanceprintlist);
+
+  add_setshow_boolean_cmd ("core-file-mmap", class_maintenance,
+			   &core_file_mmap, _("\
+Set whether core files are mapped into memory."), _("\
+Show whether core files are mapped into memory."), _("\
+When on, core files are mapped read-only into GDB's address space when\n\
+they are opened, and reads of the memory they contain copy from the\n\
+mapping instead of reading the file.  This takes effect the next time\n\
+a core file is opened."),
+			   NULL, NULL,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
 }
@@ -23,8 +23,9 @@
 #include "gdbcore.h"
 #include "target-dcache.h"
 #include "inferior.h"
-#include "splay-tree.h"
 #include "gdbarch.h"
+#include <algorithm>
+#include <unordered_map>
 
 /* Commands with a prefix of `{set,show} dcache'.  */
 static struct cmd_list_element *dcache_set_list = NULL;
@@ -43,10 +44,10 @@ static struct cmd_list_element *dcache_show_list = NULL;
    significantly.  This is most useful when accessing a large amount
    of data, such as when performing a backtrace.
 
-   The cache is a splay tree along with a linked list for replacement.
-   Each block caches a LINE_SIZE area of memory.  Within each line we
-   remember the address of the line (which must be a multiple of
-   LINE_SIZE) and the actual data block.
+   The cache is a hash table indexed by line address, along with a
+   linked list for replacement.  Each block caches a LINE_SIZE area of
+   memory.  Within each line we remember the address of the line (which
+   must be a multiple of LINE_SIZE) and the actual data block.
 
    Lines are only allocated as needed, so DCACHE_SIZE really specifies the
    *maximum* number of lines in the cache.
@@ -55,7 +56,16 @@ static struct cmd_list_element *dcache_show_list = NULL;
    as data is written to the cache, it is also immediately written to
    the target.  Therefore, cache lines are never "dirty".  Whether a given
    line is valid or not depends on where it is stored in the dcache_struct;
-   there is no per-block valid flag.  */
+   there is no per-block valid flag.
+
+   Reads that walk memory, such as the stack accesses of a backtrace,
+   usually do so in a regular pattern.  The cache follows a few streams
+   of misses, and once a stream has moved twice in the same direction,
+   or by the same stride, it reads the lines the stream is expected to
+   need next along with the missing one.  Each batch of prefetched
+   lines is twice as large as the previous one, up to
+   DCACHE_PREFETCH_MAX_LINES, and the next batch is read when the
+   first line of the current batch is used.  */
 
 /* NOTE: Interaction of dcache and memory region attributes
 
@@ -83,6 +93,27 @@ static unsigned dcache_size = DCACHE_DEFAULT_SIZE;
 #define DCACHE_DEFAULT_LINE_SIZE 64
 static unsigned dcache_line_size = DCACHE_DEFAULT_LINE_SIZE;
 
+/* Whether lines are read ahead of sequential or strided accesses.  */
+static bool dcache_prefetch_p = true;
+
+/* The number of streams of accesses the prefetcher follows at once.  */
+#define DCACHE_PREFETCH_STREAMS 4
+
+/* The number of lines in the first batch of prefetched lines of a
+   stream, and the most lines a batch may have.  A batch never has more
+   than a quarter of the cache's lines either.  */
+#define DCACHE_PREFETCH_MIN_LINES 4
+#define DCACHE_PREFETCH_MAX_LINES 64
+
+/* Two accesses at most this many lines apart, in the same direction as
+   the previous move of the stream, continue it as a sequential
+   stream, even if they are not the same distance apart.  */
+#define DCACHE_PREFETCH_NEAR_LINES 4
+
+/* The furthest apart, in lines, two accesses of a strided stream may
+   be.  */
+#define DCACHE_PREFETCH_MAX_STRIDE_LINES 64
+
 /* Each cache block holds LINE_SIZE bytes of data
    starting at a multiple-of-LINE_SIZE address.  */
 
@@ -98,32 +129,80 @@ struct dcache_block
 
   CORE_ADDR addr;		/* address of data */
   int refs;			/* # hits */
+  bool prefetched;		/* read ahead and not used yet */
   gdb_byte data[1];		/* line_size bytes at given address */
 };
 
+/* A stream of accesses followed by the prefetcher.  */
+
+struct dcache_stream
+{
+  /* The first line of the last access that missed, or 0 if the stream
+     is unused.  */
+  CORE_ADDR last = 0;
+
+  /* How far, in bytes, the stream moved with its last access, or 0 if
+     it has seen a single access.  */
+  LONGEST delta = 0;
+
+  /* The number of lines the last access covered.  */
+  unsigned span = 1;
+
+  /* Once the stream is being prefetched: how far apart, in bytes, the
+     accesses it reads ahead for are, the number of lines in its next
+     batch, and the first line of that batch.  WINDOW is 0 while the
+     stream is not prefetched.  */
+  LONGEST stride = 0;
+  unsigned window = 0;
+  CORE_ADDR next = 0;
+
+  /* The prefetched line whose first use reads the next batch.  */
+  CORE_ADDR marker = 0;
+
+  /* When the stream was last used, to pick the stream to replace.  */
+  unsigned long stamp = 0;
+};
+
 struct dcache_struct
 {
-  splay_tree tree;
-  struct dcache_block *oldest; /* least-recently-allocated list.  */
+  /* The cached lines, indexed by their address.  */
+  std::unordered_map<CORE_ADDR, dcache_block *> lines;
+
+  struct dcache_block *oldest = nullptr; /* least-recently-allocated list.  */
 
   /* The free list is maintained identically to OLDEST to simplify
      the code: we only need one set of accessors.  */
-  struct dcache_block *freelist;
+  struct dcache_block *freelist = nullptr;
 
   /* The number of in-use lines in the cache.  */
-  int size;
+  int size = 0;
   CORE_ADDR line_size;  /* current line_size.  */
 
   /* The ptid of last inferior to use cache or null_ptid.  */
-  ptid_t ptid;
+  ptid_t ptid = null_ptid;
 
   /* The process target of last inferior to use the cache or
      nullptr.  */
-  process_stratum_target *proc_target;
+  process_stratum_target *proc_target = nullptr;
+
+  /* The streams of accesses the prefetcher follows, and a counter
+     used to stamp them.  */
+  dcache_stream streams[DCACHE_PREFETCH_STREAMS];
+  unsigned long clock = 0;
+
+  /* Statistics, kept across invalidations: the number of lines that
+     reads found in the cache and that they missed, the number of lines
+     prefetched, and how many of those were used.  */
+  unsigned long hits = 0;
+  unsigned long misses = 0;
+  unsigned long prefetched = 0;
+  unsigned long prefetch_hits = 0;
 };
 
 typedef void (block_func) (struct dcache_block *block, void *param);
 
+static struct dcache_block *dcache_lookup (DCACHE *dcache, CORE_ADDR addr);
+
 static struct dcache_block *dcache_hit (DCACHE *dcache, CORE_ADDR addr);
 
 static int dcache_read_line (DCACHE *dcache, struct dcache_block *db);
@@ -223,10 +302,9 @@ free_block (struct dcache_block *block, void *param)
 void
 dcache_free (DCACHE *dcache)
 {
-  splay_tree_delete (dcache->tree);
   for_each_block (&dcache->oldest, free_block, NULL);
   for_each_block (&dcache->freelist, free_block, NULL);
-  xfree (dcache);
+  delete dcache;
 }
 
 
@@ -239,7 +317,6 @@ invalidate_block (struct dcache_block *block, void *param)
 {
   DCACHE *dcache = (DCACHE *) param;
 
-  splay_tree_remove (dcache->tree, (splay_tree_key) block->addr);
   append_block (&dcache->freelist, block);
 }
 
@@ -250,11 +327,15 @@ dcache_invalidate (DCACHE *dcache)
 {
   for_each_block (&dcache->oldest, invalidate_block, dcache);
 
+  dcache->lines.clear ();
   dcache->oldest = NULL;
   dcache->size = 0;
   dcache->ptid = null_ptid;
   dcache->proc_target = nullptr;
 
+  for (dcache_stream &stream : dcache->streams)
+    stream = {};
+
   if (dcache->line_size != dcache_line_size)
     {
       /* We've been asked to use a different line size.
@@ -275,29 +356,38 @@ dcache_invalidate_line (DCACHE *dcache, CORE_ADDR addr)
 
   if (db)
     {
-      splay_tree_remove (dcache->tree, (splay_tree_key) db->addr);
+      dcache->lines.erase (db->addr);
       remove_block (&dcache->oldest, db);
       append_block (&dcache->freelist, db);
       --dcache->size;
     }
 }
 
+/* If ADDR is present in the dcache, return the block containing it.
+   Otherwise return NULL.  Unlike dcache_hit, this does not count as a
+   reference to the block.  */
+
+static struct dcache_block *
+dcache_lookup (DCACHE *dcache, CORE_ADDR addr)
+{
+  auto it = dcache->lines.find (MASK (dcache, addr));
+
+  if (it == dcache->lines.end ())
+    return NULL;
+
+  return it->second;
+}
+
 /* If addr is present in the dcache, return the address of the block
    containing it.  Otherwise return NULL.  */
 
 static struct dcache_block *
 dcache_hit (DCACHE *dcache, CORE_ADDR addr)
 {
-  struct dcache_block *db;
-
-  splay_tree_node node = splay_tree_lookup (dcache->tree,
-					    (splay_tree_key) MASK (dcache, addr));
+  struct dcache_block *db = dcache_lookup (dcache, addr);
 
-  if (!node)
-    return NULL;
-
-  db = (struct dcache_block *) node->value;
-  db->refs++;
+  if (db != NULL)
+    db->refs++;
   return db;
 }
 
@@ -364,7 +454,7 @@ dcache_alloc (DCACHE *dcache, CORE_ADDR addr)
       db = dcache->oldest;
       remove_block (&dcache->oldest, db);
 
-      splay_tree_remove (dcache->tree, (splay_tree_key) db->addr);
+      dcache->lines.erase (db->addr);
     }
   else
     {
@@ -381,36 +471,266 @@ dcache_alloc (DCACHE *dcache, CORE_ADDR addr)
 
   db->addr = MASK (dcache, addr);
   db->refs = 0;
+  db->prefetched = false;
 
   /* Put DB at the end of the list, it's the newest.  */
   append_block (&dcache->oldest, db);
 
-  splay_tree_insert (dcache->tree, (splay_tree_key) db->addr,
-		     (splay_tree_value) db);
+  dcache->lines[db->addr] = db;
 
   return db;
 }
 
-/* Using the data cache DCACHE, store in *PTR the contents of the byte at
-   address ADDR in the remote machine.  
+/* Return true if the line at ADDR lies within a single readable memory
+   region, so that it can be read as a whole.  */
 
-   Returns 1 for success, 0 for error.  */
+static bool
+dcache_line_readable_p (DCACHE *dcache, CORE_ADDR addr)
+{
+  struct mem_region *region = lookup_mem_region (addr);
 
-static int
-dcache_peek_byte (DCACHE *dcache, CORE_ADDR addr, gdb_byte *ptr)
+  return (region->attrib.mode != MEM_WO
+	  && (region->hi == 0 || addr + dcache->line_size <= region->hi));
+}
+
+/* Allocate lines of DCACHE for the addresses in ADDRS, which must be
+   sorted and not cached yet, and fill them from the target all at
+   once.  Each run of adjacent lines is read as a single range.  If
+   the read fails, the lines are discarded again and false is
+   returned.  */
+
+static bool
+dcache_fill_lines (DCACHE *dcache, const std::vector<CORE_ADDR> &addrs)
 {
-  struct dcache_block *db = dcache_hit (dcache, addr);
+  std::vector<dcache_block *> blocks;
+  blocks.reserve (addrs.size ());
+  for (CORE_ADDR addr : addrs)
+    blocks.push_back (dcache_alloc (dcache, addr));
+
+  /* Split the lines into runs of adjacent lines, given as the index of
+     their first line and their number of lines.  */
+  std::vector<std::pair<size_t, size_t>> runs;
+  size_t run_bytes = 0;
+  for (size_t i = 0; i < blocks.size (); )
+    {
+      size_t n = 1;
+      while (i + n < blocks.size ()
+	     && (blocks[i + n]->addr
+		 == blocks[i + n - 1]->addr + dcache->line_size))
+	n++;
+
+      runs.emplace_back (i, n);
+      if (n > 1)
+	run_bytes += n * dcache->line_size;
+      i += n;
+    }
+
+  /* A run of several lines is read into a buffer and copied to its
+     lines afterwards, so that targets that can't read several ranges
+     at once still read it in one go.  */
+  gdb::byte_vector buffer (run_bytes);
+  std::vector<memory_read_range> ranges;
+  ranges.reserve (runs.size ());
+  gdb_byte *p = buffer.data ();
+  for (const auto &[first, n] : runs)
+    if (n == 1)
+      ranges.push_back ({ blocks[first]->addr, blocks[first]->data,
+			  dcache->line_size });
+    else
+      {
+	ranges.push_back ({ blocks[first]->addr, p, n * dcache->line_size });
+	p += n * dcache->line_size;
+      }
 
-  if (!db)
+  if (!target_read_raw_memory_vectored (ranges))
     {
-      db = dcache_alloc (dcache, addr);
+      for (CORE_ADDR addr : addrs)
+	dcache_invalidate_line (dcache, addr);
+      return false;
+    }
+
+  p = buffer.data ();
+  for (const auto &[first, n] : runs)
+    if (n > 1)
+      for (size_t i = first; i < first + n; i++)
+	{
+	  memcpy (blocks[i]->data, p, dcache->line_size);
+	  p += dcache->line_size;
+	}
+
+  return true;
+}
+
+/* Read the next batch of lines of STREAM into DCACHE, and make the
+   batch after it larger.  */
 
-      if (!dcache_read_line (dcache, db))
-	 return 0;
+static void
+dcache_prefetch_stream (DCACHE *dcache, dcache_stream *stream)
+{
+  unsigned max_lines = std::min<unsigned> (DCACHE_PREFETCH_MAX_LINES,
+					  dcache_size / 4);
+
+  if (stream->window == 0)
+    return;
+  if (stream->span > max_lines)
+    {
+      stream->window = 0;
+      return;
     }
 
-  *ptr = db->data[XFORM (dcache, addr)];
-  return 1;
+  /* Don't read past the memory region the accesses are in, its
+     neighbour may not be safe to read.  */
+  struct mem_region *region = lookup_mem_region (stream->last);
+  if (region->attrib.mode == MEM_WO)
+    {
+      stream->window = 0;
+      return;
+    }
+  CORE_ADDR lo = region->lo;
+  CORE_ADDR hi = region->hi;
+
+  unsigned steps = std::max (1u, (std::min (stream->window, max_lines)
+				  / stream->span));
+  std::vector<CORE_ADDR> addrs;
+  CORE_ADDR base = stream->next;
+  bool stop = false;
+
+  for (unsigned step = 0; step < steps && !stop; step++)
+    {
+      for (unsigned i = 0; i < stream->span; i++)
+	{
+	  CORE_ADDR line = base + i * dcache->line_size;
+
+	  if (line < lo
+	      || line + dcache->line_size - 1 < line
+	      || (hi != 0 && line + dcache->line_size > hi))
+	    {
+	      stop = true;
+	      break;
+	    }
+
+	  if (dcache_lookup (dcache, line) == NULL)
+	    addrs.push_back (line);
+	}
+
+      CORE_ADDR following = base + stream->stride;
+      if ((stream->stride > 0) != (following > base))
+	stop = true;
+      base = following;
+    }
+
+  if (stop)
+    stream->window = 0;
+  else
+    {
+      stream->next = base;
+      stream->window = std::min (stream->window * 2, max_lines);
+    }
+
+  if (addrs.empty ())
+    return;
+
+  /* The first line read, in the order the stream goes, is the one
+     whose use reads the next batch.  */
+  CORE_ADDR marker = addrs[0];
+
+  std::sort (addrs.begin (), addrs.end ());
+  if (!dcache_fill_lines (dcache, addrs))
+    {
+      /* Make the stream start over, it has probably run off the end
+	 of the readable memory.  */
+      stream->delta = 0;
+      stream->window = 0;
+      return;
+    }
+
+  for (CORE_ADDR addr : addrs)
+    dcache_lookup (dcache, addr)->prefetched = true;
+  dcache->prefetched += addrs.size ();
+  stream->marker = marker;
+}
+
+/* Record in the prefetcher of DCACHE a read that missed, covering SPAN
+   lines from the line at ADDR, and read ahead if the read continues a
+   stream of reads.  Return the stream the read was recorded in.  */
+
+static dcache_stream *
+dcache_train_prefetcher (DCACHE *dcache, CORE_ADDR addr, unsigned span)
+{
+  LONGEST line_size = dcache->line_size;
+  LONGEST near = DCACHE_PREFETCH_NEAR_LINES * line_size;
+  LONGEST far = DCACHE_PREFETCH_MAX_STRIDE_LINES * line_size;
+  dcache_stream *match = nullptr;
+  dcache_stream *candidate = nullptr;
+  dcache_stream *oldest = nullptr;
+
+  for (dcache_stream &stream : dcache->streams)
+    {
+      if (oldest == nullptr || stream.stamp < oldest->stamp)
+	oldest = &stream;
+      if (stream.stamp == 0)
+	continue;
+
+      LONGEST delta = (LONGEST) (addr - stream.last);
+      if (delta == 0 || delta > far || delta < -far)
+	continue;
+
+      /* A read continues a stream if it moves by the same distance as
+	 the last one, or if both are small moves in the same
+	 direction.  */
+      if (delta == stream.delta
+	  || (stream.delta != 0
+	      && (delta > 0) == (stream.delta > 0)
+	      && std::abs (delta) <= near
+	      && std::abs (stream.delta) <= near))
+	{
+	  match = &stream;
+	  break;
+	}
+
+      if (stream.delta == 0 && candidate == nullptr)
+	candidate = &stream;
+    }
+
+  dcache->clock++;
+
+  if (match != nullptr)
+    {
+      LONGEST delta = (LONGEST) (addr - match->last);
+      LONGEST run = span * line_size;
+
+      /* Only a stream that moves by more than a read's worth of lines
+	 leaves gaps; read the others ahead as sequential streams.  */
+      if (delta == match->delta && std::abs (delta) > run)
+	match->stride = delta;
+      else
+	match->stride = delta > 0 ? run : -run;
+
+      match->last = addr;
+      match->delta = delta;
+      match->span = span;
+      match->stamp = dcache->clock;
+      match->next = addr + match->stride;
+      if (match->window == 0)
+	match->window = DCACHE_PREFETCH_MIN_LINES;
+      dcache_prefetch_stream (dcache, match);
+      return match;
+    }
+
+  if (candidate != nullptr)
+    {
+      candidate->delta = (LONGEST) (addr - candidate->last);
+      candidate->last = addr;
+      candidate->span = span;
+      candidate->stamp = dcache->clock;
+      return candidate;
+    }
+
+  *oldest = {};
+  oldest->last = addr;
+  oldest->span = span;
+  oldest->stamp = dcache->clock;
+  return oldest;
 }
 
 /* Write the byte at PTR into ADDR in the data cache.
@@ -431,34 +751,14 @@ dcache_poke_byte (DCACHE *dcache, CORE_ADDR addr, const gdb_byte *ptr)
     db->data[XFORM (dcache, addr)] = *ptr;
 }
 
-static int
-dcache_splay_tree_compare (splay_tree_key a, splay_tree_key b)
-{
-  if (a > b)
-    return 1;
-  else if (a == b)
-    return 0;
-  else
-    return -1;
-}
-
 /* Allocate and initialize a data cache.  */
 
 DCACHE *
 dcache_init (void)
 {
-  DCACHE *dcache = XNEW (DCACHE);
-
-  dcache->tree = splay_tree_new (dcache_splay_tree_compare,
-				 NULL,
-				 NULL);
+  DCACHE *dcache = new DCACHE;
 
-  dcache->oldest = NULL;
-  dcache->freelist = NULL;
-  dcache->size = 0;
   dcache->line_size = dcache_line_size;
-  dcache->ptid = null_ptid;
-  dcache->proc_target = nullptr;
 
   return dcache;
 }
@@ -487,15 +787,88 @@ dcache_read_memory_partial (struct target_ops *ops, DCACHE *dcache,
       dcache->proc_target = proc_target;
     }
 
-  for (i = 0; i < len; i++)
+  CORE_ADDR first = MASK (dcache, memaddr);
+  ULONGEST nlines = 0;
+  if (len > 0)
+    nlines = (MASK (dcache, memaddr + len - 1) - first) / dcache->line_size + 1;
+
+  /* Look up the lines the read needs, noting which are missing and
+     which prefetched lines are used for the first time.  */
+  std::vector<CORE_ADDR> missing;
+  bool missed = false;
+  unsigned triggered = 0;
+  for (ULONGEST n = 0; n < nlines; n++)
+    {
+      CORE_ADDR addr = first + n * dcache->line_size;
+      struct dcache_block *db = dcache_hit (dcache, addr);
+
+      if (db == NULL)
+	{
+	  dcache->misses++;
+	  missed = true;
+
+	  /* Lines that span memory regions are left for
+	     dcache_read_line, and more lines than the cache holds would
+	     evict each other.  */
+	  if (nlines < dcache_size && dcache_line_readable_p (dcache, addr))
+	    missing.push_back (addr);
+	  continue;
+	}
+
+      dcache->hits++;
+      if (db->prefetched)
+	{
+	  db->prefetched = false;
+	  dcache->prefetch_hits++;
+	  for (int s = 0; s < DCACHE_PREFETCH_STREAMS; s++)
+	    if (dcache->streams[s].window != 0
+		&& dcache->streams[s].marker == addr)
+	      triggered |= 1u << s;
+	}
+    }
+
+  /* Fetch the lines a large read needs together, rather than one by
+     one.  If that fails, they are read one by one below, to find out
+     how much can be read.  */
+  if (missing.size () > 1)
+    dcache_fill_lines (dcache, missing);
+
+  for (i = 0; i < len; )
     {
-      if (!dcache_peek_byte (dcache, memaddr + i, myaddr + i))
+      CORE_ADDR addr = memaddr + i;
+      struct dcache_block *db = dcache_lookup (dcache, addr);
+
+      if (db == NULL)
 	{
-	  /* That failed.  Discard its cache line so we don't have a
-	     partially read line.  */
-	  dcache_invalidate_line (dcache, memaddr + i);
-	  break;
+	  db = dcache_alloc (dcache, addr);
+	  if (!dcache_read_line (dcache, db))
+	    {
+	      /* That failed.  Discard its cache line so we don't have a
+		 partially read line.  */
+	      dcache_invalidate_line (dcache, addr);
+	      break;
+	    }
 	}
+
+      ULONGEST offset = XFORM (dcache, addr);
+      ULONGEST n = std::min<ULONGEST> (len - i, dcache->line_size - offset);
+      memcpy (myaddr + i, db->data + offset, n);
+      i += n;
+    }
+
+  /* Read ahead, once the lines of this read are no longer needed.  */
+  if (dcache_prefetch_p && i == len)
+    {
+      if (missed && nlines <= DCACHE_PREFETCH_MAX_LINES)
+	{
+	  dcache_stream *stream
+	    = dcache_train_prefetcher (dcache, first, nlines);
+	  triggered &= ~(1u << (stream - dcache->streams));
+	}
+
+      for (int s = 0; s < DCACHE_PREFETCH_STREAMS; s++)
+	if ((triggered & (1u << s)) != 0)
+	  dcache_prefetch_stream (dcache, &dcache->streams[s]);
     }
 
   if (i == 0)
@@ -543,14 +916,33 @@ dcache_update (DCACHE *dcache, enum target_xfer_status status,
       }
 }
 
+/* Return the lines of DCACHE, sorted by address.  */
+
+static std::vector<dcache_block *>
+dcache_sorted_lines (DCACHE *dcache)
+{
+  std::vector<dcache_block *> blocks;
+
+  blocks.reserve (dcache->lines.size ());
+  for (const auto &item : dcache->lines)
+    blocks.push_back (item.second);
+
+  std::sort (blocks.begin (), blocks.end (),
+	     [] (const dcache_block *a, const dcache_block *b)
+	     {
+	       return a->addr < b->addr;
+	     });
+
+  return blocks;
+}
+
 /* Print DCACHE line INDEX.  */
 
 static void
 dcache_print_line (DCACHE *dcache, int index)
 {
-  splay_tree_node n;
   struct dcache_block *db;
-  int i, j;
+  int j;
 
   if (dcache == NULL)
     {
@@ -558,22 +950,15 @@ dcache_print_line (DCACHE *dcache, int index)
       return;
     }
 
-  n = splay_tree_min (dcache->tree);
+  std::vector<dcache_block *> blocks = dcache_sorted_lines (dcache);
 
-  for (i = index; i > 0; --i)
-    {
-      if (!n)
-	break;
-      n = splay_tree_successor (dcache->tree, n->key);
-    }
-
-  if (!n)
+  if ((size_t) index >= blocks.size ())
     {
       gdb_printf (_("No such cache line exists.\n"));
       return;
     }
-    
-  db = (struct dcache_block *) n->value;
+
+  db = blocks[index];
 
   gdb_printf (_("Line %d: address %s [%d hits]\n"),
 	      index, paddress (current_inferior ()->arch (), db->addr),
@@ -595,7 +980,6 @@ dcache_print_line (DCACHE *dcache, int index)
 static void
 dcache_info_1 (DCACHE *dcache, const char *exp)
 {
-  splay_tree_node n;
   int i, refcount;
 
   if (exp)
@@ -628,24 +1012,22 @@ dcache_info_1 (DCACHE *dcache, const char *exp)
 	      target_pid_to_str (dcache->ptid).c_str ());
 
   refcount = 0;
-
-  n = splay_tree_min (dcache->tree);
   i = 0;
 
-  while (n)
+  for (dcache_block *db : dcache_sorted_lines (dcache))
     {
-      struct dcache_block *db = (struct dcache_block *) n->value;
-
       gdb_printf (_("Line %d: address %s [%d hits]\n"),
 		  i, paddress (current_inferior ()->arch (), db->addr),
 		  db->refs);
       i++;
       refcount += db->refs;
-
-      n = splay_tree_successor (dcache->tree, n->key);
     }
 
   gdb_printf (_("Cache state: %d active lines, %d hits\n"), i, refcount);
+  gdb_printf (_("Line lookups: %lu hits, %lu misses; "
+		"%lu lines prefetched, %lu of them used\n"),
+	      dcache->hits, dcache->misses,
+	      dcache->prefetched, dcache->prefetch_hits);
 }
 
 static void
@@ -700,8 +1082,9 @@ exists only for compatibility reasons."),
 	    _("\
 Print information on the dcache performance.\n\
 Usage: info dcache [LINENUMBER]\n\
-With no arguments, this command prints the cache configuration and a\n\
-summary of each line in the cache.  With an argument, dump\"\n\
+With no arguments, this command prints the cache configuration, a\n\
+summary of each line in the cache, and how many lookups hit or missed\n\
+the cache.  With an argument, dump\"\n\
 the contents of the given line."));
 
   add_setshow_prefix_cmd ("dcache", class_obscure,
@@ -727,4 +1110,14 @@ Show number of dcache lines."),
 			     set_dcache_size,
 			     NULL,
 			     &dcache_set_list, &dcache_show_list);
+  add_setshow_boolean_cmd ("prefetch", class_obscure,
+			   &dcache_prefetch_p, _("\
+Set whether the dcache reads ahead of sequential or strided reads."), _("\
+Show whether the dcache reads ahead of sequential or strided reads."), _("\
+When on, the dcache follows reads that walk memory in a regular\n\
+pattern, and reads the lines they are expected to need next along\n\
+with the missing ones."),
+			   NULL,
+			   NULL,
+			   &dcache_set_list, &dcache_show_list);
 }
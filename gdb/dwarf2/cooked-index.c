@@ -270,6 +270,26 @@ cooked_index_shard::add (sect_offset die_offset, enum dwarf_tag tag,
 
 /* See cooked-index.h.  */
 
+cooked_index_entry *
+cooked_index_shard::add_finalized (sect_offset die_offset, enum dwarf_tag tag,
+				   cooked_index_flag flags, const char *name,
+				   const char *canonical,
+				   dwarf2_per_cu_data *per_cu, bool is_main)
+{
+  cooked_index_entry *result = create (die_offset, tag, flags, name,
+				       nullptr, per_cu);
+  result->canonical = canonical;
+  m_entries.push_back (result);
+  m_finalized = true;
+
+  if (is_main)
+    m_main = result;
+
+  return result;
+}
+
+/* See cooked-index.h.  */
+
 gdb::unique_xmalloc_ptr<char>
 cooked_index_shard::handle_gnat_encoded_entry (cooked_index_entry *entry,
 					       htab_t gnat_entries)
@@ -319,6 +339,9 @@ cooked_index_shard::handle_gnat_encoded_entry (cooked_index_entry *entry,
 void
 cooked_index_shard::finalize ()
 {
+  if (m_finalized)
+    return;
+
   auto hash_name_ptr = [] (const void *p)
     {
       const cooked_index_entry *entry = (const cooked_index_entry *) p;
@@ -477,14 +500,16 @@ cooked_index::wait (cooked_state desired_state, bool allow_quit)
 }
 
 void
-cooked_index::set_contents (vec_type &&vec)
+cooked_index::set_contents (vec_type &&vec, bool from_cache)
 {
   gdb_assert (m_vector.empty ());
   m_vector = std::move (vec);
 
   m_state->set (cooked_state::MAIN_AVAILABLE);
 
-  index_cache_store_context ctx (global_index_cache, m_per_bfd);
+  std::optional<index_cache_store_context> ctx;
+  if (!from_cache)
+    ctx.emplace (global_index_cache, m_per_bfd);
 
   /* This is run after finalization is done -- but not before.  If
      this task were submitted earlier, it would have to wait for
@@ -691,11 +716,13 @@ cooked_index::dump (gdbarch *arch)
 }
 
 void
-cooked_index::maybe_write_index (dwarf2_per_bfd *per_bfd,
-				 const index_cache_store_context &ctx)
+cooked_index::maybe_write_index
+  (dwarf2_per_bfd *per_bfd,
+   const std::optional<index_cache_store_context> &ctx)
 {
   /* (maybe) store an index in the cache.  */
-  global_index_cache.store (m_per_bfd, ctx);
+  if (ctx.has_value ())
+    global_index_cache.store (m_per_bfd, *ctx);
   m_state->set (cooked_state::CACHE_DONE);
 }
 
@@ -37,6 +37,7 @@
 #include "dwarf2/abbrev-cache.h"
 #include "gdbsupport/range-chain.h"
 #include "gdbsupport/task-group.h"
+#include "gdbsupport/work-queue.h"
 #include "complaints.h"
 #include "run-on-main-thread.h"
 
@@ -297,8 +298,6 @@ class cooked_index_shard
      for completion, will be returned.  */
   range find (const std::string &name, bool completing) const;
 
-private:
-
   /* Return the entry that is believed to represent the program's
      "main".  This will return NULL if no such entry is available.  */
   const cooked_index_entry *get_main () const
@@ -306,6 +305,28 @@ class cooked_index_shard
     return m_main;
   }
 
+  /* Return the address map of this shard.  */
+  const addrmap *get_addrmap () const
+  {
+    return m_addrmap;
+  }
+
+  /* Create a new entry from one that was read back from the index
+     cache, and register it with this object.  Such entries are
+     already finalized: CANONICAL is the entry's canonical name, and
+     entries must be added in sorted order.  If IS_MAIN is true, the
+     new entry becomes this shard's "main".  The caller is responsible
+     for setting the new entry's parent.  */
+  cooked_index_entry *add_finalized (sect_offset die_offset,
+				     enum dwarf_tag tag,
+				     cooked_index_flag flags,
+				     const char *name,
+				     const char *canonical,
+				     dwarf2_per_cu_data *per_cu,
+				     bool is_main);
+
+private:
+
   /* Look up ADDR in the address map, and return either the
      corresponding CU, or nullptr if the address could not be
      found.  */
@@ -339,7 +360,8 @@ class cooked_index_shard
   /* Finalize the index.  This should be called a single time, when
      the index has been fully populated.  It enters all the entries
      into the internal table.  This may be invoked in a worker
-     thread.  */
+     thread.  This does nothing for a shard that was read from the
+     index cache.  */
   void finalize ();
 
   /* Storage for the entries.  */
@@ -353,6 +375,9 @@ class cooked_index_shard
   addrmap *m_addrmap = nullptr;
   /* Storage for canonical names.  */
   std::vector<gdb::unique_xmalloc_ptr<char>> m_names;
+  /* True if the entries were read from the index cache, and so are
+     already finalized.  */
+  bool m_finalized = false;
 };
 
 class cutu_reader;
@@ -476,6 +501,11 @@ class cooked_index_worker
   /* Helper function that does most of the work for start_reading.  */
   void do_reading ();
 
+  /* Try to read the index from the index cache, and install it.
+     Return true on success; if false is returned, the DWARF must be
+     scanned.  */
+  bool read_from_cache ();
+
   /* After the last DWARF-reading task has finished, this function
      does the remaining work to finish the scan.  */
   void done_reading ();
@@ -485,7 +515,9 @@ class cooked_index_worker
 
   /* Process a batch of CUs.  This may be called multiple times in
      separate threads.  TASK_NUMBER indicates which task this is --
-     the result is stored in that slot of M_RESULTS.  */
+     the result is stored in that slot of M_RESULTS.  If M_UNIT_QUEUE
+     is set, then after [FIRST, END) has been processed, further
+     batches are taken from the queue until it is empty.  */
   void process_cus (size_t task_number, unit_iterator first,
  		    unit_iterator end);
 
@@ -506,6 +538,9 @@ class cooked_index_worker
   cooked_index_storage m_index_storage;
   /* Result of each worker task.  */
   std::vector<result_type> m_results;
+  /* When dynamic scheduling is in use, the queue of CUs that the
+     worker tasks take their work from.  */
+  std::unique_ptr<gdb::work_queue<unit_iterator>> m_unit_queue;
   /* Any warnings emitted.  This is not in 'result_type' because (for
      the time being at least), it's only needed in do_reading, not in
      every worker.  Note that deferred_warnings uses gdb_stderr in its
@@ -600,8 +635,10 @@ class cooked_index : public dwarf_scanner_base
   void start_reading ();
 
   /* Called by cooked_index_worker to set the contents of this index
-     and transition to the MAIN_AVAILABLE state.  */
-  void set_contents (vec_type &&vec);
+     and transition to the MAIN_AVAILABLE state.  FROM_CACHE is true
+     if the shards were read from the index cache; in this case they
+     are not written back to it.  */
+  void set_contents (vec_type &&vec, bool from_cache = false);
 
   /* A range over a vector of subranges.  */
   using range = range_chain<cooked_index_shard::range>;
@@ -622,6 +659,14 @@ class cooked_index : public dwarf_scanner_base
     return range (std::move (result_range));
   }
 
+  /* Return the shards of this index.  This waits for the index to
+     be finalized.  */
+  const vec_type &get_shards ()
+  {
+    wait (cooked_state::FINALIZED, true);
+    return m_vector;
+  }
+
   /* Look up ADDR in the address map, and return either the
      corresponding CU, or nullptr if the address could not be
      found.  */
@@ -664,9 +709,11 @@ class cooked_index : public dwarf_scanner_base
 
 private:
 
-  /* Maybe write the index to the index cache.  */
-  void maybe_write_index (dwarf2_per_bfd *per_bfd,
-			  const index_cache_store_context &);
+  /* Maybe write the index to the index cache.  CTX is empty if the
+     index should not be written.  */
+  void maybe_write_index
+    (dwarf2_per_bfd *per_bfd,
+     const std::optional<index_cache_store_context> &ctx);
 
   /* The vector of cooked_index objects.  This is stored because the
      entries are stored on the obstacks in those objects.  */
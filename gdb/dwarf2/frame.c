@@ -889,6 +889,162 @@ struct dwarf2_frame_cache
   struct dwarf2_frame_fn_data *fn_data;
 };
 
+/* The register rules found by running the CFI programs of an FDE up
+   to some PC.  When backtracing many threads, the same return
+   addresses come up again and again, so these are remembered rather
+   than computed for every frame.  */
+
+struct dwarf2_frame_rules
+{
+  /* The rules, with no remembered states.  */
+  dwarf2_frame_state_reg_info regs;
+
+  /* The address of the row of the rules, for complaints.  */
+  unrelocated_addr row_pc;
+
+  /* Whether the programs were first run up to the entry PC of the
+     function, and if so which.  This depends on the frame rather than
+     just on the PC, so it must match for the rules to be reused.  */
+  bool entry_pc_p;
+  unrelocated_addr entry_pc;
+
+  /* The CFA offset from the stack pointer at the entry PC, if known.  */
+  bool entry_cfa_sp_offset_p;
+  LONGEST entry_cfa_sp_offset;
+};
+
+/* The key of the rule cache: an FDE, and an unrelocated PC.  The
+   rules also depend on the architecture of the frame, for instance
+   through the register numbering and the quirks of the producer, so
+   it is part of the key too.  */
+
+struct dwarf2_frame_rules_key
+{
+  struct gdbarch *gdbarch;
+  const dwarf2_fde *fde;
+  unrelocated_addr pc;
+
+  bool operator== (const dwarf2_frame_rules_key &other) const
+  {
+    return (gdbarch == other.gdbarch
+	    && fde == other.fde
+	    && pc == other.pc);
+  }
+};
+
+struct dwarf2_frame_rules_key_hash
+{
+  size_t operator() (const dwarf2_frame_rules_key &key) const noexcept
+  {
+    return (std::hash<const dwarf2_fde *> () (key.fde)
+	    ^ std::hash<ULONGEST> () ((ULONGEST) key.pc)
+	    ^ std::hash<struct gdbarch *> () (key.gdbarch));
+  }
+};
+
+/* The rule cache of an objfile.  */
+
+struct dwarf2_frame_rule_cache
+{
+  std::unordered_map<dwarf2_frame_rules_key, dwarf2_frame_rules,
+		     dwarf2_frame_rules_key_hash> rules;
+
+  /* Statistics, for "maint print statistics".  */
+  unsigned long hits = 0;
+  unsigned long misses = 0;
+};
+
+/* The cache is emptied when it reaches this many entries, which
+   bounds its memory use.  */
+
+#define DWARF2_FRAME_RULE_CACHE_SIZE 16384
+
+static const registry<objfile>::key<dwarf2_frame_rule_cache>
+  dwarf2_frame_rule_cache_key;
+
+/* Look up the rules of FDE at PC for GDBARCH in OBJFILE's cache, when the
+   function's entry PC is ENTRY_PC if ENTRY_PC_P.  If found, store them in FS and
+   the entry CFA offset in *ENTRY_CFA_SP_OFFSET_P and *ENTRY_CFA_SP_OFFSET,
+   and return true.  */
+
+static bool
+dwarf2_frame_find_rules (struct objfile *objfile, struct gdbarch *gdbarch,
+			 const dwarf2_fde *fde, unrelocated_addr pc, bool entry_pc_p,
+			 unrelocated_addr entry_pc,
+			 struct dwarf2_frame_state *fs,
+			 int *entry_cfa_sp_offset_p,
+			 LONGEST *entry_cfa_sp_offset)
+{
+  dwarf2_frame_rule_cache *cache = dwarf2_frame_rule_cache_key.get (objfile);
+  if (cache == nullptr)
+    cache = dwarf2_frame_rule_cache_key.emplace (objfile);
+
+  auto it = cache->rules.find ({gdbarch, fde, pc});
+  if (it == cache->rules.end ()
+      || it->second.entry_pc_p != entry_pc_p
+      || (entry_pc_p && it->second.entry_pc != entry_pc))
+    {
+      cache->misses++;
+      return false;
+    }
+
+  cache->hits++;
+  fs->regs = it->second.regs;
+  fs->pc = (CORE_ADDR) it->second.row_pc + objfile->text_section_offset ();
+  *entry_cfa_sp_offset_p = it->second.entry_cfa_sp_offset_p;
+  *entry_cfa_sp_offset = it->second.entry_cfa_sp_offset;
+  return true;
+}
+
+/* Remember the rules in FS of FDE at PC for GDBARCH in OBJFILE's cache.  The other
+   arguments are as for dwarf2_frame_find_rules.  */
+
+static void
+dwarf2_frame_remember_rules (struct objfile *objfile,
+			     struct gdbarch *gdbarch, const dwarf2_fde *fde,
+			     unrelocated_addr pc, bool entry_pc_p,
+			     unrelocated_addr entry_pc,
+			     const struct dwarf2_frame_state &fs,
+			     int entry_cfa_sp_offset_p,
+			     LONGEST entry_cfa_sp_offset)
+{
+  dwarf2_frame_rule_cache *cache = dwarf2_frame_rule_cache_key.get (objfile);
+  gdb_assert (cache != nullptr);
+
+  if (cache->rules.size () >= DWARF2_FRAME_RULE_CACHE_SIZE)
+    cache->rules.clear ();
+
+  dwarf2_frame_rules &rules = cache->rules[{gdbarch, fde, pc}];
+  rules.regs = fs.regs;
+  /* Remembered states are only needed while running the programs, and
+     are owned by FS.  */
+  rules.regs.prev = nullptr;
+  rules.row_pc = (unrelocated_addr) (fs.pc - objfile->text_section_offset ());
+  rules.entry_pc_p = entry_pc_p;
+  rules.entry_pc = entry_pc;
+  rules.entry_cfa_sp_offset_p = entry_cfa_sp_offset_p;
+  rules.entry_cfa_sp_offset = entry_cfa_sp_offset;
+}
+
+/* See frame.h.  */
+
+void
+dwarf2_frame_print_statistics (struct objfile *objfile)
+{
+  dwarf2_frame_rule_cache *cache = dwarf2_frame_rule_cache_key.get (objfile);
+  if (cache == nullptr)
+    return;
+
+  gdb_printf (_("DWARF CFI rule cache statistics for '%s':\n"),
+	      objfile_name (objfile));
+  gdb_printf (_("  Number of DWARF CFI rule cache entries: %zu\n"),
+	      cache->rules.size ());
+  gdb_printf (_("  Number of DWARF CFI rule cache hits: %lu\n"),
+	      cache->hits);
+  gdb_printf (_("  Number of DWARF CFI rule cache misses: %lu\n"),
+	      cache->misses);
+}
+
 static struct dwarf2_frame_cache *
 dwarf2_frame_cache (frame_info_ptr this_frame, void **this_cache)
 {
@@ -922,7 +1078,8 @@ dwarf2_frame_cache (frame_info_ptr this_frame, void **this_cache)
      get_frame_address_in_block does just this.  It's not clear how
      reliable the method is though; there is the potential for the
      register state pre-call being different to that on return.  */
-  CORE_ADDR pc1 = get_frame_address_in_block (this_frame);
+  CORE_ADDR pc = get_frame_address_in_block (this_frame);
+  CORE_ADDR pc1 = pc;
 
   /* Find the correct FDE.  */
   fde = dwarf2_frame_find_fde (&pc1, &cache->per_objfile);
@@ -939,44 +1096,58 @@ dwarf2_frame_cache (frame_info_ptr this_frame, void **this_cache)
   /* Check for "quirks" - known bugs in producers.  */
   dwarf2_frame_find_quirks (&fs, fde);
 
-  /* First decode all the insns in the CIE.  */
-  execute_cfa_program (fde, fde->cie->initial_instructions,
-		       fde->cie->end, gdbarch,
-		       get_frame_address_in_block (this_frame), &fs,
-		       text_offset);
-
-  /* Save the initialized register set.  */
-  fs.initial = fs.regs;
-
   /* Fetching the entry pc for THIS_FRAME won't necessarily result
      in an address that's within the range of FDE locations.  This
      is due to the possibility of the function occupying non-contiguous
      ranges.  */
-  LONGEST entry_cfa_sp_offset;
+  bool entry_pc_p
+    = (get_frame_func_if_available (this_frame, &entry_pc)
+       && fde->initial_location <= (unrelocated_addr) (entry_pc - text_offset)
+       && (unrelocated_addr) (entry_pc - text_offset) < fde->end_addr ());
+  unrelocated_addr unrel_entry_pc
+    = (entry_pc_p
+       ? (unrelocated_addr) (entry_pc - text_offset) : (unrelocated_addr) 0);
+  unrelocated_addr unrel_pc = (unrelocated_addr) (pc - text_offset);
+  struct objfile *objfile = cache->per_objfile->objfile;
+
+  LONGEST entry_cfa_sp_offset = 0;
   int entry_cfa_sp_offset_p = 0;
-  if (get_frame_func_if_available (this_frame, &entry_pc)
-      && fde->initial_location <= (unrelocated_addr) (entry_pc - text_offset)
-      && (unrelocated_addr) (entry_pc - text_offset) < fde->end_addr ())
+  if (!dwarf2_frame_find_rules (objfile, gdbarch, fde, unrel_pc, entry_pc_p,
+				unrel_entry_pc, &fs, &entry_cfa_sp_offset_p,
+				&entry_cfa_sp_offset))
     {
-      /* Decode the insns in the FDE up to the entry PC.  */
-      instr = execute_cfa_program (fde, fde->instructions, fde->end, gdbarch,
-				   entry_pc, &fs, text_offset);
+      /* First decode all the insns in the CIE.  */
+      execute_cfa_program (fde, fde->cie->initial_instructions,
+			   fde->cie->end, gdbarch, pc, &fs, text_offset);
 
-      if (fs.regs.cfa_how == CFA_REG_OFFSET
-	  && (dwarf_reg_to_regnum (gdbarch, fs.regs.cfa_reg)
-	      == gdbarch_sp_regnum (gdbarch)))
+      /* Save the initialized register set.  */
+      fs.initial = fs.regs;
+
+      if (entry_pc_p)
 	{
-	  entry_cfa_sp_offset = fs.regs.cfa_offset;
-	  entry_cfa_sp_offset_p = 1;
+	  /* Decode the insns in the FDE up to the entry PC.  */
+	  instr = execute_cfa_program (fde, fde->instructions, fde->end,
+				       gdbarch, entry_pc, &fs, text_offset);
+
+	  if (fs.regs.cfa_how == CFA_REG_OFFSET
+	      && (dwarf_reg_to_regnum (gdbarch, fs.regs.cfa_reg)
+		  == gdbarch_sp_regnum (gdbarch)))
+	    {
+	      entry_cfa_sp_offset = fs.regs.cfa_offset;
+	      entry_cfa_sp_offset_p = 1;
+	    }
 	}
-    }
-  else
-    instr = fde->instructions;
+      else
+	instr = fde->instructions;
 
-  /* Then decode the insns in the FDE up to our target PC.  */
-  execute_cfa_program (fde, instr, fde->end, gdbarch,
-		       get_frame_address_in_block (this_frame), &fs,
-		       text_offset);
+      /* Then decode the insns in the FDE up to our target PC.  */
+      execute_cfa_program (fde, instr, fde->end, gdbarch, pc, &fs,
+			   text_offset);
+
+      dwarf2_frame_remember_rules (objfile, gdbarch, fde, unrel_pc,
+				   entry_pc_p, unrel_entry_pc, fs,
+				   entry_cfa_sp_offset_p, entry_cfa_sp_offset);
+    }
 
   try
     {
@@ -198,6 +198,11 @@ struct dwarf2_frame_state
   bool armcc_cfa_offsets_reversed = false;
 };
 
+/* Print statistics about OBJFILE's cache of CFI register rules, for
+   "maint print statistics".  */
+
+extern void dwarf2_frame_print_statistics (struct objfile *objfile);
+
 /* When this is true the DWARF frame unwinders can be used if they are
    registered with the gdbarch.  Not all architectures can or do use the
    DWARF unwinders.  Setting this to true on a target that does not
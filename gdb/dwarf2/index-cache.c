@@ -90,7 +90,8 @@ index_cache::disable ()
 
 index_cache_store_context::index_cache_store_context (const index_cache &ic,
 						      dwarf2_per_bfd *per_bfd)
-  :  m_enabled (ic.enabled ())
+  :  m_enabled (ic.enabled ()),
+     m_format (ic.format ())
 {
   if (!m_enabled)
     return;
@@ -170,9 +171,13 @@ index_cache::store (dwarf2_per_bfd *per_bfd,
 
       /* Write the index itself to the directory, using the build id as the
 	 filename.  */
-      write_dwarf_index (per_bfd, m_dir.c_str (),
-			 ctx.build_id_str.c_str (), dwz_build_id_ptr,
-			 dw_index_kind::GDB_INDEX);
+      if (ctx.m_format == index_cache_format::COOKED)
+	write_cooked_index_file (per_bfd, m_dir.c_str (),
+				 ctx.build_id_str.c_str (), dwz_build_id_ptr);
+      else
+	write_dwarf_index (per_bfd, m_dir.c_str (),
+			   ctx.build_id_str.c_str (), dwz_build_id_ptr,
+			   dw_index_kind::GDB_INDEX);
     }
   catch (const gdb_exception_error &except)
     {
@@ -199,8 +204,8 @@ struct index_cache_resource_mmap final : public index_cache_resource
 /* See dwarf-index-cache.h.  */
 
 gdb::array_view<const gdb_byte>
-index_cache::lookup_gdb_index (const bfd_build_id *build_id,
-			       std::unique_ptr<index_cache_resource> *resource)
+index_cache::lookup (const bfd_build_id *build_id, const char *suffix,
+		     std::unique_ptr<index_cache_resource> *resource)
 {
   if (!enabled ())
     return {};
@@ -212,8 +217,8 @@ index_cache::lookup_gdb_index (const bfd_build_id *build_id,
       return {};
     }
 
-  /* Compute where we would expect a gdb index file for this build id to be.  */
-  std::string filename = make_index_filename (build_id, INDEX4_SUFFIX);
+  /* Compute where we would expect an index file for this build id to be.  */
+  std::string filename = make_index_filename (build_id, suffix);
 
   try
     {
@@ -245,8 +250,8 @@ index_cache::lookup_gdb_index (const bfd_build_id *build_id,
 /* See dwarf-index-cache.h.  This is a no-op on unsupported systems.  */
 
 gdb::array_view<const gdb_byte>
-index_cache::lookup_gdb_index (const bfd_build_id *build_id,
-			       std::unique_ptr<index_cache_resource> *resource)
+index_cache::lookup (const bfd_build_id *build_id, const char *suffix,
+		     std::unique_ptr<index_cache_resource> *resource)
 {
   return {};
 }
@@ -255,6 +260,24 @@ index_cache::lookup_gdb_index (const bfd_build_id *build_id,
 
 /* See dwarf-index-cache.h.  */
 
+gdb::array_view<const gdb_byte>
+index_cache::lookup_gdb_index (const bfd_build_id *build_id,
+			       std::unique_ptr<index_cache_resource> *resource)
+{
+  return lookup (build_id, INDEX4_SUFFIX, resource);
+}
+
+/* See dwarf-index-cache.h.  */
+
+gdb::array_view<const gdb_byte>
+index_cache::lookup_cooked_index (const bfd_build_id *build_id,
+				  std::unique_ptr<index_cache_resource> *resource)
+{
+  return lookup (build_id, COOKED_INDEX_SUFFIX, resource);
+}
+
+/* See dwarf-index-cache.h.  */
+
 std::string
 index_cache::make_index_filename (const bfd_build_id *build_id,
 				  const char *suffix) const
@@ -324,6 +347,40 @@ set_index_cache_directory_command (const char *arg, int from_tty,
   global_index_cache.set_directory (index_cache_directory);
 }
 
+/* The possible values of "set index-cache format".  */
+
+static const char index_cache_format_gdb_index[] = "gdb-index";
+static const char index_cache_format_cooked[] = "cooked";
+static const char *const index_cache_format_enums[] =
+{
+  index_cache_format_gdb_index,
+  index_cache_format_cooked,
+  nullptr
+};
+
+static const char *index_cache_format_string = index_cache_format_gdb_index;
+
+/* "set index-cache format" handler.  */
+
+static void
+set_index_cache_format_command (const char *arg, int from_tty,
+				cmd_list_element *element)
+{
+  global_index_cache.set_format
+    (index_cache_format_string == index_cache_format_cooked
+     ? index_cache_format::COOKED
+     : index_cache_format::GDB_INDEX);
+}
+
+/* "show index-cache format" handler.  */
+
+static void
+show_index_cache_format_command (ui_file *stream, int from_tty,
+				 cmd_list_element *cmd, const char *value)
+{
+  gdb_printf (stream, _("The index cache format is \"%s\".\n"), value);
+}
+
 /* "show index-cache stats" handler.  */
 
 static void
@@ -405,6 +462,20 @@ _initialize_index_cache ()
 			    &set_index_cache_prefix_list,
 			    &show_index_cache_prefix_list);
 
+  /* set/show index-cache format */
+  add_setshow_enum_cmd ("format", class_files, index_cache_format_enums,
+			&index_cache_format_string,
+			_("Set the format of the index cache files."),
+			_("Show the format of the index cache files."),
+			_("\
+\"gdb-index\" writes indices in the .gdb_index format.  \"cooked\" writes\n\
+a direct copy of GDB's internal DWARF index, which is faster to load and\n\
+is mapped into memory, so that it can be shared between GDB sessions."),
+			set_index_cache_format_command,
+			show_index_cache_format_command,
+			&set_index_cache_prefix_list,
+			&show_index_cache_prefix_list);
+
   /* show index-cache stats */
   add_cmd ("stats", class_files, show_index_cache_stats_command,
 	   _("Show some stats about the index cache."),
@@ -23,10 +23,25 @@
 #include "dwarf2/index-common.h"
 #include "gdbsupport/array-view.h"
 #include "symfile.h"
+#include <atomic>
 
 class dwarf2_per_bfd;
 class index_cache;
 
+/* The format of the index files written to the cache.  */
+
+enum class index_cache_format
+{
+  /* GDB's .gdb_index format.  This is portable, but loses some of
+     the information that the cooked index has.  */
+  GDB_INDEX,
+
+  /* A direct serialization of the cooked index.  When it is read
+     back, the DWARF does not need to be scanned or the names
+     canonicalized again.  See read-cooked-index.h.  */
+  COOKED,
+};
+
 /* Base of the classes used to hold the resources of the indices loaded from
    the cache (e.g. mmapped files).  */
 
@@ -48,6 +63,9 @@ struct index_cache_store_context
   /* Captured value of enabled ().  */
   bool m_enabled;
 
+  /* Captured value of format ().  */
+  index_cache_format m_format;
+
   /* Captured value of build id.  */
   std::string build_id_str;
 
@@ -76,6 +94,20 @@ class index_cache
   /* Disable the cache.  */
   void disable ();
 
+  /* Return the format of the index files that are written to the
+     cache.  */
+  index_cache_format format () const
+  {
+    return m_format;
+  }
+
+  /* Set the format of the index files that are written to the
+     cache.  */
+  void set_format (index_cache_format format)
+  {
+    m_format = format;
+  }
+
   /* Store an index for the specified object file in the cache.  */
   void store (dwarf2_per_bfd *per_bfd,
 	      const index_cache_store_context &);
@@ -90,6 +122,12 @@ class index_cache
   lookup_gdb_index (const bfd_build_id *build_id,
 		    std::unique_ptr<index_cache_resource> *resource);
 
+  /* Like lookup_gdb_index, but look for a serialized cooked index;
+     see index_cache_format::COOKED.  */
+  gdb::array_view<const gdb_byte>
+  lookup_cooked_index (const bfd_build_id *build_id,
+		       std::unique_ptr<index_cache_resource> *resource);
+
   /* Return the number of cache hits.  */
   unsigned int n_hits () const
   { return m_n_hits; }
@@ -114,6 +152,12 @@ class index_cache
 
 private:
 
+  /* Look for a file with suffix SUFFIX matching BUILD_ID.  See
+     lookup_gdb_index.  */
+  gdb::array_view<const gdb_byte>
+  lookup (const bfd_build_id *build_id, const char *suffix,
+	  std::unique_ptr<index_cache_resource> *resource);
+
   /* Compute the absolute filename where the index of the objfile with build
      id BUILD_ID will be stored.  SUFFIX is appended at the end of the
      filename.  */
@@ -126,9 +170,14 @@ class index_cache
   /* Whether the cache is enabled.  */
   bool m_enabled = false;
 
-  /* Number of cache hits and misses during this GDB session.  */
-  unsigned int m_n_hits = 0;
-  unsigned int m_n_misses = 0;
+  /* The format of the files written to the cache.  */
+  index_cache_format m_format = index_cache_format::GDB_INDEX;
+
+  /* Number of cache hits and misses during this GDB session.  These
+     are atomic because a cooked index read from the cache is looked
+     up in a worker thread.  */
+  std::atomic<unsigned int> m_n_hits { 0 };
+  std::atomic<unsigned int> m_n_misses { 0 };
 };
 
 /* The global instance of the index cache.  */
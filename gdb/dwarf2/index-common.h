@@ -23,6 +23,7 @@
 /* The suffix for an index file.  */
 #define INDEX4_SUFFIX ".gdb-index"
 #define INDEX5_SUFFIX ".debug_names"
+#define COOKED_INDEX_SUFFIX ".gdb-cooked"
 #define DEBUG_STR_SUFFIX ".debug_str"
 
 /* All offsets in the index are of this type.  It must be
@@ -39,7 +39,9 @@
 #include "objfiles.h"
 #include "ada-lang.h"
 #include "dwarf2/tag.h"
+#include "dwarf2/read-cooked-index.h"
 #include "gdbsupport/gdb_tilde_expand.h"
+#include "gdbsupport/version.h"
 
 #include <algorithm>
 #include <cmath>
@@ -1662,6 +1664,187 @@ write_dwarf_index (dwarf2_per_bfd *per_bfd, const char *dir,
     dwz_index_wip->finalize ();
 }
 
+/* A string pool for a cooked index file.  Each distinct string is
+   stored once.  */
+
+class cooked_index_string_pool
+{
+public:
+
+  /* Add STR to the pool if needed, and return its offset.  */
+  offset_type add (const char *str)
+  {
+    auto iter = m_offsets.find (str);
+    if (iter != m_offsets.end ())
+      return iter->second;
+
+    if (m_buf.size () + strlen (str) + 1 > COOKED_INDEX_NONE)
+      error (_("Cooked index string pool is too large"));
+
+    offset_type offset = m_buf.size ();
+    m_buf.append_cstr0 (str);
+    m_offsets.emplace (str, offset);
+    return offset;
+  }
+
+  /* Return the contents of the pool.  */
+  const data_buf &contents () const
+  {
+    return m_buf;
+  }
+
+private:
+
+  /* The contents of the pool.  */
+  data_buf m_buf;
+
+  /* Map from a string to its offset in M_BUF.  The keys refer to the
+     strings passed to 'add', which must outlive this object.  */
+  std::unordered_map<std::string_view, offset_type> m_offsets;
+};
+
+/* Write the cooked index TABLE for PER_BFD to OUT_FILE, in the format
+   described in read-cooked-index.h.  */
+
+static void
+write_cooked_index (dwarf2_per_bfd *per_bfd, cooked_index *table,
+		    FILE *out_file, const char *dwz_build_id)
+{
+  const auto le = BFD_ENDIAN_LITTLE;
+  cooked_index_string_pool pool;
+
+  /* The unit table.  */
+  data_buf unit_table;
+  std::unordered_map<const dwarf2_per_cu_data *, offset_type> unit_index;
+  for (const auto &per_cu : per_bfd->all_units)
+    {
+      /* Type units may also be discovered while reading DWO files, in
+	 which case they can't be recreated without scanning the
+	 DWARF.  Keep things simple and never cache those.  */
+      if (per_cu->is_debug_types)
+	error (_("Cannot cache the index of a file with type units"));
+
+      offset_type index = unit_index.size ();
+      unit_index.emplace (per_cu.get (), index);
+
+      unit_table.append_uint (8, le, to_underlying (per_cu->sect_off));
+      unit_table.append_uint (4, le, per_cu->length ());
+      unit_table.append_uint (2, le, per_cu->dw_lang ());
+      unit_table.append_uint (1, le, per_cu->unit_type (false));
+      unit_table.append_uint (1, le, per_cu->lang (false));
+      unit_table.append_uint (1, le, per_cu->is_dwz);
+    }
+
+  auto get_unit_index = [&] (const dwarf2_per_cu_data *per_cu)
+    {
+      if (per_cu == nullptr)
+	return COOKED_INDEX_NONE;
+      auto iter = unit_index.find (per_cu);
+      if (iter == unit_index.end ())
+	error (_("Cooked index refers to an unknown unit"));
+      return iter->second;
+    };
+
+  /* Number all the entries first, because a parent may come after
+     its children, or be in another shard.  */
+  const cooked_index::vec_type &shards = table->get_shards ();
+  std::unordered_map<const cooked_index_entry *, offset_type> entry_index;
+  for (const auto &shard : shards)
+    for (const cooked_index_entry *entry : shard->all_entries ())
+      {
+	offset_type index = entry_index.size ();
+	entry_index.emplace (entry, index);
+      }
+
+  data_buf shard_table, entry_table, addr_table;
+  offset_type n_entries = 0, n_addrs = 0;
+  for (const auto &shard : shards)
+    {
+      offset_type first_entry = n_entries;
+      offset_type first_addr = n_addrs;
+
+      for (const cooked_index_entry *entry : shard->all_entries ())
+	{
+	  offset_type parent = COOKED_INDEX_NONE;
+	  if (entry->parent_entry != nullptr)
+	    {
+	      auto iter = entry_index.find (entry->parent_entry);
+	      if (iter == entry_index.end ())
+		error (_("Cooked index entry has an unknown parent"));
+	      parent = iter->second;
+	    }
+
+	  entry_table.append_uint (8, le, to_underlying (entry->die_offset));
+	  entry_table.append_offset (pool.add (entry->name));
+	  entry_table.append_offset (pool.add (entry->canonical));
+	  entry_table.append_offset (parent);
+	  entry_table.append_offset (get_unit_index (entry->per_cu));
+	  entry_table.append_uint (2, le, entry->tag);
+	  entry_table.append_uint (1, le, entry->flags);
+	  ++n_entries;
+	}
+
+      shard->get_addrmap ()->foreach ([&] (CORE_ADDR start, const void *obj)
+	{
+	  addr_table.append_uint (8, le, start);
+	  addr_table.append_offset
+	    (get_unit_index ((const dwarf2_per_cu_data *) obj));
+	  ++n_addrs;
+	  return 0;
+	});
+
+      const cooked_index_entry *main_entry = shard->get_main ();
+      shard_table.append_offset (first_entry);
+      shard_table.append_offset (n_entries - first_entry);
+      shard_table.append_offset (main_entry == nullptr
+				 ? COOKED_INDEX_NONE
+				 : entry_index.at (main_entry));
+      shard_table.append_offset (first_addr);
+      shard_table.append_offset (n_addrs - first_addr);
+    }
+
+  offset_type version_offset = pool.add (version);
+  offset_type dwz_offset = (dwz_build_id == nullptr
+			    ? COOKED_INDEX_NONE
+			    : pool.add (dwz_build_id));
+
+  data_buf header;
+  header.append_array (gdb::make_array_view
+		       ((const gdb_byte *) COOKED_INDEX_MAGIC,
+			sizeof (COOKED_INDEX_MAGIC)));
+  header.append_offset (COOKED_INDEX_VERSION);
+  header.append_offset (unit_index.size ());
+  header.append_offset (shards.size ());
+  header.append_offset (n_entries);
+  header.append_offset (n_addrs);
+  header.append_offset (pool.contents ().size ());
+  header.append_offset (version_offset);
+  header.append_offset (dwz_offset);
+  gdb_assert (header.size () == COOKED_INDEX_HEADER_SIZE);
+
+  header.file_write (out_file);
+  unit_table.file_write (out_file);
+  shard_table.file_write (out_file);
+  entry_table.file_write (out_file);
+  addr_table.file_write (out_file);
+  pool.contents ().file_write (out_file);
+}
+
+/* See dwarf-index-write.h.  */
+
+void
+write_cooked_index_file (dwarf2_per_bfd *per_bfd, const char *dir,
+			 const char *basename, const char *dwz_build_id)
+{
+  if (per_bfd->index_table == nullptr)
+    error (_("No debugging symbols"));
+  cooked_index *table = per_bfd->index_table->index_for_writing ();
+
+  index_wip_file wip (dir, basename, COOKED_INDEX_SUFFIX);
+  write_cooked_index (per_bfd, table, wip.out_file.get (), dwz_build_id);
+  wip.finalize ();
+}
+
 /* Options structure for the 'save gdb-index' command.  */
 
 struct save_gdb_index_options
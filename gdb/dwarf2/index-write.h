@@ -36,4 +36,14 @@ extern void write_dwarf_index
   (dwarf2_per_bfd *per_bfd, const char *dir, const char *basename,
    const char *dwz_basename, dw_index_kind index_kind);
 
+/* Write the cooked index of PER_BFD to a file in the directory DIR,
+   for use by the index cache.  BASENAME is the base of the file name.
+   DWZ_BUILD_ID is the build-id of the dwz file, if there is one;
+   unlike write_dwarf_index, its entries are written to the same
+   file.  See read-cooked-index.h for a description of the format.  */
+
+extern void write_cooked_index_file
+  (dwarf2_per_bfd *per_bfd, const char *dir, const char *basename,
+   const char *dwz_build_id);
+
 #endif /* DWARF_INDEX_WRITE_H */
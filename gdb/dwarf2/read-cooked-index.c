@@ -0,0 +1,333 @@
+/* Reading code for cooked index cache files
+
+   Copyright (C) 2024 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "dwarf2/read-cooked-index.h"
+#include "dwarf2/read.h"
+#include "addrmap.h"
+#include "cli/cli-cmds.h"
+#include "gdbsupport/version.h"
+
+/* When set to true, show debug messages about reading cooked index
+   files.  */
+static bool debug_cooked_index_file = false;
+
+#define cooked_index_file_debug(FMT, ...)				\
+  debug_prefixed_printf_cond_nofunc (debug_cooked_index_file,		\
+				     "cooked-index-file", FMT, ## __VA_ARGS__)
+
+/* A simple cursor over the contents of a cooked index file.  All the
+   bounds are checked by read_cooked_index_file before any record is
+   decoded, so this does no checking of its own.  */
+
+class cooked_index_file_reader
+{
+public:
+
+  explicit cooked_index_file_reader (const gdb_byte *ptr)
+    : m_ptr (ptr)
+  {
+  }
+
+  /* Read a little-endian integer of LEN bytes.  */
+  ULONGEST read (int len)
+  {
+    ULONGEST result = extract_unsigned_integer (m_ptr, len,
+						BFD_ENDIAN_LITTLE);
+    m_ptr += len;
+    return result;
+  }
+
+  /* Read a 4-byte offset or index.  */
+  offset_type read_offset ()
+  {
+    return read (sizeof (offset_type));
+  }
+
+private:
+
+  const gdb_byte *m_ptr;
+};
+
+/* Return the string at offset OFFSET in the string pool POOL, which
+   is POOL_SIZE bytes long, or NULL if OFFSET is invalid.  The pool is
+   known to end with a NUL, so the result is always terminated.  */
+
+static const char *
+pool_string (const gdb_byte *pool, offset_type pool_size, offset_type offset)
+{
+  if (offset >= pool_size)
+    return nullptr;
+  return (const char *) pool + offset;
+}
+
+/* See read-cooked-index.h.  */
+
+std::optional<cooked_index::vec_type>
+read_cooked_index_file (dwarf2_per_bfd *per_bfd,
+			gdb::array_view<const gdb_byte> contents,
+			const char *dwz_build_id)
+{
+  if (contents.size () < COOKED_INDEX_HEADER_SIZE
+      || memcmp (contents.data (), COOKED_INDEX_MAGIC,
+		 sizeof (COOKED_INDEX_MAGIC)) != 0)
+    {
+      cooked_index_file_debug ("bad magic");
+      return {};
+    }
+
+  cooked_index_file_reader header (contents.data ()
+				   + sizeof (COOKED_INDEX_MAGIC));
+  offset_type format_version = header.read_offset ();
+  offset_type n_units = header.read_offset ();
+  offset_type n_shards = header.read_offset ();
+  offset_type n_entries = header.read_offset ();
+  offset_type n_addrs = header.read_offset ();
+  offset_type pool_size = header.read_offset ();
+  offset_type gdb_version_offset = header.read_offset ();
+  offset_type dwz_build_id_offset = header.read_offset ();
+
+  if (format_version != COOKED_INDEX_VERSION)
+    {
+      cooked_index_file_debug ("unsupported version %u", format_version);
+      return {};
+    }
+
+  /* Compute the layout in 64 bits, so that a corrupt header can't
+     make it wrap around.  */
+  const ULONGEST units_offset = COOKED_INDEX_HEADER_SIZE;
+  const ULONGEST shards_offset
+    = units_offset + (ULONGEST) n_units * COOKED_INDEX_UNIT_SIZE;
+  const ULONGEST entries_offset
+    = shards_offset + (ULONGEST) n_shards * COOKED_INDEX_SHARD_SIZE;
+  const ULONGEST addrs_offset
+    = entries_offset + (ULONGEST) n_entries * COOKED_INDEX_ENTRY_SIZE;
+  const ULONGEST pool_offset
+    = addrs_offset + (ULONGEST) n_addrs * COOKED_INDEX_ADDR_SIZE;
+
+  if (pool_offset + pool_size != contents.size ()
+      || pool_size == 0
+      || contents[contents.size () - 1] != '\0')
+    {
+      cooked_index_file_debug ("bad size");
+      return {};
+    }
+
+  const gdb_byte *pool = contents.data () + pool_offset;
+
+  /* Files written by another GDB may not agree on the meaning of the
+     language and flag values.  */
+  const char *file_version = pool_string (pool, pool_size,
+					  gdb_version_offset);
+  if (file_version == nullptr || strcmp (file_version, version) != 0)
+    {
+      cooked_index_file_debug ("written by a different GDB");
+      return {};
+    }
+
+  const char *file_dwz_build_id
+    = (dwz_build_id_offset == COOKED_INDEX_NONE
+       ? nullptr
+       : pool_string (pool, pool_size, dwz_build_id_offset));
+  if ((file_dwz_build_id == nullptr) != (dwz_build_id == nullptr)
+      || (dwz_build_id != nullptr
+	  && strcmp (file_dwz_build_id, dwz_build_id) != 0))
+    {
+      cooked_index_file_debug ("dwz file mismatch");
+      return {};
+    }
+
+  /* Check that the units match the DWARF before changing any of
+     them.  */
+  if (n_units != per_bfd->all_units.size ())
+    {
+      cooked_index_file_debug ("unit count mismatch");
+      return {};
+    }
+
+  cooked_index_file_reader units (contents.data () + units_offset);
+  for (const auto &per_cu : per_bfd->all_units)
+    {
+      ULONGEST sect_off = units.read (8);
+      ULONGEST length = units.read (4);
+      units.read (2 + 1 + 1);
+      ULONGEST is_dwz = units.read (1);
+
+      if (per_cu->is_debug_types
+	  || sect_off != to_underlying (per_cu->sect_off)
+	  || length != per_cu->length ()
+	  || is_dwz != per_cu->is_dwz)
+	{
+	  cooked_index_file_debug ("unit mismatch at %s",
+				   sect_offset_str (per_cu->sect_off));
+	  return {};
+	}
+    }
+
+  /* Check the shard table, so that the entries and addresses can be
+     decoded without further checks.  */
+  cooked_index_file_reader shards (contents.data () + shards_offset);
+  ULONGEST next_entry = 0, next_addr = 0;
+  for (offset_type i = 0; i < n_shards; ++i)
+    {
+      offset_type first_entry = shards.read_offset ();
+      offset_type shard_entries = shards.read_offset ();
+      offset_type main_entry = shards.read_offset ();
+      offset_type first_addr = shards.read_offset ();
+      offset_type shard_addrs = shards.read_offset ();
+
+      if (first_entry != next_entry || first_addr != next_addr
+	  || (main_entry != COOKED_INDEX_NONE
+	      && (main_entry < first_entry
+		  || main_entry - first_entry >= shard_entries)))
+	{
+	  cooked_index_file_debug ("bad shard %u", i);
+	  return {};
+	}
+      next_entry += shard_entries;
+      next_addr += shard_addrs;
+    }
+  if (next_entry != n_entries || next_addr != n_addrs)
+    {
+      cooked_index_file_debug ("bad shard table");
+      return {};
+    }
+
+  /* Create all the entries first, then fill in the parents, which
+     may be in any shard.  */
+  std::vector<cooked_index_entry *> entries;
+  std::vector<offset_type> parents;
+  entries.reserve (n_entries);
+  parents.reserve (n_entries);
+
+  cooked_index::vec_type result;
+  cooked_index_file_reader entry_reader (contents.data () + entries_offset);
+  cooked_index_file_reader addr_reader (contents.data () + addrs_offset);
+  shards = cooked_index_file_reader (contents.data () + shards_offset);
+  for (offset_type i = 0; i < n_shards; ++i)
+    {
+      offset_type first_entry = shards.read_offset ();
+      offset_type shard_entries = shards.read_offset ();
+      offset_type main_entry = shards.read_offset ();
+      shards.read_offset ();
+      offset_type shard_addrs = shards.read_offset ();
+
+      auto shard = std::make_unique<cooked_index_shard> ();
+
+      for (offset_type j = 0; j < shard_entries; ++j)
+	{
+	  sect_offset die_offset = (sect_offset) entry_reader.read (8);
+	  const char *name = pool_string (pool, pool_size,
+					  entry_reader.read_offset ());
+	  const char *canonical = pool_string (pool, pool_size,
+					       entry_reader.read_offset ());
+	  offset_type parent = entry_reader.read_offset ();
+	  offset_type unit = entry_reader.read_offset ();
+	  dwarf_tag tag = (dwarf_tag) entry_reader.read (2);
+	  cooked_index_flag flags
+	    = (cooked_index_flag_enum) entry_reader.read (1);
+
+	  if (name == nullptr || canonical == nullptr
+	      || (parent != COOKED_INDEX_NONE && parent >= n_entries)
+	      || unit >= n_units)
+	    {
+	      cooked_index_file_debug ("bad entry %u",
+				       (unsigned) (first_entry + j));
+	      return {};
+	    }
+
+	  entries.push_back
+	    (shard->add_finalized (die_offset, tag, flags, name, canonical,
+				   per_bfd->all_units[unit].get (),
+				   first_entry + j == main_entry));
+	  parents.push_back (parent);
+	}
+
+      addrmap_mutable mutable_map;
+      std::optional<CORE_ADDR> range_start;
+      dwarf2_per_cu_data *range_unit = nullptr;
+      for (offset_type j = 0; j < shard_addrs; ++j)
+	{
+	  CORE_ADDR start = addr_reader.read (8);
+	  offset_type unit = addr_reader.read_offset ();
+
+	  if ((unit != COOKED_INDEX_NONE && unit >= n_units)
+	      || (range_start.has_value () && start <= *range_start))
+	    {
+	      cooked_index_file_debug ("bad address map in shard %u", i);
+	      return {};
+	    }
+
+	  if (range_unit != nullptr)
+	    mutable_map.set_empty (*range_start, start - 1, range_unit);
+	  range_start = start;
+	  range_unit = (unit == COOKED_INDEX_NONE
+			? nullptr
+			: per_bfd->all_units[unit].get ());
+	}
+      if (range_unit != nullptr)
+	mutable_map.set_empty (*range_start, (CORE_ADDR) -1, range_unit);
+      shard->install_addrmap (&mutable_map);
+
+      result.push_back (std::move (shard));
+    }
+
+  for (size_t i = 0; i < entries.size (); ++i)
+    if (parents[i] != COOKED_INDEX_NONE)
+      entries[i]->parent_entry = entries[parents[i]];
+
+  /* Everything checked out, so restore the state of the units.  Note
+     that the index is only usable once this has been done, because
+     the quick functions look at the language of the units.  */
+  units = cooked_index_file_reader (contents.data () + units_offset);
+  for (const auto &per_cu : per_bfd->all_units)
+    {
+      units.read (8 + 4);
+      dwarf_source_language dw_lang = (dwarf_source_language) units.read (2);
+      dwarf_unit_type unit_type = (dwarf_unit_type) units.read (1);
+      enum language lang = (enum language) units.read (1);
+      units.read (1);
+
+      if (unit_type != 0)
+	{
+	  per_cu->set_unit_type (unit_type);
+	  if (lang != language_unknown)
+	    per_cu->set_lang (lang, dw_lang);
+	}
+    }
+
+  cooked_index_file_debug ("read %u entries in %u shards",
+			   n_entries, n_shards);
+  return result;
+}
+
+void _initialize_read_cooked_index ();
+void
+_initialize_read_cooked_index ()
+{
+  add_setshow_boolean_cmd ("cooked-index-file", class_maintenance,
+			   &debug_cooked_index_file,
+			   _("Set display of cooked index file debug messages."),
+			   _("Show display of cooked index file debug messages."),
+			   _("\
+When non-zero, debugging output for reading cooked index files from the\n\
+index cache is displayed."),
+			   nullptr, nullptr,
+			   &setdebuglist, &showdebuglist);
+}
@@ -0,0 +1,124 @@
+/* Reading code for cooked index cache files
+
+   Copyright (C) 2024 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef DWARF2_READ_COOKED_INDEX_H
+#define DWARF2_READ_COOKED_INDEX_H
+
+#include "dwarf2/cooked-index.h"
+#include "dwarf2/index-common.h"
+
+/* A cooked index file is a direct serialization of a finalized
+   cooked_index, written to the index cache when "set index-cache
+   format cooked" is in effect.  Unlike .gdb_index, it keeps the
+   parent links, flags and canonical names of the entries, so reading
+   it back gives exactly the index that scanning the DWARF would.
+   It is private to a given GDB build: it records the GDB version,
+   and files written by any other version are ignored.
+
+   The file is mapped into memory, and the names of the entries point
+   directly into the mapping.  This way the string pool, which is
+   most of the file, is shared between all the GDB sessions that load
+   the same file.
+
+   All integers are little-endian and unaligned.  The file starts
+   with a fixed-size header:
+
+     magic		8 bytes, COOKED_INDEX_MAGIC
+     version		4 bytes, COOKED_INDEX_VERSION
+     n_units		4 bytes, number of units
+     n_shards		4 bytes, number of shards
+     n_entries		4 bytes, total number of entries
+     n_addrs		4 bytes, total number of address map entries
+     pool_size		4 bytes, size of the string pool
+     gdb_version	4 bytes, offset of GDB's version string in the pool
+     dwz_build_id	4 bytes, offset of the dwz file's build-id in the
+			pool, or COOKED_INDEX_NONE
+
+   This is followed by the unit table, the shard table, the entry
+   table, the address table, and the string pool, in that order.
+
+   Each unit record describes one element of the per-BFD all_units
+   vector, in order.  This is used to check that the file matches the
+   DWARF, and to restore the state of the units that the scanner
+   would have filled in:
+
+     sect_off		8 bytes
+     length		4 bytes
+     dw_lang		2 bytes, DW_LANG_* value
+     unit_type		1 byte, DW_UT_* value, or 0 if unknown
+     lang		1 byte, GDB's enum language
+     is_dwz		1 byte
+
+   Each shard record describes a slice of the entry and address
+   tables:
+
+     first_entry	4 bytes
+     n_entries		4 bytes
+     main_entry		4 bytes, index of the shard's "main" in the
+			entry table, or COOKED_INDEX_NONE
+     first_addr		4 bytes
+     n_addrs		4 bytes
+
+   The entries of a shard appear in sorted order.  Each entry record
+   is:
+
+     die_offset		8 bytes
+     name		4 bytes, offset in the pool
+     canonical		4 bytes, offset in the pool
+     parent		4 bytes, index in the entry table, or
+			COOKED_INDEX_NONE
+     unit		4 bytes, index in the unit table
+     tag		2 bytes, DW_TAG_* value
+     flags		1 byte, cooked_index_flag
+
+   The address records of a shard are the transitions of its address
+   map, in increasing address order.  Each one maps the addresses from
+   its start up to the start of the next record to a unit:
+
+     start		8 bytes
+     unit		4 bytes, index in the unit table, or
+			COOKED_INDEX_NONE for unmapped ranges
+
+   The string pool is a sequence of NUL-terminated strings.  */
+
+#define COOKED_INDEX_MAGIC "GDBCOOK"
+#define COOKED_INDEX_VERSION 1
+#define COOKED_INDEX_NONE ((offset_type) -1)
+
+/* Sizes of the header and of the records described above.  */
+#define COOKED_INDEX_HEADER_SIZE (8 + 8 * 4)
+#define COOKED_INDEX_UNIT_SIZE (8 + 4 + 2 + 1 + 1 + 1)
+#define COOKED_INDEX_SHARD_SIZE (5 * 4)
+#define COOKED_INDEX_ENTRY_SIZE (8 + 4 * 4 + 2 + 1)
+#define COOKED_INDEX_ADDR_SIZE (8 + 4)
+
+/* Decode the cooked index file CONTENTS, which must stay valid for as
+   long as the index is in use, for PER_BFD.  PER_BFD's units must
+   already have been created.  DWZ_BUILD_ID is the build-id of the dwz
+   file in use, or NULL if none.
+
+   Return the shards on success.  If the file is malformed, was
+   written by a different GDB, or doesn't match the DWARF, return an
+   empty optional; the caller should then scan the DWARF as usual.  */
+
+extern std::optional<cooked_index::vec_type> read_cooked_index_file
+  (dwarf2_per_bfd *per_bfd, gdb::array_view<const gdb_byte> contents,
+   const char *dwz_build_id);
+
+#endif /* DWARF2_READ_COOKED_INDEX_H */
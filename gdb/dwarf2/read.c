@@ -42,6 +42,7 @@
 #include "dwarf2/dwz.h"
 #include "dwarf2/macro.h"
 #include "dwarf2/die.h"
+#include "dwarf2/read-cooked-index.h"
 #include "dwarf2/read-debug-names.h"
 #include "dwarf2/read-gdb-index.h"
 #include "dwarf2/sect-names.h"
@@ -3253,10 +3254,13 @@ dwarf2_initialize_objfile (struct objfile *objfile,
       dwarf_read_debug_printf ("found gdb index from file");
       objfile->qf.push_front (per_bfd->index_table->make_quick_functions ());
     }
-  /* ... otherwise, try to find the index in the index cache.  */
-  else if (dwarf2_read_gdb_index (per_objfile,
-			     get_gdb_index_contents_from_cache,
-			     get_gdb_index_contents_from_cache_dwz))
+  /* ... otherwise, try to find the index in the index cache.  A
+     cooked index file is looked up by the cooked index worker
+     instead, see cooked_index_worker::read_from_cache.  */
+  else if (global_index_cache.format () == index_cache_format::GDB_INDEX
+	   && dwarf2_read_gdb_index (per_objfile,
+				     get_gdb_index_contents_from_cache,
+				     get_gdb_index_contents_from_cache_dwz))
     {
       dwarf_read_debug_printf ("found gdb index from cache");
       global_index_cache.hit ();
@@ -3264,7 +3268,8 @@ dwarf2_initialize_objfile (struct objfile *objfile,
     }
   else
     {
-      global_index_cache.miss ();
+      if (global_index_cache.format () == index_cache_format::GDB_INDEX)
+	global_index_cache.miss ();
       objfile->qf.push_front (make_cooked_index_funcs (per_objfile));
     }
   return true;
@@ -4848,6 +4853,9 @@ cooked_index_worker::cooked_index_worker (dwarf2_per_objfile *per_objfile)
   dwarf_read_debug_printf ("Building psymtabs of objfile %s ...",
 			   objfile_name (objfile));
 
+  /* Read the sections here rather than in the worker thread: sections
+     compressed as several pieces can only be decompressed in parallel
+     from the main thread.  */
   per_bfd->map_info_sections (objfile);
 }
 
@@ -4871,17 +4879,29 @@ cooked_index_worker::process_cus (size_t task_number, unit_iterator first,
 
   std::vector<gdb_exception> errors;
   cooked_index_storage thread_storage;
-  for (auto inner = first; inner != end; ++inner)
+  while (true)
     {
-      dwarf2_per_cu_data *per_cu = inner->get ();
-      try
-	{
-	  process_psymtab_comp_unit (per_cu, m_per_objfile, &thread_storage);
-	}
-      catch (gdb_exception &except)
+      for (auto inner = first; inner != end; ++inner)
 	{
-	  errors.push_back (std::move (except));
+	  dwarf2_per_cu_data *per_cu = inner->get ();
+	  try
+	    {
+	      process_psymtab_comp_unit (per_cu, m_per_objfile,
+					 &thread_storage);
+	    }
+	  catch (gdb_exception &except)
+	    {
+	      errors.push_back (std::move (except));
+	    }
 	}
+
+      /* With dynamic scheduling, keep taking more units from the
+	 shared queue until it is empty.  */
+      if (m_unit_queue == nullptr)
+	break;
+      std::tie (first, end) = m_unit_queue->pop_batch ();
+      if (first == end)
+	break;
     }
 
   m_results[task_number] = result_type (thread_storage.release (),
@@ -4927,12 +4947,73 @@ cooked_index_worker::start_reading ()
     }
 }
 
+bool
+cooked_index_worker::read_from_cache ()
+{
+  if (global_index_cache.format () != index_cache_format::COOKED
+      || !global_index_cache.enabled ())
+    return false;
+
+  dwarf2_per_bfd *per_bfd = m_per_objfile->per_bfd;
+
+  std::optional<cooked_index::vec_type> shards;
+  std::unique_ptr<index_cache_resource> resource;
+  const bfd_build_id *build_id = build_id_bfd_get (per_bfd->obfd);
+  if (build_id != nullptr)
+    {
+      gdb::array_view<const gdb_byte> contents
+	= global_index_cache.lookup_cooked_index (build_id, &resource);
+
+      std::optional<std::string> dwz_build_id;
+      const dwz_file *dwz = dwarf2_get_dwz_file (per_bfd);
+      if (dwz != nullptr)
+	{
+	  const bfd_build_id *dwz_id = build_id_bfd_get (dwz->dwz_bfd.get ());
+	  if (dwz_id != nullptr)
+	    dwz_build_id = build_id_to_string (dwz_id);
+	  else
+	    contents = {};
+	}
+
+      if (!contents.empty ())
+	shards = read_cooked_index_file (per_bfd, contents,
+					 (dwz_build_id.has_value ()
+					  ? dwz_build_id->c_str ()
+					  : nullptr));
+    }
+
+  if (!shards.has_value ())
+    {
+      global_index_cache.miss ();
+      return false;
+    }
+
+  dwarf_read_debug_printf ("found cooked index from cache");
+  global_index_cache.hit ();
+
+  /* The entries point into the mapped file, so it must live as long
+     as the index.  */
+  per_bfd->index_cache_res = std::move (resource);
+  per_bfd->quick_file_names_table
+    = create_quick_file_names_table (per_bfd->all_units.size ());
+
+  cooked_index *table
+    = (gdb::checked_static_cast<cooked_index *>
+       (per_bfd->index_table.get ()));
+  table->set_contents (std::move (*shards), true);
+  return true;
+}
+
 void
 cooked_index_worker::do_reading ()
 {
   dwarf2_per_bfd *per_bfd = m_per_objfile->per_bfd;
 
   create_all_units (m_per_objfile);
+
+  if (read_from_cache ())
+    return;
+
   build_type_psymtabs (m_per_objfile, &m_index_storage);
 
   per_bfd->quick_file_names_table
@@ -4942,17 +5023,6 @@ cooked_index_worker::do_reading ()
 			       m_index_storage.get_addrmap (),
 			       &m_warnings);
 
-  /* We want to balance the load between the worker threads.  This is
-     done by using the size of each CU as a rough estimate of how
-     difficult it will be to operate on.  This isn't ideal -- for
-     example if dwz is used, the early CUs will all tend to be
-     "included" and won't be parsed independently.  However, this
-     heuristic works well for typical compiler output.  */
-
-  size_t total_size = 0;
-  for (const auto &per_cu : per_bfd->all_units)
-    total_size += per_cu->length ();
-
   /* How many worker threads we plan to use.  We may not actually use
      this many.  We use 1 as the minimum to avoid division by zero,
      and anyway in the N==0 case the work will be done
@@ -4960,10 +5030,6 @@ cooked_index_worker::do_reading ()
   const size_t n_worker_threads
     = std::max (gdb::thread_pool::g_thread_pool->thread_count (), (size_t) 1);
 
-  /* How much effort should be put into each worker.  */
-  const size_t size_per_thread
-    = std::max (total_size / n_worker_threads, (size_t) 1);
-
   /* Work is done in a task group.  */
   gdb::task_group workers ([this] ()
   {
@@ -4972,27 +5038,62 @@ cooked_index_worker::do_reading ()
 
   auto end = per_bfd->all_units.end ();
   size_t task_count = 0;
-  for (auto iter = per_bfd->all_units.begin (); iter != end; )
+
+  if (gdb::thread_pool::g_thread_pool->scheduling ()
+      == gdb::worker_scheduling::SHARED_QUEUE)
+    {
+      /* Each task pulls CUs from a shared queue, so that a few very
+	 large CUs only keep one thread busy while the others carry
+	 on with the rest.  */
+      m_unit_queue.reset
+	(new gdb::work_queue<unit_iterator> (per_bfd->all_units.begin (),
+					     end));
+      task_count = std::min (n_worker_threads, per_bfd->all_units.size ());
+      for (size_t i = 0; i < task_count; ++i)
+	workers.add_task ([=] ()
+	  {
+	    process_cus (i, end, end);
+	  });
+    }
+  else
     {
-      auto last = iter;
-      /* Put all remaining CUs into the last task.  */
-      if (task_count == n_worker_threads - 1)
-	last = end;
-      else
-	{
-	  size_t chunk_size = 0;
-	  for (; last != end && chunk_size < size_per_thread; ++last)
-	    chunk_size += (*last)->length ();
-	}
+      /* We want to balance the load between the worker threads.  This
+	 is done by using the size of each CU as a rough estimate of
+	 how difficult it will be to operate on.  This isn't ideal --
+	 for example if dwz is used, the early CUs will all tend to be
+	 "included" and won't be parsed independently.  However, this
+	 heuristic works well for typical compiler output.  */
+
+      size_t total_size = 0;
+      for (const auto &per_cu : per_bfd->all_units)
+	total_size += per_cu->length ();
+
+      /* How much effort should be put into each worker.  */
+      const size_t size_per_thread
+	= std::max (total_size / n_worker_threads, (size_t) 1);
 
-      gdb_assert (iter != last);
-      workers.add_task ([=] ()
+      for (auto iter = per_bfd->all_units.begin (); iter != end; )
 	{
-	  process_cus (task_count, iter, last);
-	});
+	  auto last = iter;
+	  /* Put all remaining CUs into the last task.  */
+	  if (task_count == n_worker_threads - 1)
+	    last = end;
+	  else
+	    {
+	      size_t chunk_size = 0;
+	      for (; last != end && chunk_size < size_per_thread; ++last)
+		chunk_size += (*last)->length ();
+	    }
 
-      ++task_count;
-      iter = last;
+	  gdb_assert (iter != last);
+	  workers.add_task ([=] ()
+	    {
+	      process_cus (task_count, iter, last);
+	    });
+
+	  ++task_count;
+	  iter = last;
+	}
     }
 
   m_results.resize (task_count);
@@ -29,6 +29,7 @@
 #include "completer.h"
 #include "gcore.h"
 #include "cli/cli-decode.h"
+#include "gdbcmd.h"
 #include <fcntl.h>
 #include "regcache.h"
 #include "regset.h"
@@ -38,12 +39,24 @@
 #include "gdbsupport/gdb_unlinker.h"
 #include "gdbsupport/byte-vector.h"
 #include "gdbsupport/scope-exit.h"
+#include "gdbsupport/thread-pool.h"
+#include <optional>
 
 /* The largest amount of memory to read from the target at once.  We
    must throttle it to limit the amount of memory used by GDB during
    generate-core-file for programs with large resident data.  */
 #define MAX_COPY_BYTES (1024 * 1024)
 
+/* The granularity at which all-zero memory is left out of the core
+   file, when writing sparse core files.  This is the smallest page
+   size of the hosts we care about, so that the holes can be real holes
+   in the file system.  */
+#define SPARSE_BLOCK_BYTES 4096
+
+/* Whether all-zero blocks of memory are left as holes in the core file
+   rather than written out.  */
+static bool sparse_core_files = true;
+
 static const char *default_gcore_target (void);
 static enum bfd_architecture default_gcore_arch (void);
 static int gcore_memory_sections (bfd *);
@@ -567,6 +580,77 @@ objfile_find_memory_regions (struct target_ops *self,
   return 0;
 }
 
+/* Return true if the LEN bytes at DATA are all zero.  */
+
+static bool
+all_zero_p (const gdb_byte *data, size_t len)
+{
+  return len == 0 || (data[0] == 0 && memcmp (data, data + 1, len - 1) == 0);
+}
+
+/* Write the SIZE bytes at DATA to OSEC of OBFD, at OFFSET in the
+   section.  When writing sparse core files, all-zero blocks are
+   skipped so that they are left as holes in the file.  Return an
+   empty string on success, or the BFD error message on failure.
+
+   This may run in a worker thread, so it must not call into the rest
+   of GDB.  */
+
+static std::string
+gcore_write_contents (bfd *obfd, asection *osec, const gdb_byte *data,
+		      file_ptr offset, bfd_size_type size)
+{
+  if (!sparse_core_files)
+    {
+      if (!bfd_set_section_contents (obfd, osec, data, offset, size))
+	return bfd_errmsg (bfd_get_error ());
+      return {};
+    }
+
+  bfd_size_type start = 0;
+  bool wrote_end = false;
+  while (start < size)
+    {
+      bfd_size_type len = std::min (size - start,
+				    (bfd_size_type) SPARSE_BLOCK_BYTES);
+      if (all_zero_p (data + start, len))
+	{
+	  start += len;
+	  continue;
+	}
+
+      /* Write the run of blocks that are not all zero in one go.  */
+      bfd_size_type end = start + len;
+      while (end < size)
+	{
+	  len = std::min (size - end, (bfd_size_type) SPARSE_BLOCK_BYTES);
+	  if (all_zero_p (data + end, len))
+	    break;
+	  end += len;
+	}
+
+      if (!bfd_set_section_contents (obfd, osec, data + start,
+				     offset + start, end - start))
+	return bfd_errmsg (bfd_get_error ());
+
+      wrote_end = end == size;
+      start = end;
+    }
+
+  /* A hole at the very end of the file would leave it short, so make
+     sure the last byte of the section is written.  */
+  if (!wrote_end && offset + size == bfd_section_size (osec)
+      && !bfd_set_section_contents (obfd, osec, data + size - 1,
+				    offset + size - 1, 1))
+    return bfd_errmsg (bfd_get_error ());
+
+  return {};
+}
+
+/* Copy the contents of memory for the "load" section OSEC of OBFD.
+   Memory is read from the target in this thread, while the previous
+   chunk is written to the core file by a worker thread.  */
+
 static void
 gcore_copy_callback (bfd *obfd, asection *osec)
 {
@@ -582,15 +666,47 @@ gcore_copy_callback (bfd *obfd, asection *osec)
     return;
 
   size = std::min (total_size, (bfd_size_type) MAX_COPY_BYTES);
-  gdb::byte_vector memhunk (size);
+
+  /* One buffer is filled while the other is being written.  */
+  gdb::byte_vector memhunk[2] { gdb::byte_vector (size),
+				gdb::byte_vector (size) };
+  int current = 0;
+  std::optional<gdb::future<std::string>> pending;
+
+  /* The write in flight reads from MEMHUNK, so it must be finished
+     before the buffers go away, even when reading memory throws (for
+     instance on a quit request).  */
+  SCOPE_EXIT
+    {
+      if (pending.has_value ())
+	pending->wait ();
+    };
+
+  /* Wait for the write in flight, if any, and report whether it
+     succeeded.  */
+  auto finish_pending = [&] ()
+    {
+      if (!pending.has_value ())
+	return true;
+
+      std::string message = pending->get ();
+      pending.reset ();
+      if (message.empty ())
+	return true;
+
+      warning (_("Failed to write corefile contents (%s)."),
+	       message.c_str ());
+      return false;
+    };
 
   while (total_size > 0)
     {
       if (size > total_size)
 	size = total_size;
 
+      gdb_byte *data = memhunk[current].data ();
       if (target_read_memory (bfd_section_vma (osec) + offset,
-			      memhunk.data (), size) != 0)
+			      data, size) != 0)
 	{
 	  warning (_("Memory read failed for corefile "
 		     "section, %s bytes at %s."),
@@ -599,17 +715,40 @@ gcore_copy_callback (bfd *obfd, asection *osec)
 			     bfd_section_vma (osec)));
 	  break;
 	}
-      if (!bfd_set_section_contents (obfd, osec, memhunk.data (),
-				     offset, size))
+
+      if (!finish_pending ())
+	break;
+
+      /* The first write lays out the file, which is best not done in a
+	 worker thread.  */
+      if (!obfd->output_has_begun)
 	{
-	  warning (_("Failed to write corefile contents (%s)."),
-		   bfd_errmsg (bfd_get_error ()));
-	  break;
+	  std::string message
+	    = gcore_write_contents (obfd, osec, data, offset, size);
+	  if (!message.empty ())
+	    {
+	      warning (_("Failed to write corefile contents (%s)."),
+		       message.c_str ());
+	      break;
+	    }
+	}
+      else
+	{
+	  std::function<std::string ()> task
+	    = [=] ()
+	      {
+		return gcore_write_contents (obfd, osec, data, offset, size);
+	      };
+	  pending.emplace
+	    (gdb::thread_pool::g_thread_pool->post_task (std::move (task)));
+	  current = 1 - current;
 	}
 
       total_size -= size;
       offset += size;
     }
+
+  finish_pending ();
 }
 
 /* Callback to copy contents to a particular memory tag section.  */
@@ -694,4 +833,14 @@ Usage: generate-core-file [FILENAME]\n\
 Argument is optional filename.  Default filename is 'core.PROCESS_ID'."));
 
   add_com_alias ("gcore", generate_core_file_cmd, class_files, 1);
+
+  add_setshow_boolean_cmd ("sparse-core-files", class_files,
+			   &sparse_core_files, _("\
+Set whether all-zero memory is left as holes in core files."), _("\
+Show whether all-zero memory is left as holes in core files."), _("\
+When on, blocks of memory that are entirely zero are not written when\n\
+generating a core file, leaving holes in the file instead.  The core file\n\
+reads back the same, but takes less space and time to write on file\n\
+systems that support sparse files."),
+			   NULL, NULL, &setlist, &showlist);
 }
@@ -34,6 +34,13 @@
 #include "inferior.h"
 #include "cli/cli-style.h"
 #include <unordered_map>
+#include <atomic>
+#include "gdbsupport/parallel-for.h"
+#include "run-on-main-thread.h"
+#include "gdbsupport/selftest.h"
+#include "gdbsupport/scoped_fd.h"
+#include "gdbsupport/gdb_unlinker.h"
+#include "gdbsupport/byte-vector.h"
 
 #if CXX_STD_THREAD
 
@@ -45,12 +52,20 @@
    BFD.  */
 static std::recursive_mutex gdb_bfd_mutex;
 
+/* The number of times gdb_bfd_lock had to wait for another thread to
+   release the lock.  */
+static std::atomic<unsigned long> gdb_bfd_lock_contentions;
+
 /* BFD locking function.  */
 
 static bool
 gdb_bfd_lock (void *ignore)
 {
-  gdb_bfd_mutex.lock ();
+  if (!gdb_bfd_mutex.try_lock ())
+    {
+      ++gdb_bfd_lock_contentions;
+      gdb_bfd_mutex.lock ();
+    }
   return true;
 }
 
@@ -762,6 +777,61 @@ get_section_descriptor (asection *section)
   return result;
 }
 
+/* Try to decompress SECTP using the worker threads.  This only helps
+   for sections that were compressed as several independent pieces,
+   such as those written with --compress-debug-sections=zstd-chunked;
+   other sections are decompressed as a single piece.  On success,
+   store a malloc'd buffer holding the contents in *DATA and return
+   true.  Otherwise return false, in which case the caller should read
+   the section the usual way.  */
+
+static bool
+decompress_section_in_parallel (asection *sectp, bfd_byte **data)
+{
+  /* The pieces are handed to the thread pool, and waiting for them
+     from a worker thread could deadlock.  So sections read by worker
+     threads are decompressed the usual way.  The DWARF indexer maps
+     the sections it scans on the main thread before starting (see
+     cooked_index_worker), so this only affects sections it finds it
+     needs later, such as those of a dwz or DWO file.  */
+  if (!is_main_thread ()
+      || !bfd_is_section_compressed (sectp->owner, sectp))
+    return false;
+
+  bfd_byte *compressed;
+  bfd_compressed_chunk *chunks;
+  unsigned int count;
+  if (!bfd_get_compressed_section_chunks (sectp->owner, sectp, &compressed,
+					  &chunks, &count))
+    return false;
+
+  gdb::unique_xmalloc_ptr<bfd_byte> compressed_holder (compressed);
+  gdb::unique_xmalloc_ptr<bfd_compressed_chunk> chunks_holder (chunks);
+
+  /* bfd_get_compressed_section_chunks has checked the uncompressed
+     size of SECTP, and that the pieces add up to it.  */
+  gdb::unique_xmalloc_ptr<bfd_byte> buffer
+    ((bfd_byte *) xmalloc (bfd_section_size (sectp)));
+  std::atomic<bool> failed (false);
+
+  gdb::parallel_for_each (1, chunks, chunks + count,
+			  [&] (bfd_compressed_chunk *first,
+			       bfd_compressed_chunk *last)
+    {
+      for (; first != last && !failed; ++first)
+	if (!bfd_decompress_section_chunk (sectp, compressed, first,
+					   (buffer.get ()
+					    + first->uncompressed_offset)))
+	  failed = true;
+    });
+
+  if (failed)
+    return false;
+
+  *data = buffer.release ();
+  return true;
+}
+
 /* See gdb_bfd.h.  */
 
 const gdb_byte *
@@ -824,7 +894,8 @@ gdb_bfd_map_section (asection *sectp, bfd_size_type *size)
   descriptor->data = NULL;
 
   data = NULL;
-  if (!bfd_get_full_section_contents (abfd, sectp, &data))
+  if (!decompress_section_in_parallel (sectp, &data)
+      && !bfd_get_full_section_contents (abfd, sectp, &data))
     {
       warning (_("Can't read data for section '%s' in file '%s'"),
 	       bfd_section_name (sectp),
@@ -1150,6 +1221,132 @@ maintenance_info_bfds (const char *arg, int from_tty)
   htab_traverse (all_bfds, print_one_bfd, uiout);
 }
 
+/* Totals gathered by maintenance_info_bfd_section_data.  */
+
+struct bfd_section_data_totals
+{
+  /* The number of sections, and the bytes, that are mapped from the
+     file.  */
+  unsigned int n_mapped = 0;
+  ULONGEST mapped = 0;
+  /* The number of sections, and the bytes, that were read or
+     decompressed into memory.  */
+  unsigned int n_copied = 0;
+  ULONGEST copied = 0;
+};
+
+/* A callback for htab_traverse that prints the section data held for
+   a single BFD, if any, and adds it to the totals.  */
+
+static int
+print_one_bfd_section_data (void **slot, void *data)
+{
+  bfd *abfd = (struct bfd *) *slot;
+  bfd_section_data_totals *totals = (bfd_section_data_totals *) data;
+  struct ui_out *uiout = current_uiout;
+  bfd_section_data_totals this_bfd;
+
+  for (asection *sectp : gdb_bfd_sections (abfd))
+    {
+      const struct gdb_bfd_section_data *sect
+	= (const struct gdb_bfd_section_data *) bfd_section_userdata (sectp);
+
+      if (sect == nullptr || sect->data == nullptr)
+	continue;
+
+      if (sect->map_addr != nullptr)
+	{
+	  ++this_bfd.n_mapped;
+	  this_bfd.mapped += sect->size;
+	}
+      else
+	{
+	  ++this_bfd.n_copied;
+	  this_bfd.copied += sect->size;
+	}
+    }
+
+  if (this_bfd.n_mapped == 0 && this_bfd.n_copied == 0)
+    return 1;
+
+  totals->n_mapped += this_bfd.n_mapped;
+  totals->mapped += this_bfd.mapped;
+  totals->n_copied += this_bfd.n_copied;
+  totals->copied += this_bfd.copied;
+
+  ui_out_emit_tuple tuple_emitter (uiout, nullptr);
+  uiout->field_string ("mapped", pulongest (this_bfd.mapped));
+  uiout->field_string ("copied", pulongest (this_bfd.copied));
+  uiout->field_string ("filename", bfd_get_filename (abfd),
+		       file_name_style.style ());
+  uiout->text ("\n");
+
+  return 1;
+}
+
+/* Implement the 'maint info bfd-section-data' command.  */
+
+static void
+maintenance_info_bfd_section_data (const char *arg, int from_tty)
+{
+  struct ui_out *uiout = current_uiout;
+  bfd_section_data_totals totals;
+
+  {
+    ui_out_emit_table table_emitter (uiout, 3, -1, "bfd-section-data");
+    uiout->table_header (12, ui_left, "mapped", "Mapped");
+    uiout->table_header (12, ui_left, "copied", "Copied");
+    uiout->table_header (40, ui_left, "filename", "Filename");
+
+    uiout->table_body ();
+    htab_traverse (all_bfds, print_one_bfd_section_data, &totals);
+  }
+
+  uiout->text ("\n");
+  uiout->field_unsigned ("sections-mapped", totals.n_mapped);
+  uiout->text (" sections mapped (");
+  uiout->field_string ("bytes-mapped", pulongest (totals.mapped));
+  uiout->text (" bytes), ");
+  uiout->field_unsigned ("sections-copied", totals.n_copied);
+  uiout->text (" sections copied (");
+  uiout->field_string ("bytes-copied", pulongest (totals.copied));
+  uiout->text (" bytes)\n");
+}
+
+/* Implement the 'maint info bfd-cache' command.  */
+
+static void
+maintenance_info_bfd_cache (const char *arg, int from_tty)
+{
+  struct ui_out *uiout = current_uiout;
+  bfd_cache_stats stats;
+
+  bfd_cache_get_stats (&stats);
+
+  uiout->text ("Files opened: ");
+  uiout->field_unsigned ("opens", stats.opens);
+  uiout->text ("\nFiles closed to make room: ");
+  uiout->field_unsigned ("evictions", stats.evictions);
+  uiout->text ("\nLock acquisitions: ");
+  uiout->field_unsigned ("lock-acquisitions", stats.lock_acquisitions);
+  uiout->text ("\nContended lock acquisitions: ");
+#if CXX_STD_THREAD
+  uiout->field_unsigned ("lock-contentions", gdb_bfd_lock_contentions);
+#else
+  uiout->field_unsigned ("lock-contentions", 0);
+#endif
+  uiout->text ("\nReads with the lock held: ");
+  uiout->field_unsigned ("locked-reads", stats.locked_reads);
+  uiout->text (" (");
+  uiout->field_string ("locked-bytes", pulongest (stats.locked_bytes));
+  uiout->text (" bytes)\nPositional reads: ");
+  uiout->field_unsigned ("positional-reads", stats.positional_reads);
+  uiout->text (" (");
+  uiout->field_string ("positional-bytes",
+		       pulongest (stats.positional_bytes));
+  uiout->text (" bytes)\n");
+}
+
 /* BFD related per-inferior data.  */
 
 struct bfd_inferior_data
@@ -1229,6 +1426,82 @@ gdb_bfd_init ()
   error (_("fatal error: libbfd ABI mismatch"));
 }
 
+#if GDB_SELF_TEST && CXX_STD_THREAD
+
+namespace selftests {
+
+/* Check that closing BFD's cached files while other threads are
+   reading one of them with bfd_pread does not disturb those reads.  */
+
+static void
+test_bfd_cache_close_while_reading ()
+{
+  char filename[] = "gdb_bfd-selftest-XXXXXX";
+  char other_filename[] = "gdb_bfd-selftest-XXXXXX";
+  gdb::byte_vector contents (1 << 16);
+
+  for (size_t i = 0; i < contents.size (); ++i)
+    contents[i] = i * 7 + (i >> 8);
+
+  {
+    scoped_fd fd = gdb_mkostemp_cloexec (filename);
+    SELF_CHECK (fd.get () >= 0);
+    SELF_CHECK (write (fd.get (), contents.data (), contents.size ())
+		== (ssize_t) contents.size ());
+  }
+  gdb::unlinker unlink_test_file (filename);
+
+  /* A file of the same size with other contents.  */
+  {
+    gdb::byte_vector zeros (contents.size ());
+    scoped_fd fd = gdb_mkostemp_cloexec (other_filename);
+    SELF_CHECK (fd.get () >= 0);
+    SELF_CHECK (write (fd.get (), zeros.data (), zeros.size ())
+		== (ssize_t) zeros.size ());
+  }
+  gdb::unlinker unlink_other_file (other_filename);
+
+  gdb_bfd_ref_ptr abfd (gdb_bfd_openr (filename, "binary"));
+  SELF_CHECK (abfd != nullptr);
+
+  const int n_readers = 4;
+  std::atomic<bool> reads_ok (true);
+  std::atomic<int> readers_done (0);
+  std::vector<std::thread> readers;
+  for (int i = 0; i < n_readers; ++i)
+    readers.emplace_back ([&] ()
+      {
+	gdb::byte_vector buf (contents.size ());
+
+	for (int j = 0; j < 1000; ++j)
+	  if (bfd_pread (buf.data (), buf.size (), 0, abfd.get ())
+	      != buf.size ()
+	      || buf != contents)
+	    reads_ok = false;
+	++readers_done;
+      });
+
+  /* Close the files of the cache again and again while they are read.
+     Opening the other file right after each close takes the descriptor
+     that the close freed, so that a read still using that descriptor
+     would see the wrong contents rather than just fail.  */
+  while (readers_done < n_readers)
+    {
+      SELF_CHECK (bfd_cache_close_all ());
+      scoped_fd other = gdb_open_cloexec (other_filename, O_RDONLY, 0);
+      SELF_CHECK (other.get () >= 0);
+    }
+
+  for (std::thread &reader : readers)
+    reader.join ();
+
+  SELF_CHECK (reads_ok);
+}
+
+} /* namespace selftests */
+
+#endif /* GDB_SELF_TEST && CXX_STD_THREAD */
+
 void _initialize_gdb_bfd ();
 void
 _initialize_gdb_bfd ()
@@ -1240,6 +1513,20 @@ _initialize_gdb_bfd ()
 List the BFDs that are currently open."),
 	   &maintenanceinfolist);
 
+  add_cmd ("bfd-section-data", class_maintenance,
+	   maintenance_info_bfd_section_data, _("\
+Show how much section data GDB holds for each open BFD.\n\
+Sections that are mapped from the file are listed separately from\n\
+those that were read or decompressed into memory."),
+	   &maintenanceinfolist);
+
+  add_cmd ("bfd-cache", class_maintenance, maintenance_info_bfd_cache, _("\
+Show statistics about BFD's cache of open files.\n\
+This shows how often files were opened and closed, how often the\n\
+BFD lock was taken and had to be waited for, and how many reads were\n\
+done with the lock held rather than as concurrent positional reads."),
+	   &maintenanceinfolist);
+
   add_setshow_boolean_cmd ("bfd-sharing", no_class,
 			   &bfd_sharing, _("\
 Set whether gdb will share bfds that appear to be the same file."), _("\
@@ -1264,4 +1551,8 @@ When non-zero, bfd cache specific debugging is enabled."),
 
   /* Hook the BFD error/warning handler to limit amount of output.  */
   default_bfd_error_handler = bfd_set_error_handler (gdb_bfd_error_handler);
+#if GDB_SELF_TEST && CXX_STD_THREAD
+  selftests::register_test ("bfd-cache-close-while-reading",
+			    selftests::test_bfd_cache_close_while_reading);
+#endif
 }
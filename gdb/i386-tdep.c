@@ -44,6 +44,7 @@
 #include "dis-asm.h"
 #include "disasm.h"
 #include "remote.h"
+#include "sframe-unwind.h"
 #include "i386-tdep.h"
 #include "i387-tdep.h"
 #include "gdbsupport/x86-xstate.h"
@@ -8632,7 +8633,9 @@ i386_gdbarch_init (struct gdbarch_info info, struct gdbarch_list *arches)
 
   /* Hook in the DWARF CFI frame unwinder.  This unwinder is appended
      to the list before the prologue-based unwinders, so that DWARF
-     CFI info will be used if it is available.  */
+     CFI info will be used if it is available.  The SFrame unwinder,
+     when enabled, is preferred to it.  */
+  sframe_append_unwinders (gdbarch);
   dwarf2_append_unwinders (gdbarch);
 
   if (info.bfd_arch_info->bits_per_word == 32)
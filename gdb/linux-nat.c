@@ -3860,6 +3860,30 @@ linux_nat_target::xfer_partial (enum target_object object,
 					  offset, len, xfered_len);
 }
 
+/* Implement the read_memory_vectored target method, with
+   process_vm_readv.  */
+
+bool
+linux_nat_target::read_memory_vectored
+  (gdb::array_view<memory_read_range> ranges)
+{
+  if (inferior_ptid == null_ptid)
+    return false;
+
+  /* Mask the addresses as xfer_partial does.  */
+  int addr_bit = gdbarch_addr_bit (current_inferior ()->arch ());
+  if (addr_bit < (sizeof (ULONGEST) * HOST_CHAR_BIT))
+    {
+      std::vector<memory_read_range> masked (ranges.begin (), ranges.end ());
+      for (memory_read_range &range : masked)
+	range.addr &= ((ULONGEST) 1 << addr_bit) - 1;
+
+      return linux_read_memory_vectored (inferior_ptid.pid (), masked);
+    }
+
+  return linux_read_memory_vectored (inferior_ptid.pid (), ranges);
+}
+
 bool
 linux_nat_target::thread_alive (ptid_t ptid)
 {
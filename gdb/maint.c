@@ -898,6 +898,39 @@ maintenance_show_worker_threads (struct ui_file *file, int from_tty,
 	      report_threads);
 }
 
+/* The possible values of "maint set worker-scheduling".  */
+
+static const char worker_scheduling_static[] = "static";
+static const char worker_scheduling_dynamic[] = "dynamic";
+static const char *const worker_scheduling_enums[] =
+{
+  worker_scheduling_static,
+  worker_scheduling_dynamic,
+  nullptr
+};
+
+static const char *worker_scheduling_mode = worker_scheduling_dynamic;
+
+static void
+maintenance_set_worker_scheduling (const char *args, int from_tty,
+				   struct cmd_list_element *c)
+{
+  gdb::thread_pool::g_thread_pool->set_scheduling
+    (worker_scheduling_mode == worker_scheduling_static
+     ? gdb::worker_scheduling::STATIC_SPLIT
+     : gdb::worker_scheduling::SHARED_QUEUE);
+}
+
+static void
+maintenance_show_worker_scheduling (struct ui_file *file, int from_tty,
+				    struct cmd_list_element *c,
+				    const char *value)
+{
+  gdb_printf (file, _("The scheduling of work across worker threads "
+		      "is \"%s\".\n"),
+	      value);
+}
+
 
 /* If true, display time usage both at startup and for each command.  */
 
@@ -1467,6 +1500,19 @@ such as demangling symbol names."),
 				       &maintenance_set_cmdlist,
 				       &maintenance_show_cmdlist);
 
+  add_setshow_enum_cmd ("worker-scheduling", class_maintenance,
+			worker_scheduling_enums, &worker_scheduling_mode, _("\
+Set how work is divided between GDB's worker threads."), _("\
+Show how work is divided between GDB's worker threads."), _("\
+With \"static\", the work is split up front into one chunk per thread,\n\
+sized by a rough estimate of its cost.  With \"dynamic\", the threads\n\
+take batches of work from a shared queue until it is empty, which keeps\n\
+them busy when a few items are much more expensive than the rest."),
+			maintenance_set_worker_scheduling,
+			maintenance_show_worker_scheduling,
+			&maintenance_set_cmdlist,
+			&maintenance_show_cmdlist);
+
   /* Add the "maint set/show selftest" commands.  */
   static cmd_list_element *set_selftest_cmdlist = nullptr;
   static cmd_list_element *show_selftest_cmdlist = nullptr;
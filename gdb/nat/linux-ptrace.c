@@ -23,6 +23,8 @@
 #ifdef HAVE_SYS_PROCFS_H
 #include <sys/procfs.h>
 #endif
+#include <sys/syscall.h>
+#include <sys/uio.h>
 
 /* Stores the ptrace options supported by the running kernel.
    A value of -1 means we did not check for features yet.  A value
@@ -445,3 +447,59 @@ linux_wstatus_maybe_breakpoint (int wstat)
 	      || WSTOPSIG (wstat) == SIGILL
 	      || WSTOPSIG (wstat) == SIGSEGV));
 }
+
+/* See linux-ptrace.h.  */
+
+bool
+linux_read_memory_vectored (pid_t pid,
+			    gdb::array_view<memory_read_range> ranges)
+{
+#ifdef __NR_process_vm_readv
+  /* The most iovecs the kernel accepts in one call (UIO_MAXIOV).  */
+  const size_t max_iov = 1024;
+  struct iovec local[max_iov];
+  struct iovec remote[max_iov];
+
+  size_t i = 0;
+  while (i < ranges.size ())
+    {
+      size_t count = 0;
+      ssize_t expected = 0;
+
+      for (; i < ranges.size () && count < max_iov; ++i)
+	{
+	  const memory_read_range &range = ranges[i];
+
+	  /* A 32-bit GDB can't describe addresses of a 64-bit
+	     inferior to process_vm_readv.  */
+	  if (range.addr != (uintptr_t) range.addr
+	      || range.len != (size_t) range.len)
+	    return false;
+
+	  if (range.len == 0)
+	    continue;
+
+	  local[count].iov_base = range.buf;
+	  local[count].iov_len = range.len;
+	  remote[count].iov_base = (void *) (uintptr_t) range.addr;
+	  remote[count].iov_len = range.len;
+	  expected += range.len;
+	  ++count;
+	}
+
+      if (count == 0)
+	continue;
+
+      /* The kernel stops at the first range it fails to read, so
+	 anything short of the total means some range was missed.  */
+      ssize_t ret = syscall (__NR_process_vm_readv, pid, local, count,
+			     remote, count, 0);
+      if (ret != expected)
+	return false;
+    }
+
+  return true;
+#else
+  return false;
+#endif
+}
@@ -20,6 +20,7 @@
 
 #include "nat/gdb_ptrace.h"
 #include "gdbsupport/gdb_wait.h"
+#include "target/target.h"
 
 #ifdef __UCLIBC__
 #if !(defined(__UCLIBC_HAS_MMU__) || defined(__ARCH_HAS_MMU__))
@@ -189,4 +190,12 @@ extern int linux_ptrace_get_extended_event (int wstat);
 extern int linux_is_extended_waitstatus (int wstat);
 extern int linux_wstatus_maybe_breakpoint (int wstat);
 
+/* Read each of RANGES of the memory of process PID with as few
+   process_vm_readv calls as possible.  Return true if every range was
+   read in full.  Return false if any range could not be read, or if
+   process_vm_readv is not available; the caller should then read the
+   ranges some other way.  Inserted breakpoints are not hidden.  */
+extern bool linux_read_memory_vectored
+  (pid_t pid, gdb::array_view<memory_read_range> ranges);
+
 #endif /* NAT_LINUX_PTRACE_H */
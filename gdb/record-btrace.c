@@ -104,6 +104,9 @@ class record_btrace_target final : public target_ops
 					ULONGEST offset, ULONGEST len,
 					ULONGEST *xfered_len) override;
 
+  bool read_memory_vectored (gdb::array_view<memory_read_range> ranges)
+    override;
+
   int insert_breakpoint (struct gdbarch *,
 			 struct bp_target_info *) override;
   int remove_breakpoint (struct gdbarch *, struct bp_target_info *,
@@ -1480,6 +1483,21 @@ record_btrace_target::xfer_partial (enum target_object object,
 					 offset, len, xfered_len);
 }
 
+/* The read_memory_vectored method of target record-btrace.  */
+
+bool
+record_btrace_target::read_memory_vectored
+  (gdb::array_view<memory_read_range> ranges)
+{
+  /* Leave the filtering of reads during replay to xfer_partial.  */
+  if (replay_memory_access == replay_memory_access_read_only
+      && !record_btrace_generating_corefile
+      && record_is_replaying (inferior_ptid))
+    return false;
+
+  return this->beneath ()->read_memory_vectored (ranges);
+}
+
 /* The insert_breakpoint method of target record-btrace.  */
 
 int
@@ -305,6 +305,9 @@ enum {
      packets and the tag violation stop replies.  */
   PACKET_memory_tagging_feature,
 
+  /* Support for the qReadMemoryRanges packet.  */
+  PACKET_qReadMemoryRanges,
+
   PACKET_MAX
 };
 
@@ -885,6 +888,9 @@ class remote_target : public process_stratum_target
 		     const gdb_byte *pattern, ULONGEST pattern_len,
 		     CORE_ADDR *found_addrp) override;
 
+  bool read_memory_vectored (gdb::array_view<memory_read_range> ranges)
+    override;
+
   bool can_async_p () override;
 
   bool is_async_p () override;
@@ -1254,6 +1260,8 @@ class remote_target : public process_stratum_target
 					int unit_size,
 					ULONGEST *xfered_len);
 
+  size_t remote_read_memory_ranges (gdb::array_view<memory_read_range> ranges);
+
   packet_result remote_send_printf (const char *format, ...)
     ATTRIBUTE_PRINTF (2, 3);
 
@@ -5723,6 +5731,8 @@ static const struct protocol_feature remote_protocol_features[] = {
   { "no-resumed", PACKET_DISABLE, remote_supported_packet, PACKET_no_resumed },
   { "memory-tagging", PACKET_DISABLE, remote_supported_packet,
     PACKET_memory_tagging_feature },
+  { "qReadMemoryRanges", PACKET_DISABLE, remote_supported_packet,
+    PACKET_qReadMemoryRanges },
 };
 
 static char *remote_support_xml;
@@ -9678,6 +9688,116 @@ remote_target::remote_read_bytes (CORE_ADDR memaddr,
 }
 
 
+/* Read as many of RANGES as fit in one qReadMemoryRanges packet.
+   Return the number of ranges that were read in full, which is zero
+   if the first one could not be.  */
+
+size_t
+remote_target::remote_read_memory_ranges
+  (gdb::array_view<memory_read_range> ranges)
+{
+  struct remote_state *rs = get_remote_state ();
+  int addr_size = gdbarch_addr_bit (current_inferior ()->arch ()) / 8;
+  int max_size = get_remote_packet_size ();
+
+  /* Binary data in the reply may need escaping, which at worst doubles
+     its size, so ask for no more than half of what a reply can hold,
+     as remote_read_bytes_1 does for hex.  */
+  ULONGEST reply_budget = get_memory_read_packet_size () / 2;
+
+  std::string packet = "qReadMemoryRanges:";
+  size_t count = 0;
+  for (const memory_read_range &range : ranges)
+    {
+      /* Each range in the reply is introduced by its length in hex and
+	 a colon.  */
+      ULONGEST reply_size = range.len + 2 * sizeof (ULONGEST) + 1;
+
+      std::string item
+	= string_printf ("%s%s,%s", count == 0 ? "" : ";",
+			 phex_nz (remote_address_masked (range.addr),
+				  addr_size),
+			 phex_nz (range.len, sizeof (range.len)));
+      if (range.len > reply_budget
+	  || reply_size > reply_budget
+	  || packet.size () + item.size () >= max_size)
+	break;
+
+      packet += item;
+      reply_budget -= reply_size;
+      ++count;
+    }
+
+  if (count == 0)
+    return 0;
+
+  strcpy (rs->buf.data (), packet.c_str ());
+  putpkt (rs->buf);
+  int packet_len = getpkt (&rs->buf);
+  if (packet_len < 0
+      || m_features.packet_ok (rs->buf, PACKET_qReadMemoryRanges) != PACKET_OK)
+    return 0;
+
+  gdb::byte_vector reply (packet_len);
+  int reply_len = remote_unescape_input ((const gdb_byte *) rs->buf.data (),
+					 packet_len, reply.data (),
+					 reply.size ());
+
+  /* The reply holds, for each range in order, the number of bytes read
+     in hex, a colon, and the bytes.  The stub may answer fewer ranges
+     than were asked for, and stops at the first one it could not read
+     in full.  */
+  const gdb_byte *p = reply.data ();
+  const gdb_byte *end = reply.data () + reply_len;
+  size_t done = 0;
+  while (p < end && done < count)
+    {
+      ULONGEST len = 0;
+
+      while (p < end && isxdigit (*p))
+	len = (len << 4) | fromhex (*p++);
+      if (p == end || *p++ != ':' || len > (ULONGEST) (end - p)
+	  || len > ranges[done].len)
+	return done;
+
+      memcpy (ranges[done].buf, p, len);
+      p += len;
+      if (len < ranges[done].len)
+	return done;
+      ++done;
+    }
+
+  return done;
+}
+
+/* Implement the read_memory_vectored target method, with the
+   qReadMemoryRanges packet.  */
+
+bool
+remote_target::read_memory_vectored
+  (gdb::array_view<memory_read_range> ranges)
+{
+  if (m_features.packet_support (PACKET_qReadMemoryRanges) == PACKET_DISABLE
+      || !target_has_execution ()
+      || get_traceframe_number () != -1
+      || (gdbarch_addressable_memory_unit_size (current_inferior ()->arch ())
+	  != 1))
+    return false;
+
+  set_general_thread (inferior_ptid);
+
+  while (!ranges.empty ())
+    {
+      size_t done = remote_read_memory_ranges (ranges);
+      if (done == 0)
+	return false;
+
+      ranges = ranges.slice (done);
+    }
+
+  return true;
+}
+
 
 /* Sends a packet with content determined by the printf format string
    FORMAT and the remaining arguments, then gets the reply.  Returns
@@ -15990,6 +16110,9 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
   add_packet_config_cmd (PACKET_memory_tagging_feature,
 			 "memory-tagging-feature", "memory-tagging-feature", 0);
 
+  add_packet_config_cmd (PACKET_qReadMemoryRanges, "qReadMemoryRanges",
+			 "read-memory-ranges", 0);
+
   /* Assert that we've registered "set remote foo-packet" commands
      for all packet configs.  */
   {
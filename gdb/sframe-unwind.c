@@ -0,0 +1,465 @@
+/* Frame unwinder for frames with SFrame stack trace information.
+
+   Copyright (C) 2024 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "sframe-unwind.h"
+#include "arch-utils.h"
+#include "cli/cli-cmds.h"
+#include "dwarf2/frame.h"
+#include "dwarf2/loc.h"
+#include "frame.h"
+#include "frame-unwind.h"
+#include "gdb_bfd.h"
+#include "gdbcmd.h"
+#include "objfiles.h"
+#include "regcache.h"
+#include "sframe-api.h"
+
+/* The SFrame format only describes how to find the CFA, the return
+   address and the frame pointer of a frame.  This is enough to walk
+   the stack much more cheaply than by interpreting DWARF CFI, which is
+   what "backtrace" mostly needs.  The other registers are assumed to
+   be unchanged by the frame, like the prologue analyzers do.  */
+
+/* See sframe-unwind.h.  */
+
+bool sframe_unwinders_enabled_p = false;
+
+/* Whether to check the CFA computed from SFrame against the one
+   computed from DWARF CFI.  */
+
+static bool sframe_check_p = false;
+
+/* The SFrame data of an objfile.  */
+
+struct sframe_objfile_data
+{
+  ~sframe_objfile_data ()
+  {
+    sframe_decoder_free (&decoder);
+  }
+
+  /* The decoder for the objfile's .sframe section, or NULL if it has
+     none or it can not be used.  */
+  sframe_decoder_ctx *decoder = nullptr;
+
+  /* The run-time address of the .sframe section.  Function addresses
+     in the section are relative to it.  */
+  CORE_ADDR sframe_addr = 0;
+};
+
+static const registry<objfile>::key<sframe_objfile_data> sframe_objfile_key;
+
+/* The GDB register numbers of the registers described by SFrame.  */
+
+struct sframe_regs
+{
+  int sp;
+  int fp;
+
+  /* The register holding the return address on entry to a function,
+     or -1 if the return address is on the stack.  */
+  int ra;
+};
+
+/* Fill REGS with the GDB register numbers of the registers described
+   by SFrame data for ABI_ARCH.  Return false if that data can't be
+   used with GDBARCH.  */
+
+static bool
+sframe_find_regs (struct gdbarch *gdbarch, uint8_t abi_arch,
+		  struct sframe_regs *regs)
+{
+  const struct bfd_arch_info *info = gdbarch_bfd_arch_info (gdbarch);
+  int sp, fp, ra;
+
+  switch (abi_arch)
+    {
+    case SFRAME_ABI_AMD64_ENDIAN_LITTLE:
+      if (info->arch != bfd_arch_i386 || gdbarch_ptr_bit (gdbarch) != 64)
+	return false;
+      /* %rsp, %rbp.  */
+      sp = 7;
+      fp = 6;
+      ra = -1;
+      break;
+
+    case SFRAME_ABI_AARCH64_ENDIAN_BIG:
+    case SFRAME_ABI_AARCH64_ENDIAN_LITTLE:
+      if (info->arch != bfd_arch_aarch64
+	  || (gdbarch_byte_order (gdbarch)
+	      != (abi_arch == SFRAME_ABI_AARCH64_ENDIAN_BIG
+		  ? BFD_ENDIAN_BIG : BFD_ENDIAN_LITTLE)))
+	return false;
+      /* SP, x29, x30.  */
+      sp = 31;
+      fp = 29;
+      ra = 30;
+      break;
+
+    default:
+      return false;
+    }
+
+  /* The numbers above are the DWARF register numbers.  */
+  regs->sp = dwarf_reg_to_regnum (gdbarch, sp);
+  regs->fp = dwarf_reg_to_regnum (gdbarch, fp);
+  regs->ra = ra == -1 ? -1 : dwarf_reg_to_regnum (gdbarch, ra);
+  return (regs->sp == gdbarch_sp_regnum (gdbarch)
+	  && regs->fp >= 0
+	  && (ra == -1 || regs->ra >= 0));
+}
+
+/* Return the SFrame data of OBJFILE, reading it the first time.  */
+
+static sframe_objfile_data *
+get_sframe_data (struct objfile *objfile)
+{
+  sframe_objfile_data *data = sframe_objfile_key.get (objfile);
+  if (data != nullptr)
+    return data;
+
+  data = sframe_objfile_key.emplace (objfile);
+
+  bfd *abfd = objfile->obfd.get ();
+  asection *sect = bfd_get_section_by_name (abfd, ".sframe");
+  if (sect == nullptr)
+    return data;
+
+  gdb::byte_vector contents;
+  if (!gdb_bfd_get_full_section_contents (abfd, sect, &contents)
+      || contents.empty ())
+    return data;
+
+  int err = 0;
+  data->decoder = sframe_decode ((const char *) contents.data (),
+				 contents.size (), &err);
+  if (data->decoder == nullptr)
+    {
+      warning (_("Could not read .sframe section of %s: %s"),
+	       objfile_name (objfile), sframe_errmsg (err));
+      return data;
+    }
+
+  /* Each frame is looked up many times when backtracing every thread,
+     so make lookups fast.  Without the index they are merely slower.  */
+  sframe_decoder_build_lookup_index (data->decoder);
+
+  data->sframe_addr = (bfd_section_vma (sect)
+		       + objfile->text_section_offset ());
+  return data;
+}
+
+/* The unwind information of a frame, from its SFrame row.  */
+
+struct sframe_frame_cache
+{
+  struct sframe_regs regs;
+
+  /* The CFA is the value of the SP or FP register plus CFA_OFFSET.  */
+  bool cfa_base_fp;
+  int32_t cfa_offset;
+
+  /* Whether the frame pointer and return address are saved on the
+     stack, and at which offset from the CFA.  */
+  bool fp_saved;
+  int32_t fp_offset;
+  bool ra_saved;
+  int32_t ra_offset;
+
+  /* The CFA, once computed.  */
+  bool cfa_p;
+  bool cfa_unavailable;
+  CORE_ADDR cfa;
+};
+
+/* Compute the CFA of THIS_FRAME into CACHE, if not done yet.  */
+
+static void
+sframe_frame_cfa (frame_info_ptr this_frame, struct sframe_frame_cache *cache)
+{
+  if (cache->cfa_p)
+    return;
+  cache->cfa_p = true;
+
+  try
+    {
+      int base = cache->cfa_base_fp ? cache->regs.fp : cache->regs.sp;
+
+      cache->cfa = (get_frame_register_unsigned (this_frame, base)
+		    + cache->cfa_offset);
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      if (ex.error != NOT_AVAILABLE_ERROR)
+	throw;
+      cache->cfa_unavailable = true;
+      return;
+    }
+
+  if (sframe_check_p)
+    {
+      struct gdbarch *gdbarch = get_frame_arch (this_frame);
+      CORE_ADDR pc = get_frame_address_in_block (this_frame);
+      int regnum;
+      LONGEST offset;
+      CORE_ADDR text_offset;
+      const gdb_byte *cfa_start, *cfa_end;
+
+      try
+	{
+	  if (dwarf2_fetch_cfa_info (gdbarch, pc, nullptr, &regnum, &offset,
+				     &text_offset, &cfa_start, &cfa_end) == 1)
+	    {
+	      CORE_ADDR dwarf_cfa
+		= get_frame_register_unsigned (this_frame, regnum) + offset;
+
+	      if (dwarf_cfa != cache->cfa)
+		warning (_("SFrame CFA %s differs from DWARF CFA %s at %s"),
+			 paddress (gdbarch, cache->cfa),
+			 paddress (gdbarch, dwarf_cfa),
+			 paddress (gdbarch, pc));
+	    }
+	}
+      catch (const gdb_exception_error &ex)
+	{
+	  /* No DWARF CFI to compare with.  */
+	}
+    }
+}
+
+static enum unwind_stop_reason
+sframe_frame_unwind_stop_reason (frame_info_ptr this_frame,
+				 void **this_cache)
+{
+  struct sframe_frame_cache *cache
+    = (struct sframe_frame_cache *) *this_cache;
+
+  sframe_frame_cfa (this_frame, cache);
+  if (cache->cfa_unavailable)
+    return UNWIND_UNAVAILABLE;
+
+  return UNWIND_NO_REASON;
+}
+
+static void
+sframe_frame_this_id (frame_info_ptr this_frame, void **this_cache,
+		      struct frame_id *this_id)
+{
+  struct sframe_frame_cache *cache
+    = (struct sframe_frame_cache *) *this_cache;
+
+  sframe_frame_cfa (this_frame, cache);
+  if (cache->cfa_unavailable)
+    (*this_id) = frame_id_build_unavailable_stack (get_frame_func (this_frame));
+  else
+    (*this_id) = frame_id_build (cache->cfa, get_frame_func (this_frame));
+}
+
+static struct value *
+sframe_frame_prev_register (frame_info_ptr this_frame, void **this_cache,
+			    int regnum)
+{
+  struct gdbarch *gdbarch = get_frame_arch (this_frame);
+  struct sframe_frame_cache *cache
+    = (struct sframe_frame_cache *) *this_cache;
+
+  sframe_frame_cfa (this_frame, cache);
+
+  if (regnum == gdbarch_pc_regnum (gdbarch) || regnum == cache->regs.ra)
+    {
+      if (cache->ra_saved)
+	return frame_unwind_got_memory (this_frame, regnum,
+					cache->cfa + cache->ra_offset);
+      if (cache->regs.ra >= 0)
+	return frame_unwind_got_register (this_frame, regnum,
+					  cache->regs.ra);
+      return frame_unwind_got_optimized (this_frame, regnum);
+    }
+
+  if (regnum == cache->regs.sp)
+    return frame_unwind_got_address (this_frame, regnum, cache->cfa);
+
+  if (regnum == cache->regs.fp && cache->fp_saved)
+    return frame_unwind_got_memory (this_frame, regnum,
+				    cache->cfa + cache->fp_offset);
+
+  return frame_unwind_got_register (this_frame, regnum, regnum);
+}
+
+static int
+sframe_frame_sniffer (const struct frame_unwind *self,
+		      frame_info_ptr this_frame, void **this_cache)
+{
+  if (!sframe_unwinders_enabled_p)
+    return 0;
+
+  /* As for DWARF CFI, look up an address that is guaranteed to be in
+     the function; see dwarf2_frame_sniffer.  */
+  CORE_ADDR pc = get_frame_address_in_block (this_frame);
+  struct obj_section *osect = find_pc_section (pc);
+  if (osect == nullptr)
+    return 0;
+
+  struct objfile *objfile = osect->objfile;
+  if (objfile->separate_debug_objfile_backlink != nullptr)
+    objfile = objfile->separate_debug_objfile_backlink;
+
+  sframe_objfile_data *data = get_sframe_data (objfile);
+  if (data->decoder == nullptr)
+    return 0;
+
+  struct gdbarch *gdbarch = get_frame_arch (this_frame);
+  struct sframe_regs regs;
+  if (!sframe_find_regs (gdbarch,
+			 sframe_decoder_get_abi_arch (data->decoder), &regs))
+    return 0;
+
+  /* Addresses in the SFrame data are relative to the section, and
+     held in 32 bits.  */
+  LONGEST rel_pc = (LONGEST) (pc - data->sframe_addr);
+  if (rel_pc != (int32_t) rel_pc)
+    return 0;
+
+  sframe_frame_row_entry fre;
+  if (sframe_find_fre (data->decoder, (int32_t) rel_pc, &fre) != 0)
+    return 0;
+
+  int err = 0;
+  uint8_t base_reg = sframe_fre_get_base_reg_id (&fre, &err);
+  int32_t cfa_offset = sframe_fre_get_cfa_offset (data->decoder, &fre, &err);
+  if (err != 0)
+    return 0;
+
+  /* A return address signed with pointer authentication would need
+     to be stripped; leave that to the DWARF unwinder.  */
+  if (sframe_fre_get_ra_mangled_p (data->decoder, &fre, &err) || err != 0)
+    return 0;
+
+  struct sframe_frame_cache *cache
+    = FRAME_OBSTACK_ZALLOC (struct sframe_frame_cache);
+  cache->regs = regs;
+  cache->cfa_base_fp = base_reg == SFRAME_BASE_REG_FP;
+  cache->cfa_offset = cfa_offset;
+
+  err = 0;
+  cache->ra_offset = sframe_fre_get_ra_offset (data->decoder, &fre, &err);
+  cache->ra_saved = err == 0;
+  err = 0;
+  cache->fp_offset = sframe_fre_get_fp_offset (data->decoder, &fre, &err);
+  cache->fp_saved = err == 0;
+
+  /* Without a return address register, it must be on the stack.  */
+  if (!cache->ra_saved && regs.ra < 0)
+    return 0;
+
+  *this_cache = cache;
+  return 1;
+}
+
+static const struct frame_unwind sframe_frame_unwind =
+{
+  "sframe",
+  NORMAL_FRAME,
+  sframe_frame_unwind_stop_reason,
+  sframe_frame_this_id,
+  sframe_frame_prev_register,
+  NULL,
+  sframe_frame_sniffer
+};
+
+/* See sframe-unwind.h.  */
+
+void
+sframe_append_unwinders (struct gdbarch *gdbarch)
+{
+  frame_unwind_append_unwinder (gdbarch, &sframe_frame_unwind);
+}
+
+/* Handle 'maintenance show sframe unwinders'.  */
+
+static void
+show_sframe_unwinders_enabled_p (struct ui_file *file, int from_tty,
+				 struct cmd_list_element *c,
+				 const char *value)
+{
+  gdb_printf (file,
+	      _("The SFrame stack unwinder is currently %s.\n"),
+	      value);
+}
+
+/* Handle 'maintenance show sframe check'.  */
+
+static void
+show_sframe_check_p (struct ui_file *file, int from_tty,
+		     struct cmd_list_element *c, const char *value)
+{
+  gdb_printf (file,
+	      _("Checking SFrame against DWARF CFI is %s.\n"),
+	      value);
+}
+
+/* Handle 'maintenance set sframe unwinders' and 'maintenance set
+   sframe check'.  Frames already unwound keep the unwinder they were
+   built with, so flush them to make the new setting take effect.  */
+
+static void
+set_sframe_setting (const char *args, int from_tty,
+		    struct cmd_list_element *c)
+{
+  reinit_frame_cache ();
+}
+
+static struct cmd_list_element *set_sframe_cmdlist;
+static struct cmd_list_element *show_sframe_cmdlist;
+
+void _initialize_sframe_unwind ();
+void
+_initialize_sframe_unwind ()
+{
+  add_setshow_prefix_cmd ("sframe", class_maintenance,
+			  _("Set SFrame specific variables."),
+			  _("Show SFrame specific variables."),
+			  &set_sframe_cmdlist, &show_sframe_cmdlist,
+			  &maintenance_set_cmdlist, &maintenance_show_cmdlist);
+
+  add_setshow_boolean_cmd ("unwinders", class_obscure,
+			   &sframe_unwinders_enabled_p, _("\
+Set whether the SFrame stack frame unwinder is used."), _("\
+Show whether the SFrame stack frame unwinder is used."), _("\
+When enabled, frames of functions with SFrame stack trace information\n\
+are unwound using it in preference to DWARF CFI.  This is faster, but\n\
+only the stack pointer, frame pointer and return address are unwound;\n\
+other registers are assumed to be unchanged in the caller."),
+			   set_sframe_setting,
+			   show_sframe_unwinders_enabled_p,
+			   &set_sframe_cmdlist,
+			   &show_sframe_cmdlist);
+
+  add_setshow_boolean_cmd ("check", class_obscure,
+			   &sframe_check_p, _("\
+Set whether to check SFrame unwinding against DWARF CFI."), _("\
+Show whether to check SFrame unwinding against DWARF CFI."), _("\
+When enabled, the CFA of each frame unwound using SFrame is also computed\n\
+from the DWARF CFI, if any, and a warning is given if they differ."),
+			   set_sframe_setting,
+			   show_sframe_check_p,
+			   &set_sframe_cmdlist,
+			   &show_sframe_cmdlist);
+}
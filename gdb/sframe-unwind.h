@@ -0,0 +1,36 @@
+/* Frame unwinder for frames with SFrame stack trace information.
+
+   Copyright (C) 2024 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef SFRAME_UNWIND_H
+#define SFRAME_UNWIND_H
+
+struct gdbarch;
+
+/* Whether the SFrame unwinder should be used.  */
+
+extern bool sframe_unwinders_enabled_p;
+
+/* Append the SFrame frame unwinder to GDBARCH's list.  Architectures
+   supported by SFrame call this just before dwarf2_append_unwinders,
+   so that SFrame information is preferred to DWARF CFI when both are
+   present.  */
+
+extern void sframe_append_unwinders (struct gdbarch *gdbarch);
+
+#endif /* SFRAME_UNWIND_H */
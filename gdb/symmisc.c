@@ -33,6 +33,7 @@
 #include "gdbsupport/gdb_regex.h"
 #include <sys/stat.h>
 #include "dictionary.h"
+#include "dwarf2/frame.h"
 #include "typeprint.h"
 #include "gdbcmd.h"
 #include "source.h"
@@ -107,6 +108,7 @@ print_objfile_statistics (void)
 		    objfile_name (objfile));
 	objfile->per_bfd->string_cache.print_statistics ("string cache");
 	objfile->print_stats (true);
+	dwarf2_frame_print_statistics (objfile);
       }
 }
 
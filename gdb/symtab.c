@@ -66,11 +66,13 @@
 #include "parser-defs.h"
 #include "completer.h"
 #include "progspace-and-thread.h"
+#include "run-on-main-thread.h"
 #include <optional>
 #include "filename-seen-cache.h"
 #include "arch-utils.h"
 #include <algorithm>
 #include <string_view>
+#include <mutex>
 #include "gdbsupport/pathstuff.h"
 #include "gdbsupport/common-utils.h"
 #include <optional>
@@ -121,12 +123,28 @@ struct main_info
 
 static const registry<program_space>::key<main_info> main_progspace_key;
 
-/* The default symbol cache size.
+/* The default symbol cache size, and the smallest size picked when the
+   size is "auto".
    There is no extra cpu cost for large N (except when flushing the cache,
    which is rare).  The value here is just a first attempt.  A better default
-   value may be higher or lower.  A prime number can make up for a bad hash
-   computation, so that's why the number is what it is.  */
-#define DEFAULT_SYMBOL_CACHE_SIZE 1021
+   value may be higher or lower.  */
+#define DEFAULT_SYMBOL_CACHE_SIZE 1024
+
+/* When the symbol cache size is "auto", the number of slots wanted for
+   each objfile of the program space.  Programs with many shared libraries
+   look up many more distinct names, and a cache that is too small for them
+   thrashes.  */
+#define SYMBOL_CACHE_SLOTS_PER_OBJFILE 256
+
+/* The value of symbol_cache_size meaning "auto".  */
+#define SYMBOL_CACHE_SIZE_AUTO UINT_MAX
+
+/* The number of slots in each set of the symbol cache.
+   The cache is set-associative: an entry hashes to a set and may live in
+   any of its slots, so a few names hashing to the same set don't keep
+   evicting each other.  Within a set the slots are kept in order of last
+   use, and when the set is full the least recently used entry goes.  */
+#define SYMBOL_CACHE_WAYS 4
 
 /* The maximum symbol cache size.
    There's no method to the decision of what value to use here, other than
@@ -198,10 +216,20 @@ symbol_cache_clear_slot (struct symbol_cache_slot *slot)
 struct block_symbol_cache
 {
   unsigned int hits;
+
+  /* The number of hits on entries recording a failed lookup.
+     These are included in HITS.  */
+  unsigned int not_found_hits;
+
   unsigned int misses;
-  unsigned int collisions;
 
-  /* SYMBOLS is a variable length array of this size.
+  /* The number of entries dropped to make room for a new one.  */
+  unsigned int evictions;
+
+  /* SYMBOLS is a variable length array of this size, which is a multiple
+     of SYMBOL_CACHE_WAYS.  It is made of SIZE / SYMBOL_CACHE_WAYS sets;
+     the slots of a set are ordered from most to least recently used, with
+     the unused slots last.
      One can imagine that in general one cache (global/static) should be a
      fraction of the size of the other, but there's no data at the moment
      on which to decide.  */
@@ -231,7 +259,14 @@ destroy_block_symbol_cache (struct block_symbol_cache *bsc)
    overall gdb performance.
 
    Symbols are hashed on the name, its domain, and block.
-   They are also hashed on their objfile for objfile-specific lookups.  */
+   They are also hashed on their objfile for objfile-specific lookups.
+
+   Each program space has its own cache, sized for its objfiles.  The
+   cache functions below take the cache's lock, and the cache is created
+   and found under SYMBOL_CACHE_KEY_LOCK, so they may be used from worker
+   threads; the lock is never held while doing a full lookup.  Only the
+   main thread sizes a cache for the objfiles of its program space, as
+   only it may walk the objfile list.  */
 
 struct symbol_cache
 {
@@ -245,12 +280,23 @@ struct symbol_cache
 
   struct block_symbol_cache *global_symbols = nullptr;
   struct block_symbol_cache *static_symbols = nullptr;
+
+#if CXX_STD_THREAD
+  /* Protects GLOBAL_SYMBOLS and STATIC_SYMBOLS.  */
+  std::mutex lock;
+#endif
 };
 
 /* Program space key for finding its symbol cache.  */
 
 static const registry<program_space>::key<symbol_cache> symbol_cache_key;
 
+#if CXX_STD_THREAD
+/* Protects the creation of symbol caches, and the lookups of
+   SYMBOL_CACHE_KEY that may race with it.  */
+static std::mutex symbol_cache_key_lock;
+#endif
+
 /* When non-zero, print debugging messages related to symtab creation.  */
 unsigned int symtab_create_debug = 0;
 
@@ -258,12 +304,20 @@ unsigned int symtab_create_debug = 0;
 unsigned int symbol_lookup_debug = 0;
 
 /* The size of the cache is staged here.  */
-static unsigned int new_symbol_cache_size = DEFAULT_SYMBOL_CACHE_SIZE;
+static unsigned int new_symbol_cache_size = SYMBOL_CACHE_SIZE_AUTO;
 
-/* The current value of the symbol cache size.
+/* The current value of the symbol cache size, or SYMBOL_CACHE_SIZE_AUTO.
    This is saved so that if the user enters a value too big we can restore
    the original value from here.  */
-static unsigned int symbol_cache_size = DEFAULT_SYMBOL_CACHE_SIZE;
+static unsigned int symbol_cache_size = SYMBOL_CACHE_SIZE_AUTO;
+
+/* Extra literals supported by "maint set symbol-cache-size".  */
+
+static const literal_def symbol_cache_size_literals[] =
+  {
+    { "auto", SYMBOL_CACHE_SIZE_AUTO },
+    { nullptr }
+  };
 
 /* True if a file may be known by two different basenames.
    This is the uncommon case, and significantly slows down gdb.
@@ -1306,11 +1360,17 @@ symbol_cache_byte_size (unsigned int size)
 	  + ((size - 1) * sizeof (struct symbol_cache_slot)));
 }
 
-/* Resize CACHE.  */
+/* Resize CACHE to hold at least NEW_SIZE entries, emptying it.
+   Return true if the size changed, false if CACHE was left alone.
+   The caller must hold CACHE's lock.  */
 
-static void
+static bool
 resize_symbol_cache (struct symbol_cache *cache, unsigned int new_size)
 {
+  /* Every set has all its ways.  */
+  new_size = ((new_size + SYMBOL_CACHE_WAYS - 1) / SYMBOL_CACHE_WAYS
+	      * SYMBOL_CACHE_WAYS);
+
   /* If there's no change in size, don't do anything.
      All caches have the same size, so we can just compare with the size
      of the global symbols cache.  */
@@ -1318,7 +1378,7 @@ resize_symbol_cache (struct symbol_cache *cache, unsigned int new_size)
        && cache->global_symbols->size == new_size)
       || (cache->global_symbols == NULL
 	  && new_size == 0))
-    return;
+    return false;
 
   destroy_block_symbol_cache (cache->global_symbols);
   destroy_block_symbol_cache (cache->static_symbols);
@@ -1339,6 +1399,49 @@ resize_symbol_cache (struct symbol_cache *cache, unsigned int new_size)
       cache->global_symbols->size = new_size;
       cache->static_symbols->size = new_size;
     }
+
+  return true;
+}
+
+/* Return the number of entries the symbol cache of PSPACE should have.
+   When the size is "auto" this doubles from DEFAULT_SYMBOL_CACHE_SIZE
+   until there are SYMBOL_CACHE_SLOTS_PER_OBJFILE slots per objfile, so
+   that loading objfiles one at a time only resizes the cache now and
+   then.  Off the main thread, where the objfiles of PSPACE can't be
+   walked, this is DEFAULT_SYMBOL_CACHE_SIZE; the cache then follows the
+   objfiles from its next flush.  */
+
+static unsigned int
+symbol_cache_size_for (struct program_space *pspace)
+{
+  if (symbol_cache_size != SYMBOL_CACHE_SIZE_AUTO)
+    return symbol_cache_size;
+
+  if (!is_main_thread ())
+    return DEFAULT_SYMBOL_CACHE_SIZE;
+
+  size_t wanted = 0;
+  for (objfile *objfile ATTRIBUTE_UNUSED : pspace->objfiles ())
+    wanted += SYMBOL_CACHE_SLOTS_PER_OBJFILE;
+
+  unsigned int size = DEFAULT_SYMBOL_CACHE_SIZE;
+  while (size < wanted && size < MAX_SYMBOL_CACHE_SIZE)
+    size *= 2;
+
+  return std::min (size, (unsigned int) MAX_SYMBOL_CACHE_SIZE);
+}
+
+/* Return the symbol cache of PSPACE, or NULL if it doesn't have one
+   yet.  */
+
+static struct symbol_cache *
+find_symbol_cache (struct program_space *pspace)
+{
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (symbol_cache_key_lock);
+#endif
+
+  return symbol_cache_key.get (pspace);
 }
 
 /* Return the symbol cache of PSPACE.
@@ -1347,12 +1450,16 @@ resize_symbol_cache (struct symbol_cache *cache, unsigned int new_size)
 static struct symbol_cache *
 get_symbol_cache (struct program_space *pspace)
 {
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (symbol_cache_key_lock);
+#endif
+
   struct symbol_cache *cache = symbol_cache_key.get (pspace);
 
   if (cache == NULL)
     {
       cache = symbol_cache_key.emplace (pspace);
-      resize_symbol_cache (cache, symbol_cache_size);
+      resize_symbol_cache (cache, symbol_cache_size_for (pspace));
     }
 
   return cache;
@@ -1361,15 +1468,21 @@ get_symbol_cache (struct program_space *pspace)
 /* Set the size of the symbol cache in all program spaces.  */
 
 static void
-set_symbol_cache_size (unsigned int new_size)
+set_symbol_cache_size ()
 {
   for (struct program_space *pspace : program_spaces)
     {
-      struct symbol_cache *cache = symbol_cache_key.get (pspace);
+      struct symbol_cache *cache = find_symbol_cache (pspace);
 
       /* The pspace could have been created but not have a cache yet.  */
       if (cache != NULL)
-	resize_symbol_cache (cache, new_size);
+	{
+#if CXX_STD_THREAD
+	  std::lock_guard<std::mutex> guard (cache->lock);
+#endif
+
+	  resize_symbol_cache (cache, symbol_cache_size_for (pspace));
+	}
     }
 }
 
@@ -1379,7 +1492,8 @@ static void
 set_symbol_cache_size_handler (const char *args, int from_tty,
 			       struct cmd_list_element *c)
 {
-  if (new_symbol_cache_size > MAX_SYMBOL_CACHE_SIZE)
+  if (new_symbol_cache_size > MAX_SYMBOL_CACHE_SIZE
+      && new_symbol_cache_size != SYMBOL_CACHE_SIZE_AUTO)
     {
       /* Restore the previous value.
 	 This is the value the "show" command prints.  */
@@ -1390,47 +1504,82 @@ set_symbol_cache_size_handler (const char *args, int from_tty,
     }
   symbol_cache_size = new_symbol_cache_size;
 
-  set_symbol_cache_size (symbol_cache_size);
+  set_symbol_cache_size ();
+}
+
+/* Return the block cache of CACHE for BLOCK, or NULL if the cache is
+   disabled.  */
+
+static struct block_symbol_cache *
+symbol_cache_for_block (struct symbol_cache *cache, enum block_enum block)
+{
+  if (block == GLOBAL_BLOCK)
+    return cache->global_symbols;
+  else
+    return cache->static_symbols;
+}
+
+/* Return the first slot of the set of BSC that symbol NAME,DOMAIN looked
+   up with OBJFILE_CONTEXT belongs to.  */
+
+static struct symbol_cache_slot *
+symbol_cache_set (struct block_symbol_cache *bsc,
+		  const struct objfile *objfile_context,
+		  const char *name, domain_enum domain)
+{
+  unsigned int hash = hash_symbol_entry (objfile_context, name, domain);
+  unsigned int nsets = bsc->size / SYMBOL_CACHE_WAYS;
+
+  return bsc->symbols + (hash % nsets) * SYMBOL_CACHE_WAYS;
 }
 
-/* Lookup symbol NAME,DOMAIN in BLOCK in the symbol cache of PSPACE.
+/* Make slot I of SET its first, most recently used, slot.  Return it.  */
+
+static struct symbol_cache_slot *
+symbol_cache_promote (struct symbol_cache_slot *set, unsigned int i)
+{
+  struct symbol_cache_slot entry = set[i];
+
+  for (; i > 0; --i)
+    set[i] = set[i - 1];
+  set[0] = entry;
+
+  return &set[0];
+}
+
+/* Lookup symbol NAME,DOMAIN in BLOCK in the symbol cache CACHE.
    OBJFILE_CONTEXT is the current objfile, which may be NULL.
    The result is the symbol if found, SYMBOL_LOOKUP_FAILED if a previous lookup
    failed (and thus this one will too), or NULL if the symbol is not present
-   in the cache.
-   *BSC_PTR and *SLOT_PTR are set to the cache and slot of the symbol, which
-   can be used to save the result of a full lookup attempt.  */
+   in the cache.  The result of a full lookup attempt can then be saved with
+   symbol_cache_mark_found or symbol_cache_mark_not_found.  */
 
 static struct block_symbol
 symbol_cache_lookup (struct symbol_cache *cache,
 		     struct objfile *objfile_context, enum block_enum block,
-		     const char *name, domain_enum domain,
-		     struct block_symbol_cache **bsc_ptr,
-		     struct symbol_cache_slot **slot_ptr)
+		     const char *name, domain_enum domain)
 {
-  struct block_symbol_cache *bsc;
-  unsigned int hash;
-  struct symbol_cache_slot *slot;
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (cache->lock);
+#endif
 
-  if (block == GLOBAL_BLOCK)
-    bsc = cache->global_symbols;
-  else
-    bsc = cache->static_symbols;
+  struct block_symbol_cache *bsc = symbol_cache_for_block (cache, block);
   if (bsc == NULL)
-    {
-      *bsc_ptr = NULL;
-      *slot_ptr = NULL;
-      return {};
-    }
-
-  hash = hash_symbol_entry (objfile_context, name, domain);
-  slot = bsc->symbols + hash % bsc->size;
+    return {};
 
-  *bsc_ptr = bsc;
-  *slot_ptr = slot;
+  struct symbol_cache_slot *set
+    = symbol_cache_set (bsc, objfile_context, name, domain);
 
-  if (eq_symbol_entry (slot, objfile_context, name, domain))
+  for (unsigned int i = 0; i < SYMBOL_CACHE_WAYS; ++i)
     {
+      /* The unused slots are at the end of the set.  */
+      if (set[i].state == SYMBOL_SLOT_UNUSED)
+	break;
+      if (!eq_symbol_entry (&set[i], objfile_context, name, domain))
+	continue;
+
+      struct symbol_cache_slot *slot = symbol_cache_promote (set, i);
+
       symbol_lookup_debug_printf ("%s block symbol cache hit%s for %s, %s",
 				  block == GLOBAL_BLOCK ? "Global" : "Static",
 				  slot->state == SYMBOL_SLOT_NOT_FOUND
@@ -1438,7 +1587,10 @@ symbol_cache_lookup (struct symbol_cache *cache,
 				  domain_name (domain));
       ++bsc->hits;
       if (slot->state == SYMBOL_SLOT_NOT_FOUND)
-	return SYMBOL_LOOKUP_FAILED;
+	{
+	  ++bsc->not_found_hits;
+	  return SYMBOL_LOOKUP_FAILED;
+	}
       return slot->value.found;
     }
 
@@ -1451,67 +1603,117 @@ symbol_cache_lookup (struct symbol_cache *cache,
   return {};
 }
 
-/* Mark SYMBOL as found in SLOT.
+/* Return an unused slot of BSC to record the result of looking up
+   NAME,DOMAIN with OBJFILE_CONTEXT in, as the most recently used slot of
+   its set.  If the set is full, its least recently used entry is evicted.
+
+   The set is found again rather than remembered by symbol_cache_lookup,
+   as the full lookup in between may have done lookups of its own that
+   reordered the set, or even recorded this very entry.  */
+
+static struct symbol_cache_slot *
+symbol_cache_insert_slot (struct block_symbol_cache *bsc,
+			  const struct objfile *objfile_context,
+			  const char *name, domain_enum domain)
+{
+  struct symbol_cache_slot *set
+    = symbol_cache_set (bsc, objfile_context, name, domain);
+  unsigned int i;
+
+  for (i = 0; i < SYMBOL_CACHE_WAYS - 1; ++i)
+    if (set[i].state == SYMBOL_SLOT_UNUSED
+	|| eq_symbol_entry (&set[i], objfile_context, name, domain))
+      break;
+
+  if (set[i].state != SYMBOL_SLOT_UNUSED)
+    {
+      if (!eq_symbol_entry (&set[i], objfile_context, name, domain))
+	++bsc->evictions;
+      symbol_cache_clear_slot (&set[i]);
+    }
+
+  return symbol_cache_promote (set, i);
+}
+
+/* Mark SYMBOL, which is in SBLOCK, as the result of looking up NAME,DOMAIN
+   in BLOCK in CACHE.
    OBJFILE_CONTEXT is the current objfile when the lookup was done, or NULL
    if it's not needed to distinguish lookups (STATIC_BLOCK).  It is *not*
    necessarily the objfile the symbol was found in.  */
 
 static void
-symbol_cache_mark_found (struct block_symbol_cache *bsc,
-			 struct symbol_cache_slot *slot,
+symbol_cache_mark_found (struct symbol_cache *cache,
 			 struct objfile *objfile_context,
+			 enum block_enum block,
+			 const char *name, domain_enum domain,
 			 struct symbol *symbol,
-			 const struct block *block)
+			 const struct block *sblock)
 {
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (cache->lock);
+#endif
+
+  struct block_symbol_cache *bsc = symbol_cache_for_block (cache, block);
   if (bsc == NULL)
     return;
-  if (slot->state != SYMBOL_SLOT_UNUSED)
-    {
-      ++bsc->collisions;
-      symbol_cache_clear_slot (slot);
-    }
+
+  struct symbol_cache_slot *slot
+    = symbol_cache_insert_slot (bsc, objfile_context, name, domain);
   slot->state = SYMBOL_SLOT_FOUND;
   slot->objfile_context = objfile_context;
   slot->value.found.symbol = symbol;
-  slot->value.found.block = block;
+  slot->value.found.block = sblock;
 }
 
-/* Mark symbol NAME, DOMAIN as not found in SLOT.
+/* Mark symbol NAME, DOMAIN as not found in BLOCK in CACHE.
    OBJFILE_CONTEXT is the current objfile when the lookup was done, or NULL
    if it's not needed to distinguish lookups (STATIC_BLOCK).  */
 
 static void
-symbol_cache_mark_not_found (struct block_symbol_cache *bsc,
-			     struct symbol_cache_slot *slot,
+symbol_cache_mark_not_found (struct symbol_cache *cache,
 			     struct objfile *objfile_context,
+			     enum block_enum block,
 			     const char *name, domain_enum domain)
 {
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (cache->lock);
+#endif
+
+  struct block_symbol_cache *bsc = symbol_cache_for_block (cache, block);
   if (bsc == NULL)
     return;
-  if (slot->state != SYMBOL_SLOT_UNUSED)
-    {
-      ++bsc->collisions;
-      symbol_cache_clear_slot (slot);
-    }
+
+  struct symbol_cache_slot *slot
+    = symbol_cache_insert_slot (bsc, objfile_context, name, domain);
   slot->state = SYMBOL_SLOT_NOT_FOUND;
   slot->objfile_context = objfile_context;
   slot->value.not_found.name = xstrdup (name);
   slot->value.not_found.domain = domain;
 }
 
-/* Flush the symbol cache of PSPACE.  */
+/* Flush the symbol cache of PSPACE.
+   When the size of the cache is "auto", this is also where it follows the
+   number of objfiles of PSPACE.  */
 
 static void
 symbol_cache_flush (struct program_space *pspace)
 {
-  struct symbol_cache *cache = symbol_cache_key.get (pspace);
+  struct symbol_cache *cache = find_symbol_cache (pspace);
   int pass;
 
   if (cache == NULL)
     return;
+
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (cache->lock);
+#endif
+
+  /* Resizing the cache empties it.  */
+  if (resize_symbol_cache (cache, symbol_cache_size_for (pspace)))
+    return;
+
   if (cache->global_symbols == NULL)
     {
-      gdb_assert (symbol_cache_size == 0);
       gdb_assert (cache->static_symbols == NULL);
       return;
     }
@@ -1523,9 +1725,6 @@ symbol_cache_flush (struct program_space *pspace)
       && cache->static_symbols->misses == 0)
     return;
 
-  gdb_assert (cache->global_symbols->size == symbol_cache_size);
-  gdb_assert (cache->static_symbols->size == symbol_cache_size);
-
   for (pass = 0; pass < 2; ++pass)
     {
       struct block_symbol_cache *bsc
@@ -1534,23 +1733,25 @@ symbol_cache_flush (struct program_space *pspace)
 
       for (i = 0; i < bsc->size; ++i)
 	symbol_cache_clear_slot (&bsc->symbols[i]);
-    }
 
-  cache->global_symbols->hits = 0;
-  cache->global_symbols->misses = 0;
-  cache->global_symbols->collisions = 0;
-  cache->static_symbols->hits = 0;
-  cache->static_symbols->misses = 0;
-  cache->static_symbols->collisions = 0;
+      bsc->hits = 0;
+      bsc->not_found_hits = 0;
+      bsc->misses = 0;
+      bsc->evictions = 0;
+    }
 }
 
 /* Dump CACHE.  */
 
 static void
-symbol_cache_dump (const struct symbol_cache *cache)
+symbol_cache_dump (struct symbol_cache *cache)
 {
   int pass;
 
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (cache->lock);
+#endif
+
   if (cache->global_symbols == NULL)
     {
       gdb_printf ("  <disabled>\n");
@@ -1616,7 +1817,7 @@ maintenance_print_symbol_cache (const char *args, int from_tty)
 		  : "(no object file)");
 
       /* If the cache hasn't been created yet, avoid creating one.  */
-      cache = symbol_cache_key.get (pspace);
+      cache = find_symbol_cache (pspace);
       if (cache == NULL)
 	gdb_printf ("  <empty>\n");
       else
@@ -1642,6 +1843,10 @@ symbol_cache_stats (struct symbol_cache *cache)
 {
   int pass;
 
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (cache->lock);
+#endif
+
   if (cache->global_symbols == NULL)
     {
       gdb_printf ("  <disabled>\n");
@@ -1660,10 +1865,16 @@ symbol_cache_stats (struct symbol_cache *cache)
       else
 	gdb_printf ("Static block cache stats:\n");
 
-      gdb_printf ("  size:       %u\n", bsc->size);
-      gdb_printf ("  hits:       %u\n", bsc->hits);
-      gdb_printf ("  misses:     %u\n", bsc->misses);
-      gdb_printf ("  collisions: %u\n", bsc->collisions);
+      gdb_printf ("  size:           %u\n", bsc->size);
+      gdb_printf ("  ways:           %u\n", SYMBOL_CACHE_WAYS);
+      gdb_printf ("  hits:           %u\n", bsc->hits);
+      gdb_printf ("  not-found hits: %u\n", bsc->not_found_hits);
+      gdb_printf ("  misses:         %u\n", bsc->misses);
+      gdb_printf ("  evictions:      %u\n", bsc->evictions);
+      /* The share of misses whose result pushed another entry out.  */
+      gdb_printf ("  eviction rate:  %.1f%%\n",
+		  bsc->misses == 0
+		  ? 0.0 : 100.0 * bsc->evictions / bsc->misses);
     }
 }
 
@@ -1683,7 +1894,7 @@ maintenance_print_symbol_cache_statistics (const char *args, int from_tty)
 		  : "(no object file)");
 
       /* If the cache hasn't been created yet, avoid creating one.  */
-      cache = symbol_cache_key.get (pspace);
+      cache = find_symbol_cache (pspace);
       if (cache == NULL)
 	gdb_printf ("  empty, no stats available\n");
       else
@@ -2563,16 +2774,13 @@ lookup_global_or_static_symbol (const char *name,
 {
   struct symbol_cache *cache = get_symbol_cache (current_program_space);
   struct block_symbol result;
-  struct block_symbol_cache *bsc;
-  struct symbol_cache_slot *slot;
 
   gdb_assert (block_index == GLOBAL_BLOCK || block_index == STATIC_BLOCK);
   gdb_assert (objfile == nullptr || block_index == GLOBAL_BLOCK);
 
   /* First see if we can find the symbol in the cache.
      This works because we use the current objfile to qualify the lookup.  */
-  result = symbol_cache_lookup (cache, objfile, block_index, name, domain,
-				&bsc, &slot);
+  result = symbol_cache_lookup (cache, objfile, block_index, name, domain);
   if (result.symbol != NULL)
     {
       if (SYMBOL_LOOKUP_FAILED_P (result))
@@ -2593,9 +2801,10 @@ lookup_global_or_static_symbol (const char *name,
        objfile);
 
   if (result.symbol != NULL)
-    symbol_cache_mark_found (bsc, slot, objfile, result.symbol, result.block);
+    symbol_cache_mark_found (cache, objfile, block_index, name, domain,
+			     result.symbol, result.block);
   else
-    symbol_cache_mark_not_found (bsc, slot, objfile, name, domain);
+    symbol_cache_mark_not_found (cache, objfile, block_index, name, domain);
 
   return result;
 }
@@ -7084,15 +7293,17 @@ When enabled (non-zero), symbol lookups are logged."),
 			   NULL, NULL,
 			   &setdebuglist, &showdebuglist);
 
-  add_setshow_zuinteger_cmd ("symbol-cache-size", no_class,
-			     &new_symbol_cache_size,
-			     _("Set the size of the symbol cache."),
-			     _("Show the size of the symbol cache."), _("\
+  add_setshow_uinteger_cmd ("symbol-cache-size", no_class,
+			    &new_symbol_cache_size,
+			    symbol_cache_size_literals,
+			    _("Set the size of the symbol cache."),
+			    _("Show the size of the symbol cache."), _("\
 The size of the symbol cache.\n\
-If zero then the symbol cache is disabled."),
-			     set_symbol_cache_size_handler, NULL,
-			     &maintenance_set_cmdlist,
-			     &maintenance_show_cmdlist);
+If zero then the symbol cache is disabled.  If \"auto\" then the size\n\
+of the cache of each program space grows with its number of objfiles."),
+			    set_symbol_cache_size_handler, NULL,
+			    &maintenance_set_cmdlist,
+			    &maintenance_show_cmdlist);
 
   add_setshow_boolean_cmd ("ignore-prologue-end-flag", no_class,
 			   &ignore_prologue_end_flag,
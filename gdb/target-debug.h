@@ -245,6 +245,18 @@ target_debug_print_gdb_byte_vector_r (gdb::byte_vector &vector)
   target_debug_print_const_gdb_byte_vector_r (vector);
 }
 
+static void
+target_debug_print_gdb_array_view_memory_read_range
+  (gdb::array_view<memory_read_range> ranges)
+{
+  gdb_puts ("{", gdb_stdlog);
+
+  for (const memory_read_range &range : ranges)
+    gdb_printf (gdb_stdlog, " %s,%s", core_addr_to_string (range.addr),
+		pulongest (range.len));
+  gdb_puts (" }", gdb_stdlog);
+}
+
 static void
 target_debug_print_x86_xsave_layout (const x86_xsave_layout &layout)
 {
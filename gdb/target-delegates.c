@@ -116,6 +116,7 @@ struct dummy_target : public target_ops
   CORE_ADDR get_thread_local_address (ptid_t arg0, CORE_ADDR arg1, CORE_ADDR arg2) override;
   enum target_xfer_status xfer_partial (enum target_object arg0, const char *arg1, gdb_byte *arg2, const gdb_byte *arg3, ULONGEST arg4, ULONGEST arg5, ULONGEST *arg6) override;
   ULONGEST get_memory_xfer_limit () override;
+  bool read_memory_vectored (gdb::array_view<memory_read_range> arg0) override;
   std::vector<mem_region> memory_map () override;
   void flash_erase (ULONGEST arg0, LONGEST arg1) override;
   void flash_done () override;
@@ -292,6 +293,7 @@ struct debug_target : public target_ops
   CORE_ADDR get_thread_local_address (ptid_t arg0, CORE_ADDR arg1, CORE_ADDR arg2) override;
   enum target_xfer_status xfer_partial (enum target_object arg0, const char *arg1, gdb_byte *arg2, const gdb_byte *arg3, ULONGEST arg4, ULONGEST arg5, ULONGEST *arg6) override;
   ULONGEST get_memory_xfer_limit () override;
+  bool read_memory_vectored (gdb::array_view<memory_read_range> arg0) override;
   std::vector<mem_region> memory_map () override;
   void flash_erase (ULONGEST arg0, LONGEST arg1) override;
   void flash_done () override;
@@ -2551,6 +2553,32 @@ debug_target::get_memory_xfer_limit ()
   return result;
 }
 
+bool
+target_ops::read_memory_vectored (gdb::array_view<memory_read_range> arg0)
+{
+  return this->beneath ()->read_memory_vectored (arg0);
+}
+
+bool
+dummy_target::read_memory_vectored (gdb::array_view<memory_read_range> arg0)
+{
+  return false;
+}
+
+bool
+debug_target::read_memory_vectored (gdb::array_view<memory_read_range> arg0)
+{
+  gdb_printf (gdb_stdlog, "-> %s->read_memory_vectored (...)\n", this->beneath ()->shortname ());
+  bool result
+    = this->beneath ()->read_memory_vectored (arg0);
+  gdb_printf (gdb_stdlog, "<- %s->read_memory_vectored (", this->beneath ()->shortname ());
+  target_debug_print_gdb_array_view_memory_read_range (arg0);
+  gdb_puts (") = ", gdb_stdlog);
+  target_debug_print_bool (result);
+  gdb_puts ("\n", gdb_stdlog);
+  return result;
+}
+
 std::vector<mem_region>
 target_ops::memory_map ()
 {
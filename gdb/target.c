@@ -1792,6 +1792,51 @@ target_read_raw_memory (CORE_ADDR memaddr, gdb_byte *myaddr, ssize_t len)
     return -1;
 }
 
+/* Try to read RANGES of raw memory with one call to the target's
+   read_memory_vectored method.  This is only done when nothing in GDB
+   would treat any of the ranges differently from a plain read of
+   target memory, as memory_xfer_partial_1 can.  Return true if every
+   range was read in full.  */
+
+static bool
+target_read_raw_memory_vectored_1 (gdb::array_view<memory_read_range> ranges)
+{
+  if (overlay_debugging || trust_readonly || inferior_ptid == null_ptid)
+    return false;
+
+  gdbarch *arch = current_inferior ()->arch ();
+  if (gdbarch_addressable_memory_unit_size (arch) != 1)
+    return false;
+
+  for (const memory_read_range &range : ranges)
+    {
+      ULONGEST reg_len;
+
+      if (range.len != 0
+	  && (!memory_xfer_check_region (range.buf, NULL, range.addr,
+					 range.len, &reg_len, NULL)
+	      || reg_len < range.len))
+	return false;
+    }
+
+  return current_inferior ()->top_target ()->read_memory_vectored (ranges);
+}
+
+/* See target.h.  */
+
+bool
+target_read_raw_memory_vectored (gdb::array_view<memory_read_range> ranges)
+{
+  if (target_read_raw_memory_vectored_1 (ranges))
+    return true;
+
+  for (const memory_read_range &range : ranges)
+    if (target_read_raw_memory (range.addr, range.buf, range.len) != 0)
+      return false;
+
+  return true;
+}
+
 /* Like target_read_memory, but specify explicitly that this is a read from
    the target's stack.  This may trigger different cache behavior.  */
 
@@ -822,6 +822,17 @@ struct target_ops
     virtual ULONGEST get_memory_xfer_limit ()
       TARGET_DEFAULT_RETURN (ULONGEST_MAX);
 
+    /* Read each of RANGES of raw memory (breakpoint shadows are not
+       applied) in as few transfers as the target can manage.  Return
+       true if every range was read in full.  Return false if some
+       range could not be read, or if the target has no better way to
+       do this than one xfer_partial per range;
+       target_read_raw_memory_vectored then reads the ranges one by
+       one.  */
+
+    virtual bool read_memory_vectored (gdb::array_view<memory_read_range> ranges)
+      TARGET_DEFAULT_RETURN (false);
+
     /* Returns the memory map for the target.  A return value of NULL
        means that no memory map is available.  If a memory address
        does not fall within any returned regions, it's assumed to be
@@ -1581,6 +1592,15 @@ extern bool target_can_run_breakpoint_commands ();
 extern int target_read_raw_memory (CORE_ADDR memaddr, gdb_byte *myaddr,
 				   ssize_t len);
 
+/* Read each of RANGES of raw memory, as target_read_raw_memory does
+   for one range, but letting the target fetch them all at once when
+   it can.  Return true if every range was read in full.  No guarantee
+   is made about the contents of any of the buffers if some range
+   could not be read.  */
+
+extern bool target_read_raw_memory_vectored
+  (gdb::array_view<memory_read_range> ranges);
+
 extern int target_read_stack (CORE_ADDR memaddr, gdb_byte *myaddr, ssize_t len);
 
 extern int target_read_code (CORE_ADDR memaddr, gdb_byte *myaddr, ssize_t len);
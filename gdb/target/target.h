@@ -23,6 +23,7 @@
 #include "target/waitstatus.h"
 #include "target/wait.h"
 #include "gdbsupport/enum-flags.h"
+#include "gdbsupport/array-view.h"
 
 /* This header is a stopgap until more code is shared.  */
 
@@ -57,6 +58,17 @@ extern std::string to_string (gdb_thread_options options);
 extern int target_read_memory (CORE_ADDR memaddr, gdb_byte *myaddr,
 			       ssize_t len);
 
+/* One of the ranges of target memory read by a target's
+   read_memory_vectored method: LEN bytes at address ADDR, to be
+   stored in GDB's memory at BUF.  */
+
+struct memory_read_range
+{
+  CORE_ADDR addr;
+  gdb_byte *buf;
+  ULONGEST len;
+};
+
 /* Read an unsigned 32-bit integer in the target's format from target
    memory at address MEMADDR, storing the result in GDB's format in
    GDB's memory at RESULT.  Return zero for success, nonzero if any
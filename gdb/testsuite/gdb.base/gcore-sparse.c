@@ -0,0 +1,42 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2024 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SIZE (8 * 1024 * 1024)
+
+/* Mostly zero, with a few bytes set in the middle and at the end.  */
+char *buffer;
+
+static void
+break_here (void)
+{
+}
+
+int
+main (void)
+{
+  buffer = malloc (SIZE);
+  memset (buffer, 0, SIZE);
+  buffer[SIZE / 2] = 0x5a;
+  buffer[SIZE - 1] = 0xa5;
+
+  break_here ();
+
+  return 0;
+}
@@ -0,0 +1,63 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2024 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+size_t pg_size;
+unsigned char *mapped_page;
+unsigned char *unmapped_page;
+
+void
+break_here (void)
+{
+}
+
+int
+main (void)
+{
+  unsigned char *p;
+  size_t i;
+
+  /* Map three pages and unmap the middle one, so that GDB can read
+     up to the end of the first page and then fails.  */
+  pg_size = getpagesize ();
+  p = mmap (0, 3 * pg_size, PROT_READ | PROT_WRITE,
+	    MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+  if (p == MAP_FAILED)
+    {
+      perror ("mmap");
+      return EXIT_FAILURE;
+    }
+
+  if (munmap (p + pg_size, pg_size) == -1)
+    {
+      perror ("munmap");
+      return EXIT_FAILURE;
+    }
+
+  for (i = 0; i < pg_size; i++)
+    p[i] = i % 251;
+
+  mapped_page = p;
+  unmapped_page = p + pg_size;
+
+  break_here ();
+  return EXIT_SUCCESS;
+}
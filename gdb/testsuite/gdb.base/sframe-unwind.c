@@ -0,0 +1,58 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2024 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+volatile int global;
+
+void __attribute__ ((noinline))
+breakpt (void)
+{
+  asm ("" ::: "memory");
+}
+
+/* Use some stack, so that the CFA is not just a small offset from
+   the stack pointer.  */
+
+void __attribute__ ((noinline))
+func3 (int i)
+{
+  volatile char buf[256];
+
+  buf[i] = i;
+  breakpt ();
+  global += buf[i];
+}
+
+void __attribute__ ((noinline))
+func2 (int i)
+{
+  func3 (i + 1);
+  global++;
+}
+
+void __attribute__ ((noinline))
+func1 (int i)
+{
+  func2 (i + 1);
+  global++;
+}
+
+int
+main (void)
+{
+  func1 (0);
+  return 0;
+}
@@ -0,0 +1,71 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2024 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+
+static pthread_barrier_t barrier;
+
+static void __attribute__ ((noinline))
+all_started (void)
+{
+  asm ("" ::: "memory");
+}
+
+static void __attribute__ ((noinline))
+recurse (int i)
+{
+  volatile char buf[64];
+
+  buf[0] = i;
+  if (i < BACKTRACE_DEPTH)
+    recurse (i + 1);
+  else
+    {
+      /* Wait for all threads to be started, then for the process to
+	 be killed.  */
+      pthread_barrier_wait (&barrier);
+      for (;;)
+	pthread_barrier_wait (&barrier);
+    }
+  buf[0]++;
+}
+
+static void *
+thread_func (void *arg)
+{
+  recurse (0);
+  return arg;
+}
+
+int
+main (void)
+{
+  pthread_t threads[NUM_THREADS];
+  int i;
+
+  pthread_barrier_init (&barrier, NULL, NUM_THREADS + 1);
+
+  for (i = 0; i < NUM_THREADS; i++)
+    pthread_create (&threads[i], NULL, thread_func, NULL);
+
+  pthread_barrier_wait (&barrier);
+  all_started ();
+
+  for (i = 0; i < NUM_THREADS; i++)
+    pthread_join (threads[i], NULL);
+  return 0;
+}
@@ -0,0 +1,41 @@
+# Copyright (C) 2024 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+from perftest import perftest
+
+
+class SFrameBackTrace(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self):
+        super(SFrameBackTrace, self).__init__("sframe-backtrace")
+
+    def warm_up(self):
+        # Read the symbols and unwind tables of all objfiles.
+        gdb.execute("thread apply all bt", False, True)
+
+    def _do_test(self):
+        # Flushing the frame cache makes every thread be unwound again.
+        gdb.execute("maint flush register-cache", False, True)
+        gdb.execute("thread apply all bt", False, True)
+
+    def execute_test(self):
+        for unwinder in ["dwarf", "sframe"]:
+            if unwinder == "sframe":
+                gdb.execute("maint set sframe unwinders on")
+            else:
+                gdb.execute("maint set sframe unwinders off")
+
+            func = lambda: self._do_test()
+
+            self.measure.measure(func, unwinder)
@@ -0,0 +1,300 @@
+/* Self tests for work_queue and dynamic scheduling
+
+   Copyright (C) 2024 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "gdbsupport/selftest.h"
+#include "gdbsupport/work-queue.h"
+#include "gdbsupport/parallel-for.h"
+#include "gdbsupport/thread-pool.h"
+#include "gdbsupport/scope-exit.h"
+#include <chrono>
+#include <thread>
+
+namespace selftests {
+namespace work_queue {
+
+/* Check that every element of a queue is handed out exactly once, in
+   batches of the requested size.  */
+
+static void
+test_pop_batch ()
+{
+  std::vector<int> items (10);
+
+  gdb::work_queue<std::vector<int>::iterator> queue (items.begin (),
+						      items.end (), 3);
+  size_t total = 0;
+  while (true)
+    {
+      auto batch = queue.pop_batch ();
+      if (batch.first == batch.second)
+	break;
+      SELF_CHECK (batch.second - batch.first <= 3);
+      for (auto iter = batch.first; iter != batch.second; ++iter)
+	++*iter;
+      total += batch.second - batch.first;
+    }
+
+  SELF_CHECK (total == items.size ());
+  SELF_CHECK (std::all_of (items.begin (), items.end (),
+			   [] (int count) { return count == 1; }));
+
+  /* Popping from an exhausted queue keeps returning an empty
+     range.  */
+  auto batch = queue.pop_batch ();
+  SELF_CHECK (batch.first == batch.second);
+  SELF_CHECK (batch.first == items.end ());
+
+  /* An empty queue.  */
+  gdb::work_queue<int *> empty (nullptr, nullptr);
+  auto none = empty.pop_batch ();
+  SELF_CHECK (none.first == none.second);
+}
+
+/* Return the weights of a skewed workload: a few huge items in a row,
+   followed by many small ones.  This resembles a program where most
+   template-heavy code ended up in a handful of adjacent CUs.  */
+
+static std::vector<size_t>
+skewed_weights ()
+{
+  std::vector<size_t> weights (4, 1000);
+  weights.insert (weights.end (), 2000, 1);
+  weights.insert (weights.begin () + 1000, 2, 500);
+  return weights;
+}
+
+/* Simulate N_WORKERS threads processing WEIGHTS, each element costing
+   its weight in time, with the elements split up front into
+   contiguous chunks of about equal total weight -- the way the DWARF
+   indexer divides CUs in static mode.  Return the time at which the
+   last worker finishes.  */
+
+static size_t
+static_makespan (const std::vector<size_t> &weights, size_t n_workers)
+{
+  size_t total = 0;
+  for (size_t w : weights)
+    total += w;
+  const size_t per_worker = std::max (total / n_workers, (size_t) 1);
+
+  size_t makespan = 0;
+  size_t worker = 0;
+  for (size_t i = 0; i < weights.size (); )
+    {
+      size_t chunk = 0;
+      if (worker == n_workers - 1)
+	for (; i < weights.size (); ++i)
+	  chunk += weights[i];
+      else
+	for (; i < weights.size () && chunk < per_worker; ++i)
+	  chunk += weights[i];
+      makespan = std::max (makespan, chunk);
+      ++worker;
+    }
+
+  return makespan;
+}
+
+/* Like static_makespan, but simulate the workers popping batches of
+   BATCH_SIZE elements from a work_queue.  Whichever worker is free
+   first pops the next batch.  */
+
+static size_t
+dynamic_makespan (const std::vector<size_t> &weights, size_t n_workers,
+		  size_t batch_size)
+{
+  gdb::work_queue<std::vector<size_t>::const_iterator>
+    queue (weights.begin (), weights.end (), batch_size);
+  std::vector<size_t> clocks (n_workers);
+
+  while (true)
+    {
+      auto next = std::min_element (clocks.begin (), clocks.end ());
+      auto batch = queue.pop_batch ();
+      if (batch.first == batch.second)
+	break;
+      for (auto iter = batch.first; iter != batch.second; ++iter)
+	*next += *iter;
+    }
+
+  return *std::max_element (clocks.begin (), clocks.end ());
+}
+
+/* Check that dynamic scheduling balances a skewed workload.  */
+
+static void
+test_balance ()
+{
+  std::vector<size_t> weights = skewed_weights ();
+  size_t total = 0;
+  for (size_t w : weights)
+    total += w;
+  const size_t max_weight = *std::max_element (weights.begin (),
+					       weights.end ());
+
+  for (size_t n_workers : { 2, 3, 4, 8 })
+    {
+      size_t dynamic = dynamic_makespan (weights, n_workers, 1);
+
+      /* With single-element batches, greedy scheduling never leaves
+	 a worker idle while another one has more than one element's
+	 worth of work left.  */
+      SELF_CHECK (dynamic <= total / n_workers + max_weight);
+
+      /* Static partitioning puts several of the huge items in the
+	 same chunk; dynamic scheduling must do at least as well.  */
+      SELF_CHECK (dynamic <= static_makespan (weights, n_workers));
+    }
+
+  /* With 4 workers the static split gives two of the huge items to
+     each of the first two workers, while dynamic scheduling gives
+     each worker one of them and evens out the rest.  */
+  SELF_CHECK (static_makespan (weights, 4) == 2000);
+  SELF_CHECK (dynamic_makespan (weights, 4, 1) <= total / 4 + 1);
+}
+
+#if CXX_STD_THREAD
+
+/* Check that parallel_for_each_dynamic visits each element exactly
+   once, using real threads.  */
+
+static void
+test_parallel_for_each_dynamic ()
+{
+  size_t saved_count = gdb::thread_pool::g_thread_pool->thread_count ();
+  SCOPE_EXIT
+    {
+      gdb::thread_pool::g_thread_pool->set_thread_count (saved_count);
+    };
+
+  for (size_t n_threads : { 0, 1, 3 })
+    {
+      gdb::thread_pool::g_thread_pool->set_thread_count (n_threads);
+
+      const size_t n_elements = 10000;
+      std::vector<std::atomic<int>> visits (n_elements);
+      std::atomic<bool> any_empty (false);
+
+      gdb::parallel_for_each_dynamic
+	(1, visits.begin (), visits.end (),
+	 [&] (std::vector<std::atomic<int>>::iterator first,
+	      std::vector<std::atomic<int>>::iterator last)
+	 {
+	   if (first == last)
+	     any_empty = true;
+	   for (; first != last; ++first)
+	     ++*first;
+	 });
+
+      SELF_CHECK (!any_empty);
+      SELF_CHECK (std::all_of (visits.begin (), visits.end (),
+			       [] (const std::atomic<int> &count)
+			       {
+				 return count == 1;
+			       }));
+    }
+}
+
+/* Check that parallel_for_each_dynamic waits for all its tasks before
+   propagating an exception thrown by the callback, whether it is
+   thrown in the calling thread or in a worker thread.  */
+
+static void
+test_parallel_for_each_dynamic_throw ()
+{
+  size_t saved_count = gdb::thread_pool::g_thread_pool->thread_count ();
+  SCOPE_EXIT
+    {
+      gdb::thread_pool::g_thread_pool->set_thread_count (saved_count);
+    };
+
+  gdb::thread_pool::g_thread_pool->set_thread_count (3);
+
+  std::vector<int> items (1000);
+  const std::thread::id caller = std::this_thread::get_id ();
+
+  for (bool throw_in_caller : { true, false })
+    {
+      /* The number of callbacks running, and whether the exception
+	 was thrown.  */
+      std::atomic<int> running (0);
+      std::atomic<bool> thrown (false);
+      bool caught = false;
+
+      try
+	{
+	  gdb::parallel_for_each_dynamic
+	    (1, items.begin (), items.end (),
+	     [&] (std::vector<int>::iterator first,
+		  std::vector<int>::iterator last)
+	     {
+	       ++running;
+	       SCOPE_EXIT { --running; };
+
+	       bool in_caller = std::this_thread::get_id () == caller;
+	       if (in_caller == throw_in_caller && !thrown.exchange (true))
+		 {
+		   /* Throw while another thread is busy, giving up
+		      waiting for one after a second.  */
+		   for (int i = 0; running < 2 && i < 1000; ++i)
+		     std::this_thread::sleep_for (std::chrono::milliseconds (1));
+		   error (_("bad batch"));
+		 }
+
+	       /* Keep the other threads busy until well after the
+		  exception is thrown.  */
+	       for (int i = 0; !thrown && i < 1000; ++i)
+		 std::this_thread::sleep_for (std::chrono::milliseconds (1));
+	       std::this_thread::sleep_for (std::chrono::milliseconds (10));
+	     });
+	}
+      catch (const gdb_exception_error &ex)
+	{
+	  caught = true;
+	  SELF_CHECK (strcmp (ex.what (), "bad batch") == 0);
+	}
+
+      SELF_CHECK (caught);
+      SELF_CHECK (running == 0);
+    }
+}
+
+#endif /* CXX_STD_THREAD */
+
+static void
+test ()
+{
+  test_pop_batch ();
+  test_balance ();
+#if CXX_STD_THREAD
+  test_parallel_for_each_dynamic ();
+  test_parallel_for_each_dynamic_throw ();
+#endif
+}
+
+} /* namespace work_queue */
+} /* namespace selftests */
+
+void _initialize_work_queue_selftests ();
+void
+_initialize_work_queue_selftests ()
+{
+  selftests::register_test ("work_queue", selftests::work_queue::test);
+}
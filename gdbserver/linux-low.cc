@@ -5505,6 +5505,16 @@ linux_process_target::read_memory (CORE_ADDR memaddr,
   return proc_xfer_memory (memaddr, myaddr, nullptr, len);
 }
 
+/* Implement the read_memory_vectored target method, with
+   process_vm_readv.  */
+
+bool
+linux_process_target::read_memory_vectored
+  (gdb::array_view<memory_read_range> ranges)
+{
+  return linux_read_memory_vectored (current_process ()->pid, ranges);
+}
+
 /* Copy LEN bytes of data from debugger memory at MYADDR to inferior's
    memory at MEMADDR.  On failure (cannot write to the inferior)
    returns the value of errno.  Always succeeds if LEN is zero.  */
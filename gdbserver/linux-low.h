@@ -172,6 +172,9 @@ class linux_process_target : public process_stratum_target
   int write_memory (CORE_ADDR memaddr, const unsigned char *myaddr,
 		    int len) override;
 
+  bool read_memory_vectored (gdb::array_view<memory_read_range> ranges)
+    override;
+
   void look_up_symbols () override;
 
   void request_interrupt () override;
@@ -1265,6 +1265,114 @@ handle_search_memory (char *own_buf, int packet_len)
   free (pattern);
 }
 
+/* Handle qReadMemoryRanges packets.  The reply is binary, and its
+   length is stored in *NEW_PACKET_LEN_P.  */
+
+static void
+handle_read_memory_ranges (char *own_buf, int *new_packet_len_p)
+{
+  client_state &cs = get_client_state ();
+  const char *p = own_buf + strlen ("qReadMemoryRanges:");
+  std::vector<memory_read_range> ranges;
+  ULONGEST total = 0;
+
+  while (*p != '\0')
+    {
+      ULONGEST addr, len;
+
+      p = unpack_varlen_hex (p, &addr);
+      if (*p++ != ',')
+	{
+	  write_enn (own_buf);
+	  return;
+	}
+      p = unpack_varlen_hex (p, &len);
+      if (*p == ';')
+	p++;
+      else if (*p != '\0')
+	{
+	  write_enn (own_buf);
+	  return;
+	}
+
+      /* Ranges that can't fit in the reply are not read; GDB asks for
+	 them again.  */
+      if (total >= PBUFSIZ)
+	break;
+      len = std::min (len, (ULONGEST) PBUFSIZ - total);
+
+      ranges.push_back ({ addr, nullptr, len });
+      total += len;
+    }
+
+  if (ranges.empty ()
+      || cs.current_traceframe >= 0
+      || !set_desired_process ())
+    {
+      write_enn (own_buf);
+      return;
+    }
+
+  gdb::byte_vector data (total);
+  gdb_byte *buf = data.data ();
+  for (memory_read_range &range : ranges)
+    {
+      range.buf = buf;
+      buf += range.len;
+    }
+
+  /* If some range can't be read, find out which, so that the ranges
+     before it can still be returned.  */
+  size_t readable = ranges.size ();
+  if (!target_read_memory_vectored (ranges))
+    for (readable = 0; readable < ranges.size (); ++readable)
+      if (gdb_read_memory (ranges[readable].addr, ranges[readable].buf,
+			   ranges[readable].len) != ranges[readable].len)
+	break;
+
+  /* For each range, write the number of bytes read in hex, a colon and
+     the bytes, stopping after the first range that can't be returned
+     in full.  */
+  char *out = own_buf;
+  int room = PBUFSIZ - 1;
+  for (size_t i = 0; i < ranges.size (); ++i)
+    {
+      ULONGEST len = i < readable ? ranges[i].len : 0;
+      std::string header = string_printf ("%s:", phex_nz (len, sizeof (len)));
+      if ((int) header.size () >= room)
+	break;
+
+      int used;
+      int escaped_len
+	= remote_escape_output (ranges[i].buf, len, 1,
+				(gdb_byte *) out + header.size (), &used,
+				room - header.size ());
+      if (used < len)
+	{
+	  /* Only the first range is returned cut short; the others are
+	     left for GDB to ask for again.  */
+	  if (i > 0)
+	    break;
+
+	  std::string short_header
+	    = string_printf ("%s:", phex_nz (used, sizeof (used)));
+	  memmove (out + short_header.size (), out + header.size (),
+		   escaped_len);
+	  header = short_header;
+	  len = used;
+	}
+
+      memcpy (out, header.data (), header.size ());
+      out += header.size () + escaped_len;
+      room -= header.size () + escaped_len;
+
+      if (len < ranges[i].len)
+	break;
+    }
+
+  *new_packet_len_p = out - own_buf;
+}
+
 /* Handle the "D" packet.  */
 
 static void
@@ -2825,6 +2933,8 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 
       strcat (own_buf, ";vContSupported+");
 
+      strcat (own_buf, ";qReadMemoryRanges+");
+
       gdb_thread_options supported_options = target_supported_thread_options ();
       if (supported_options != 0)
 	{
@@ -2973,6 +3083,13 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
       return;
     }
 
+  if (startswith (own_buf, "qReadMemoryRanges:"))
+    {
+      require_running_or_return (own_buf);
+      handle_read_memory_ranges (own_buf, new_packet_len_p);
+      return;
+    }
+
   if (strcmp (own_buf, "qAttached") == 0
       || startswith (own_buf, "qAttached:"))
     {
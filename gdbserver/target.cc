@@ -104,6 +104,26 @@ target_read_memory (CORE_ADDR memaddr, gdb_byte *myaddr, ssize_t len)
   return read_inferior_memory (memaddr, myaddr, len);
 }
 
+/* See target.h.  */
+
+bool
+target_read_memory_vectored (gdb::array_view<memory_read_range> ranges)
+{
+  if (the_target->read_memory_vectored (ranges))
+    {
+      for (const memory_read_range &range : ranges)
+	check_mem_read (range.addr, range.buf, range.len);
+      return true;
+    }
+
+  for (const memory_read_range &range : ranges)
+    if (range.len != 0
+	&& read_inferior_memory (range.addr, range.buf, range.len) != 0)
+      return false;
+
+  return true;
+}
+
 /* See target/target.h.  */
 
 int
@@ -333,6 +353,13 @@ process_stratum_target::post_create_inferior ()
   /* Nop.  */
 }
 
+bool
+process_stratum_target::read_memory_vectored
+  (gdb::array_view<memory_read_range> ranges)
+{
+  return false;
+}
+
 void
 process_stratum_target::look_up_symbols ()
 {
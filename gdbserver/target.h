@@ -158,6 +158,16 @@ class process_stratum_target
   virtual int write_memory (CORE_ADDR memaddr, const unsigned char *myaddr,
 			    int len) = 0;
 
+  /* Read each of RANGES of memory from the inferior process, without
+     breakpoint shadowing, in as few operations as possible.  This
+     should generally be called through target_read_memory_vectored.
+
+     Return true if every range was read in full.  Return false if
+     some range could not be read, or if the target cannot do better
+     than one read_memory call per range.  */
+  virtual bool read_memory_vectored (gdb::array_view<memory_read_range>
+				     ranges);
+
   /* Query GDB for the values of any symbols we're interested in.
      This function is called whenever we receive a "qSymbols::"
      query, which corresponds to every time more symbols (might)
@@ -718,6 +728,14 @@ target_thread_pending_child (thread_info *thread, target_waitkind *kind)
 
 int read_inferior_memory (CORE_ADDR memaddr, unsigned char *myaddr, int len);
 
+/* Read each of RANGES of memory, like read_inferior_memory does for
+   one range, but letting the target fetch them all at once when it
+   can.  Return true if every range was read in full.  No guarantee is
+   made about the contents of any of the buffers if some range could
+   not be read.  */
+
+bool target_read_memory_vectored (gdb::array_view<memory_read_range> ranges);
+
 /* Set GDBserver's current thread to the thread the client requested
    via Hg.  Also switches the current process to the requested
    process.  If the requested thread is not found in the thread list,
@@ -21,9 +21,11 @@
 #define GDBSUPPORT_PARALLEL_FOR_H
 
 #include <algorithm>
+#include <exception>
 #include <type_traits>
 #include "gdbsupport/thread-pool.h"
 #include "gdbsupport/function-view.h"
+#include "gdbsupport/work-queue.h"
 
 namespace gdb
 {
@@ -38,13 +40,29 @@ namespace gdb
 
    The parameter N says how batching ought to be done -- there will be
    at least N elements processed per thread.  Setting N to 0 is not
-   allowed.  */
+   allowed.
+
+   If the thread pool uses dynamic scheduling, the callback may be
+   invoked several times per thread, each time with a batch of at
+   least N elements (except possibly the last one); see
+   parallel_for_each_dynamic.  */
+
+template<class RandomIt, class RangeFunction>
+void parallel_for_each_dynamic (unsigned n, RandomIt first, RandomIt last,
+				RangeFunction callback);
 
 template<class RandomIt, class RangeFunction>
 void
 parallel_for_each (unsigned n, RandomIt first, RandomIt last,
 		   RangeFunction callback)
 {
+  if (thread_pool::g_thread_pool->scheduling ()
+      == worker_scheduling::SHARED_QUEUE)
+    {
+      parallel_for_each_dynamic (n, first, last, callback);
+      return;
+    }
+
   /* If enabled, print debug info about how the work is distributed across
      the threads.  */
   const bool parallel_for_each_debug = false;
@@ -135,6 +153,84 @@ parallel_for_each (unsigned n, RandomIt first, RandomIt last,
     fut.get ();
 }
 
+/* A variant of parallel_for_each that always uses dynamic scheduling.
+   One task per worker thread is submitted to the thread pool, and
+   each task -- as well as the calling thread -- pops batches of
+   elements from a shared work_queue until none remain.  This keeps
+   all the threads busy even when the cost of the elements is very
+   uneven.  */
+
+template<class RandomIt, class RangeFunction>
+void
+parallel_for_each_dynamic (unsigned n, RandomIt first, RandomIt last,
+			   RangeFunction callback)
+{
+  gdb_assert (n > 0);
+
+  size_t n_elements = last - first;
+  size_t n_threads = thread_pool::g_thread_pool->thread_count ();
+
+  /* Don't start more tasks than there are batches of N elements.  */
+  n_threads = std::min (n_threads, n_elements / n);
+
+  if (n_threads <= 1)
+    {
+      callback (first, last);
+      return;
+    }
+
+  /* Aim for several batches per thread, so that there is something
+     left to rebalance once the first batches are done.  */
+  const size_t batch_size = std::max (n_elements / (8 * n_threads),
+				      (size_t) n);
+  work_queue<RandomIt> queue (first, last, batch_size);
+  auto drain = [&] ()
+    {
+      while (true)
+	{
+	  std::pair<RandomIt, RandomIt> batch = queue.pop_batch ();
+	  if (batch.first == batch.second)
+	    break;
+	  callback (batch.first, batch.second);
+	}
+    };
+
+  /* The calling thread participates as well, so one less task is
+     needed.  */
+  std::vector<gdb::future<void>> results;
+  for (size_t i = 1; i < n_threads; ++i)
+    results.push_back (gdb::thread_pool::g_thread_pool->post_task (drain));
+
+  /* The tasks use QUEUE and CALLBACK from this frame, so all of them
+     must be finished before returning, even if one of them throws.
+     The first exception seen is then rethrown.  */
+  std::exception_ptr error;
+  try
+    {
+      drain ();
+    }
+  catch (...)
+    {
+      error = std::current_exception ();
+    }
+
+  for (auto &fut : results)
+    {
+      try
+	{
+	  fut.get ();
+	}
+      catch (...)
+	{
+	  if (error == nullptr)
+	    error = std::current_exception ();
+	}
+    }
+
+  if (error != nullptr)
+    std::rethrow_exception (error);
+}
+
 /* A sequential drop-in replacement of parallel_for_each.  This can be useful
    when debugging multi-threading behaviour, and you want to limit
    multi-threading in a fine-grained way.  */
@@ -50,6 +50,20 @@ class scoped_mmap
     rhs.m_length = 0;
   }
 
+  scoped_mmap &operator= (scoped_mmap &&rhs) noexcept
+  {
+    if (this != &rhs)
+      {
+	destroy ();
+
+	m_mem = rhs.m_mem;
+	m_length = rhs.m_length;
+	rhs.m_mem = MAP_FAILED;
+	rhs.m_length = 0;
+      }
+    return *this;
+  }
+
   DISABLE_COPY_AND_ASSIGN (scoped_mmap);
 
   ATTRIBUTE_UNUSED_RESULT void *release () noexcept
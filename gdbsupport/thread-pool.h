@@ -117,6 +117,20 @@ class future<void>
 
 #endif /* CXX_STD_THREAD */
 
+/* How work that is spread over the thread pool is divided between the
+   threads.  Note that the enumerators can't be called STATIC and
+   DYNAMIC, as bfd.h defines the latter as a macro.  */
+
+enum class worker_scheduling
+{
+  /* The work is split up front into one contiguous chunk per
+     thread.  */
+  STATIC_SPLIT,
+  /* The threads repeatedly take batches of work from a shared queue
+     until it is exhausted; see work_queue.  */
+  SHARED_QUEUE,
+};
+
 
 /* A thread pool.
 
@@ -146,6 +160,19 @@ class thread_pool
 #endif
   }
 
+  /* Return the scheduling mode that users of this pool, like
+     parallel_for_each, should use to distribute their work.  */
+  worker_scheduling scheduling () const
+  {
+    return m_scheduling;
+  }
+
+  /* Set the scheduling mode.  */
+  void set_scheduling (worker_scheduling scheduling)
+  {
+    m_scheduling = scheduling;
+  }
+
   /* Post a task to the thread pool.  A future is returned, which can
      be used to wait for the result.  */
   future<void> post_task (std::function<void ()> &&func)
@@ -180,6 +207,9 @@ class thread_pool
 
   thread_pool () = default;
 
+  /* The current scheduling mode.  */
+  worker_scheduling m_scheduling = worker_scheduling::SHARED_QUEUE;
+
 #if CXX_STD_THREAD
   /* The callback for each worker thread.  */
   void thread_function ();
@@ -0,0 +1,87 @@
+/* Thread-safe work queue
+
+   Copyright (C) 2024 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef GDBSUPPORT_WORK_QUEUE_H
+#define GDBSUPPORT_WORK_QUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+namespace gdb
+{
+
+/* A work queue hands out batches of the elements of [FIRST, LAST) to
+   any number of consumers, which may run concurrently.  Each element
+   is handed out exactly once.
+
+   This is used for dynamic scheduling: rather than splitting the work
+   into one fixed subrange per thread up front, each worker repeatedly
+   pops a batch until the queue is empty.  A thread that happens to
+   receive expensive elements simply pops fewer batches, so a few
+   large elements can't leave the other threads idle.
+
+   BATCH_SIZE trades synchronization cost against balance.  When the
+   cost of an element is large compared to an atomic increment -- for
+   instance, a whole compilation unit -- a batch size of 1 gives the
+   best balance.  */
+
+template<typename RandomIt>
+class work_queue
+{
+public:
+
+  work_queue (RandomIt first, RandomIt last, size_t batch_size = 1)
+    : m_first (first),
+      m_size (last - first),
+      m_batch_size (std::max (batch_size, (size_t) 1))
+  {
+  }
+
+  DISABLE_COPY_AND_ASSIGN (work_queue);
+
+  /* Pop the next batch of elements.  The result is a pair of
+     iterators delimiting the batch.  An empty range means that the
+     queue has been exhausted.  */
+  std::pair<RandomIt, RandomIt> pop_batch ()
+  {
+    size_t start = m_next.fetch_add (m_batch_size, std::memory_order_relaxed);
+    if (start >= m_size)
+      return { m_first + m_size, m_first + m_size };
+
+    size_t end = std::min (start + m_batch_size, m_size);
+    return { m_first + start, m_first + end };
+  }
+
+private:
+
+  /* The start of the range.  */
+  const RandomIt m_first;
+  /* Number of elements in the range.  */
+  const size_t m_size;
+  /* The number of elements in a batch.  */
+  const size_t m_batch_size;
+  /* Index of the next element to hand out.  This may go past
+     M_SIZE once the queue is exhausted.  */
+  std::atomic<size_t> m_next { 0 };
+};
+
+} /* namespace gdb */
+
+#endif /* GDBSUPPORT_WORK_QUEUE_H */
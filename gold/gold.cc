@@ -134,6 +134,48 @@ Middle_runner::run(Workqueue* workqueue, const Task* task)
 		     this->layout_, workqueue, this->mapfile_);
 }
 
+static void
+queue_middle_tasks_after_icf(const General_options&,
+			     const Task*,
+			     const Input_objects*,
+			     Symbol_table*,
+			     Layout*,
+			     Workqueue*,
+			     Mapfile*);
+
+// This class arranges to run the rest of the middle tasks once
+// identical code folding has found the sections to fold.
+
+class Middle_after_icf_runner : public Task_function_runner
+{
+ public:
+  Middle_after_icf_runner(const General_options& options,
+			  const Input_objects* input_objects,
+			  Symbol_table* symtab,
+			  Layout* layout, Mapfile* mapfile)
+    : options_(options), input_objects_(input_objects), symtab_(symtab),
+      layout_(layout), mapfile_(mapfile)
+  { }
+
+  void
+  run(Workqueue*, const Task*);
+
+ private:
+  const General_options& options_;
+  const Input_objects* input_objects_;
+  Symbol_table* symtab_;
+  Layout* layout_;
+  Mapfile* mapfile_;
+};
+
+void
+Middle_after_icf_runner::run(Workqueue* workqueue, const Task* task)
+{
+  queue_middle_tasks_after_icf(this->options_, task, this->input_objects_,
+			       this->symtab_, this->layout_, workqueue,
+			       this->mapfile_);
+}
+
 // This class arranges the tasks to process the relocs for garbage collection.
 
 class Gc_runner : public Task_function_runner
@@ -525,14 +567,42 @@ queue_middle_tasks(const General_options& options,
       symtab->gc()->do_transitive_closure();
     }
 
+  int thread_count = options.thread_count_middle();
+  if (thread_count == 0)
+    thread_count = std::max(2, input_objects->number_of_input_objects());
+  workqueue->set_thread_count(thread_count);
+
   // If identical code folding (--icf) is chosen it makes sense to do it
   // only after garbage collection (--gc-sections) as we do not want to
-  // be folding sections that will be garbage.
+  // be folding sections that will be garbage.  The search is done by
+  // a set of tasks, the last of which queues the rest of the middle
+  // tasks.
   if (parameters->options().icf_enabled())
     {
-      symtab->icf()->find_identical_sections(input_objects, symtab);
+      symtab->icf()->find_identical_sections(input_objects, symtab,
+					     workqueue,
+					     new Middle_after_icf_runner(
+					       options, input_objects,
+					       symtab, layout, mapfile));
+      return;
     }
 
+  queue_middle_tasks_after_icf(options, task, input_objects, symtab, layout,
+			       workqueue, mapfile);
+}
+
+// Queue up the rest of the middle set of tasks, once identical code
+// folding is done.
+
+static void
+queue_middle_tasks_after_icf(const General_options& options,
+			     const Task* task,
+			     const Input_objects* input_objects,
+			     Symbol_table* symtab,
+			     Layout* layout,
+			     Workqueue* workqueue,
+			     Mapfile* mapfile)
+{
   // Call Object::layout for the second time to determine the
   // output_sections for all referenced input sections.  When
   // --gc-sections or --icf is turned on, or when certain input
@@ -597,11 +667,6 @@ queue_middle_tasks(const General_options& options,
 	}
     }
 
-  int thread_count = options.thread_count_middle();
-  if (thread_count == 0)
-    thread_count = std::max(2, input_objects->number_of_input_objects());
-  workqueue->set_thread_count(thread_count);
-
   // Now we have seen all the input files.
   const bool doing_static_link =
     (!input_objects->any_dynamic()
@@ -167,62 +167,212 @@
 #include "demangle.h"
 #include "elfcpp.h"
 #include "int_encoding.h"
+#include "fileread.h"
+#include "workqueue.h"
 
 #include <limits>
 
 namespace gold
 {
 
+// A view of the contents of a section, kept for the whole of ICF.
+
+struct Icf_view
+{
+  const unsigned char* data;
+  section_size_type size;
+};
+
+typedef Unordered_map<Section_id, Icf_view, Section_id_hash> Icf_view_map;
+
+// What ICF compares for a section: the concatenation of PIECES, which
+// are the parts that do not change from iteration to iteration, followed
+// by ICF_TEXT, which describes the relocations to sections that could
+// be folded.  A piece is either a view of an input file or a part of
+// TEXT, so the contents of the sections are never copied.
+
+struct Icf_contents
+{
+  struct Piece
+  {
+    // The data, or NULL if the piece is TEXT from OFFSET on.
+    const unsigned char* view;
+    section_size_type offset;
+    section_size_type length;
+  };
+
+  Icf_contents()
+    : pieces(), text(), length(0), cksum(0xffffffff), icf_text(),
+      targets()
+  { }
+
+  // Append LEN bytes at P to the pieces.
+  void
+  append_view(const unsigned char* p, section_size_type len)
+  {
+    if (len == 0)
+      return;
+    Piece piece = { p, 0, len };
+    this->pieces.push_back(piece);
+    this->length += len;
+  }
+
+  // Append a string to the pieces.
+  void
+  append_text(const char* str, size_t len)
+  {
+    if (len == 0)
+      return;
+    if (this->pieces.empty() || this->pieces.back().view != NULL)
+      {
+	Piece piece = { NULL, this->text.length(), 0 };
+	this->pieces.push_back(piece);
+      }
+    this->text.append(str, len);
+    this->pieces.back().length += len;
+    this->length += len;
+  }
+
+  void
+  append_text(const std::string& str)
+  { this->append_text(str.data(), str.length()); }
+
+  void
+  append_text(const char* str)
+  { this->append_text(str, strlen(str)); }
+
+  // Return the data of piece I.
+  const unsigned char*
+  piece_data(size_t i) const
+  {
+    const Piece& piece = this->pieces[i];
+    if (piece.view != NULL)
+      return piece.view;
+    return (reinterpret_cast<const unsigned char*>(this->text.data())
+	    + piece.offset);
+  }
+
+  // Compute CKSUM, the checksum of the pieces.
+  void
+  compute_cksum()
+  {
+    uint32_t crc = 0xffffffff;
+    for (size_t i = 0; i < this->pieces.size(); ++i)
+      crc = xcrc32(this->piece_data(i), this->pieces[i].length, crc);
+    this->cksum = crc;
+  }
+
+  // Return the checksum of all the contents, pieces and ICF_TEXT.
+  uint32_t
+  full_cksum() const
+  {
+    return xcrc32(reinterpret_cast<const unsigned char*>(this->icf_text.data()),
+		  this->icf_text.length(), this->cksum);
+  }
+
+  // Return the length of all the contents.
+  size_t
+  full_length() const
+  { return this->length + this->icf_text.length(); }
+
+  // The parts that don't change.
+  std::vector<Piece> pieces;
+  std::string text;
+  // The total length of the pieces, and their checksum.
+  size_t length;
+  uint32_t cksum;
+  // The part describing the relocations to sections that could be
+  // folded, which is recomputed on every iteration.
+  std::string icf_text;
+  // The ids of the sections whose kept sections ICF_TEXT names.
+  std::vector<unsigned int> targets;
+};
+
+// Return whether A and B have the same contents.
+
+static bool
+icf_contents_equal(const Icf_contents& a, const Icf_contents& b)
+{
+  if (a.full_length() != b.full_length())
+    return false;
+
+  // Walk both lists of pieces, with ICF_TEXT as a last piece, comparing
+  // as much as the shorter of the current pieces has left.
+  size_t ia = 0, ib = 0;
+  size_t offa = 0, offb = 0;
+  size_t left = a.full_length();
+  while (left > 0)
+    {
+      const unsigned char* pa;
+      size_t lena;
+      if (ia < a.pieces.size())
+	{
+	  pa = a.piece_data(ia);
+	  lena = a.pieces[ia].length;
+	}
+      else
+	{
+	  pa = reinterpret_cast<const unsigned char*>(a.icf_text.data());
+	  lena = a.icf_text.length();
+	}
+      const unsigned char* pb;
+      size_t lenb;
+      if (ib < b.pieces.size())
+	{
+	  pb = b.piece_data(ib);
+	  lenb = b.pieces[ib].length;
+	}
+      else
+	{
+	  pb = reinterpret_cast<const unsigned char*>(b.icf_text.data());
+	  lenb = b.icf_text.length();
+	}
+
+      size_t len = std::min(lena - offa, lenb - offb);
+      if (len > 0 && memcmp(pa + offa, pb + offb, len) != 0)
+	return false;
+      offa += len;
+      offb += len;
+      left -= len;
+      if (offa == lena)
+	{
+	  ++ia;
+	  offa = 0;
+	}
+      if (offb == lenb)
+	{
+	  ++ib;
+	  offb = 0;
+	}
+    }
+  return true;
+}
+
 // This function determines if a section or a group of identical
 // sections has unique contents.  Such unique sections or groups can be
 // declared final and need not be processed any further.
 // Parameters :
-// ID_SECTION : Vector mapping a section index to a Section_id pair.
+// CKSUMS : Checksum of each section's contents.  Before the first
+//          iteration of icf these are checksums of the contents of the
+//          sections themselves, later ones are of the section's text
+//          and relocs to sections that cannot be folded.
 // IS_SECN_OR_GROUP_UNIQUE : To check if a section or a group of identical
 //                            sections is already known to be unique.
-// SECTION_CONTENTS : Contains the section's text and relocs to sections
-//                    that cannot be folded.   SECTION_CONTENTS are NULL
-//                    implies that this function is being called for the
-//                    first time before the first iteration of icf.
 
 static void
-preprocess_for_unique_sections(const std::vector<Section_id>& id_section,
-                               std::vector<bool>* is_secn_or_group_unique,
-                               std::vector<std::string>* section_contents)
+preprocess_for_unique_sections(const std::vector<uint32_t>& cksums,
+                               std::vector<bool>* is_secn_or_group_unique)
 {
   Unordered_map<uint32_t, unsigned int> uniq_map;
   std::pair<Unordered_map<uint32_t, unsigned int>::iterator, bool>
     uniq_map_insert;
 
-  for (unsigned int i = 0; i < id_section.size(); i++)
+  for (unsigned int i = 0; i < cksums.size(); i++)
     {
       if ((*is_secn_or_group_unique)[i])
         continue;
 
-      uint32_t cksum;
-      Section_id secn = id_section[i];
-      section_size_type plen;
-      if (section_contents == NULL)
-        {
-          // Lock the object so we can read from it.  This is only called
-          // single-threaded from queue_middle_tasks, so it is OK to lock.
-          // Unfortunately we have no way to pass in a Task token.
-          const Task* dummy_task = reinterpret_cast<const Task*>(-1);
-          Task_lock_obj<Object> tl(dummy_task, secn.first);
-          const unsigned char* contents;
-          contents = secn.first->section_contents(secn.second,
-                                                  &plen,
-                                                  false);
-          cksum = xcrc32(contents, plen, 0xffffffff);
-        }
-      else
-        {
-          const unsigned char* contents_array = reinterpret_cast
-            <const unsigned char*>((*section_contents)[i].c_str());
-          cksum = xcrc32(contents_array, (*section_contents)[i].length(),
-                         0xffffffff);
-        }
-      uniq_map_insert = uniq_map.insert(std::make_pair(cksum, i));
+      uniq_map_insert = uniq_map.insert(std::make_pair(cksums[i], i));
       if (uniq_map_insert.second)
         {
           (*is_secn_or_group_unique)[i] = true;
@@ -274,16 +424,16 @@ get_rel_addend(const unsigned char* reloc_addend_ptr,
     }
 }
 
-// This returns the buffer containing the section's contents, both
-// text and relocs.  Relocs are differentiated as those pointing to
-// sections that could be folded and those that cannot.  Only relocs
-// pointing to sections that could be folded are recomputed on
-// subsequent invocations of this function.
+// This computes the section's contents, both text and relocs.  Relocs
+// are differentiated as those pointing to sections that could be folded
+// and those that cannot.  Only relocs pointing to sections that could be
+// folded are recomputed on subsequent invocations of this function.
 // Parameters  :
 // FIRST_ITERATION    : true if it is the first invocation.
-// FIXED_CACHE        : String that stores the portion of the result that
-//                      does not change from iteration to iteration;
-//                      written if first_iteration is true, read if it's false.
+// SECN_CONTENTS      : Where the contents are appended.  The pieces that
+//                      do not change from iteration to iteration are
+//                      appended only if first_iteration is true, the
+//                      ICF_TEXT that does always is.
 // SECN               : Section for which contents are desired.
 // SELF_SECN          : Relocations that target this section will be
 //                      considered "relocations to self" so that recursive
@@ -293,32 +443,35 @@ get_rel_addend(const unsigned char* reloc_addend_ptr,
 // NUM_TRACKED_RELOCS : Vector reference to store the number of relocs
 //                      to ICF sections.
 // KEPT_SECTION_ID    : Vector which maps folded sections to kept sections.
+// VIEWS              : Views of the contents of the candidate sections
+//                      and of the sections holding extra identity regions.
 // START_OFFSET       : Only consider the part of the section at and after
 //                      this offset.
 // END_OFFSET         : Only consider the part of the section before this
 //                      offset.
 
-static std::string
+static void
 get_section_contents(bool first_iteration,
-		     std::string* fixed_cache,
+		     Icf_contents* secn_contents,
                      const Section_id& secn,
 		     const Section_id& self_secn,
                      unsigned int* num_tracked_relocs,
                      Symbol_table* symtab,
                      const std::vector<unsigned int>& kept_section_id,
+		     const Icf_view_map& views,
 		     section_offset_type start_offset = 0,
 		     section_offset_type end_offset =
 		       std::numeric_limits<section_offset_type>::max())
 {
-  section_size_type plen;
+  section_size_type plen = 0;
   const unsigned char* contents = NULL;
   if (first_iteration)
-    contents = secn.first->section_contents(secn.second, &plen, false);
-
-  // The buffer to hold all the contents including relocs.  A checksum
-  // is then computed on this buffer.
-  std::string buffer;
-  std::string icf_reloc_buffer;
+    {
+      Icf_view_map::const_iterator it_view = views.find(secn);
+      gold_assert(it_view != views.end());
+      contents = it_view->second.data;
+      plen = it_view->second.size;
+    }
 
   Icf::Reloc_info_list& reloc_info_list = 
     symtab->icf()->reloc_info_list();
@@ -326,9 +479,6 @@ get_section_contents(bool first_iteration,
   Icf::Reloc_info_list::iterator it_reloc_info_list =
     reloc_info_list.find(secn);
 
-  buffer.clear();
-  icf_reloc_buffer.clear();
-
   // Process relocs and put them into the buffer.
 
   if (it_reloc_info_list != reloc_info_list.end())
@@ -408,10 +558,10 @@ get_section_contents(bool first_iteration,
                 {
 		  // If the symbol name is available, use it.
                   if (gsym != NULL)
-                      buffer.append(gsym->name());
+                      secn_contents->append_text(gsym->name());
                   // Append the addend.
-                  buffer.append(addend_str);
-                  buffer.append("@");
+                  secn_contents->append_text(addend_str);
+                  secn_contents->append_text("@");
 		}
 	      continue;
 	    }
@@ -425,9 +575,9 @@ get_section_contents(bool first_iteration,
             {
               if (first_iteration)
                 {
-                  buffer.append("R");
-                  buffer.append(addend_str);
-                  buffer.append("@");
+                  secn_contents->append_text("R");
+                  secn_contents->append_text(addend_str);
+                  secn_contents->append_text("@");
                 }
               continue;
             }
@@ -452,13 +602,14 @@ get_section_contents(bool first_iteration,
                        kept_section_id[secn_id]);
               if (first_iteration)
                 {
-                  buffer.append("ICF_R");
-                  buffer.append(addend_str);
+                  secn_contents->append_text("ICF_R");
+                  secn_contents->append_text(addend_str);
+                  secn_contents->targets.push_back(secn_id);
                 }
-              icf_reloc_buffer.append(kept_section_str);
+              secn_contents->icf_text.append(kept_section_str);
               // Append the addend.
-              icf_reloc_buffer.append(addend_str);
-              icf_reloc_buffer.append("@");
+              secn_contents->icf_text.append(addend_str);
+              secn_contents->icf_text.append("@");
             }
           else
             {
@@ -529,7 +680,7 @@ get_section_contents(bool first_iteration,
                         {
                         case 1:
                           {
-                            buffer.append(str_char);
+                            secn_contents->append_text(str_char);
                             break;
                           }
                         case 2:
@@ -540,7 +691,8 @@ get_section_contents(bool first_iteration,
                             // Find the NULL character.
                             while(*(ptr_16 + strlen_16) != 0)
                                 strlen_16++;
-                            buffer.append(str_char, strlen_16 * 2);
+                            secn_contents->append_text(str_char,
+                                                       strlen_16 * 2);
                           }
                           break;
                         case 4:
@@ -551,7 +703,8 @@ get_section_contents(bool first_iteration,
                             // Find the NULL character.
                             while(*(ptr_32 + strlen_32) != 0)
                                 strlen_32++;
-                            buffer.append(str_char, strlen_32 * 4);
+                            secn_contents->append_text(str_char,
+                                                       strlen_32 * 4);
                           }
                           break;
                         default:
@@ -565,31 +718,31 @@ get_section_contents(bool first_iteration,
 		      // If entsize is too big, copy all the remaining bytes.
 		      if ((offset + entsize) > secn_len)
 			bufsize = secn_len - offset;
-                      buffer.append(reinterpret_cast<const
-                                                     char*>(str_contents),
-                                    bufsize);
+                      secn_contents->append_text(reinterpret_cast<const
+                                                 char*>(str_contents),
+                                                 bufsize);
                     }
-		  buffer.append("@");
+		  secn_contents->append_text("@");
                 }
               else if (gsym != NULL)
                 {
                   // If symbol name is available use that.
-                  buffer.append(gsym->name());
+                  secn_contents->append_text(gsym->name());
                   // Append the addend.
-                  buffer.append(addend_str);
-                  buffer.append("@");
+                  secn_contents->append_text(addend_str);
+                  secn_contents->append_text("@");
                 }
               else
                 {
                   // Symbol name is not available, like for a local symbol,
                   // use object and section id.
-                  buffer.append(it_v->first->name());
+                  secn_contents->append_text(it_v->first->name());
                   char secn_id[10];
                   snprintf(secn_id, sizeof(secn_id), "%u",it_v->second);
-                  buffer.append(secn_id);
+                  secn_contents->append_text(secn_id);
                   // Append the addend.
-                  buffer.append(addend_str);
-                  buffer.append("@");
+                  secn_contents->append_text(addend_str);
+                  secn_contents->append_text("@");
                 }
             }
         }
@@ -597,16 +750,14 @@ get_section_contents(bool first_iteration,
 
   if (first_iteration)
     {
-      buffer.append("Contents = ");
+      secn_contents->append_text("Contents = ");
 
-      const unsigned char* slice_end =
-	contents + std::min<section_offset_type>(plen, end_offset);
+      section_offset_type slice_end =
+	std::min<section_offset_type>(plen, end_offset);
 
-      if (contents + start_offset < slice_end)
-	{
-	  buffer.append(reinterpret_cast<const char*>(contents + start_offset),
-			slice_end - (contents + start_offset));
-	}
+      if (start_offset < slice_end)
+	secn_contents->append_view(contents + start_offset,
+				   slice_end - start_offset);
     }
 
   // Add any extra identity regions.
@@ -615,207 +766,11 @@ get_section_contents(bool first_iteration,
     extra_range = symtab->icf()->extra_identity_list().equal_range(secn);
   for (Icf::Extra_identity_list::const_iterator it_ext = extra_range.first;
        it_ext != extra_range.second; ++it_ext)
-    {
-      std::string external_fixed;
-      std::string external_all =
-	get_section_contents(first_iteration, &external_fixed,
-			     it_ext->second.section, self_secn,
-			     num_tracked_relocs, symtab,
-			     kept_section_id, it_ext->second.offset,
-			     it_ext->second.offset + it_ext->second.length);
-      buffer.append(external_fixed);
-      icf_reloc_buffer.append(external_all, external_fixed.length(),
-			      std::string::npos);
-    }
-
-  if (first_iteration)
-    {
-      // Store the section contents that don't change to avoid recomputing
-      // during the next call to this function.
-      *fixed_cache = buffer;
-    }
-  else
-    {
-      gold_assert(buffer.empty());
-
-      // Reuse the contents computed in the previous iteration.
-      buffer.append(*fixed_cache);
-    }
-
-  buffer.append(icf_reloc_buffer);
-  return buffer;
-}
-
-// This function computes a checksum on each section to detect and form
-// groups of identical sections.  The first iteration does this for all 
-// sections.
-// Further iterations do this only for the kept sections from each group to
-// determine if larger groups of identical sections could be formed.  The
-// first section in each group is the kept section for that group.
-//
-// CRC32 is the checksumming algorithm and can have collisions.  That is,
-// two sections with different contents can have the same checksum. Hence,
-// a multimap is used to maintain more than one group of checksum
-// identical sections.  A section is added to a group only after its
-// contents are explicitly compared with the kept section of the group.
-//
-// Parameters  :
-// ITERATION_NUM           : Invocation instance of this function.
-// NUM_TRACKED_RELOCS : Vector reference to store the number of relocs
-//                      to ICF sections.
-// KEPT_SECTION_ID    : Vector which maps folded sections to kept sections.
-// ID_SECTION         : Vector mapping a section to an unique integer.
-// IS_SECN_OR_GROUP_UNIQUE : To check if a section or a group of identical
-//                            sections is already known to be unique.
-// SECTION_CONTENTS   : Store the section's text and relocs to non-ICF
-//                      sections.
-
-static bool
-match_sections(unsigned int iteration_num,
-               Symbol_table* symtab,
-               std::vector<unsigned int>* num_tracked_relocs,
-               std::vector<unsigned int>* kept_section_id,
-               const std::vector<Section_id>& id_section,
-	       const std::vector<uint64_t>& section_addraligns,
-               std::vector<bool>* is_secn_or_group_unique,
-               std::vector<std::string>* section_contents)
-{
-  Unordered_multimap<uint32_t, unsigned int> section_cksum;
-  std::pair<Unordered_multimap<uint32_t, unsigned int>::iterator,
-            Unordered_multimap<uint32_t, unsigned int>::iterator> key_range;
-  bool converged = true;
-
-  if (iteration_num == 1)
-    preprocess_for_unique_sections(id_section,
-                                   is_secn_or_group_unique,
-                                   NULL);
-  else
-    preprocess_for_unique_sections(id_section,
-                                   is_secn_or_group_unique,
-                                   section_contents);
-
-  std::vector<std::string> full_section_contents;
-
-  for (unsigned int i = 0; i < id_section.size(); i++)
-    {
-      full_section_contents.push_back("");
-      if ((*is_secn_or_group_unique)[i])
-        continue;
-
-      Section_id secn = id_section[i];
-
-      // Lock the object so we can read from it.  This is only called
-      // single-threaded from queue_middle_tasks, so it is OK to lock.
-      // Unfortunately we have no way to pass in a Task token.
-      const Task* dummy_task = reinterpret_cast<const Task*>(-1);
-      Task_lock_obj<Object> tl(dummy_task, secn.first);
-
-      std::string this_secn_contents;
-      uint32_t cksum;
-      std::string* this_secn_cache = &((*section_contents)[i]);
-      if (iteration_num == 1)
-        {
-          unsigned int num_relocs = 0;
-          this_secn_contents = get_section_contents(true, this_secn_cache,
-						    secn, secn, &num_relocs,
-						    symtab, (*kept_section_id));
-          (*num_tracked_relocs)[i] = num_relocs;
-        }
-      else
-        {
-          if ((*kept_section_id)[i] != i)
-            {
-              // This section is already folded into something.
-              continue;
-            }
-          this_secn_contents = get_section_contents(false, this_secn_cache,
-						    secn, secn, NULL,
-						    symtab, (*kept_section_id));
-        }
-
-      const unsigned char* this_secn_contents_array =
-            reinterpret_cast<const unsigned char*>(this_secn_contents.c_str());
-      cksum = xcrc32(this_secn_contents_array, this_secn_contents.length(),
-                     0xffffffff);
-      size_t count = section_cksum.count(cksum);
-
-      if (count == 0)
-        {
-          // Start a group with this cksum.
-          section_cksum.insert(std::make_pair(cksum, i));
-          full_section_contents[i] = this_secn_contents;
-        }
-      else
-        {
-          key_range = section_cksum.equal_range(cksum);
-          Unordered_multimap<uint32_t, unsigned int>::iterator it;
-          // Search all the groups with this cksum for a match.
-          for (it = key_range.first; it != key_range.second; ++it)
-            {
-              unsigned int kept_section = it->second;
-              if (full_section_contents[kept_section].length()
-                  != this_secn_contents.length())
-                  continue;
-              if (memcmp(full_section_contents[kept_section].c_str(),
-                         this_secn_contents.c_str(),
-                         this_secn_contents.length()) != 0)
-                  continue;
-
-	      // Check section alignment here.
-	      // The section with the larger alignment requirement
-	      // should be kept.  We assume alignment can only be 
-	      // zero or positive integral powers of two.
-	      uint64_t align_i = section_addraligns[i];
-	      uint64_t align_kept = section_addraligns[kept_section];
-	      if (align_i <= align_kept)
-		{
-		  (*kept_section_id)[i] = kept_section;
-		}
-	      else
-		{
-		  (*kept_section_id)[kept_section] = i;
-		  it->second = i;
-		  full_section_contents[kept_section].swap(
-		      full_section_contents[i]);
-		}
-
-              converged = false;
-              break;
-            }
-          if (it == key_range.second)
-            {
-              // Create a new group for this cksum.
-              section_cksum.insert(std::make_pair(cksum, i));
-              full_section_contents[i] = this_secn_contents;
-            }
-        }
-      // If there are no relocs to foldable sections do not process
-      // this section any further.
-      if (iteration_num == 1 && (*num_tracked_relocs)[i] == 0)
-        (*is_secn_or_group_unique)[i] = true;
-    }
-
-  // If a section was folded into another section that was later folded
-  // again then the former has to be updated.
-  for (unsigned int i = 0; i < id_section.size(); i++)
-    {
-      // Find the end of the folding chain
-      unsigned int kept = i;
-      while ((*kept_section_id)[kept] != kept)
-        {
-          kept = (*kept_section_id)[kept];
-        }
-      // Update every element of the chain
-      unsigned int current = i;
-      while ((*kept_section_id)[current] != kept)
-        {
-          unsigned int next = (*kept_section_id)[current];
-          (*kept_section_id)[current] = kept;
-          current = next;
-        }
-    }
-
-  return converged;
+    get_section_contents(first_iteration, secn_contents,
+			 it_ext->second.section, self_secn,
+			 num_tracked_relocs, symtab,
+			 kept_section_id, views, it_ext->second.offset,
+			 it_ext->second.offset + it_ext->second.length);
 }
 
 // During safe icf (--icf=safe), only fold functions that are ctors or dtors.
@@ -837,13 +792,14 @@ is_function_ctor_or_dtor(const std::string& section_name)
 }
 
 // Iterate through the .eh_frame section that has index
-// `ehframe_shndx` in `object`, adding entries to extra_identity_list_
-// that will cause the contents of each FDE and its CIE to be included
-// in the logical ICF identity of the function that the FDE refers to.
+// `ehframe_shndx` in `object`, adding entries for extra_identity_list_
+// to `links` that will cause the contents of each FDE and its CIE to be
+// included in the logical ICF identity of the function that the FDE
+// refers to.
 
 bool
 Icf::add_ehframe_links(Relobj* object, unsigned int ehframe_shndx,
-		       Reloc_info& relocs)
+		       Reloc_info& relocs, Extra_identity_vector* links)
 {
   section_size_type contents_len;
   const unsigned char* pcontents = object->section_contents(ehframe_shndx,
@@ -932,8 +888,8 @@ Icf::add_ehframe_links(Relobj* object, unsigned int ehframe_shndx,
 					     p - pcontents, len - 4};
 	      Extra_identity_info rec_cie = {Section_id(object, ehframe_shndx),
 					     it->first, it->second};
-	      extra_identity_list_.insert(std::make_pair(*it_target, rec_fde));
-	      extra_identity_list_.insert(std::make_pair(*it_target, rec_cie));
+	      links->push_back(std::make_pair(*it_target, rec_fde));
+	      links->push_back(std::make_pair(*it_target, rec_cie));
 	    }
 	}
 
@@ -943,123 +899,598 @@ Icf::add_ehframe_links(Relobj* object, unsigned int ehframe_shndx,
   return true;
 }
 
-// This is the main ICF function called in gold.cc.  This does the
-// initialization and calls match_sections repeatedly (thrice by default)
-// which computes the crc checksums and detects identical functions.
+// The state of a search for identical sections.  The search is done by
+// the tasks below; an Icf_search is created by find_identical_sections
+// and deleted by the last of them.
+//
+// The first iteration of ICF computes a checksum on the contents of
+// every candidate section to detect and form groups of identical
+// sections.  Further iterations do this only for the kept sections from
+// each group to determine if larger groups of identical sections could
+// be formed.  The first section in each group is the kept section for
+// that group.
+//
+// The work is split up as follows:
+//
+// Icf_scan_task   : One per input object, in parallel.  Find the
+//                   candidate sections of the object, take views of
+//                   their contents and compute a checksum on them.
+// start_matching  : Record the candidates and determine which of them
+//                   have unique contents.  For the others, collect the
+//                   parts of the contents that do not change from
+//                   iteration to iteration.
+// Icf_hash_task   : Ranges of sections, in parallel.  In the first
+//                   iteration, compute a checksum on the parts that do
+//                   not change; in later ones, recompute the relocs to
+//                   sections that could be folded.
+// match           : Form the groups of identical sections for an
+//                   iteration, then queue the next one.
+// finish          : Unfold --keep-unique sections, release the views
+//                   and queue the rest of the link.
+//
+// Grouping sections is done in order, and the relocs of a section are
+// recomputed when it is reached if a section they point to was folded
+// earlier in the same iteration, so the result is the same as doing the
+// whole search serially.
 
-void
-Icf::find_identical_sections(const Input_objects* input_objects,
-                             Symbol_table* symtab)
+class Icf_search
 {
-  unsigned int section_num = 0;
-  std::vector<unsigned int> num_tracked_relocs;
-  std::vector<uint64_t> section_addraligns;
-  std::vector<bool> is_secn_or_group_unique;
-  std::vector<std::string> section_contents;
-  const Target& target = parameters->target();
+ public:
+  Icf_search(Icf* icf, const Input_objects* input_objects,
+	     Symbol_table* symtab, Task_function_runner* next);
+
+  // Queue the tasks which do the search.
+  void
+  queue_tasks(Workqueue*);
+
+  // Scan the object with index INDEX.
+  void
+  scan_object(size_t index);
+
+  // Record the candidates found by the scan and prepare the first
+  // iteration.
+  void
+  start_matching(Workqueue*, const Task*);
+
+  // Hash the sections with ids from START to END.
+  void
+  hash_sections(unsigned int start, unsigned int end);
+
+  // Form the groups of identical sections for this iteration.
+  void
+  match(Workqueue*, const Task*);
+
+  // The object with index INDEX.
+  Relobj*
+  object(size_t index) const
+  { return this->objects_[index]; }
+
+ private:
+  // What the scan of an object finds.
+  struct Object_scan
+  {
+    // The candidate sections.
+    std::vector<unsigned int> shndxs;
+    // Their alignments.
+    std::vector<uint64_t> addraligns;
+    // The checksums of their contents.
+    std::vector<uint32_t> cksums;
+    // The views of the candidates and of the .eh_frame sections
+    // holding extra identity regions.
+    std::vector<std::pair<unsigned int, Icf_view> > views;
+    std::vector<File_view*> file_views;
+    // The extra identity regions found in .eh_frame sections.
+    Icf::Extra_identity_vector links;
+    // The .eh_frame sections which could not be parsed.
+    std::vector<unsigned int> bad_eh_frames;
+  };
+
+  // Queue the Icf_hash_tasks for this iteration, followed by match.
+  void
+  queue_hash_tasks(Workqueue*);
+
+  // Check whether section I has to be matched in this iteration.
+  bool
+  is_active(unsigned int i) const
+  {
+    return (!this->is_secn_or_group_unique_[i]
+	    && (this->iteration_num_ == 1
+		|| this->icf_->kept_section_id_[i] == i));
+  }
+
+  // Finish the search.
+  void
+  finish(bool converged, Workqueue*, const Task*);
+
+  Icf* icf_;
+  Symbol_table* symtab_;
+  Task_function_runner* next_;
+  // The input objects, in order.
+  std::vector<Relobj*> objects_;
+  // The scan of each of them.
+  std::vector<Object_scan> scans_;
+  // The views of the sections, and the file views to delete.
+  Icf_view_map views_;
+  std::vector<std::vector<File_view*> > file_views_;
+  // Indexed by section id.
+  std::vector<unsigned int> num_tracked_relocs_;
+  std::vector<uint64_t> section_addraligns_;
+  std::vector<bool> is_secn_or_group_unique_;
+  std::vector<Icf_contents> section_contents_;
+  // The sections whose kept section changed in this iteration.
+  std::vector<bool> is_kept_section_changed_;
+  unsigned int iteration_num_;
+  unsigned int max_iterations_;
+};
+
+// A task to scan an input object for candidate sections.
+
+class Icf_scan_task : public Task
+{
+ public:
+  Icf_scan_task(Icf_search* search, size_t index, Task_token* blocker)
+    : search_(search), index_(index), blocker_(blocker)
+  { }
+
+  Task_token*
+  is_runnable()
+  {
+    Relobj* object = this->search_->object(this->index_);
+    return object->is_locked() ? object->token() : NULL;
+  }
+
+  void
+  locks(Task_locker* tl)
+  {
+    Task_token* token = this->search_->object(this->index_)->token();
+    if (token != NULL)
+      tl->add(this, token);
+    tl->add(this, this->blocker_);
+  }
+
+  void
+  run(Workqueue*)
+  {
+    this->search_->scan_object(this->index_);
+    this->search_->object(this->index_)->release();
+  }
+
+  std::string
+  get_name() const
+  { return "Icf_scan_task " + this->search_->object(this->index_)->name(); }
+
+ private:
+  Icf_search* search_;
+  size_t index_;
+  Task_token* blocker_;
+};
+
+// A task to hash a range of sections.
+
+class Icf_hash_task : public Task
+{
+ public:
+  Icf_hash_task(Icf_search* search, unsigned int start, unsigned int end,
+		Task_token* blocker)
+    : search_(search), start_(start), end_(end), blocker_(blocker)
+  { }
+
+  Task_token*
+  is_runnable()
+  { return NULL; }
+
+  void
+  locks(Task_locker* tl)
+  { tl->add(this, this->blocker_); }
+
+  void
+  run(Workqueue*)
+  { this->search_->hash_sections(this->start_, this->end_); }
+
+  std::string
+  get_name() const
+  { return "Icf_hash_task"; }
+
+ private:
+  Icf_search* search_;
+  unsigned int start_;
+  unsigned int end_;
+  Task_token* blocker_;
+};
+
+// This class runs one of the serial steps of the search.  It is just a
+// closure.
+
+class Icf_search_runner : public Task_function_runner
+{
+ public:
+  typedef void (Icf_search::*Step)(Workqueue*, const Task*);
 
-  // Decide which sections are possible candidates first.
+  Icf_search_runner(Icf_search* search, Step step)
+    : search_(search), step_(step)
+  { }
 
+  void
+  run(Workqueue* workqueue, const Task* task)
+  { (this->search_->*(this->step_))(workqueue, task); }
+
+ private:
+  Icf_search* search_;
+  Step step_;
+};
+
+// The number of sections hashed by an Icf_hash_task.
+
+static const unsigned int icf_hash_task_sections = 1024;
+
+Icf_search::Icf_search(Icf* icf, const Input_objects* input_objects,
+		       Symbol_table* symtab, Task_function_runner* next)
+  : icf_(icf), symtab_(symtab), next_(next), objects_(), scans_(),
+    views_(), file_views_(), num_tracked_relocs_(), section_addraligns_(),
+    is_secn_or_group_unique_(), section_contents_(),
+    is_kept_section_changed_(), iteration_num_(1)
+{
   for (Input_objects::Relobj_iterator p = input_objects->relobj_begin();
        p != input_objects->relobj_end();
        ++p)
+    this->objects_.push_back(*p);
+  this->scans_.resize(this->objects_.size());
+  this->file_views_.resize(this->objects_.size());
+
+  // Default number of iterations to run ICF is 3.
+  this->max_iterations_ = (parameters->options().icf_iterations() > 0
+			   ? parameters->options().icf_iterations()
+			   : 3);
+}
+
+void
+Icf_search::queue_tasks(Workqueue* workqueue)
+{
+  Task_token* blocker = new Task_token(true);
+  for (size_t i = 0; i < this->objects_.size(); ++i)
     {
-      // Lock the object so we can read from it.  This is only called
-      // single-threaded from queue_middle_tasks, so it is OK to lock.
-      // Unfortunately we have no way to pass in a Task token.
-      const Task* dummy_task = reinterpret_cast<const Task*>(-1);
-      Task_lock_obj<Object> tl(dummy_task, *p);
-      std::vector<unsigned int> eh_frame_ind;
-
-      for (unsigned int i = 0; i < (*p)->shnum(); ++i)
-        {
-          if ((*p)->section_size(i) == 0)
-            continue;
-	  const std::string section_name = (*p)->section_name(i);
-          if (!is_section_foldable_candidate(section_name))
-	    {
-	      if (is_prefix_of(".eh_frame", section_name.c_str()))
-		eh_frame_ind.push_back(i);
-	      continue;
-	    }
+      blocker->add_blocker();
+      workqueue->queue(new Icf_scan_task(this, i, blocker));
+    }
+  workqueue->queue(new Task_function(
+      new Icf_search_runner(this, &Icf_search::start_matching),
+      blocker, "Task_function Icf_search start_matching"));
+}
 
-          if (!(*p)->is_section_included(i))
-            continue;
-          if (parameters->options().gc_sections()
-              && symtab->gc()->is_section_garbage(*p, i))
-              continue;
-	  // With --icf=safe, check if the mangled function name is a ctor
-	  // or a dtor.  The mangled function name can be obtained from the
-	  // section name by stripping the section prefix.
-	  if (parameters->options().icf_safe_folding()
-              && !is_function_ctor_or_dtor(section_name)
-	      && (!target.can_check_for_function_pointers()
-                  || section_has_function_pointers(*p, i)))
-            {
-	      continue;
-            }
-          this->id_section_.push_back(Section_id(*p, i));
-          this->section_id_[Section_id(*p, i)] = section_num;
-          this->kept_section_id_.push_back(section_num);
-          num_tracked_relocs.push_back(0);
-	  section_addraligns.push_back((*p)->section_addralign(i));
-          is_secn_or_group_unique.push_back(false);
-          section_contents.push_back("");
-          section_num++;
-        }
+// Decide which sections of an object are possible candidates, and find
+// the extra identity regions in its .eh_frame sections.  This runs in
+// parallel with the scans of the other objects, so the results are kept
+// in the object's Object_scan until start_matching.
+
+void
+Icf_search::scan_object(size_t index)
+{
+  Relobj* object = this->objects_[index];
+  Object_scan* scan = &this->scans_[index];
+  const Target& target = parameters->target();
+  std::vector<unsigned int> eh_frame_ind;
+
+  for (unsigned int i = 0; i < object->shnum(); ++i)
+    {
+      if (object->section_size(i) == 0)
+	continue;
+      const std::string section_name = object->section_name(i);
+      if (!is_section_foldable_candidate(section_name))
+	{
+	  if (is_prefix_of(".eh_frame", section_name.c_str()))
+	    eh_frame_ind.push_back(i);
+	  continue;
+	}
+
+      if (!object->is_section_included(i))
+	continue;
+      if (parameters->options().gc_sections()
+	  && this->symtab_->gc()->is_section_garbage(object, i))
+	continue;
+      // With --icf=safe, check if the mangled function name is a ctor
+      // or a dtor.  The mangled function name can be obtained from the
+      // section name by stripping the section prefix.
+      if (parameters->options().icf_safe_folding()
+	  && !is_function_ctor_or_dtor(section_name)
+	  && (!target.can_check_for_function_pointers()
+	      || this->icf_->section_has_function_pointers(object, i)))
+	continue;
+
+      section_size_type plen;
+      File_view* view = object->section_lasting_view(i, &plen);
+      Icf_view icf_view = { view->data(), plen };
+      scan->shndxs.push_back(i);
+      scan->addraligns.push_back(object->section_addralign(i));
+      scan->cksums.push_back(xcrc32(view->data(), plen, 0xffffffff));
+      scan->views.push_back(std::make_pair(i, icf_view));
+      scan->file_views.push_back(view);
+    }
+
+  for (std::vector<unsigned int>::iterator it_eh_ind = eh_frame_ind.begin();
+       it_eh_ind != eh_frame_ind.end(); ++it_eh_ind)
+    {
+      // gc_process_relocs() recorded relocations for this
+      // section even though we can't fold it. We need to
+      // use those relocations to associate other foldable
+      // sections with the FDEs and CIEs that are relevant
+      // to them, so we can avoid merging sections that
+      // don't have identical exception-handling behavior.
+
+      Section_id sect(object, *it_eh_ind);
+      Icf::Reloc_info_list::iterator it_rel =
+	this->icf_->reloc_info_list().find(sect);
+      if (it_rel == this->icf_->reloc_info_list().end())
+	continue;
+
+      size_t num_links = scan->links.size();
+      if (!this->icf_->add_ehframe_links(object, *it_eh_ind, it_rel->second,
+					 &scan->links))
+	scan->bad_eh_frames.push_back(*it_eh_ind);
+
+      // Keep the contents for get_section_contents.
+      if (scan->links.size() > num_links)
+	{
+	  section_size_type plen;
+	  File_view* view = object->section_lasting_view(*it_eh_ind, &plen);
+	  Icf_view icf_view = { view->data(), plen };
+	  scan->views.push_back(std::make_pair(*it_eh_ind, icf_view));
+	  scan->file_views.push_back(view);
+	}
+    }
+}
+
+// Record the candidates in the order of the objects, which gives them
+// their ids, and start the first iteration.
+
+void
+Icf_search::start_matching(Workqueue* workqueue, const Task* task)
+{
+  std::vector<uint32_t> cksums;
+  unsigned int section_num = 0;
+  for (size_t i = 0; i < this->objects_.size(); ++i)
+    {
+      Relobj* object = this->objects_[i];
+      Object_scan* scan = &this->scans_[i];
+      for (size_t j = 0; j < scan->shndxs.size(); ++j)
+	{
+	  Section_id secn(object, scan->shndxs[j]);
+	  this->icf_->id_section_.push_back(secn);
+	  this->icf_->section_id_[secn] = section_num;
+	  this->icf_->kept_section_id_.push_back(section_num);
+	  this->section_addraligns_.push_back(scan->addraligns[j]);
+	  cksums.push_back(scan->cksums[j]);
+	  section_num++;
+	}
+
+      for (Icf::Extra_identity_vector::const_iterator p = scan->links.begin();
+	   p != scan->links.end();
+	   ++p)
+	this->icf_->extra_identity_list_.insert(*p);
+
+      for (std::vector<unsigned int>::const_iterator p =
+	     scan->bad_eh_frames.begin();
+	   p != scan->bad_eh_frames.end();
+	   ++p)
+	{
+	  Task_lock_obj<Object> tl(task, object);
+	  gold_warning(_("could not parse eh_frame section %s(%s); ICF "
+			 "might not preserve exception handling "
+			 "behavior"),
+		       object->name().c_str(),
+		       object->section_name(*p).c_str());
+	}
+
+      for (size_t j = 0; j < scan->views.size(); ++j)
+	this->views_[Section_id(object, scan->views[j].first)]
+	  = scan->views[j].second;
+      this->file_views_[i].swap(scan->file_views);
+    }
+  std::vector<Object_scan>().swap(this->scans_);
+
+  this->num_tracked_relocs_.resize(section_num, 0);
+  this->is_secn_or_group_unique_.resize(section_num, false);
+  this->section_contents_.resize(section_num);
+  this->is_kept_section_changed_.resize(section_num, false);
+
+  // The first time, sections are compared by their contents alone.
+  preprocess_for_unique_sections(cksums, &this->is_secn_or_group_unique_);
+
+  const std::vector<Section_id>& id_section(this->icf_->id_section_);
+  for (unsigned int i = 0; i < section_num; ++i)
+    {
+      if (this->is_secn_or_group_unique_[i])
+	continue;
+
+      Section_id secn = id_section[i];
+      Task_lock_obj<Object> tl(task, secn.first);
+      get_section_contents(true, &this->section_contents_[i], secn, secn,
+			   &this->num_tracked_relocs_[i], this->symtab_,
+			   this->icf_->kept_section_id_, this->views_);
+    }
+
+  this->queue_hash_tasks(workqueue);
+}
+
+void
+Icf_search::queue_hash_tasks(Workqueue* workqueue)
+{
+  unsigned int section_num = this->icf_->id_section_.size();
+  Task_token* blocker = new Task_token(true);
+  for (unsigned int start = 0;
+       start < section_num;
+       start += icf_hash_task_sections)
+    {
+      unsigned int end = std::min(start + icf_hash_task_sections,
+				  section_num);
+      blocker->add_blocker();
+      workqueue->queue(new Icf_hash_task(this, start, end, blocker));
+    }
+  workqueue->queue(new Task_function(
+      new Icf_search_runner(this, &Icf_search::match),
+      blocker, "Task_function Icf_search match"));
+}
+
+// The first iteration collected the section's contents, all that is
+// left is to compute the checksum of the parts that do not change.
+// Later iterations recompute the relocs to sections that could be
+// folded, which depend on the kept sections of the previous one.
+
+void
+Icf_search::hash_sections(unsigned int start, unsigned int end)
+{
+  for (unsigned int i = start; i < end; ++i)
+    {
+      if (!this->is_active(i))
+	continue;
+
+      Icf_contents* contents = &this->section_contents_[i];
+      if (this->iteration_num_ == 1)
+	contents->compute_cksum();
+      else
+	{
+	  const Section_id& secn(this->icf_->id_section_[i]);
+	  contents->icf_text.clear();
+	  get_section_contents(false, contents, secn, secn, NULL,
+			       this->symtab_, this->icf_->kept_section_id_,
+			       this->views_);
+	}
+    }
+}
+
+// CRC32 is the checksumming algorithm and can have collisions.  That is,
+// two sections with different contents can have the same checksum. Hence,
+// a multimap is used to maintain more than one group of checksum
+// identical sections.  A section is added to a group only after its
+// contents are explicitly compared with the kept section of the group.
+
+void
+Icf_search::match(Workqueue* workqueue, const Task* task)
+{
+  Unordered_multimap<uint32_t, unsigned int> section_cksum;
+  std::pair<Unordered_multimap<uint32_t, unsigned int>::iterator,
+            Unordered_multimap<uint32_t, unsigned int>::iterator> key_range;
+  std::vector<unsigned int>* kept_section_id = &this->icf_->kept_section_id_;
+  const std::vector<Section_id>& id_section(this->icf_->id_section_);
+  bool converged = true;
+
+  for (unsigned int i = 0; i < id_section.size(); i++)
+    {
+      if (!this->is_active(i))
+	continue;
+
+      Icf_contents* this_secn_contents = &this->section_contents_[i];
 
-      for (std::vector<unsigned int>::iterator it_eh_ind = eh_frame_ind.begin();
-	   it_eh_ind != eh_frame_ind.end(); ++it_eh_ind)
+      // The relocs were computed before any section was folded in this
+      // iteration; redo them if they point to one that has been since.
+      for (std::vector<unsigned int>::const_iterator p =
+	     this_secn_contents->targets.begin();
+	   p != this_secn_contents->targets.end();
+	   ++p)
 	{
-	  // gc_process_relocs() recorded relocations for this
-	  // section even though we can't fold it. We need to
-	  // use those relocations to associate other foldable
-	  // sections with the FDEs and CIEs that are relevant
-	  // to them, so we can avoid merging sections that
-	  // don't have identical exception-handling behavior.
-
-	  Section_id sect(*p, *it_eh_ind);
-	  Reloc_info_list::iterator it_rel = this->reloc_info_list().find(sect);
-	  if (it_rel != this->reloc_info_list().end())
+	  if (this->is_kept_section_changed_[*p])
 	    {
-	      if (!add_ehframe_links(*p, *it_eh_ind, it_rel->second))
-		{
-		  gold_warning(_("could not parse eh_frame section %s(%s); ICF "
-				 "might not preserve exception handling "
-				 "behavior"),
-			       (*p)->name().c_str(),
-			       (*p)->section_name(*it_eh_ind).c_str());
-		}
+	      const Section_id& secn(id_section[i]);
+	      this_secn_contents->icf_text.clear();
+	      get_section_contents(false, this_secn_contents, secn, secn,
+				   NULL, this->symtab_, *kept_section_id,
+				   this->views_);
+	      break;
 	    }
 	}
-    }
 
-  unsigned int num_iterations = 0;
+      uint32_t cksum = this_secn_contents->full_cksum();
+      key_range = section_cksum.equal_range(cksum);
+      Unordered_multimap<uint32_t, unsigned int>::iterator it;
+      // Search all the groups with this cksum for a match.
+      for (it = key_range.first; it != key_range.second; ++it)
+	{
+	  unsigned int kept_section = it->second;
+	  if (!icf_contents_equal(this->section_contents_[kept_section],
+				  *this_secn_contents))
+	    continue;
 
-  // Default number of iterations to run ICF is 3.
-  unsigned int max_iterations = (parameters->options().icf_iterations() > 0)
-                            ? parameters->options().icf_iterations()
-                            : 3;
+	  // Check section alignment here.
+	  // The section with the larger alignment requirement
+	  // should be kept.  We assume alignment can only be
+	  // zero or positive integral powers of two.
+	  uint64_t align_i = this->section_addraligns_[i];
+	  uint64_t align_kept = this->section_addraligns_[kept_section];
+	  if (align_i <= align_kept)
+	    {
+	      (*kept_section_id)[i] = kept_section;
+	      this->is_kept_section_changed_[i] = true;
+	    }
+	  else
+	    {
+	      (*kept_section_id)[kept_section] = i;
+	      this->is_kept_section_changed_[kept_section] = true;
+	      it->second = i;
+	    }
 
-  bool converged = false;
+	  converged = false;
+	  break;
+	}
+      if (it == key_range.second)
+	{
+	  // Create a new group for this cksum.
+	  section_cksum.insert(std::make_pair(cksum, i));
+	}
+      // If there are no relocs to foldable sections do not process
+      // this section any further.
+      if (this->iteration_num_ == 1 && this->num_tracked_relocs_[i] == 0)
+	this->is_secn_or_group_unique_[i] = true;
+    }
 
-  while (!converged && (num_iterations < max_iterations))
+  // If a section was folded into another section that was later folded
+  // again then the former has to be updated.
+  for (unsigned int i = 0; i < id_section.size(); i++)
     {
-      num_iterations++;
-      converged = match_sections(num_iterations, symtab,
-                                 &num_tracked_relocs, &this->kept_section_id_,
-                                 this->id_section_, section_addraligns,
-                                 &is_secn_or_group_unique, &section_contents);
+      // Find the end of the folding chain
+      unsigned int kept = i;
+      while ((*kept_section_id)[kept] != kept)
+        {
+          kept = (*kept_section_id)[kept];
+        }
+      // Update every element of the chain
+      unsigned int current = i;
+      while ((*kept_section_id)[current] != kept)
+        {
+          unsigned int next = (*kept_section_id)[current];
+          (*kept_section_id)[current] = kept;
+          current = next;
+        }
     }
 
+  if (converged || this->iteration_num_ >= this->max_iterations_)
+    {
+      this->finish(converged, workqueue, task);
+      return;
+    }
+
+  this->iteration_num_++;
+  this->is_kept_section_changed_.assign(id_section.size(), false);
+
+  // From now on, sections are compared by their text and relocs to
+  // sections that cannot be folded first.
+  std::vector<uint32_t> cksums(id_section.size());
+  for (unsigned int i = 0; i < id_section.size(); i++)
+    cksums[i] = this->section_contents_[i].cksum;
+  preprocess_for_unique_sections(cksums, &this->is_secn_or_group_unique_);
+
+  this->queue_hash_tasks(workqueue);
+}
+
+void
+Icf_search::finish(bool converged, Workqueue* workqueue, const Task* task)
+{
   if (parameters->options().print_icf_sections())
     {
       if (converged)
         gold_info(_("%s: ICF Converged after %u iteration(s)"),
-                  program_name, num_iterations);
+                  program_name, this->iteration_num_);
       else
         gold_info(_("%s: ICF stopped after %u iteration(s)"),
-                  program_name, num_iterations);
+                  program_name, this->iteration_num_);
     }
 
   // Unfold --keep-unique symbols.
@@ -1069,12 +1500,12 @@ Icf::find_identical_sections(const Input_objects* input_objects,
        ++p)
     {
       const char* name = p->c_str();
-      Symbol* sym = symtab->lookup(name);
+      Symbol* sym = this->symtab_->lookup(name);
       if (sym == NULL)
 	{
 	  gold_warning(_("Could not find symbol %s to unfold\n"), name);
 	}
-      else if (sym->source() == Symbol::FROM_OBJECT 
+      else if (sym->source() == Symbol::FROM_OBJECT
                && !sym->object()->is_dynamic())
         {
           Relobj* obj = static_cast<Relobj*>(sym->object());
@@ -1082,13 +1513,41 @@ Icf::find_identical_sections(const Input_objects* input_objects,
           unsigned int shndx = sym->shndx(&is_ordinary);
           if (is_ordinary)
             {
-	      this->unfold_section(obj, shndx);
+	      this->icf_->unfold_section(obj, shndx);
             }
         }
+    }
+
+  this->icf_->icf_ready();
 
+  // The views may only be deleted while the objects are locked.
+  for (size_t i = 0; i < this->objects_.size(); ++i)
+    {
+      std::vector<File_view*>& file_views(this->file_views_[i]);
+      if (file_views.empty())
+	continue;
+      Task_lock_obj<Object> tl(task, this->objects_[i]);
+      for (size_t j = 0; j < file_views.size(); ++j)
+	delete file_views[j];
     }
 
-  this->icf_ready();
+  workqueue->queue(new Task_function(this->next_, new Task_token(true),
+				     "Task_function Icf_search next"));
+  delete this;
+}
+
+// This is the main ICF function called in gold.cc.  It queues the tasks
+// which compute the crc checksums and detect identical functions,
+// iterating (thrice by default) until the groups of identical sections
+// no longer change.
+
+void
+Icf::find_identical_sections(const Input_objects* input_objects,
+                             Symbol_table* symtab, Workqueue* workqueue,
+                             Task_function_runner* next)
+{
+  Icf_search* search = new Icf_search(this, input_objects, symtab, next);
+  search->queue_tasks(workqueue);
 }
 
 // Unfolds the section denoted by OBJ and SHNDX if folded.
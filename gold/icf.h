@@ -35,6 +35,9 @@ namespace gold
 class Object;
 class Input_objects;
 class Symbol_table;
+class Workqueue;
+class Task_function_runner;
+class Icf_search;
 
 class Icf
 {
@@ -90,10 +93,13 @@ class Icf
   get_folded_section(Relobj* dup_obj, unsigned int dup_shndx);
 
   // Forms groups of identical sections where the first member
-  // of each group is the kept section during folding.
+  // of each group is the kept section during folding.  This is done
+  // by tasks queued on WORKQUEUE; the last of them queues a task to
+  // run NEXT.
   void
   find_identical_sections(const Input_objects* input_objects,
-                          Symbol_table* symtab);
+                          Symbol_table* symtab, Workqueue* workqueue,
+                          Task_function_runner* next);
 
   // This is set when ICF has been run and the groups of
   // identical sections have been formed.
@@ -162,10 +168,14 @@ class Icf
   { return this->section_id_; }
 
  private:
+  friend class Icf_search;
+
+  typedef std::vector<std::pair<Section_id, Extra_identity_info> >
+    Extra_identity_vector;
 
   bool
   add_ehframe_links(Relobj* object, unsigned int ehframe_shndx,
-		    Reloc_info& ehframe_relocs);
+		    Reloc_info& ehframe_relocs, Extra_identity_vector* links);
 
   // Maps integers to sections.
   std::vector<Section_id> id_section_;
@@ -597,6 +597,13 @@ class Object
   const unsigned char*
   section_contents(unsigned int shndx, section_size_type* plen, bool cache);
 
+  // Return a lasting view of the contents of a section, which remains
+  // valid after the object is unlocked.  Set *PLEN to the size.  The
+  // view must be deleted while the object is locked.
+  File_view*
+  section_lasting_view(unsigned int shndx, section_size_type* plen)
+  { return this->do_section_lasting_view(shndx, plen); }
+
   // Adjust a symbol's section index as needed.  SYMNDX is the index
   // of the symbol and SHNDX is the symbol's section from
   // get_st_shndx.  This returns the section index.  It sets
@@ -957,6 +964,12 @@ class Object
   do_section_contents(unsigned int shndx, section_size_type* plen,
 		      bool cache) = 0;
 
+  // Return a lasting view of the contents of a section--implemented
+  // by child class.
+  virtual File_view*
+  do_section_lasting_view(unsigned int, section_size_type*)
+  { gold_unreachable(); }
+
   // Get the size of a section--implemented by child class.
   virtual uint64_t
   do_section_size(unsigned int shndx) = 0;
@@ -2501,6 +2514,15 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
     return this->get_view(loc.file_offset, *plen, true, cache);
   }
 
+  // Return a lasting view of the contents of a section.
+  File_view*
+  do_section_lasting_view(unsigned int shndx, section_size_type* plen)
+  {
+    Object::Location loc(this->elf_file_.section_contents(shndx));
+    *plen = convert_to_section_size_type(loc.data_size);
+    return this->get_lasting_view(loc.file_offset, *plen, true, false);
+  }
+
   // Return section flags.
   uint64_t
   do_section_flags(unsigned int shndx);
@@ -213,6 +213,11 @@ struct bfd_link_hash_table
   void (*hash_table_free) (bfd *);
   /* The type of the link hash table.  */
   enum bfd_link_hash_table_type type;
+  /* The number of passes made over archive symbol maps, and the number
+     of archive symbol map entries looked up in the hash table, when
+     searching archives for members to include.  */
+  unsigned long archive_passes;
+  unsigned long archive_lookups;
 };
 
 /* Look up an entry in a link hash table.  If FOLLOW is TRUE, this
@@ -900,6 +905,13 @@ struct bfd_link_callbacks
      the output BFD named .ctf or a name beginning with ".ctf.".  */
   void (*emit_ctf)
     (void);
+  /* If not NULL, this callback should call FUNC (I, DATA) for every I
+     from 0 to COUNT - 1, possibly on several threads at once, and
+     return once they have all finished.  BFD uses it to spread work
+     that touches no shared state, such as hashing the contents of
+     SEC_MERGE sections, over the threads the linker was asked to use.  */
+  void (*parallel_for)
+    (size_t count, void (*func) (size_t, void *), void *data);
 };
 
 /* The linker builds link_order structures which tell the code how to
@@ -86,6 +86,16 @@ typedef struct ctf_link_sym
   uint32_t st_value;
 } ctf_link_sym_t;
 
+/* The elapsed (wall-clock) time spent in each phase of the deduplicating
+   links done by ctf_link, in microseconds, as returned by ctf_link_times.  */
+
+typedef struct ctf_link_times
+{
+  long clt_hash;		  /* Hashing the input types.  */
+  long clt_conflicts;		  /* Finding conflicting types.  */
+  long clt_emit;		  /* Emitting the output types.  */
+} ctf_link_times_t;
+
 /* Flags applying to this specific link.  */
 
 /* Share all types that are not in conflict.  The default.  */
@@ -533,6 +543,15 @@ typedef int ctf_link_variable_filter_f (ctf_dict_t *, const char *, ctf_id_t,
 extern int ctf_link_set_variable_filter (ctf_dict_t *,
 					 ctf_link_variable_filter_f *, void *);
 extern int ctf_link (ctf_dict_t *, int flags);
+/* The parallel-for function should call FN (I, DATA) for every I from 0 to
+   COUNT - 1, possibly concurrently, and return once all the calls have
+   finished.  ctf_link uses it to hash the types of the inputs in parallel.  */
+typedef void ctf_link_parallel_for_f (size_t count,
+				      void (*fn) (size_t, void *),
+				      void *data, void *arg);
+extern int ctf_link_set_parallel_for (ctf_dict_t *,
+				      ctf_link_parallel_for_f *, void *);
+extern int ctf_link_times (ctf_dict_t *, ctf_link_times_t *);
 typedef const char *ctf_link_strtab_string_f (uint32_t *offset, void *arg);
 extern int ctf_link_add_strtab (ctf_dict_t *, ctf_link_strtab_string_f *,
 				void *);
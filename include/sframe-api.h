@@ -152,6 +152,17 @@ extern int
 sframe_find_fre (sframe_decoder_ctx *ctx, int32_t pc,
 		 sframe_frame_row_entry *frep);
 
+/* Build an index of the FREs in the SFrame decoder CTX so that
+   sframe_find_fre finds the FRE for a PC in near constant time rather
+   than by a binary search over the FDEs and a scan of the FREs of the
+   function.  This uses memory proportional to the total number of FREs,
+   and is worthwhile when many lookups are done.  Returns SFRAME_ERR if
+   failure, in which case sframe_find_fre keeps working without the
+   index.  */
+
+extern int
+sframe_decoder_build_lookup_index (sframe_decoder_ctx *ctx);
+
 /* Get the FRE_IDX'th FRE of the function at FUNC_IDX'th function
    index entry in the SFrame decoder CTX.  Returns error code as
    applicable.  */
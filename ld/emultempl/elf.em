@@ -663,12 +663,12 @@ gld${EMULATION_NAME}_handle_option (int optc)
 
     case OPTION_COMPRESS_DEBUG:
       config.compress_debug = bfd_get_compression_algorithm (optarg);
-      if (strcasecmp (optarg, "zstd") == 0)
+      if (strcasecmp (optarg, "zstd") == 0
+	  || strcasecmp (optarg, "zstd-chunked") == 0)
 	{
 #ifndef HAVE_ZSTD
-	  if (config.compress_debug == COMPRESS_DEBUG_ZSTD)
-	    einfo (_ ("%F%P: --compress-debug-sections=zstd: ld is not built "
-		  "with zstd support\n"));
+	  einfo (_ ("%F%P: --compress-debug-sections=%s: ld is not built "
+		    "with zstd support\n"), optarg);
 #endif
 	}
       if (config.compress_debug == COMPRESS_UNKNOWN)
@@ -954,5 +954,6 @@ LDEMUL_ADD_OPTIONS=gld${EMULATION_NAME}_add_options
 LDEMUL_HANDLE_OPTION=gld${EMULATION_NAME}_handle_option
 LDEMUL_LIST_OPTIONS=${LDEMUL_LIST_OPTIONS-${gld_list_options}}
 LDEMUL_RECOGNIZED_FILE=${LDEMUL_RECOGNIZED_FILE-ldelf_load_symbols}
+LDEMUL_PRELOAD_INPUT=${LDEMUL_PRELOAD_INPUT-ldelf_preload_input}
 
 source_em ${srcdir}/emultempl/emulation.em
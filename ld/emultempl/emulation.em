@@ -36,6 +36,7 @@ struct ld_emulation_xfer_struct ld_${EMULATION_NAME}_emulation =
   ${LDEMUL_EMIT_CTF_EARLY-NULL},
   ${LDEMUL_ACQUIRE_STRINGS_FOR_CTF-NULL},
   ${LDEMUL_NEW_DYNSYM_FOR_CTF-NULL},
-  ${LDEMUL_PRINT_SYMBOL-NULL}
+  ${LDEMUL_PRINT_SYMBOL-NULL},
+  ${LDEMUL_PRELOAD_INPUT-NULL}
 };
 EOF
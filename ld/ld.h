@@ -297,6 +297,9 @@ typedef struct
   unsigned int split_by_reloc;
   bfd_size_type split_by_file;
 
+  /* The number of threads to use, or 0 for one per CPU.  */
+  unsigned int threads;
+
   /* The size of the hash table to use.  */
   unsigned long hash_table_size;
 
@@ -20,10 +20,12 @@
 
 #include "sysdep.h"
 #include "bfd.h"
+#include "libiberty.h"
 #include "safe-ctype.h"
 #include "md5.h"
 #include "sha1.h"
 #include "ldbuildid.h"
+#include "ldthread.h"
 #ifdef __MINGW32__
 #include <windows.h>
 #include <rpcdce.h>
@@ -35,6 +37,7 @@ bool
 validate_build_id_style (const char *style)
 {
   if ((streq (style, "md5")) || (streq (style, "sha1"))
+      || (streq (style, "tree"))
       || (streq (style, "uuid")) || (startswith (style, "0x")))
     return true;
 
@@ -47,7 +50,7 @@ compute_build_id_size (const char *style)
   if (streq (style, "md5") || streq (style, "uuid"))
     return 128 / 8;
 
-  if (streq (style, "sha1"))
+  if (streq (style, "sha1") || streq (style, "tree"))
     return 160 / 8;
 
   if (startswith (style, "0x"))
@@ -93,6 +96,180 @@ read_hex (const char xdigit)
   return 0;
 }
 
+/* The "tree" style splits the bytes passed to the checksum function
+   into chunks of TREE_CHUNK_SIZE bytes, the last one possibly shorter,
+   computes the MD5 hash of each chunk and then the SHA1 hash of the
+   chunk hashes, in order.  The chunks are hashed by several threads
+   with --threads.  */
+
+#define TREE_CHUNK_SIZE (2 << 20)
+
+/* The size of an MD5 hash.  */
+#define TREE_HASH_SIZE 16
+
+/* The most chunks which have been copied and not yet hashed.  */
+#define TREE_MAX_PENDING 64
+
+struct tree_chunk
+{
+  /* The bytes to hash.  */
+  const void *data;
+  size_t size;
+
+  /* Where the chunk is in the sequence of chunks.  */
+  size_t index;
+
+  /* Whether DATA was copied, and should be freed once hashed.  */
+  bool copied;
+};
+
+struct tree_ctx
+{
+  /* The chunks not yet hashed.  */
+  struct tree_chunk *chunks;
+  size_t nchunks;
+  size_t nchunks_alloc;
+
+  /* The MD5 hashes of the chunks, by index.  */
+  unsigned char *hashes;
+  size_t nhashes;
+  size_t nhashes_alloc;
+
+  /* The start of the next chunk, when it does not fit in the bytes
+     passed in a single call.  */
+  char *partial;
+  size_t partial_size;
+};
+
+static void
+tree_hash_chunk (size_t i, void *data)
+{
+  struct tree_ctx *ctx = (struct tree_ctx *) data;
+  struct tree_chunk *chunk = &ctx->chunks[i];
+
+  md5_buffer ((const char *) chunk->data, chunk->size,
+	      ctx->hashes + chunk->index * TREE_HASH_SIZE);
+}
+
+/* Hash all the chunks queued in CTX.  */
+
+static void
+tree_flush (struct tree_ctx *ctx)
+{
+  size_t i;
+
+  ld_parallel_for (ctx->nchunks, tree_hash_chunk, ctx);
+  for (i = 0; i < ctx->nchunks; i++)
+    if (ctx->chunks[i].copied)
+      free ((void *) ctx->chunks[i].data);
+  ctx->nchunks = 0;
+}
+
+/* Queue SIZE bytes at DATA as the next chunk.  */
+
+static void
+tree_add_chunk (struct tree_ctx *ctx, const void *data, size_t size,
+		bool copied)
+{
+  struct tree_chunk *chunk;
+
+  if (ctx->nchunks == ctx->nchunks_alloc)
+    {
+      ctx->nchunks_alloc = ctx->nchunks_alloc * 2 + 16;
+      ctx->chunks = ((struct tree_chunk *)
+		     xrealloc (ctx->chunks,
+			       ctx->nchunks_alloc * sizeof (*ctx->chunks)));
+    }
+  if (ctx->nhashes == ctx->nhashes_alloc)
+    {
+      ctx->nhashes_alloc = ctx->nhashes_alloc * 2 + 16;
+      ctx->hashes = ((unsigned char *)
+		     xrealloc (ctx->hashes,
+			       ctx->nhashes_alloc * TREE_HASH_SIZE));
+    }
+
+  chunk = &ctx->chunks[ctx->nchunks++];
+  chunk->data = data;
+  chunk->size = size;
+  chunk->index = ctx->nhashes++;
+  chunk->copied = copied;
+}
+
+static void
+tree_process_bytes (const void *buffer, size_t len, void *arg)
+{
+  struct tree_ctx *ctx = (struct tree_ctx *) arg;
+  const char *p = (const char *) buffer;
+  bool borrowed = false;
+
+  /* Complete the chunk started by earlier calls.  */
+  if (ctx->partial_size != 0)
+    {
+      size_t n = TREE_CHUNK_SIZE - ctx->partial_size;
+
+      if (n > len)
+	n = len;
+      memcpy (ctx->partial + ctx->partial_size, p, n);
+      ctx->partial_size += n;
+      p += n;
+      len -= n;
+      if (ctx->partial_size < TREE_CHUNK_SIZE)
+	return;
+      tree_add_chunk (ctx, ctx->partial, TREE_CHUNK_SIZE, true);
+      ctx->partial = NULL;
+      ctx->partial_size = 0;
+    }
+
+  /* Whole chunks are hashed in place, before returning.  */
+  while (len >= TREE_CHUNK_SIZE)
+    {
+      tree_add_chunk (ctx, p, TREE_CHUNK_SIZE, false);
+      p += TREE_CHUNK_SIZE;
+      len -= TREE_CHUNK_SIZE;
+      borrowed = true;
+    }
+
+  if (len != 0)
+    {
+      ctx->partial = (char *) xmalloc (TREE_CHUNK_SIZE);
+      memcpy (ctx->partial, p, len);
+      ctx->partial_size = len;
+    }
+
+  if (borrowed || ctx->nchunks >= TREE_MAX_PENDING)
+    tree_flush (ctx);
+}
+
+/* Compute the "tree" style build ID of ABFD into ID_BITS.  */
+
+static bool
+generate_tree_build_id (bfd *abfd, checksum_fn checksum_contents,
+			unsigned char *id_bits)
+{
+  struct tree_ctx ctx;
+  bool ret;
+
+  memset (&ctx, 0, sizeof (ctx));
+  ret = (*checksum_contents) (abfd, tree_process_bytes, &ctx);
+  if (ctx.partial_size != 0)
+    tree_add_chunk (&ctx, ctx.partial, ctx.partial_size, true);
+  tree_flush (&ctx);
+
+  if (ret)
+    {
+      struct sha1_ctx sha1;
+
+      sha1_init_ctx (&sha1);
+      sha1_choose_process_bytes () (ctx.hashes,
+				    ctx.nhashes * TREE_HASH_SIZE, &sha1);
+      sha1_finish_ctx (&sha1, id_bits);
+    }
+
+  free (ctx.hashes);
+  free (ctx.chunks);
+  return ret;
+}
+
 bool
 generate_build_id (bfd *abfd,
 		   const char *style,
@@ -119,6 +296,11 @@ generate_build_id (bfd *abfd,
 	return false;
       sha1_finish_ctx (&ctx, id_bits);
     }
+  else if (streq (style, "tree"))
+    {
+      if (!generate_tree_build_id (abfd, checksum_contents, id_bits))
+	return false;
+    }
   else if (streq (style, "uuid"))
     {
 #ifndef __MINGW32__
@@ -2417,3 +2417,11 @@ ldelf_set_output_arch (void)
   if (link_info.output_bfd->xvec->flavour == bfd_target_elf_flavour)
     elf_link_info (link_info.output_bfd) = &link_info;
 }
+
+/* Read input file ABFD into memory for --threads.  */
+
+bool
+ldelf_preload_input (bfd *abfd)
+{
+  return bfd_elf_link_preload_input (abfd, &link_info);
+}
@@ -36,3 +36,4 @@ extern lang_output_section_statement_type *ldelf_place_orphan
   (asection *, const char *, int);
 extern void ldelf_before_place_orphans (void);
 extern void ldelf_set_output_arch (void);
+extern bool ldelf_preload_input (bfd *);
@@ -443,3 +443,11 @@ ldemul_print_symbol (struct bfd_link_hash_entry *hash_entry, void *ptr)
     return ld_emulation->print_symbol (hash_entry, ptr);
   return print_one_symbol (hash_entry, ptr);
 }
+
+bool
+ldemul_preload_input (bfd *abfd)
+{
+  if (ld_emulation->preload_input)
+    return ld_emulation->preload_input (abfd);
+  return false;
+}
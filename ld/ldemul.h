@@ -119,6 +119,9 @@ extern void ldemul_new_dynsym_for_ctf
 extern bool ldemul_print_symbol
   (struct bfd_link_hash_entry *hash_entry, void *ptr);
 
+extern bool ldemul_preload_input
+  (bfd *);
+
 typedef struct ld_emulation_xfer_struct {
   /* Run before parsing the command line and script file.
      Set the architecture, maybe other things.  */
@@ -259,6 +262,12 @@ typedef struct ld_emulation_xfer_struct {
   bool (*print_symbol)
     (struct bfd_link_hash_entry *hash_entry, void *ptr);
 
+  /* Called by --threads before the final link to read an input file
+     into memory.  May be called from several threads at once, for
+     input files which are not members of the same archive.  */
+  bool (*preload_input)
+    (bfd *abfd);
+
 } ld_emulation_xfer_type;
 
 typedef enum {
@@ -37,6 +37,7 @@
 #include "ldctor.h"
 #include "ldfile.h"
 #include "ldemul.h"
+#include "ldthread.h"
 #include "fnmatch.h"
 #include "demangle.h"
 #include "hashtab.h"
@@ -135,6 +136,8 @@ bool had_output_filename = false;
 bool lang_float_flag = false;
 bool delete_output_file_on_failure = false;
 bool enable_linker_version = false;
+long lang_wild_time;
+struct lang_ctf_stats lang_ctf_stats;
 struct lang_phdr *lang_phdr_list;
 struct lang_nocrossrefs *nocrossref_list;
 struct asneeded_minfo **asneeded_list_tail;
@@ -405,18 +408,13 @@ add_matching_section (lang_wild_statement_type *ptr,
   new_section->input_stmt = file;
 }
 
-/* Process section S (from input file FILE) in relation to wildcard
-   statement PTR.  We already know that a prefix of the name of S matches
-   some wildcard in PTR's wildcard list.  Here we check if the filename
-   matches as well (if it's specified) and if any of the wildcards in fact
-   does match.  */
+/* Return whether input file FILE matches the file name pattern of
+   wildcard statement PTR, and is not excluded by it.  */
 
-static void
-walk_wild_section_match (lang_wild_statement_type *ptr,
-			 lang_input_statement_type *file,
-			 asection *s)
+static bool
+walk_wild_file_match (lang_wild_statement_type *ptr,
+		      lang_input_statement_type *file)
 {
-  struct wildcard_list *sec;
   const char *file_spec = ptr->filename;
   char *p;
 
@@ -426,12 +424,12 @@ walk_wild_section_match (lang_wild_statement_type *ptr,
   else if ((p = archive_path (file_spec)) != NULL)
     {
       if (!input_statement_is_archive_path (file_spec, p, file))
-	return;
+	return false;
     }
   else if (wildcardp (file_spec))
     {
       if (fnmatch (file_spec, file->filename, 0) != 0)
-	return;
+	return false;
     }
   else
     {
@@ -458,11 +456,34 @@ walk_wild_section_match (lang_wild_statement_type *ptr,
 	       && filename_cmp (arch_is->local_sym_name, file_spec) == 0)
 	;
       else
-	return;
+	return false;
     }
 
-  /* If filename is excluded we're done.  */
-  if (walk_wild_file_in_exclude_list (ptr->exclude_name_list, file))
+  /* Check the file is not excluded.  */
+  return !walk_wild_file_in_exclude_list (ptr->exclude_name_list, file);
+}
+
+/* Process section S (from input file FILE) in relation to wildcard
+   statement PTR.  We already know that a prefix of the name of S matches
+   some wildcard in PTR's wildcard list.  Here we check if the filename
+   matches as well (if it's specified) and if any of the wildcards in fact
+   does match.  */
+
+static void
+walk_wild_section_match (lang_wild_statement_type *ptr,
+			 lang_input_statement_type *file,
+			 asection *s)
+{
+  struct wildcard_list *sec;
+
+  /* The sections of a file are matched one after the other, so
+     remember whether the last file matched.  */
+  if (ptr->last_file != file)
+    {
+      ptr->last_file = file;
+      ptr->last_file_matched = walk_wild_file_match (ptr, file);
+    }
+  if (!ptr->last_file_matched)
     return;
 
   /* Check section name against each wildcard spec.  If there's no
@@ -792,6 +813,18 @@ struct prefixtree
    empty prefix.  E.g. a glob like "*" would sit in this root.  */
 static struct prefixtree the_root, *ptroot = &the_root;
 
+/* Patterns without wildcard characters only match a section with that
+   exact name, so rather than in the prefix tree they are kept in a hash
+   table keyed by the name.  */
+struct exact_wild
+{
+  const char *name;
+  /* The statements with a pattern matching exactly NAME.  */
+  struct wild_stmt_list *stmt;
+};
+
+static htab_t exact_wild_table;
+
 /* Given a prefix tree in *TREE, corresponding to prefix P, find or
    INSERT the tree node corresponding to prefix P+C.  */
 
@@ -829,6 +862,54 @@ pt_add_stmt (struct prefixtree *t, lang_wild_statement_type *stmt)
   *psl = sl;
 }
 
+static hashval_t
+exact_wild_hash (const void *p)
+{
+  const struct exact_wild *e = (const struct exact_wild *) p;
+  return htab_hash_string (e->name);
+}
+
+static int
+exact_wild_eq (const void *p1, const void *p2)
+{
+  const struct exact_wild *e1 = (const struct exact_wild *) p1;
+  const struct exact_wild *e2 = (const struct exact_wild *) p2;
+  return strcmp (e1->name, e2->name) == 0;
+}
+
+/* Add STMT to the statements matching section names equal to NAME.  */
+
+static void
+exact_wild_add_stmt (const char *name, lang_wild_statement_type *stmt)
+{
+  struct exact_wild e, *entry;
+  struct wild_stmt_list *sl, **psl;
+  void **slot;
+
+  if (exact_wild_table == NULL)
+    exact_wild_table = htab_create (64, exact_wild_hash, exact_wild_eq, NULL);
+
+  e.name = name;
+  slot = htab_find_slot (exact_wild_table, &e, INSERT);
+  entry = (struct exact_wild *) *slot;
+  if (entry == NULL)
+    {
+      entry = (struct exact_wild *) obstack_alloc (&pt_obstack,
+						   sizeof *entry);
+      entry->name = name;
+      entry->stmt = NULL;
+      *slot = entry;
+    }
+
+  sl = (struct wild_stmt_list *) obstack_alloc (&pt_obstack, sizeof *sl);
+  sl->stmt = stmt;
+  sl->next = NULL;
+  psl = &entry->stmt;
+  while (*psl)
+    psl = &(*psl)->next;
+  *psl = sl;
+}
+
 /* Insert STMT into the global prefix tree.  */
 
 static void
@@ -849,6 +930,17 @@ insert_prefix_tree (lang_wild_statement_type *stmt)
     {
       const char *name = sec->spec.name ? sec->spec.name : "*";
       char c;
+
+      /* If the pattern has no glob characters we can do better than a
+	 prefix: only a section with exactly that name can match.  */
+      if (name[strcspn (name, "*[?")] == '\0')
+	{
+	  exact_wild_add_stmt (name, stmt);
+	  continue;
+	}
+
+      /* Otherwise the matching prefix is what comes before the first
+	 glob character.  */
       t = ptroot;
       for (; (c = *name); name++)
 	{
@@ -856,13 +948,6 @@ insert_prefix_tree (lang_wild_statement_type *stmt)
 	    break;
 	  t = get_prefix_tree (&t->child, c, true);
 	}
-      /* If we hit a glob character, the matching prefix is what we saw
-	 until now.  If we hit the end of pattern (hence it's no glob) then
-	 we can do better: we only need to record a match when a section name
-	 completely matches, not merely a prefix, so record the trailing 0
-	 as well.  */
-      if (!c)
-	t = get_prefix_tree (&t->child, 0, true);
       pt_add_stmt (t, stmt);
     }
 }
@@ -924,6 +1009,8 @@ analyze_walk_wild_section_handler (lang_wild_statement_type *ptr)
 
   ptr->tree = NULL;
   ptr->rightmost = &ptr->tree;
+  ptr->last_file = NULL;
+  ptr->last_file_matched = false;
 
   for (sec = ptr->section_list; sec != NULL; sec = sec->next)
     {
@@ -955,7 +1042,7 @@ resolve_wild_sections (lang_input_statement_type *file)
   for (s = file->the_bfd->sections; s != NULL; s = s->next)
     {
       const char *sname = bfd_section_name (s);
-      char c = 1;
+      const char *p = sname;
       struct prefixtree *t = ptroot;
       //printf (" YYY consider %s of %s\n", sname, file->the_bfd->filename);
       do
@@ -969,12 +1056,26 @@ resolve_wild_sections (lang_input_statement_type *file)
 		  //printf ("   ZZZ maybe place into %p\n", sl->stmt);
 		}
 	    }
-	  if (!c)
+	  if (*p == '\0')
 	    break;
-	  c = *sname++;
-	  t = get_prefix_tree (&t->child, c, false);
+	  t = get_prefix_tree (&t->child, *p++, false);
 	}
       while (t);
+
+      /* Then the statements with a pattern equal to the name.  */
+      if (exact_wild_table != NULL)
+	{
+	  struct exact_wild e, *entry;
+
+	  e.name = sname;
+	  entry = (struct exact_wild *) htab_find (exact_wild_table, &e);
+	  if (entry != NULL)
+	    {
+	      struct wild_stmt_list *sl;
+	      for (sl = entry->stmt; sl; sl = sl->next)
+		walk_wild_section_match (sl->stmt, file, s);
+	    }
+	}
     }
 }
 
@@ -983,6 +1084,8 @@ resolve_wild_sections (lang_input_statement_type *file)
 static void
 resolve_wilds (void)
 {
+  long start_time = ld_wall_time ();
+
   LANG_FOR_EACH_INPUT_STATEMENT (f)
     {
       //printf("XXX   %s\n", f->filename);
@@ -1010,6 +1113,8 @@ resolve_wilds (void)
 	    }
 	}
     }
+
+  lang_wild_time += ld_wall_time () - start_time;
 }
 
 /* For each input section that matches wild statement S calls
@@ -3754,6 +3859,15 @@ ldlang_open_ctf (void)
     ctf_close (errfile->the_ctf);
 }
 
+/* Let libctf hash the types of the inputs using the --threads threads.  */
+
+static void
+lang_ctf_parallel_for (size_t count, void (*func) (size_t, void *),
+		       void *data, void *arg ATTRIBUTE_UNUSED)
+{
+  ld_parallel_for (count, func, data);
+}
+
 /* Merge together CTF sections.  After this, only the symtab-dependent
    function and data object sections need adjustment.  */
 
@@ -3762,6 +3876,8 @@ lang_merge_ctf (void)
 {
   asection *output_sect;
   int flags = 0;
+  long start_time;
+  ctf_link_times_t times;
 
   if (!ctf_output)
     return;
@@ -3807,6 +3923,10 @@ lang_merge_ctf (void)
   if (bfd_link_relocatable (&link_info))
     flags |= CTF_LINK_NO_FILTER_REPORTED_SYMS;
 
+  if (ld_thread_count () > 1)
+    ctf_link_set_parallel_for (ctf_output, lang_ctf_parallel_for, NULL);
+
+  start_time = ld_wall_time ();
   if (ctf_link (ctf_output, flags) < 0)
     {
       lang_ctf_errs_warnings (ctf_output);
@@ -3819,6 +3939,13 @@ lang_merge_ctf (void)
 	  output_sect->flags |= SEC_EXCLUDE;
 	}
     }
+  lang_ctf_stats.linked = true;
+  lang_ctf_stats.time = ld_wall_time () - start_time;
+  ctf_link_times (ctf_output, &times);
+  lang_ctf_stats.hash_time = times.clt_hash;
+  lang_ctf_stats.conflicts_time = times.clt_conflicts;
+  lang_ctf_stats.emit_time = times.clt_emit;
+
   /* Output any lingering errors that didn't come from ctf_link.  */
   lang_ctf_errs_warnings (ctf_output);
 }
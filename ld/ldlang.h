@@ -403,6 +403,11 @@ struct lang_wild_statement_struct
   bool                        filenames_reversed;
   bool                        any_specs_sorted;
   bool                        keep_sections;
+  /* The last input file checked against FILENAME and
+     EXCLUDE_NAME_LIST when matching sections, and whether it
+     matched.  */
+  lang_input_statement_type * last_file;
+  bool                        last_file_matched;
 };
 
 typedef struct lang_address_statement_struct
@@ -532,6 +537,21 @@ extern lang_statement_list_type statement_list;
 extern lang_statement_list_type *stat_ptr;
 extern bool delete_output_file_on_failure;
 extern bool enable_linker_version;
+/* The time spent matching input sections against wildcards, for
+   --stats.  */
+extern long lang_wild_time;
+
+/* The time spent linking CTF, and in the phases of the CTF deduplicator,
+   for --stats.  LINKED is false if there was no CTF to link.  */
+struct lang_ctf_stats
+{
+  bool linked;
+  long time;
+  long hash_time;
+  long conflicts_time;
+  long emit_time;
+};
+extern struct lang_ctf_stats lang_ctf_stats;
 
 extern struct bfd_sym_chain entry_symbol;
 extern const char *entry_section;
@@ -181,6 +181,8 @@ enum option_values
   OPTION_DISABLE_LINKER_VERSION,
   OPTION_REMAP_INPUTS,
   OPTION_REMAP_INPUTS_FILE,
+  OPTION_THREADS,
+  OPTION_NO_THREADS,
 };
 
 /* The initial parser states.  */
@@ -39,6 +39,7 @@
 #include "ldfile.h"
 #include "ldemul.h"
 #include "ldctor.h"
+#include "ldthread.h"
 #if BFD_SUPPORTS_PLUGINS
 #include "plugin.h"
 #include "plugin-api.h"
@@ -50,6 +51,7 @@
 #endif
 
 #include <string.h>
+#include <time.h>
 
 #ifndef TARGET_SYSTEM_ROOT
 #define TARGET_SYSTEM_ROOT ""
@@ -153,7 +155,8 @@ static struct bfd_link_callbacks link_callbacks =
   ldlang_ctf_acquire_strings,
   NULL,
   ldlang_ctf_new_dynsym,
-  ldlang_write_ctf_late
+  ldlang_write_ctf_late,
+  NULL
 };
 
 static bfd_assert_handler_type default_bfd_assert_handler;
@@ -208,6 +211,24 @@ write_dependency_file (void)
   fclose (out);
 }
 
+/* Return the elapsed (wall-clock) time in microseconds, for the
+   --stats phase times.  Unlike get_run_time, this does not add up the
+   time used by every thread, so phases run with --threads are not
+   reported as slower.  Falls back to the run time if there is no
+   monotonic clock.  */
+
+long
+ld_wall_time (void)
+{
+#ifdef CLOCK_MONOTONIC
+  struct timespec ts;
+
+  if (clock_gettime (CLOCK_MONOTONIC, &ts) == 0)
+    return (long) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+  return get_run_time ();
+}
+
 static void
 ld_cleanup (void)
 {
@@ -251,6 +272,8 @@ main (int argc, char **argv)
 {
   char *emulation;
   long start_time = get_run_time ();
+  long phase_time, lang_time, write_time;
+  unsigned long archive_passes, archive_lookups;
 
 #ifdef HAVE_LC_MESSAGES
   setlocale (LC_MESSAGES, "");
@@ -316,6 +339,7 @@ main (int argc, char **argv)
   config.rpath_separator = ':';
   config.split_by_reloc = (unsigned) -1;
   config.split_by_file = (bfd_size_type) -1;
+  config.threads = 1;
   config.make_executable = true;
   config.magic_demand_paged = true;
   config.text_read_only = true;
@@ -374,6 +398,9 @@ main (int argc, char **argv)
   lang_has_input_file = false;
   parse_args (argc, argv);
 
+  if (ld_thread_count () > 1)
+    link_callbacks.parallel_for = ld_parallel_for;
+
   if (config.hash_table_size != 0)
     bfd_hash_set_default_size (config.hash_table_size);
 
@@ -498,7 +525,9 @@ main (int argc, char **argv)
       link_info.has_map_file = true;
     }
 
+  phase_time = ld_wall_time ();
   lang_process ();
+  lang_time = ld_wall_time () - phase_time;
 
   /* Print error messages for any missing symbols, for any warning
      symbols, and possibly multiple definitions.  */
@@ -519,13 +548,23 @@ main (int argc, char **argv)
     case COMPRESS_DEBUG_ZSTD:
       flags = BFD_COMPRESS | BFD_COMPRESS_GABI | BFD_COMPRESS_ZSTD;
       break;
+    case COMPRESS_DEBUG_ZSTD_CHUNKED:
+      flags = (BFD_COMPRESS | BFD_COMPRESS_GABI | BFD_COMPRESS_ZSTD
+	       | BFD_COMPRESS_CHUNKED);
+      break;
     default:
       break;
     }
   link_info.output_bfd->flags
     |= flags & bfd_applicable_file_flags (link_info.output_bfd);
 
+  phase_time = ld_wall_time ();
   ldwrite ();
+  write_time = ld_wall_time () - phase_time;
+
+  /* The link hash table goes away with the output bfd.  */
+  archive_passes = link_info.hash->archive_passes;
+  archive_lookups = link_info.hash->archive_lookups;
 
   if (config.map_file != NULL)
     lang_map ();
@@ -620,6 +659,34 @@ main (int argc, char **argv)
       long run_time = get_run_time () - start_time;
 
       fflush (stdout);
+      fprintf (stderr, _("%s: time laying out the link: %ld.%06ld\n"),
+	       program_name, lang_time / 1000000, lang_time % 1000000);
+      fprintf (stderr, _("%s:   of which matching input sections: "
+			 "%ld.%06ld\n"),
+	       program_name, lang_wild_time / 1000000,
+	       lang_wild_time % 1000000);
+      if (lang_ctf_stats.linked)
+	{
+	  fprintf (stderr, _("%s:   of which linking CTF: %ld.%06ld\n"),
+		   program_name, lang_ctf_stats.time / 1000000,
+		   lang_ctf_stats.time % 1000000);
+	  fprintf (stderr, _("%s:     hashing types: %ld.%06ld\n"),
+		   program_name, lang_ctf_stats.hash_time / 1000000,
+		   lang_ctf_stats.hash_time % 1000000);
+	  fprintf (stderr, _("%s:     finding conflicting types: "
+			     "%ld.%06ld\n"),
+		   program_name, lang_ctf_stats.conflicts_time / 1000000,
+		   lang_ctf_stats.conflicts_time % 1000000);
+	  fprintf (stderr, _("%s:     emitting types: %ld.%06ld\n"),
+		   program_name, lang_ctf_stats.emit_time / 1000000,
+		   lang_ctf_stats.emit_time % 1000000);
+	}
+      if (archive_passes != 0)
+	fprintf (stderr, _("%s: archive symbol map passes: %lu, "
+			   "lookups: %lu\n"),
+		 program_name, archive_passes, archive_lookups);
+      fprintf (stderr, _("%s: time writing the output: %ld.%06ld\n"),
+	       program_name, write_time / 1000000, write_time % 1000000);
       fprintf (stderr, _("%s: total time in link: %ld.%06ld\n"),
 	       program_name, run_time / 1000000, run_time % 1000000);
       fflush (stderr);
@@ -0,0 +1,197 @@
+/* ldthread.c -- running linker work on several threads.
+   Copyright (C) 2024 Free Software Foundation, Inc.
+
+   This file is part of the GNU Binutils.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.  */
+
+#include "sysdep.h"
+#include "bfd.h"
+#include "bfdlink.h"
+#include "libiberty.h"
+#include "ld.h"
+#include "ldthread.h"
+
+#if defined (HAVE_PTHREAD_H) && defined (HAVE_PTHREAD_CREATE)
+#define USE_THREADS 1
+#include <pthread.h>
+#endif
+
+/* Return the number of threads to use, as set by --threads.  */
+
+unsigned int
+ld_thread_count (void)
+{
+#ifdef USE_THREADS
+  if (config.threads == 0)
+    {
+      long ncpus = -1;
+
+#ifdef _SC_NPROCESSORS_ONLN
+      ncpus = sysconf (_SC_NPROCESSORS_ONLN);
+#endif
+      return ncpus > 1 ? ncpus : 1;
+    }
+  return config.threads;
+#else
+  return 1;
+#endif
+}
+
+#ifdef USE_THREADS
+
+/* The BFD library lock, taken around its use of global data such as
+   the cache of open files.  BFD may take it recursively.  */
+static pthread_mutex_t bfd_mutex;
+
+static bool
+ld_bfd_lock (void *data ATTRIBUTE_UNUSED)
+{
+  if (pthread_mutex_lock (&bfd_mutex) != 0)
+    {
+      bfd_set_error (bfd_error_system_call);
+      return false;
+    }
+  return true;
+}
+
+static bool
+ld_bfd_unlock (void *data ATTRIBUTE_UNUSED)
+{
+  if (pthread_mutex_unlock (&bfd_mutex) != 0)
+    {
+      bfd_set_error (bfd_error_system_call);
+      return false;
+    }
+  return true;
+}
+
+/* Tell BFD to lock its global data, the first time we start threads.
+   Returns false if BFD can not be used from several threads.  */
+
+static bool
+init_bfd_threads (void)
+{
+  static int initialized;
+  pthread_mutexattr_t attr;
+
+  if (initialized != 0)
+    return initialized > 0;
+
+  initialized = -1;
+  if (pthread_mutexattr_init (&attr) != 0)
+    return false;
+  if (pthread_mutexattr_settype (&attr, PTHREAD_MUTEX_RECURSIVE) == 0
+      && pthread_mutex_init (&bfd_mutex, &attr) == 0)
+    {
+      if (bfd_thread_init (ld_bfd_lock, ld_bfd_unlock, NULL))
+	initialized = 1;
+      else
+	pthread_mutex_destroy (&bfd_mutex);
+    }
+  pthread_mutexattr_destroy (&attr);
+  return initialized > 0;
+}
+
+struct parallel_for
+{
+  pthread_mutex_t lock;
+  size_t next;
+  size_t count;
+  void (*func) (size_t, void *);
+  void *data;
+};
+
+/* Call PF->func for unclaimed indices until there are none left.  */
+
+static void
+parallel_for_run (struct parallel_for *pf)
+{
+  for (;;)
+    {
+      size_t i;
+
+      pthread_mutex_lock (&pf->lock);
+      i = pf->next;
+      if (i < pf->count)
+	pf->next++;
+      pthread_mutex_unlock (&pf->lock);
+
+      if (i >= pf->count)
+	break;
+      pf->func (i, pf->data);
+    }
+}
+
+static void *
+parallel_for_thread (void *arg)
+{
+  parallel_for_run ((struct parallel_for *) arg);
+  bfd_thread_cleanup ();
+  return NULL;
+}
+
+#endif /* USE_THREADS */
+
+/* Call FUNC (I, DATA) for every I from 0 to COUNT - 1, spread over up
+   to ld_thread_count threads, the calling thread being one of them.
+   The calls may run concurrently and in any order.  Returns once they
+   have all finished.  */
+
+void
+ld_parallel_for (size_t count, void (*func) (size_t, void *), void *data)
+{
+  size_t i;
+#ifdef USE_THREADS
+  unsigned int nthreads = ld_thread_count ();
+
+  if (nthreads > count)
+    nthreads = count;
+  if (nthreads > 1 && init_bfd_threads ())
+    {
+      struct parallel_for pf;
+      pthread_t *threads;
+      unsigned int started;
+
+      if (pthread_mutex_init (&pf.lock, NULL) == 0)
+	{
+	  pf.next = 0;
+	  pf.count = count;
+	  pf.func = func;
+	  pf.data = data;
+
+	  /* If a thread can't be created, the ones we have do the
+	     work.  */
+	  threads = (pthread_t *) xmalloc ((nthreads - 1) * sizeof (*threads));
+	  for (started = 0; started < nthreads - 1; started++)
+	    if (pthread_create (&threads[started], NULL,
+				parallel_for_thread, &pf) != 0)
+	      break;
+
+	  parallel_for_run (&pf);
+
+	  while (started > 0)
+	    pthread_join (threads[--started], NULL);
+	  free (threads);
+	  pthread_mutex_destroy (&pf.lock);
+	  return;
+	}
+    }
+#endif
+
+  for (i = 0; i < count; i++)
+    func (i, data);
+}
@@ -33,6 +33,9 @@
 #include "ldmisc.h"
 #include <ldgram.h>
 #include "ldmain.h"
+#include "ldfile.h"
+#include "ldemul.h"
+#include "ldthread.h"
 
 /* Build link_order structures for the BFD linker.  */
 
@@ -533,11 +536,115 @@ split_sections (bfd *abfd, struct bfd_link_info *info)
   sanity_check (abfd);
 }
 
+/* The input files to read ahead of the final link.  */
+
+struct preload_info
+{
+  /* The input files, sorted so that the members of each archive are
+     next to each other.  */
+  bfd **files;
+
+  /* GROUPS[I] is the index in FILES of the first file of group I.
+     GROUPS[NGROUPS] is the number of files.  */
+  size_t *groups;
+};
+
+/* Return the BFD holding the file that ABFD is read from.  Members of
+   an archive share its file position, so they can't be read by more
+   than one thread at a time.  */
+
+static bfd *
+preload_file_owner (bfd *abfd)
+{
+  while (abfd->my_archive != NULL && !bfd_is_thin_archive (abfd->my_archive))
+    abfd = abfd->my_archive;
+  return abfd;
+}
+
+static int
+compare_preload_files (const void *a, const void *b)
+{
+  uintptr_t owner1 = (uintptr_t) preload_file_owner (*(bfd **) a);
+  uintptr_t owner2 = (uintptr_t) preload_file_owner (*(bfd **) b);
+
+  if (owner1 < owner2)
+    return -1;
+  if (owner1 > owner2)
+    return 1;
+  return 0;
+}
+
+static void
+preload_group (size_t i, void *data)
+{
+  struct preload_info *info = (struct preload_info *) data;
+  size_t j;
+
+  for (j = info->groups[i]; j < info->groups[i + 1]; j++)
+    if (!ldemul_preload_input (info->files[j]))
+      break;
+}
+
+/* Errors are reported when the final link reads the files again.  */
+
+static void
+preload_error_handler (const char *fmt ATTRIBUTE_UNUSED,
+		       va_list ap ATTRIBUTE_UNUSED)
+{
+}
+
+/* Read the symbols, relocs and section contents of all the input files
+   using several threads, so that the final link finds them in memory.
+   Only the reading is done in parallel; the final link still processes
+   the files one at a time and in the usual order, so the output is the
+   same as without threads.  */
+
+static void
+preload_inputs (void)
+{
+  struct preload_info info;
+  bfd_error_handler_type old_handler;
+  size_t nfiles, ngroups, i;
+  bfd *abfd;
+
+  nfiles = 0;
+  for (abfd = link_info.input_bfds; abfd != NULL; abfd = abfd->link.next)
+    nfiles++;
+  if (nfiles == 0)
+    return;
+
+  info.files = (bfd **) xmalloc (nfiles * sizeof (*info.files));
+  info.groups = (size_t *) xmalloc ((nfiles + 1) * sizeof (*info.groups));
+  i = 0;
+  for (abfd = link_info.input_bfds; abfd != NULL; abfd = abfd->link.next)
+    info.files[i++] = abfd;
+  qsort (info.files, nfiles, sizeof (*info.files), compare_preload_files);
+
+  ngroups = 0;
+  for (i = 0; i < nfiles; i++)
+    if (i == 0
+	|| (preload_file_owner (info.files[i])
+	    != preload_file_owner (info.files[i - 1])))
+      info.groups[ngroups++] = i;
+  info.groups[ngroups] = nfiles;
+
+  old_handler = bfd_set_error_handler (preload_error_handler);
+  ld_parallel_for (ngroups, preload_group, &info);
+  bfd_set_error_handler (old_handler);
+
+  free (info.groups);
+  free (info.files);
+}
+
 /* Call BFD to write out the linked file.  */
 
 void
 ldwrite (void)
 {
+  if (ld_thread_count () > 1
+      && bfd_get_flavour (link_info.output_bfd) == bfd_target_elf_flavour)
+    preload_inputs ();
+
   /* Reset error indicator, which can typically something like invalid
      format from opening up the .o files.  */
   bfd_set_error (bfd_error_no_error);
@@ -493,6 +493,12 @@ static const struct ld_option ld_options[] =
   { {"split-by-reloc", optional_argument, NULL, OPTION_SPLIT_BY_RELOC},
     '\0', N_("[=COUNT]"), N_("Split output sections every COUNT relocs"),
     TWO_DASHES },
+  { {"threads", optional_argument, NULL, OPTION_THREADS},
+    '\0', N_("[=COUNT]"),
+    N_("Read input files using COUNT threads [default: all CPUs]"),
+    TWO_DASHES },
+  { {"no-threads", no_argument, NULL, OPTION_NO_THREADS},
+    '\0', NULL, N_("Use a single thread (default)"), TWO_DASHES },
   { {"stats", no_argument, NULL, OPTION_STATS},
     '\0', NULL, N_("Print memory usage statistics"), TWO_DASHES },
   { {"target-help", no_argument, NULL, OPTION_TARGET_HELP},
@@ -1687,6 +1693,21 @@ parse_args (unsigned argc, char **argv)
 	  else
 	    config.split_by_file = 1;
 	  break;
+	case OPTION_THREADS:
+	  if (optarg != NULL)
+	    {
+	      char *end;
+
+	      config.threads = strtoul (optarg, &end, 0);
+	      if (*end != '\0' || config.threads == 0)
+		einfo (_("%F%P: invalid thread count: %s\n"), optarg);
+	    }
+	  else
+	    config.threads = 0;
+	  break;
+	case OPTION_NO_THREADS:
+	  config.threads = 1;
+	  break;
 	case OPTION_CHECK_SECTIONS:
 	  command_line.check_section_addresses = 1;
 	  break;
@@ -2253,7 +2274,7 @@ elf_static_list_options (FILE *file)
   fprintf (file, _("\
   --package-metadata[=JSON]   Generate package metadata note\n"));
   fprintf (file, _("\
-  --compress-debug-sections=[none|zlib|zlib-gnu|zlib-gabi|zstd]\n\
+  --compress-debug-sections=[none|zlib|zlib-gnu|zlib-gabi|zstd|zstd-chunked]\n\
 			      Compress DWARF debug sections\n"));
   fprintf (file, _("\
                                 Default: %s\n"),
@@ -0,0 +1,4 @@
+	.data
+	.global	chain1
+chain1:
+	.dc.a	chain2
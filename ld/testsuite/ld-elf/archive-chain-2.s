@@ -0,0 +1,4 @@
+	.data
+	.global	chain2
+chain2:
+	.dc.a	chain3
@@ -0,0 +1,8 @@
+/* Not included: chain2 is already defined by archive-chain-2.s,
+   which comes first in the archive.  */
+	.data
+	.global	chain2
+chain2:
+	.global	chain2b
+chain2b:
+	.dc.a	0
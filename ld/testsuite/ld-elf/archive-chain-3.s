@@ -0,0 +1,4 @@
+	.data
+	.global	chain3
+chain3:
+	.dc.a	0
@@ -0,0 +1,4 @@
+	.text
+	.global	_start
+_start:
+	.dc.a	chain1
@@ -0,0 +1,17 @@
+	.text
+	.global func1
+func1:
+	.dc.a	data1
+	.dc.a	func2
+
+	.data
+	.global data1
+data1:
+	.dc.a	func1
+	.dc.a	data1
+
+	.section .text.func2,"ax",%progbits
+	.global func2
+func2:
+	.dc.a	data1
+	.dc.a	start
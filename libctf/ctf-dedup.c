@@ -149,6 +149,19 @@
    *type hash values*, so it's small: in effect it is automatically
    deduplicated.)
 
+   [ctf_dedup_hash_parallel, ctf_dedup_hash_family, ctf_dedup_replay]
+   If the caller has provided a parallel-for function, the inputs are hashed
+   on several threads.  This works because the hashing of one input never looks
+   at the hashing state of another: the GIDs that key cd_type_hashes include the
+   input number (even for types in a child's parent), and every other table is
+   only ever added to.  Each family of inputs (a parent and its children, which
+   share the parent's types and error state) is hashed by one thread into a
+   scratch dict with its own hashing state and atoms table, which records every
+   change the hashing would have made to the real output's tables in a log (a
+   ctf_dedup_log).  The logs are then replayed into the output in input order
+   on a single thread, which leaves every table in exactly the state serial
+   hashing would have, so the output is the same.
+
    2) COLLISIONAL MARKING.
 
    [ctf_dedup_detect_name_ambiguity, ctf_dedup_mark_conflicting_hash]
@@ -366,6 +379,65 @@ make_set_element (ctf_dynhash_t *set, const void *key)
   return element;
 }
 
+/* The log of changes to the hashing state made while hashing a family of
+   inputs in parallel.  Strings are atoms in the scratch dict doing the
+   hashing.  */
+
+typedef enum ctf_dedup_event_kind
+{
+  CTF_DEDUP_EV_TYPE_HASH,	/* Insert into cd_type_hashes.  */
+  CTF_DEDUP_EV_POPULATE,	/* Call ctf_dedup_populate_mappings.  */
+  CTF_DEDUP_EV_ORIGIN,		/* Call ctf_dedup_record_origin.  */
+  CTF_DEDUP_EV_CITER		/* Call ctf_dedup_add_citer.  */
+} ctf_dedup_event_kind_t;
+
+typedef struct ctf_dedup_event
+{
+  ctf_dedup_event_kind_t cde_kind;
+  int cde_input_num;
+  ctf_id_t cde_type;
+  const char *cde_name;		/* Decorated name, or citer hash.  */
+  const char *cde_hval;
+} ctf_dedup_event_t;
+
+struct ctf_dedup_log
+{
+  ctf_dedup_event_t *cdl_events;
+  size_t cdl_nevents;
+  size_t cdl_size;
+};
+
+/* Append an event to the log of the scratch dict FP.  */
+
+static int
+ctf_dedup_log_event (ctf_dict_t *fp, ctf_dedup_event_kind_t kind,
+		     int input_num, ctf_id_t type, const char *name,
+		     const char *hval)
+{
+  struct ctf_dedup_log *log = fp->ctf_dedup.cd_log;
+  ctf_dedup_event_t *event;
+
+  if (log->cdl_nevents == log->cdl_size)
+    {
+      size_t size = log->cdl_size ? log->cdl_size * 2 : 1024;
+      ctf_dedup_event_t *events;
+
+      if ((events = realloc (log->cdl_events,
+			     size * sizeof (ctf_dedup_event_t))) == NULL)
+	return ctf_set_errno (fp, ENOMEM);
+      log->cdl_events = events;
+      log->cdl_size = size;
+    }
+
+  event = &log->cdl_events[log->cdl_nevents++];
+  event->cde_kind = kind;
+  event->cde_input_num = input_num;
+  event->cde_type = type;
+  event->cde_name = name;
+  event->cde_hval = hval;
+  return 0;
+}
+
 /* Initialize the dedup atoms table.  */
 int
 ctf_dedup_atoms_init (ctf_dict_t *fp)
@@ -526,6 +598,10 @@ ctf_dedup_record_origin (ctf_dict_t *fp, int input_num, const char *decorated,
   void *origin;
   int populate_origin = 0;
 
+  if (d->cd_log)
+    return ctf_dedup_log_event (fp, CTF_DEDUP_EV_ORIGIN, input_num,
+				CTF_DEDUP_GID_TO_TYPE (id), decorated, NULL);
+
   if (ctf_dynhash_lookup_kv (d->cd_struct_origin, decorated, NULL, &origin))
     {
       if (CTF_DEDUP_GID_TO_INPUT (origin) != input_num
@@ -547,6 +623,27 @@ ctf_dedup_record_origin (ctf_dict_t *fp, int input_num, const char *decorated,
   return 0;
 }
 
+/* Record that the type with hash value HVAL cites the type with hash value
+   CITER, in the cd_citers graph.  */
+static int
+ctf_dedup_add_citer (ctf_dict_t *fp, const char *citer, const char *hval)
+{
+  ctf_dedup_t *d = &fp->ctf_dedup;
+  ctf_dynset_t *citer_hashes;
+
+  if (d->cd_log)
+    return ctf_dedup_log_event (fp, CTF_DEDUP_EV_CITER, -1, 0, citer, hval);
+
+  if ((citer_hashes = make_set_element (d->cd_citers, citer)) == NULL)
+    return ctf_set_errno (fp, errno);
+
+  if (ctf_dynset_exists (citer_hashes, hval, NULL))
+    return 0;
+  if (ctf_dynset_cinsert (citer_hashes, hval) < 0)
+    return ctf_set_errno (fp, errno);
+  return 0;
+}
+
 /* Do the underlying hashing and recursion for ctf_dedup_hash_type (which it
    calls, recursively).  */
 
@@ -939,11 +1036,7 @@ ctf_dedup_rhash_type (ctf_dict_t *fp, ctf_dict_t *input, ctf_dict_t **inputs,
 
   if (citer)
     {
-      ctf_dynset_t *citer_hashes;
-
-      if ((citer_hashes = make_set_element (d->cd_citers, citer)) == NULL)
-	goto oom;
-      if (ctf_dynset_cinsert (citer_hashes, hval) < 0)
+      if (ctf_dedup_add_citer (fp, citer, hval) < 0)
 	goto oom;
     }
   else if (citers)
@@ -952,15 +1045,9 @@ ctf_dedup_rhash_type (ctf_dict_t *fp, ctf_dict_t *input, ctf_dict_t **inputs,
 
       while ((err = ctf_dynset_cnext (citers, &i, &k)) == 0)
 	{
-	  ctf_dynset_t *citer_hashes;
 	  citer = (const char *) k;
 
-	  if ((citer_hashes = make_set_element (d->cd_citers, citer)) == NULL)
-	    goto oom;
-
-	  if (ctf_dynset_exists (citer_hashes, hval, NULL))
-	    continue;
-	  if (ctf_dynset_cinsert (citer_hashes, hval) < 0)
+	  if (ctf_dedup_add_citer (fp, citer, hval) < 0)
 	    goto oom;
 	}
       if (err != ECTF_NEXT_END)
@@ -1125,6 +1212,14 @@ ctf_dedup_hash_type (ctf_dict_t *fp, ctf_dict_t *input,
 	  goto oom;
 	}
 
+      if (d->cd_log
+	  && ctf_dedup_log_event (fp, CTF_DEDUP_EV_TYPE_HASH, input_num, type,
+				  NULL, hval) < 0)
+	{
+	  whaterr = N_("error logging hash");
+	  goto err;
+	}
+
       if (populate_fun (fp, input, inputs, input_num, type, type_id,
 			decorated, hval) < 0)
 	{
@@ -1881,6 +1976,323 @@ ctf_dedup_conflictify_unshared (ctf_dict_t *output, ctf_dict_t **inputs)
   return ctf_set_errno (output, err);
 }
 
+/* Hash all the types in input INPUT_NUM, recording them with POPULATE_FUN.  */
+
+static int
+ctf_dedup_hash_input (ctf_dict_t *fp, ctf_dict_t **inputs, uint32_t *parents,
+		      uint32_t input_num,
+		      int (*populate_fun) (ctf_dict_t *fp,
+					   ctf_dict_t *input,
+					   ctf_dict_t **inputs,
+					   int input_num,
+					   ctf_id_t type,
+					   void *id,
+					   const char *decorated_name,
+					   const char *hash))
+{
+  ctf_dict_t *input = inputs[input_num];
+  ctf_next_t *it = NULL;
+  ctf_id_t id;
+
+  while ((id = ctf_type_next (input, &it, NULL, 1)) != CTF_ERR)
+    {
+      if (ctf_dedup_hash_type (fp, input, inputs, parents, input_num, id,
+			       0, 0, populate_fun) == NULL)
+	{
+	  ctf_next_destroy (it);
+	  return -1;				/* errno is set for us.  */
+	}
+    }
+  if (ctf_errno (input) != ECTF_NEXT_END)
+    {
+      ctf_set_errno (fp, ctf_errno (input));
+      ctf_err_warn (fp, 0, 0, _("iteration failure computing type hashes"));
+      return -1;
+    }
+  return 0;
+}
+
+/* A population function for parallel hashing, which logs the call for
+   ctf_dedup_replay to make later.  */
+
+static int
+ctf_dedup_log_populate (ctf_dict_t *fp, ctf_dict_t *input _libctf_unused_,
+			ctf_dict_t **inputs _libctf_unused_, int input_num,
+			ctf_id_t type, void *id _libctf_unused_,
+			const char *decorated_name, const char *hval)
+{
+  return ctf_dedup_log_event (fp, CTF_DEDUP_EV_POPULATE, input_num, type,
+			      decorated_name, hval);
+}
+
+/* A family of inputs hashed together by one thread: an input and the children
+   that follow it in the inputs array.  */
+
+typedef struct ctf_dedup_family
+{
+  uint32_t cdf_first;		/* First input in the family.  */
+  uint32_t cdf_count;		/* Number of inputs in the family.  */
+  int cdf_failed;		/* Set if hashing failed.  */
+  ctf_dict_t *cdf_scratch;	/* Dict holding the hashing state.  */
+  struct ctf_dedup_log cdf_log;	/* Changes to make to the output.  */
+} ctf_dedup_family_t;
+
+typedef struct ctf_dedup_parallel_arg
+{
+  ctf_dict_t **cdp_inputs;
+  uint32_t *cdp_parents;
+  int cdp_link_flags;
+  ctf_dedup_family_t *cdp_families;
+} ctf_dedup_parallel_arg_t;
+
+/* Hash the types in family N of the families in ARG_: called by the caller's
+   parallel-for function, possibly on another thread.  The only dicts touched
+   are the family's inputs and its scratch dict, which collects any errors.  */
+
+static void
+ctf_dedup_hash_family (size_t n, void *arg_)
+{
+  ctf_dedup_parallel_arg_t *arg = (ctf_dedup_parallel_arg_t *) arg_;
+  ctf_dedup_family_t *family = &arg->cdp_families[n];
+  ctf_dict_t *scratch = family->cdf_scratch;
+  uint32_t i;
+
+  if (ctf_dedup_init (scratch) < 0)
+    goto err;
+
+  scratch->ctf_dedup.cd_link_flags = arg->cdp_link_flags;
+  scratch->ctf_dedup.cd_log = &family->cdf_log;
+
+  for (i = family->cdf_first; i < family->cdf_first + family->cdf_count; i++)
+    if (ctf_dedup_hash_input (scratch, arg->cdp_inputs, arg->cdp_parents, i,
+			      ctf_dedup_log_populate) < 0)
+      goto err;
+  return;
+
+ err:
+  family->cdf_failed = 1;
+}
+
+/* Free a family's scratch state, and any errors and warnings left in it.  */
+
+static void
+ctf_dedup_free_family (ctf_dedup_family_t *family)
+{
+  ctf_dict_t *scratch = family->cdf_scratch;
+  ctf_err_warning_t *err, *nerr;
+
+  if (scratch == NULL)
+    return;
+
+  ctf_dedup_fini (scratch, NULL, 0);
+  ctf_dynset_destroy (scratch->ctf_dedup_atoms_alloc);
+
+  for (err = ctf_list_next (&scratch->ctf_errs_warnings); err != NULL;
+       err = nerr)
+    {
+      nerr = ctf_list_next (err);
+      ctf_list_delete (&scratch->ctf_errs_warnings, err);
+      free (err->cew_text);
+      free (err);
+    }
+  free (scratch);
+  free (family->cdf_log.cdl_events);
+  family->cdf_scratch = NULL;
+  family->cdf_log.cdl_events = NULL;
+}
+
+/* Return the atom in the OUTPUT equivalent to ATOM, an atom in the SCRATCH
+   dict, interning it if need be.  ATOMS caches the mapping.  Strings that are
+   not atoms at all are static, and are returned unchanged.  */
+
+static const char *
+ctf_dedup_replay_atom (ctf_dict_t *output, ctf_dict_t *scratch,
+		       ctf_dynhash_t *atoms, const char *atom)
+{
+  const void *found;
+  const char *ret;
+  char *copy;
+
+  if ((ret = ctf_dynhash_lookup (atoms, atom)) != NULL)
+    return ret;
+
+  if (!ctf_dynset_exists (scratch->ctf_dedup_atoms, atom, &found)
+      || found != atom)
+    return atom;
+
+  if ((copy = strdup (atom)) == NULL)
+    {
+      ctf_set_errno (output, ENOMEM);
+      return NULL;
+    }
+  if ((ret = intern (output, copy)) == NULL)
+    return NULL;				/* errno is set for us.  */
+
+  if (ctf_dynhash_cinsert (atoms, atom, ret) < 0)
+    {
+      ctf_set_errno (output, errno);
+      return NULL;
+    }
+  return ret;
+}
+
+/* Make the changes to the hashing state of the OUTPUT logged while hashing
+   FAMILY, in the order they were logged.  */
+
+static int
+ctf_dedup_replay (ctf_dict_t *output, ctf_dict_t **inputs,
+		  ctf_dedup_family_t *family)
+{
+  ctf_dedup_t *d = &output->ctf_dedup;
+  ctf_dict_t *scratch = family->cdf_scratch;
+  ctf_dynhash_t *atoms;
+  size_t i;
+
+  if ((atoms = ctf_dynhash_create (ctf_hash_integer, ctf_hash_eq_integer,
+				   NULL, NULL)) == NULL)
+    {
+      ctf_set_errno (output, ENOMEM);
+      goto err;
+    }
+
+  for (i = 0; i < family->cdf_log.cdl_nevents; i++)
+    {
+      ctf_dedup_event_t *event = &family->cdf_log.cdl_events[i];
+      const char *name = NULL;
+      const char *hval = NULL;
+      void *id = NULL;
+
+      if (event->cde_name
+	  && (name = ctf_dedup_replay_atom (output, scratch, atoms,
+					    event->cde_name)) == NULL)
+	goto err;
+      if (event->cde_hval
+	  && (hval = ctf_dedup_replay_atom (output, scratch, atoms,
+					    event->cde_hval)) == NULL)
+	goto err;
+      if (event->cde_kind != CTF_DEDUP_EV_CITER)
+	id = CTF_DEDUP_GID (output, event->cde_input_num, event->cde_type);
+
+      switch (event->cde_kind)
+	{
+	case CTF_DEDUP_EV_TYPE_HASH:
+	  if (ctf_dynhash_cinsert (d->cd_type_hashes, id, hval) < 0)
+	    {
+	      ctf_set_errno (output, errno);
+	      goto err;
+	    }
+	  break;
+	case CTF_DEDUP_EV_POPULATE:
+	  if (ctf_dedup_populate_mappings (output,
+					   inputs[event->cde_input_num],
+					   inputs, event->cde_input_num,
+					   event->cde_type, id, name,
+					   hval) < 0)
+	    goto err;
+	  break;
+	case CTF_DEDUP_EV_ORIGIN:
+	  if (ctf_dedup_record_origin (output, event->cde_input_num, name,
+				       id) < 0)
+	    goto err;
+	  break;
+	case CTF_DEDUP_EV_CITER:
+	  if (ctf_dedup_add_citer (output, name, hval) < 0)
+	    goto err;
+	  break;
+	}
+    }
+
+  ctf_dynhash_destroy (atoms);
+  return 0;
+
+ err:
+  ctf_dynhash_destroy (atoms);
+  ctf_err_warn (output, 0, 0, _("error replaying type hashes of %s"),
+		ctf_link_input_name (inputs[family->cdf_first]));
+  return -1;					/* errno is set for us.  */
+}
+
+/* Hash all the types in all the INPUTS using the parallel-for function set on
+   the OUTPUT, leaving the OUTPUT's hashing state exactly as hashing each input
+   in turn with ctf_dedup_hash_input would.  The inputs are hashed in batches,
+   so as not to keep the scratch state of every input in memory at once.  */
+
+static int
+ctf_dedup_hash_parallel (ctf_dict_t *output, ctf_dict_t **inputs,
+			 uint32_t ninputs, uint32_t *parents)
+{
+  ctf_dedup_parallel_arg_t arg;
+  ctf_dedup_family_t *families;
+  uint32_t nfamilies = 0;
+  uint32_t i, j;
+
+  if ((families = calloc (ninputs, sizeof (ctf_dedup_family_t))) == NULL)
+    {
+      ctf_err_warn (output, 0, ENOMEM, _("ctf_dedup: cannot allocate "
+					 "parallel hashing state"));
+      return ctf_set_errno (output, ENOMEM);
+    }
+
+  /* Children follow their parent in the inputs array (see
+     ctf_link_deduplicating_open_inputs), and hashing them looks into the
+     parent, so they must be hashed by the same thread.  */
+
+  for (i = 0; i < ninputs; i++)
+    {
+      if (nfamilies == 0 || !(inputs[i]->ctf_flags & LCTF_CHILD))
+	families[nfamilies++].cdf_first = i;
+      families[nfamilies - 1].cdf_count++;
+    }
+
+  arg.cdp_inputs = inputs;
+  arg.cdp_parents = parents;
+  arg.cdp_link_flags = output->ctf_dedup.cd_link_flags;
+
+  for (i = 0; i < nfamilies; i += CTF_DEDUP_PARALLEL_BATCH)
+    {
+      uint32_t nbatch = MIN (nfamilies - i, CTF_DEDUP_PARALLEL_BATCH);
+
+      for (j = i; j < i + nbatch; j++)
+	if ((families[j].cdf_scratch = calloc (1, sizeof (ctf_dict_t))) == NULL)
+	  {
+	    ctf_err_warn (output, 0, ENOMEM, _("ctf_dedup: cannot allocate "
+					       "parallel hashing state"));
+	    ctf_set_errno (output, ENOMEM);
+	    goto err;
+	  }
+
+      arg.cdp_families = &families[i];
+      output->ctf_link_parallel_for (nbatch, ctf_dedup_hash_family, &arg,
+				     output->ctf_link_parallel_for_arg);
+
+      for (j = i; j < i + nbatch; j++)
+	{
+	  ctf_dict_t *scratch = families[j].cdf_scratch;
+
+	  ctf_list_splice (&output->ctf_errs_warnings,
+			   &scratch->ctf_errs_warnings);
+	  if (families[j].cdf_failed)
+	    {
+	      ctf_set_errno (output, ctf_errno (scratch));
+	      goto err;
+	    }
+
+	  if (ctf_dedup_replay (output, inputs, &families[j]) < 0)
+	    goto err;				/* errno is set for us.  */
+	  ctf_dedup_free_family (&families[j]);
+	}
+    }
+
+  free (families);
+  return 0;
+
+ err:
+  for (j = 0; j < nfamilies; j++)
+    ctf_dedup_free_family (&families[j]);
+  free (families);
+  return -1;
+}
+
 /* The core deduplicator.  Populate cd_output_mapping in the output ctf_dedup
    with a mapping of all types that belong in this dictionary and where they
    come from, and cd_conflicting_types with an indication of whether each type
@@ -1901,7 +2313,7 @@ ctf_dedup (ctf_dict_t *output, ctf_dict_t **inputs, uint32_t ninputs,
 {
   ctf_dedup_t *d = &output->ctf_dedup;
   size_t i;
-  ctf_next_t *it = NULL;
+  long start_time;
 
   if (ctf_dedup_init (output) < 0)
     return -1; 					/* errno is set for us.  */
@@ -1936,25 +2348,20 @@ ctf_dedup (ctf_dict_t *output, ctf_dict_t **inputs, uint32_t ninputs,
      IDs in cd_output_mapping.  */
 
   ctf_dprintf ("Computing type hashes\n");
-  for (i = 0; i < ninputs; i++)
+  start_time = ctf_wall_time ();
+  if (output->ctf_link_parallel_for && ninputs > 1)
     {
-      ctf_id_t id;
-
-      while ((id = ctf_type_next (inputs[i], &it, NULL, 1)) != CTF_ERR)
-	{
-	  if (ctf_dedup_hash_type (output, inputs[i], inputs,
-				   parents, i, id, 0, 0,
-				   ctf_dedup_populate_mappings) == NULL)
-	    goto err;				/* errno is set for us.  */
-	}
-      if (ctf_errno (inputs[i]) != ECTF_NEXT_END)
-	{
-	  ctf_set_errno (output, ctf_errno (inputs[i]));
-	  ctf_err_warn (output, 0, 0, _("iteration failure "
-					"computing type hashes"));
-	  goto err;
-	}
+      if (ctf_dedup_hash_parallel (output, inputs, ninputs, parents) < 0)
+	goto err;				/* errno is set for us.  */
     }
+  else
+    for (i = 0; i < ninputs; i++)
+      {
+	if (ctf_dedup_hash_input (output, inputs, parents, i,
+				  ctf_dedup_populate_mappings) < 0)
+	  goto err;				/* errno is set for us.  */
+      }
+  output->ctf_link_times.clt_hash += ctf_wall_time () - start_time;
 
   /* Go through the cd_name_counts name->hash->count mapping for all CTF
      namespaces: any name with many hashes associated with it at this stage is
@@ -1962,6 +2369,7 @@ ctf_dedup (ctf_dict_t *output, ctf_dict_t **inputs, uint32_t ninputs,
      conflicting in the output.  */
 
   ctf_dprintf ("Detecting type name ambiguity\n");
+  start_time = ctf_wall_time ();
   if (ctf_dedup_detect_name_ambiguity (output, inputs) < 0)
       goto err;					/* errno is set for us.  */
 
@@ -1975,6 +2383,7 @@ ctf_dedup (ctf_dict_t *output, ctf_dict_t **inputs, uint32_t ninputs,
       if (ctf_dedup_conflictify_unshared (output, inputs) < 0)
 	goto err;				/* errno is set for us.  */
     }
+  output->ctf_link_times.clt_conflicts += ctf_wall_time () - start_time;
   return 0;
 
  err:
@@ -3071,6 +3480,7 @@ ctf_dedup_emit (ctf_dict_t *output, ctf_dict_t **inputs, uint32_t ninputs,
   ctf_dict_t **outputs;
   ctf_dict_t **walk;
   size_t i;
+  long start_time = ctf_wall_time ();
 
   ctf_dprintf ("Triggering emission.\n");
   if (ctf_dedup_walk_output_mapping (output, inputs, ninputs, parents,
@@ -3114,6 +3524,7 @@ ctf_dedup_emit (ctf_dict_t *output, ctf_dict_t **inputs, uint32_t ninputs,
 	}
     }
 
+  output->ctf_link_times.clt_emit += ctf_wall_time () - start_time;
   return outputs;
 }
 
@@ -54,6 +54,11 @@ extern "C"
    cost.  */
 #define CTF_INDEX_PAD_THRESHOLD .75
 
+/* The number of input dicts whose types are hashed by each round of a parallel
+   deduplication.  The hashing state of all of them is kept in memory until the
+   round is over.  */
+#define CTF_DEDUP_PARALLEL_BATCH 256
+
 /* Compiler attributes.  */
 
 #if defined (__GNUC__)
@@ -351,6 +356,11 @@ typedef struct ctf_dedup
   /* Points to the output counterpart of this input dictionary, at emission
      time.  */
   ctf_dict_t *cd_output;
+
+  /* In the scratch dicts used to hash inputs in parallel, a log of the changes
+     that hashing would have made to the state of the real output, replayed into
+     it later.  NULL when hashing directly into the output.  */
+  struct ctf_dedup_log *cd_log;
 } ctf_dedup_t;
 
 /* The ctf_dict is the structure used to represent a CTF dictionary to library
@@ -480,6 +490,12 @@ struct ctf_dict
   ctf_link_variable_filter_f *ctf_link_variable_filter;
   void *ctf_link_variable_filter_arg;           /* Argument for it. */
 
+  /* Allow the caller to hash input types in parallel.  */
+  ctf_link_parallel_for_f *ctf_link_parallel_for;
+  void *ctf_link_parallel_for_arg;		/* Argument for it. */
+
+  ctf_link_times_t ctf_link_times;  /* Time spent in link phases.  */
+
   ctf_dynhash_t *ctf_add_processing; /* Types ctf_add_type is working on now.  */
 
   /* Atoms table for dedup string storage.  All strings in the ctf_dedup_t are
@@ -760,6 +776,7 @@ extern void ctf_munmap (void *, size_t);
 extern ssize_t ctf_pread (int fd, void *buf, ssize_t count, off_t offset);
 
 extern void *ctf_realloc (ctf_dict_t *, void *, size_t);
+extern long ctf_wall_time (void);
 extern char *ctf_str_append (char *, const char *);
 extern char *ctf_str_append_noerr (char *, const char *);
 
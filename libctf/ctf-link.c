@@ -490,6 +490,25 @@ ctf_link_set_variable_filter (ctf_dict_t *fp, ctf_link_variable_filter_f *filter
   return 0;
 }
 
+/* Set a function which is used to run the hashing of input types on several
+   threads.  The output of the link is the same with or without it.  */
+int
+ctf_link_set_parallel_for (ctf_dict_t *fp, ctf_link_parallel_for_f *fn,
+			   void *arg)
+{
+  fp->ctf_link_parallel_for = fn;
+  fp->ctf_link_parallel_for_arg = arg;
+  return 0;
+}
+
+/* Get the time spent in each phase of the last ctf_link on this dict.  */
+int
+ctf_link_times (ctf_dict_t *fp, ctf_link_times_t *times)
+{
+  *times = fp->ctf_link_times;
+  return 0;
+}
+
 /* Check if we can safely add a variable with the given type to this dict.  */
 
 static int
@@ -1236,6 +1255,9 @@ ctf_link_deduplicating_per_cu (ctf_dict_t *fp)
       /* Share the atoms table to reduce memory usage.  */
       out->ctf_dedup_atoms = fp->ctf_dedup_atoms_alloc;
 
+      out->ctf_link_parallel_for = fp->ctf_link_parallel_for;
+      out->ctf_link_parallel_for_arg = fp->ctf_link_parallel_for_arg;
+
       /* No ctf_imports at this stage: this per-CU dictionary has no parents.
 	 Parent/child deduplication happens in the link's final pass.  However,
 	 the cuname *is* important, as it is propagated into the final
@@ -1258,6 +1280,10 @@ ctf_link_deduplicating_per_cu (ctf_dict_t *fp)
 				     "failed for %s"), out_name);
 	  goto err_inputs;
 	}
+      fp->ctf_link_times.clt_hash += out->ctf_link_times.clt_hash;
+      fp->ctf_link_times.clt_conflicts += out->ctf_link_times.clt_conflicts;
+      fp->ctf_link_times.clt_emit += out->ctf_link_times.clt_emit;
+
       if (!ctf_assert (fp, noutputs == 1))
 	{
 	  size_t j;
@@ -1500,6 +1526,7 @@ ctf_link (ctf_dict_t *fp, int flags)
   int err;
 
   fp->ctf_link_flags = flags;
+  memset (&fp->ctf_link_times, 0, sizeof (ctf_link_times_t));
 
   if (fp->ctf_link_inputs == NULL)
     return 0;					/* Nothing to do. */
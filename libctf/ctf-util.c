@@ -19,6 +19,7 @@
 
 #include <ctf-impl.h>
 #include <string.h>
+#include <time.h>
 #include "ctf-endian.h"
 
 /* Simple doubly-linked list append routine.  This implementation assumes that
@@ -194,6 +195,23 @@ ctf_elf64_to_link_sym (ctf_dict_t *fp, ctf_link_sym_t *dst, const Elf64_Sym *src
   return dst;
 }
 
+/* Return the elapsed (wall-clock) time in microseconds, for
+   ctf_link_times.  Unlike get_run_time, this does not add up the time
+   used by every thread, so phases run in parallel are not reported as
+   slower.  Falls back to the run time if there is no monotonic clock.  */
+
+long
+ctf_wall_time (void)
+{
+#ifdef CLOCK_MONOTONIC
+  struct timespec ts;
+
+  if (clock_gettime (CLOCK_MONOTONIC, &ts) == 0)
+    return (long) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+  return get_run_time ();
+}
+
 /* A string appender working on dynamic strings.  Returns NULL on OOM.  */
 
 char *
@@ -30,6 +30,37 @@ extern "C"
 #include <assert.h>
 #define sframe_assert(expr) (assert (expr))
 
+/* An entry of the lookup index: the FRE which covers the PCs from
+   SLR_START to SLR_END inclusive.  */
+
+typedef struct sframe_lookup_row
+{
+  int32_t slr_start;
+  int32_t slr_end;
+  sframe_frame_row_entry slr_fre;
+} sframe_lookup_row;
+
+/* The lookup index of a decoder, built by
+   sframe_decoder_build_lookup_index.  The rows of all the FDEs are held
+   sorted by PC, and the PCs they cover are divided into buckets of
+   (1 << SLI_SHIFT) bytes.  The rows which may cover a PC in bucket B are
+   those from SLI_BUCKETS[B] to SLI_BUCKETS[B + 1] inclusive.  */
+
+typedef struct sframe_lookup_index
+{
+  /* The first PC covered by the rows.  */
+  int32_t sli_base;
+  /* The number of bytes from SLI_BASE to the last PC covered.  */
+  uint32_t sli_span;
+  uint32_t sli_shift;
+  uint32_t *sli_buckets;
+  sframe_lookup_row *sli_rows;
+  uint32_t sli_num_rows;
+  /* Whether some FDEs are not in the index, so that a PC not found in
+     it must still be looked up the slow way.  */
+  bool sli_partial_p;
+} sframe_lookup_index;
+
 struct sframe_decoder_ctx
 {
   /* SFrame header.  */
@@ -43,6 +74,8 @@ struct sframe_decoder_ctx
   /* Reference to the internally malloc'd buffer, if any, for endian flipping
      the original input buffer before decoding.  */
   void *sfd_buf;
+  /* Lookup index for sframe_find_fre, if built.  */
+  sframe_lookup_index *sfd_lookup;
 };
 
 typedef struct sf_fde_tbl sf_fde_tbl;
@@ -39,6 +39,9 @@ struct sf_fre_tbl
   sframe_frame_row_entry entry[1];
 };
 
+/* The smallest bucket size of the lookup index, as a power of 2.  */
+#define SFRAME_LOOKUP_MIN_SHIFT 4
+
 #define _sf_printflike_(string_index,first_to_check) \
     __attribute__ ((__format__ (__printf__, (string_index), (first_to_check))))
 
@@ -595,6 +598,16 @@ sframe_get_fre_offset (sframe_frame_row_entry *fre, int idx, int *errp)
     }
 }
 
+/* Free the lookup index LOOKUP.  */
+
+static void
+sframe_lookup_index_free (sframe_lookup_index *lookup)
+{
+  free (lookup->sli_buckets);
+  free (lookup->sli_rows);
+  free (lookup);
+}
+
 /* Free the decoder context.  */
 
 void
@@ -621,6 +634,11 @@ sframe_decoder_free (sframe_decoder_ctx **dctxp)
 	  free (dctx->sfd_buf);
 	  dctx->sfd_buf = NULL;
 	}
+      if (dctx->sfd_lookup != NULL)
+	{
+	  sframe_lookup_index_free (dctx->sfd_lookup);
+	  dctx->sfd_lookup = NULL;
+	}
 
       free (*dctxp);
       *dctxp = NULL;
@@ -1103,6 +1121,186 @@ sframe_fre_get_end_ip_offset (sframe_func_desc_entry *fdep, unsigned int i,
   return end_ip_offset;
 }
 
+/* Find the FRE which contains the PC in the lookup index LOOKUP, and copy
+   it to FREP.  Returns SFRAME_ERR if there is none.  */
+
+static int
+sframe_lookup_fre (sframe_lookup_index *lookup, int32_t pc,
+		   sframe_frame_row_entry *frep)
+{
+  sframe_lookup_row *rows = lookup->sli_rows;
+  uint32_t offset, bucket, low, high;
+  int err = 0;
+
+  /* PCs before the first row wrap around to large offsets.  */
+  offset = (uint32_t) pc - (uint32_t) lookup->sli_base;
+  if (offset > lookup->sli_span)
+    return sframe_set_errno (&err, SFRAME_ERR_FRE_NOTFOUND);
+
+  bucket = offset >> lookup->sli_shift;
+  low = lookup->sli_buckets[bucket];
+  high = lookup->sli_buckets[bucket + 1];
+  if (high >= lookup->sli_num_rows)
+    high = lookup->sli_num_rows - 1;
+
+  /* Find the last row of the bucket starting at or before PC.  Buckets
+     are small, so this takes a few steps at most.  */
+  while (low < high)
+    {
+      uint32_t mid = high - (high - low) / 2;
+
+      if (rows[mid].slr_start <= pc)
+	low = mid;
+      else
+	high = mid - 1;
+    }
+
+  if (low >= lookup->sli_num_rows
+      || rows[low].slr_start > pc || rows[low].slr_end < pc)
+    return sframe_set_errno (&err, SFRAME_ERR_FRE_NOTFOUND);
+
+  sframe_frame_row_entry_copy (frep, &rows[low].slr_fre);
+  return 0;
+}
+
+/* Build the lookup index of the SFrame decoder CTX.  Returns SFRAME_ERR
+   if failure.  */
+
+int
+sframe_decoder_build_lookup_index (sframe_decoder_ctx *ctx)
+{
+  sframe_lookup_index *lookup;
+  sframe_lookup_row *rows;
+  sframe_func_desc_entry *fdep;
+  sframe_header *dhp;
+  uint32_t num_rows, num_buckets, shift, i, j, r;
+  const char *fres;
+  size_t size = 0;
+  int err = 0;
+
+  if (ctx == NULL)
+    return sframe_set_errno (&err, SFRAME_ERR_INVAL);
+
+  if (ctx->sfd_lookup != NULL)
+    return 0;
+
+  dhp = sframe_decoder_get_header (ctx);
+  if (dhp == NULL || dhp->sfh_num_fdes == 0 || ctx->sfd_funcdesc == NULL
+      || ctx->sfd_fres == NULL)
+    return sframe_set_errno (&err, SFRAME_ERR_DCTX_INVAL);
+  /* The rows are collected in FDE order, which must be sorted on PCs.  */
+  if ((dhp->sfh_preamble.sfp_flags & SFRAME_F_FDE_SORTED) == 0)
+    return sframe_set_errno (&err, SFRAME_ERR_FDE_NOTSORTED);
+
+  lookup = calloc (1, sizeof (sframe_lookup_index));
+  if (lookup == NULL)
+    return sframe_set_errno (&err, SFRAME_ERR_NOMEM);
+
+  num_rows = 0;
+  fdep = ctx->sfd_funcdesc;
+  for (i = 0; i < dhp->sfh_num_fdes; i++)
+    if (sframe_get_fde_type (&fdep[i]) != SFRAME_FDE_TYPE_PCMASK)
+      num_rows += fdep[i].sfde_func_num_fres;
+
+  rows = malloc ((num_rows ? num_rows : 1) * sizeof (sframe_lookup_row));
+  if (rows == NULL)
+    {
+      sframe_lookup_index_free (lookup);
+      return sframe_set_errno (&err, SFRAME_ERR_NOMEM);
+    }
+  lookup->sli_rows = rows;
+
+  r = 0;
+  for (i = 0; i < dhp->sfh_num_fdes; i++)
+    {
+      uint32_t fre_type = sframe_get_fre_type (&fdep[i]);
+      int32_t func_start_addr = fdep[i].sfde_func_start_address;
+
+      /* The FREs of PCMASK FDEs repeat over the function, so they can't
+	 be indexed by PC.  Leave them to the slow lookup.  */
+      if (sframe_get_fde_type (&fdep[i]) == SFRAME_FDE_TYPE_PCMASK)
+	{
+	  lookup->sli_partial_p = true;
+	  continue;
+	}
+
+      fres = ctx->sfd_fres + fdep[i].sfde_func_start_fre_off;
+      for (j = 0; j < fdep[i].sfde_func_num_fres; j++)
+	{
+	  sframe_lookup_row *row = &rows[r];
+
+	  if (sframe_decode_fre (fres, &row->slr_fre, fre_type, &size))
+	    {
+	      sframe_lookup_index_free (lookup);
+	      return sframe_set_errno (&err, SFRAME_ERR_FRE_INVAL);
+	    }
+	  row->slr_start = func_start_addr + row->slr_fre.fre_start_addr;
+	  row->slr_end = (func_start_addr
+			  + sframe_fre_get_end_ip_offset (&fdep[i], j,
+							  fres + size));
+	  fres += size;
+
+	  /* Drop FREs covering no PC, as the slow lookup never finds
+	     them either.  */
+	  if (row->slr_end < row->slr_start)
+	    continue;
+
+	  /* The bucket table relies on rows not overlapping.  */
+	  if (r > 0 && row->slr_start <= rows[r - 1].slr_end)
+	    {
+	      sframe_lookup_index_free (lookup);
+	      return sframe_set_errno (&err, SFRAME_ERR_FDE_NOTSORTED);
+	    }
+	  r++;
+	}
+    }
+  num_rows = r;
+  lookup->sli_num_rows = num_rows;
+
+  if (num_rows == 0)
+    {
+      sframe_lookup_index_free (lookup);
+      return sframe_set_errno (&err, SFRAME_ERR_FRE_NOTFOUND);
+    }
+
+  lookup->sli_base = rows[0].slr_start;
+  lookup->sli_span = ((uint32_t) rows[num_rows - 1].slr_end
+		      - (uint32_t) lookup->sli_base);
+
+  /* Use the smallest buckets that still keep their number below the
+     number of rows, so that there is about one row per bucket.  */
+  shift = SFRAME_LOOKUP_MIN_SHIFT;
+  while (shift < 31 && (lookup->sli_span >> shift) + 1 > num_rows)
+    shift++;
+  lookup->sli_shift = shift;
+  num_buckets = (lookup->sli_span >> shift) + 1;
+
+  lookup->sli_buckets = malloc ((num_buckets + 1) * sizeof (uint32_t));
+  if (lookup->sli_buckets == NULL)
+    {
+      sframe_lookup_index_free (lookup);
+      return sframe_set_errno (&err, SFRAME_ERR_NOMEM);
+    }
+
+  /* The first row which may cover a PC in a bucket is the first one
+     ending at or after the start of the bucket.  */
+  r = 0;
+  for (i = 0; i < num_buckets; i++)
+    {
+      uint32_t bucket_start = i << shift;
+
+      while (r < num_rows
+	     && ((uint32_t) rows[r].slr_end - (uint32_t) lookup->sli_base
+		 < bucket_start))
+	r++;
+      lookup->sli_buckets[i] = r;
+    }
+  lookup->sli_buckets[num_buckets] = num_rows;
+
+  ctx->sfd_lookup = lookup;
+  return 0;
+}
+
 /* Find the SFrame Row Entry which contains the PC.  Returns
    SFRAME_ERR if failure.  */
 
@@ -1124,6 +1322,15 @@ sframe_find_fre (sframe_decoder_ctx *ctx, int32_t pc,
   if ((ctx == NULL) || (frep == NULL))
     return sframe_set_errno (&err, SFRAME_ERR_INVAL);
 
+  /* Use the lookup index if there is one.  */
+  if (ctx->sfd_lookup != NULL)
+    {
+      if (sframe_lookup_fre (ctx->sfd_lookup, pc, frep) == 0)
+	return 0;
+      if (!ctx->sfd_lookup->sli_partial_p)
+	return sframe_set_errno (&err, SFRAME_ERR_FRE_NOTFOUND);
+    }
+
   /* Find the FDE which contains the PC, then scan its fre entries.  */
   fdep = sframe_get_funcdesc_with_addr_internal (ctx, pc, &err);
   if (fdep == NULL || ctx->sfd_fres == NULL)
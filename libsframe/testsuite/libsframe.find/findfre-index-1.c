@@ -0,0 +1,199 @@
+/* findfre-index-1.c -- Test and microbenchmark for
+   sframe_decoder_build_lookup_index in libsframe.
+
+   Copyright (C) 2024 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Check that sframe_find_fre gives the same answers with and without the
+   lookup index for every PC in and around a large set of functions, and
+   report how long the lookups take each way.  */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sframe-api.h"
+
+/* DejaGnu should not use gnulib's vsnprintf replacement here.  */
+#undef vsnprintf
+#include <dejagnu.h>
+
+#define NUM_FUNCS 20000
+#define FUNC_START 0x2000
+#define FUNC_SIZE 0x40
+#define FUNC_STRIDE 0x50
+#define PLT_START 0x1000
+#define PLT_SIZE 0x50
+
+static int
+add_plt_fde (sframe_encoder_ctx *ectx, int idx)
+{
+  int i, err;
+  sframe_frame_row_entry fres[]
+    = { {0x0, {0x8, 0, 0}, 0x3},
+	{0x6, {0x10, 0xf0, 0}, 0x5},
+	{0xb, {0x8, 0xf0, 0}, 0x4}
+      };
+
+  unsigned char finfo = sframe_fde_create_func_info (SFRAME_FRE_TYPE_ADDR1,
+						     SFRAME_FDE_TYPE_PCMASK);
+  err = sframe_encoder_add_funcdesc_v2 (ectx, PLT_START, PLT_SIZE, finfo,
+					16, 3);
+  if (err == -1)
+    return err;
+
+  for (i = 0; i < 3; i++)
+    if (sframe_encoder_add_fre (ectx, idx, fres + i) == SFRAME_ERR)
+      return -1;
+
+  return 0;
+}
+
+static int
+add_fde (sframe_encoder_ctx *ectx, int idx, int32_t start)
+{
+  int i, err;
+  /* Vary the CFA offset so that finding the wrong FRE shows.  */
+  uint8_t off = 0x18 + idx % 7;
+  sframe_frame_row_entry fres[]
+    = { {0x0, {0x8, 0, 0}, 0x3},
+	{0x1, {0x10, 0xf0, 0}, 0x5},
+	{0x10, {off, 0xf0, 0}, 0x5},
+	{0x38, {0x8, 0xf0, 0}, 0x5}
+      };
+
+  unsigned char finfo = sframe_fde_create_func_info (SFRAME_FRE_TYPE_ADDR1,
+						     SFRAME_FDE_TYPE_PCINC);
+  err = sframe_encoder_add_funcdesc (ectx, start, FUNC_SIZE, finfo, 4);
+  if (err == -1)
+    return err;
+
+  for (i = 0; i < 4; i++)
+    if (sframe_encoder_add_fre (ectx, idx, fres + i) == SFRAME_ERR)
+      return -1;
+
+  return 0;
+}
+
+/* Look up every PC from LOW to HIGH in DCTX, and return the number of
+   FREs found.  */
+
+static unsigned int
+find_all (sframe_decoder_ctx *dctx, int32_t low, int32_t high)
+{
+  sframe_frame_row_entry frep;
+  unsigned int found = 0;
+  int32_t pc;
+
+  for (pc = low; pc <= high; pc++)
+    if (sframe_find_fre (dctx, pc, &frep) == 0)
+      found++;
+
+  return found;
+}
+
+int main (void)
+{
+  sframe_encoder_ctx *ectx;
+  sframe_decoder_ctx *slow, *fast;
+  sframe_frame_row_entry slow_fre, fast_fre;
+  char *sframe_buf;
+  size_t sf_size;
+  int err = 0, slow_err, fast_err;
+  int32_t low, high, pc;
+  unsigned int i, slow_found, fast_found, mismatches;
+  clock_t start, slow_time, fast_time;
+  char msg[128];
+
+#define TEST(name, cond)                                                      \
+  do                                                                          \
+    {                                                                         \
+      if (cond)                                                               \
+	pass (name);                                                          \
+      else                                                                    \
+	fail (name);                                                          \
+    }                                                                         \
+    while (0)
+
+  ectx = sframe_encode (SFRAME_VERSION, 0, SFRAME_ABI_AMD64_ENDIAN_LITTLE,
+			SFRAME_CFA_FIXED_FP_INVALID,
+			-8, /* Fixed RA offset for AMD64.  */
+			&err);
+
+  err = add_plt_fde (ectx, 0);
+  for (i = 0; i < NUM_FUNCS && err == 0; i++)
+    err = add_fde (ectx, i + 1, FUNC_START + i * FUNC_STRIDE);
+  TEST ("findfre-index-1: Adding FDEs", err == 0);
+
+  sframe_buf = sframe_encoder_write (ectx, &sf_size, &err);
+  TEST ("findfre-index-1: Encoder write", err == 0);
+
+  slow = sframe_decode (sframe_buf, sf_size, &err);
+  TEST ("findfre-index-1: Decoder setup", slow != NULL);
+  fast = sframe_decode (sframe_buf, sf_size, &err);
+  TEST ("findfre-index-1: Decoder setup for index", fast != NULL);
+
+  err = sframe_decoder_build_lookup_index (fast);
+  TEST ("findfre-index-1: Build lookup index", err == 0);
+  err = sframe_decoder_build_lookup_index (fast);
+  TEST ("findfre-index-1: Build lookup index again", err == 0);
+
+  /* Cover some PCs before the PLT and after the last function too.  */
+  low = PLT_START - 0x100;
+  high = FUNC_START + NUM_FUNCS * FUNC_STRIDE + 0x100;
+
+  mismatches = 0;
+  for (pc = low; pc <= high; pc++)
+    {
+      slow_err = sframe_find_fre (slow, pc, &slow_fre);
+      fast_err = sframe_find_fre (fast, pc, &fast_fre);
+      if (slow_err != fast_err
+	  || (slow_err == 0
+	      && (slow_fre.fre_start_addr != fast_fre.fre_start_addr
+		  || slow_fre.fre_info != fast_fre.fre_info
+		  || memcmp (slow_fre.fre_offsets, fast_fre.fre_offsets,
+			     sizeof (slow_fre.fre_offsets)) != 0)))
+	mismatches++;
+    }
+  TEST ("findfre-index-1: Same FREs with and without index", mismatches == 0);
+
+  /* The microbenchmark proper.  */
+  start = clock ();
+  slow_found = find_all (slow, low, high);
+  slow_time = clock () - start;
+
+  start = clock ();
+  fast_found = find_all (fast, low, high);
+  fast_time = clock () - start;
+
+  TEST ("findfre-index-1: Same number of FREs found",
+	slow_found == fast_found);
+
+  snprintf (msg, sizeof (msg),
+	    "findfre-index-1: %u lookups: %.3fs without index, %.3fs with",
+	    (unsigned int) (high - low + 1),
+	    (double) slow_time / CLOCKS_PER_SEC,
+	    (double) fast_time / CLOCKS_PER_SEC);
+  note ("%s", msg);
+
+  sframe_encoder_free (&ectx);
+  sframe_decoder_free (&slow);
+  sframe_decoder_free (&fast);
+
+  return 0;
+}